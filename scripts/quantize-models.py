@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+# Copyright    2025  Xiaomi Corp.
+"""
+Generate int8 and/or fp16 variants of fp32 onnx models, so that sherpa-onnx
+can select the precision at runtime with --precision, e.g.,
+
+    encoder.onnx -> encoder.int8.onnx, encoder.fp16.onnx
+
+Usage:
+
+    pip install onnx onnxruntime onnxconverter-common
+
+    ./scripts/quantize-models.py \
+      --precision int8,fp16 \
+      ./sherpa-onnx-zipformer-en-2023-06-26
+
+Existing files are not regenerated, so it is cheap to run it again, e.g.,
+each time a machine starts. Use --overwrite to regenerate them.
+
+The int8 models use dynamic quantization of the weights of MatMul.
+Use ./bin/sherpa-onnx-offline-precision-check to check their accuracy and
+speed.
+"""
+
+import argparse
+from pathlib import Path
+from typing import List
+
+
+def get_args():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+    )
+    parser.add_argument(
+        "--precision",
+        type=str,
+        default="int8",
+        help="Comma separated list of precisions to generate: int8, fp16",
+    )
+
+    parser.add_argument(
+        "--op-types",
+        type=str,
+        default="MatMul",
+        help="Comma separated list of op types to quantize for int8",
+    )
+
+    parser.add_argument(
+        "--overwrite",
+        action="store_true",
+        help="Regenerate files that already exist",
+    )
+
+    parser.add_argument(
+        "inputs",
+        type=str,
+        nargs="+",
+        help="fp32 onnx models or directories containing them",
+    )
+    return parser.parse_args()
+
+
+def find_models(inputs: List[str]) -> List[Path]:
+    ans = []
+    for i in inputs:
+        p = Path(i)
+        if p.is_dir():
+            ans.extend(sorted(p.glob("*.onnx")))
+        else:
+            ans.append(p)
+
+    # Skip models that are not fp32
+    return [p for p in ans if not p.name.endswith((".int8.onnx", ".fp16.onnx"))]
+
+
+def output_filename(filename: Path, precision: str) -> Path:
+    return filename.with_name(filename.name[: -len(".onnx")] + f".{precision}.onnx")
+
+
+def to_int8(filename: Path, out: Path, op_types: List[str]):
+    from onnxruntime.quantization import QuantType, quantize_dynamic
+
+    quantize_dynamic(
+        model_input=str(filename),
+        model_output=str(out),
+        op_types_to_quantize=op_types,
+        # Note that we have to use QUInt8 here.
+        #
+        # When QInt8 is used, C++ onnxruntime produces incorrect results
+        # for some models
+        weight_type=QuantType.QUInt8,
+    )
+
+
+def to_fp16(filename: Path, out: Path):
+    import onnx
+    from onnxconverter_common import float16
+
+    model = onnx.load(str(filename))
+    # Inputs and outputs stay in fp32 so that the C++ code does not change
+    model = float16.convert_float_to_float16(model, keep_io_types=True)
+    onnx.save(model, str(out))
+
+
+def main():
+    args = get_args()
+    print(vars(args))
+
+    precisions = [p.strip() for p in args.precision.split(",") if p.strip()]
+    for p in precisions:
+        if p not in ("int8", "fp16"):
+            raise ValueError(f"Unsupported precision: {p}")
+
+    op_types = [t.strip() for t in args.op_types.split(",") if t.strip()]
+
+    for filename in find_models(args.inputs):
+        for p in precisions:
+            out = output_filename(filename, p)
+            if out.is_file() and not args.overwrite:
+                print(f"Skip {out} since it exists")
+                continue
+
+            # Write to a temporary file so that an interrupted run does not
+            # leave a broken model behind
+            tmp = out.with_name(out.name + ".tmp")
+            print(f"{filename} -> {out}")
+            if p == "int8":
+                to_int8(filename, tmp, op_types)
+            else:
+                to_fp16(filename, tmp)
+            tmp.replace(out)
+
+
+if __name__ == "__main__":
+    main()
@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <map>
 #include <memory>
 #include <string>
 #include <strstream>
@@ -22,11 +23,14 @@
 #include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/keyword-spotter.h"
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/model-registry.h"
 #include "sherpa-onnx/csrc/offline-punctuation.h"
 #include "sherpa-onnx/csrc/offline-recognizer.h"
 #include "sherpa-onnx/csrc/offline-speech-denoiser.h"
 #include "sherpa-onnx/csrc/online-punctuation.h"
 #include "sherpa-onnx/csrc/online-recognizer.h"
+#include "sherpa-onnx/csrc/ort-env.h"
+#include "sherpa-onnx/csrc/perf-stats.h"
 #include "sherpa-onnx/csrc/resample.h"
 #include "sherpa-onnx/csrc/speaker-embedding-extractor.h"
 #include "sherpa-onnx/csrc/speaker-embedding-manager.h"
@@ -182,11 +186,52 @@ const SherpaOnnxOnlineRecognizer *SherpaOnnxCreateOnlineRecognizer(
   return recognizer;
 }
 
+const SherpaOnnxOnlineRecognizer *SherpaOnnxCloneOnlineRecognizer(
+    const SherpaOnnxOnlineRecognizer *recognizer,
+    const SherpaOnnxOnlineRecognizerConfig *config) {
+  sherpa_onnx::OnlineRecognizerConfig recognizer_config =
+      GetOnlineRecognizerConfig(config);
+
+  if (!recognizer_config.Validate()) {
+    SHERPA_ONNX_LOGE("Errors in config!");
+    return nullptr;
+  }
+
+  auto impl = recognizer->impl->Clone(recognizer_config);
+  if (!impl) {
+    return nullptr;
+  }
+
+  SherpaOnnxOnlineRecognizer *ans = new SherpaOnnxOnlineRecognizer;
+  ans->impl = std::move(impl);
+
+  return ans;
+}
+
 void SherpaOnnxDestroyOnlineRecognizer(
     const SherpaOnnxOnlineRecognizer *recognizer) {
   delete recognizer;
 }
 
+static const char *StatsToJson(
+    const std::map<std::string, sherpa_onnx::StageStats> &stats) {
+  std::string json = sherpa_onnx::PerfStatsToJson(stats);
+  char *p = new char[json.size() + 1];
+  std::copy(json.begin(), json.end(), p);
+  p[json.size()] = 0;
+  return p;
+}
+
+const char *SherpaOnnxOnlineRecognizerGetStatsAsJson(
+    const SherpaOnnxOnlineRecognizer *recognizer) {
+  return StatsToJson(recognizer->impl->GetStats());
+}
+
+void SherpaOnnxOnlineRecognizerResetStats(
+    const SherpaOnnxOnlineRecognizer *recognizer) {
+  recognizer->impl->ResetStats();
+}
+
 const SherpaOnnxOnlineStream *SherpaOnnxCreateOnlineStream(
     const SherpaOnnxOnlineRecognizer *recognizer) {
   SherpaOnnxOnlineStream *stream =
@@ -357,7 +402,8 @@ void SherpaOnnxPrint(const SherpaOnnxDisplay *display, int32_t idx,
 // ============================================================
 //
 struct SherpaOnnxOfflineRecognizer {
-  std::unique_ptr<sherpa_onnx::OfflineRecognizer> impl;
+  // It is shared with SherpaOnnxOfflineRecognizerRegistry
+  std::shared_ptr<sherpa_onnx::OfflineRecognizer> impl;
 };
 
 struct SherpaOnnxOfflineStream {
@@ -523,6 +569,28 @@ const SherpaOnnxOfflineRecognizer *SherpaOnnxCreateOfflineRecognizer(
   return recognizer;
 }
 
+const SherpaOnnxOfflineRecognizer *SherpaOnnxCloneOfflineRecognizer(
+    const SherpaOnnxOfflineRecognizer *recognizer,
+    const SherpaOnnxOfflineRecognizerConfig *config) {
+  sherpa_onnx::OfflineRecognizerConfig recognizer_config =
+      GetOfflineRecognizerConfig(config);
+
+  if (!recognizer_config.Validate()) {
+    SHERPA_ONNX_LOGE("Errors in config");
+    return nullptr;
+  }
+
+  auto impl = recognizer->impl->Clone(recognizer_config);
+  if (!impl) {
+    return nullptr;
+  }
+
+  SherpaOnnxOfflineRecognizer *ans = new SherpaOnnxOfflineRecognizer;
+  ans->impl = std::move(impl);
+
+  return ans;
+}
+
 void SherpaOnnxOfflineRecognizerSetConfig(
     const SherpaOnnxOfflineRecognizer *recognizer,
     const SherpaOnnxOfflineRecognizerConfig *config) {
@@ -536,6 +604,76 @@ void SherpaOnnxDestroyOfflineRecognizer(
   delete recognizer;
 }
 
+const char *SherpaOnnxOfflineRecognizerGetStatsAsJson(
+    const SherpaOnnxOfflineRecognizer *recognizer) {
+  return StatsToJson(recognizer->impl->GetStats());
+}
+
+void SherpaOnnxOfflineRecognizerResetStats(
+    const SherpaOnnxOfflineRecognizer *recognizer) {
+  recognizer->impl->ResetStats();
+}
+
+struct SherpaOnnxOfflineRecognizerRegistry {
+  std::unique_ptr<sherpa_onnx::ModelRegistry<
+      sherpa_onnx::OfflineRecognizer, sherpa_onnx::OfflineRecognizerConfig>>
+      impl;
+};
+
+const SherpaOnnxOfflineRecognizerRegistry *
+SherpaOnnxCreateOfflineRecognizerRegistry(int32_t max_memory_mb,
+                                          float max_idle_seconds) {
+  sherpa_onnx::ModelRegistryConfig config(max_memory_mb, max_idle_seconds);
+  if (!config.Validate()) {
+    SHERPA_ONNX_LOGE("Errors in config");
+    return nullptr;
+  }
+
+  auto registry = new SherpaOnnxOfflineRecognizerRegistry;
+  registry->impl = std::make_unique<sherpa_onnx::ModelRegistry<
+      sherpa_onnx::OfflineRecognizer, sherpa_onnx::OfflineRecognizerConfig>>(
+      config);
+
+  return registry;
+}
+
+void SherpaOnnxDestroyOfflineRecognizerRegistry(
+    const SherpaOnnxOfflineRecognizerRegistry *registry) {
+  delete registry;
+}
+
+int32_t SherpaOnnxOfflineRecognizerRegistryAdd(
+    const SherpaOnnxOfflineRecognizerRegistry *registry, const char *name,
+    const SherpaOnnxOfflineRecognizerConfig *config) {
+  sherpa_onnx::OfflineRecognizerConfig recognizer_config =
+      GetOfflineRecognizerConfig(config);
+
+  if (!recognizer_config.Validate()) {
+    SHERPA_ONNX_LOGE("Errors in config");
+    return 0;
+  }
+
+  return registry->impl->Add(name, recognizer_config);
+}
+
+const SherpaOnnxOfflineRecognizer *SherpaOnnxOfflineRecognizerRegistryGet(
+    const SherpaOnnxOfflineRecognizerRegistry *registry, const char *name) {
+  auto impl = registry->impl->Get(name);
+  if (!impl) {
+    return nullptr;
+  }
+
+  SherpaOnnxOfflineRecognizer *ans = new SherpaOnnxOfflineRecognizer;
+  ans->impl = std::move(impl);
+
+  return ans;
+}
+
+int32_t SherpaOnnxOfflineRecognizerRegistryUnload(
+    const SherpaOnnxOfflineRecognizerRegistry *registry, const char *name) {
+  return registry->impl->Unload(name);
+}
+
 const SherpaOnnxOfflineStream *SherpaOnnxCreateOfflineStream(
     const SherpaOnnxOfflineRecognizer *recognizer) {
   SherpaOnnxOfflineStream *stream =
@@ -1091,7 +1229,8 @@ void SherpaOnnxVoiceActivityDetectorFlush(
 
 #if SHERPA_ONNX_ENABLE_TTS == 1
 struct SherpaOnnxOfflineTts {
-  std::unique_ptr<sherpa_onnx::OfflineTts> impl;
+  // It is shared with SherpaOnnxOfflineTtsRegistry
+  std::shared_ptr<sherpa_onnx::OfflineTts> impl;
 };
 
 static sherpa_onnx::OfflineTtsConfig GetOfflineTtsConfig(
@@ -1187,6 +1326,26 @@ const SherpaOnnxOfflineTts *SherpaOnnxCreateOfflineTts(
   return tts;
 }
 
+const SherpaOnnxOfflineTts *SherpaOnnxCloneOfflineTts(
+    const SherpaOnnxOfflineTts *tts, const SherpaOnnxOfflineTtsConfig *config) {
+  auto tts_config = GetOfflineTtsConfig(config);
+
+  if (!tts_config.Validate()) {
+    SHERPA_ONNX_LOGE("Errors in config");
+    return nullptr;
+  }
+
+  auto impl = tts->impl->Clone(tts_config);
+  if (!impl) {
+    return nullptr;
+  }
+
+  SherpaOnnxOfflineTts *ans = new SherpaOnnxOfflineTts;
+  ans->impl = std::move(impl);
+
+  return ans;
+}
+
 void SherpaOnnxDestroyOfflineTts(const SherpaOnnxOfflineTts *tts) {
   delete tts;
 }
@@ -1199,6 +1358,72 @@ int32_t SherpaOnnxOfflineTtsNumSpeakers(const SherpaOnnxOfflineTts *tts) {
   return tts->impl->NumSpeakers();
 }
 
+const char *SherpaOnnxOfflineTtsGetStatsAsJson(
+    const SherpaOnnxOfflineTts *tts) {
+  return StatsToJson(tts->impl->GetStats());
+}
+
+void SherpaOnnxOfflineTtsResetStats(const SherpaOnnxOfflineTts *tts) {
+  tts->impl->ResetStats();
+}
+
+struct SherpaOnnxOfflineTtsRegistry {
+  std::unique_ptr<sherpa_onnx::ModelRegistry<sherpa_onnx::OfflineTts,
+                                             sherpa_onnx::OfflineTtsConfig>>
+      impl;
+};
+
+const SherpaOnnxOfflineTtsRegistry *SherpaOnnxCreateOfflineTtsRegistry(
+    int32_t max_memory_mb, float max_idle_seconds) {
+  sherpa_onnx::ModelRegistryConfig config(max_memory_mb, max_idle_seconds);
+  if (!config.Validate()) {
+    SHERPA_ONNX_LOGE("Errors in config");
+    return nullptr;
+  }
+
+  auto registry = new SherpaOnnxOfflineTtsRegistry;
+  registry->impl = std::make_unique<sherpa_onnx::ModelRegistry<
+      sherpa_onnx::OfflineTts, sherpa_onnx::OfflineTtsConfig>>(config);
+
+  return registry;
+}
+
+void SherpaOnnxDestroyOfflineTtsRegistry(
+    const SherpaOnnxOfflineTtsRegistry *registry) {
+  delete registry;
+}
+
+int32_t SherpaOnnxOfflineTtsRegistryAdd(
+    const SherpaOnnxOfflineTtsRegistry *registry, const char *name,
+    const SherpaOnnxOfflineTtsConfig *config) {
+  auto tts_config = GetOfflineTtsConfig(config);
+
+  if (!tts_config.Validate()) {
+    SHERPA_ONNX_LOGE("Errors in config");
+    return 0;
+  }
+
+  return registry->impl->Add(name, tts_config);
+}
+
+const SherpaOnnxOfflineTts *SherpaOnnxOfflineTtsRegistryGet(
+    const SherpaOnnxOfflineTtsRegistry *registry, const char *name) {
+  auto impl = registry->impl->Get(name);
+  if (!impl) {
+    return nullptr;
+  }
+
+  SherpaOnnxOfflineTts *ans = new SherpaOnnxOfflineTts;
+  ans->impl = std::move(impl);
+
+  return ans;
+}
+
+int32_t SherpaOnnxOfflineTtsRegistryUnload(
+    const SherpaOnnxOfflineTtsRegistry *registry, const char *name) {
+  return registry->impl->Unload(name);
+}
+
 static const SherpaOnnxGeneratedAudio *SherpaOnnxOfflineTtsGenerateInternal(
     const SherpaOnnxOfflineTts *tts, const char *text, int32_t sid, float speed,
     std::function<int32_t(const float *, int32_t, float)> callback) {
@@ -1284,6 +1509,12 @@ const SherpaOnnxOfflineTts *SherpaOnnxCreateOfflineTts(
   return nullptr;
 }
 
+const SherpaOnnxOfflineTts *SherpaOnnxCloneOfflineTts(
+    const SherpaOnnxOfflineTts *tts, const SherpaOnnxOfflineTtsConfig *config) {
+  SHERPA_ONNX_LOGE("TTS is not enabled. Please rebuild sherpa-onnx");
+  return nullptr;
+}
+
 void SherpaOnnxDestroyOfflineTts(const SherpaOnnxOfflineTts *tts) {
   SHERPA_ONNX_LOGE("TTS is not enabled. Please rebuild sherpa-onnx");
 }
@@ -1298,6 +1529,46 @@ int32_t SherpaOnnxOfflineTtsNumSpeakers(const SherpaOnnxOfflineTts *tts) {
   return 0;
 }
 
+const char *SherpaOnnxOfflineTtsGetStatsAsJson(
+    const SherpaOnnxOfflineTts *tts) {
+  SHERPA_ONNX_LOGE("TTS is not enabled. Please rebuild sherpa-onnx");
+  return nullptr;
+}
+
+void SherpaOnnxOfflineTtsResetStats(const SherpaOnnxOfflineTts *tts) {
+  SHERPA_ONNX_LOGE("TTS is not enabled. Please rebuild sherpa-onnx");
+}
+
+const SherpaOnnxOfflineTtsRegistry *SherpaOnnxCreateOfflineTtsRegistry(
+    int32_t max_memory_mb, float max_idle_seconds) {
+  SHERPA_ONNX_LOGE("TTS is not enabled. Please rebuild sherpa-onnx");
+  return nullptr;
+}
+
+void SherpaOnnxDestroyOfflineTtsRegistry(
+    const SherpaOnnxOfflineTtsRegistry *registry) {
+  SHERPA_ONNX_LOGE("TTS is not enabled. Please rebuild sherpa-onnx");
+}
+
+int32_t SherpaOnnxOfflineTtsRegistryAdd(
+    const SherpaOnnxOfflineTtsRegistry *registry, const char *name,
+    const SherpaOnnxOfflineTtsConfig *config) {
+  SHERPA_ONNX_LOGE("TTS is not enabled. Please rebuild sherpa-onnx");
+  return 0;
+}
+
+const SherpaOnnxOfflineTts *SherpaOnnxOfflineTtsRegistryGet(
+    const SherpaOnnxOfflineTtsRegistry *registry, const char *name) {
+  SHERPA_ONNX_LOGE("TTS is not enabled. Please rebuild sherpa-onnx");
+  return nullptr;
+}
+
+int32_t SherpaOnnxOfflineTtsRegistryUnload(
+    const SherpaOnnxOfflineTtsRegistry *registry, const char *name) {
+  SHERPA_ONNX_LOGE("TTS is not enabled. Please rebuild sherpa-onnx");
+  return 0;
+}
+
 const SherpaOnnxGeneratedAudio *SherpaOnnxOfflineTtsGenerate(
     const SherpaOnnxOfflineTts *tts, const char *text, int32_t sid,
     float speed) {
@@ -2323,6 +2594,24 @@ void SherpaOnnxOfflineSpeakerDiarizationDestroyResult(
 
 #endif
 
+int32_t SherpaOnnxInitOrtEnv(const SherpaOnnxOrtEnvConfig *config) {
+  sherpa_onnx::OrtEnvConfig env_config;
+  env_config.use_global_thread_pool = config->use_global_thread_pool != 0;
+  env_config.intra_op_num_threads = config->intra_op_num_threads;
+  env_config.inter_op_num_threads = config->inter_op_num_threads;
+  env_config.allow_spinning = config->allow_spinning != 0;
+  env_config.share_prepacked_weights = config->share_prepacked_weights != 0;
+  env_config.optimized_model_cache_dir =
+      SHERPA_ONNX_OR(config->optimized_model_cache_dir, "");
+  env_config.intra_op_thread_affinities =
+      SHERPA_ONNX_OR(config->intra_op_thread_affinities, "");
+  env_config.profiling_prefix = SHERPA_ONNX_OR(config->profiling_prefix, "");
+
+  return sherpa_onnx::InitOrtEnv(env_config);
+}
+
+void SherpaOnnxFreeStatsJson(const char *s) { delete[] s; }
+
 #ifdef __OHOS__
 
 const SherpaOnnxOfflineSpeechDenoiser *
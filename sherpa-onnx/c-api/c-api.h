@@ -209,12 +209,40 @@ SHERPA_ONNX_API const SherpaOnnxOnlineRecognizer *
 SherpaOnnxCreateOnlineRecognizer(
     const SherpaOnnxOnlineRecognizerConfig *config);
 
+/// Create a recognizer that shares the models of the given one but uses
+/// the decoding settings from config, e.g., decoding_method, hotwords and
+/// endpoint rules. It is much cheaper than SherpaOnnxCreateOnlineRecognizer().
+///
+/// config should describe the same model as the one used to create
+/// recognizer. The given recognizer can be freed before the returned one.
+///
+/// @return Return a pointer to the recognizer or NULL if the model does not
+///         support it. The user has to invoke
+///         SherpaOnnxDestroyOnlineRecognizer() to free it.
+SHERPA_ONNX_API const SherpaOnnxOnlineRecognizer *
+SherpaOnnxCloneOnlineRecognizer(const SherpaOnnxOnlineRecognizer *recognizer,
+                                const SherpaOnnxOnlineRecognizerConfig *config);
+
 /// Free a pointer returned by SherpaOnnxCreateOnlineRecognizer()
 ///
 /// @param p A pointer returned by SherpaOnnxCreateOnlineRecognizer()
 SHERPA_ONNX_API void SherpaOnnxDestroyOnlineRecognizer(
     const SherpaOnnxOnlineRecognizer *recognizer);
 
+/// Return the cumulative time of each stage of the recognizer, e.g.,
+/// feature_extraction, encoder, decoder and joiner, as a json string:
+///
+///   {"encoder": {"num_calls": 10, "total_seconds": 0.500000}, ...}
+///
+/// The user has to invoke SherpaOnnxFreeStatsJson() to free the returned
+/// pointer to avoid memory leak.
+SHERPA_ONNX_API const char *SherpaOnnxOnlineRecognizerGetStatsAsJson(
+    const SherpaOnnxOnlineRecognizer *recognizer);
+
+/// Clear the stats returned by SherpaOnnxOnlineRecognizerGetStatsAsJson()
+SHERPA_ONNX_API void SherpaOnnxOnlineRecognizerResetStats(
+    const SherpaOnnxOnlineRecognizer *recognizer);
+
 /// Create an online stream for accepting wave samples.
 ///
 /// @param recognizer  A pointer returned by SherpaOnnxCreateOnlineRecognizer()
@@ -476,6 +504,22 @@ SHERPA_ONNX_API const SherpaOnnxOfflineRecognizer *
 SherpaOnnxCreateOfflineRecognizer(
     const SherpaOnnxOfflineRecognizerConfig *config);
 
+/// Create a recognizer that shares the models of the given one but uses
+/// the decoding settings from config, e.g., decoding_method, hotwords and
+/// the language of whisper models. It is much cheaper than
+/// SherpaOnnxCreateOfflineRecognizer().
+///
+/// config should describe the same model as the one used to create
+/// recognizer. The given recognizer can be freed before the returned one.
+///
+/// @return Return a pointer to the recognizer or NULL if the model does not
+///         support it. The user has to invoke
+///         SherpaOnnxDestroyOfflineRecognizer() to free it.
+SHERPA_ONNX_API const SherpaOnnxOfflineRecognizer *
+SherpaOnnxCloneOfflineRecognizer(
+    const SherpaOnnxOfflineRecognizer *recognizer,
+    const SherpaOnnxOfflineRecognizerConfig *config);
+
 /// @param config  Config for the recognizer.
 SHERPA_ONNX_API void SherpaOnnxOfflineRecognizerSetConfig(
     const SherpaOnnxOfflineRecognizer *recognizer,
@@ -487,6 +531,68 @@ SHERPA_ONNX_API void SherpaOnnxOfflineRecognizerSetConfig(
 SHERPA_ONNX_API void SherpaOnnxDestroyOfflineRecognizer(
     const SherpaOnnxOfflineRecognizer *recognizer);
 
+/// Return the cumulative time of each stage of the recognizer as a json
+/// string. See SherpaOnnxOnlineRecognizerGetStatsAsJson().
+///
+/// The user has to invoke SherpaOnnxFreeStatsJson() to free the returned
+/// pointer to avoid memory leak.
+SHERPA_ONNX_API const char *SherpaOnnxOfflineRecognizerGetStatsAsJson(
+    const SherpaOnnxOfflineRecognizer *recognizer);
+
+/// Clear the stats returned by SherpaOnnxOfflineRecognizerGetStatsAsJson()
+SHERPA_ONNX_API void SherpaOnnxOfflineRecognizerResetStats(
+    const SherpaOnnxOfflineRecognizer *recognizer);
+
+/// A registry creates recognizers on first use and unloads them when they
+/// are idle or when the memory budget is exceeded, so that a process can
+/// serve more models, e.g., one per language, than fit in memory at once.
+SHERPA_ONNX_API typedef struct SherpaOnnxOfflineRecognizerRegistry
+    SherpaOnnxOfflineRecognizerRegistry;
+
+/// @param max_memory_mb  If positive, the least recently used idle models
+///                       are unloaded when the estimated memory of loaded
+///                       models exceeds this number of MB.
+/// @param max_idle_seconds  If positive, models that have not been used for
+///                          this number of seconds are unloaded.
+/// @return Return a pointer to the registry or NULL if the arguments are
+///         invalid. The user has to invoke
+///         SherpaOnnxDestroyOfflineRecognizerRegistry() to free it.
+SHERPA_ONNX_API const SherpaOnnxOfflineRecognizerRegistry *
+SherpaOnnxCreateOfflineRecognizerRegistry(int32_t max_memory_mb,
+                                          float max_idle_seconds);
+
+/// Free a pointer returned by SherpaOnnxCreateOfflineRecognizerRegistry().
+/// Recognizers returned by SherpaOnnxOfflineRecognizerRegistryGet() stay
+/// valid until they are freed.
+SHERPA_ONNX_API void SherpaOnnxDestroyOfflineRecognizerRegistry(
+    const SherpaOnnxOfflineRecognizerRegistry *registry);
+
+/// Register a model under the given name without loading it.
+///
+/// @return Return 1 on success. Return 0 if the name is already used or
+///         the config is invalid.
+SHERPA_ONNX_API int32_t SherpaOnnxOfflineRecognizerRegistryAdd(
+    const SherpaOnnxOfflineRecognizerRegistry *registry, const char *name,
+    const SherpaOnnxOfflineRecognizerConfig *config);
+
+/// Return the recognizer with the given name, loading it if needed.
+///
+/// The model is not unloaded while the returned pointer is alive, so use
+/// one for a request and free it afterwards.
+///
+/// @return Return NULL if no model with the given name was added. The user
+///         has to invoke SherpaOnnxDestroyOfflineRecognizer() to free it.
+SHERPA_ONNX_API const SherpaOnnxOfflineRecognizer *
+SherpaOnnxOfflineRecognizerRegistryGet(
+    const SherpaOnnxOfflineRecognizerRegistry *registry, const char *name);
+
+/// Unload the model with the given name. It is freed once all recognizers
+/// returned for it are freed.
+///
+/// @return Return 1 if the model was loaded; return 0 otherwise.
+SHERPA_ONNX_API int32_t SherpaOnnxOfflineRecognizerRegistryUnload(
+    const SherpaOnnxOfflineRecognizerRegistry *registry, const char *name);
+
 /// Create an offline stream for accepting wave samples.
 ///
 /// @param recognizer  A pointer returned by SherpaOnnxCreateOfflineRecognizer()
@@ -996,6 +1102,13 @@ SHERPA_ONNX_API typedef struct SherpaOnnxOfflineTts SherpaOnnxOfflineTts;
 SHERPA_ONNX_API const SherpaOnnxOfflineTts *SherpaOnnxCreateOfflineTts(
     const SherpaOnnxOfflineTtsConfig *config);
 
+// Create an instance of offline TTS that shares the models of the given one
+// but uses rule_fsts, rule_fars, max_num_sentences and silence_scale from
+// config. It returns NULL if the model does not support it. The user has to
+// use SherpaOnnxDestroyOfflineTts() to free the returned pointer.
+SHERPA_ONNX_API const SherpaOnnxOfflineTts *SherpaOnnxCloneOfflineTts(
+    const SherpaOnnxOfflineTts *tts, const SherpaOnnxOfflineTtsConfig *config);
+
 // Free the pointer returned by SherpaOnnxCreateOfflineTts()
 SHERPA_ONNX_API void SherpaOnnxDestroyOfflineTts(
     const SherpaOnnxOfflineTts *tts);
@@ -1008,6 +1121,48 @@ SherpaOnnxOfflineTtsSampleRate(const SherpaOnnxOfflineTts *tts);
 SHERPA_ONNX_API int32_t
 SherpaOnnxOfflineTtsNumSpeakers(const SherpaOnnxOfflineTts *tts);
 
+// Return the cumulative time of each stage, e.g., frontend, acoustic_model
+// and vocoder, as a json string. See
+// SherpaOnnxOnlineRecognizerGetStatsAsJson() for the format. The user has
+// to use SherpaOnnxFreeStatsJson() to free the returned pointer.
+SHERPA_ONNX_API const char *SherpaOnnxOfflineTtsGetStatsAsJson(
+    const SherpaOnnxOfflineTts *tts);
+
+// Clear the stats returned by SherpaOnnxOfflineTtsGetStatsAsJson()
+SHERPA_ONNX_API void SherpaOnnxOfflineTtsResetStats(
+    const SherpaOnnxOfflineTts *tts);
+
+// Like SherpaOnnxOfflineRecognizerRegistry, but for TTS models, e.g., one
+// per voice.
+SHERPA_ONNX_API typedef struct SherpaOnnxOfflineTtsRegistry
+    SherpaOnnxOfflineTtsRegistry;
+
+// See SherpaOnnxCreateOfflineRecognizerRegistry(). The user has to use
+// SherpaOnnxDestroyOfflineTtsRegistry() to free the returned pointer.
+SHERPA_ONNX_API const SherpaOnnxOfflineTtsRegistry *
+SherpaOnnxCreateOfflineTtsRegistry(int32_t max_memory_mb,
+                                   float max_idle_seconds);
+
+SHERPA_ONNX_API void SherpaOnnxDestroyOfflineTtsRegistry(
+    const SherpaOnnxOfflineTtsRegistry *registry);
+
+// Return 1 on success. Return 0 if the name is already used or the config
+// is invalid.
+SHERPA_ONNX_API int32_t SherpaOnnxOfflineTtsRegistryAdd(
+    const SherpaOnnxOfflineTtsRegistry *registry, const char *name,
+    const SherpaOnnxOfflineTtsConfig *config);
+
+// Return the TTS with the given name, loading it if needed, or NULL if no
+// model with the given name was added. The model is not unloaded while the
+// returned pointer is alive. The user has to use SherpaOnnxDestroyOfflineTts()
+// to free it.
+SHERPA_ONNX_API const SherpaOnnxOfflineTts *SherpaOnnxOfflineTtsRegistryGet(
+    const SherpaOnnxOfflineTtsRegistry *registry, const char *name);
+
+// Return 1 if the model was loaded; return 0 otherwise.
+SHERPA_ONNX_API int32_t SherpaOnnxOfflineTtsRegistryUnload(
+    const SherpaOnnxOfflineTtsRegistry *registry, const char *name);
+
 // Generate audio from the given text and speaker id (sid).
 // The user has to use SherpaOnnxDestroyOfflineTtsGeneratedAudio() to free the
 // returned pointer to avoid memory leak.
@@ -1701,6 +1856,56 @@ SherpaOnnxOfflineSpeechDenoiserRun(const SherpaOnnxOfflineSpeechDenoiser *sd,
 SHERPA_ONNX_API void SherpaOnnxDestroyDenoisedAudio(
     const SherpaOnnxDenoisedAudio *p);
 
+// ============================================================
+// For the onnxruntime environment shared by all models
+// ============================================================
+SHERPA_ONNX_API typedef struct SherpaOnnxOrtEnvConfig {
+  // 1 to let all models share one intra-op and one inter-op thread pool.
+  // num_threads of each model config is then ignored.
+  int32_t use_global_thread_pool;
+
+  // Size of the global intra-op thread pool. 0 means the number of
+  // physical cores.
+  int32_t intra_op_num_threads;
+
+  // Size of the global inter-op thread pool. 0 means to let onnxruntime
+  // decide.
+  int32_t inter_op_num_threads;
+
+  // 1 to let idle threads of the global thread pools spin waiting for work
+  int32_t allow_spinning;
+
+  // 1 to let sessions share prepacked weights, so that loading the same
+  // model again in this process does not duplicate them
+  int32_t share_prepacked_weights;
+
+  // If not NULL or empty, models running on the CPU are saved to this
+  // directory after graph optimization so that later runs skip it
+  const char *optimized_model_cache_dir;
+
+  // If not NULL or empty, pin the intra-op threads to these logical
+  // processors, e.g., "1,2;3-4;5" for 4 threads. See
+  // --ort-intra-op-thread-affinities of ./bin/sherpa-onnx-offline
+  const char *intra_op_thread_affinities;
+
+  // If not NULL or empty, each onnxruntime session writes a profile with
+  // the time of each node to <profiling_prefix>-<n>_<timestamp>.json
+  const char *profiling_prefix;
+} SherpaOnnxOrtEnvConfig;
+
+// Set up the onnxruntime environment shared by all models.
+//
+// It must be called before creating any recognizer, VAD, TTS, etc.
+// Return 1 on success. Return 0 if the config is invalid or a model
+// has already been created.
+SHERPA_ONNX_API int32_t
+SherpaOnnxInitOrtEnv(const SherpaOnnxOrtEnvConfig *config);
+
+// Free the pointer returned by SherpaOnnxOnlineRecognizerGetStatsAsJson(),
+// SherpaOnnxOfflineRecognizerGetStatsAsJson() and
+// SherpaOnnxOfflineTtsGetStatsAsJson()
+SHERPA_ONNX_API void SherpaOnnxFreeStatsJson(const char *s);
+
 #ifdef __OHOS__
 
 // It is for HarmonyOS
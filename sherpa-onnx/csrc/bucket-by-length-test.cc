@@ -0,0 +1,49 @@
+// sherpa-onnx/csrc/bucket-by-length-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/bucket-by-length.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(BucketByLength, Basic) {
+  std::vector<int32_t> lengths = {200, 6000, 300, 250, 180, 5800};
+
+  auto batches = BucketByLength(lengths, 1000);
+
+  // 6000 and 5800 exceed the budget and get their own batches
+  std::vector<std::vector<int32_t>> expected = {{1}, {5}, {2, 3, 0}, {4}};
+  EXPECT_EQ(batches, expected);
+
+  batches = BucketByLength(lengths, 20000, 2);
+  expected = {{1, 5}, {2, 3}, {0, 4}};
+  EXPECT_EQ(batches, expected);
+}
+
+TEST(BucketByLength, NoLimit) {
+  std::vector<int32_t> lengths = {3, 1, 2};
+
+  auto batches = BucketByLength(lengths, 0);
+
+  std::vector<std::vector<int32_t>> expected = {{0, 2, 1}};
+  EXPECT_EQ(batches, expected);
+
+  EXPECT_TRUE(BucketByLength({}, 100).empty());
+}
+
+TEST(GroupByLength, Basic) {
+  std::vector<int32_t> lengths = {200, 300, 200, 100, 300, 200};
+
+  auto groups = GroupByLength(lengths);
+
+  std::vector<std::vector<int32_t>> expected = {{0, 2, 5}, {1, 4}, {3}};
+  EXPECT_EQ(groups, expected);
+
+  EXPECT_TRUE(GroupByLength({}).empty());
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,69 @@
+// sherpa-onnx/csrc/bucket-by-length.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/bucket-by-length.h"
+
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+namespace sherpa_onnx {
+
+std::vector<std::vector<int32_t>> BucketByLength(
+    const std::vector<int32_t> &lengths, int32_t max_padded_frames,
+    int32_t max_batch_size /*= 0*/) {
+  std::vector<int32_t> indexes(lengths.size());
+  std::iota(indexes.begin(), indexes.end(), 0);
+
+  // Keep the input order for utterances of the same length
+  std::stable_sort(indexes.begin(), indexes.end(),
+                   [&lengths](int32_t a, int32_t b) {
+                     return lengths[a] > lengths[b];
+                   });
+
+  std::vector<std::vector<int32_t>> ans;
+  for (auto i : indexes) {
+    if (!ans.empty()) {
+      auto &batch = ans.back();
+
+      // Since lengths are in descending order, the first one is the
+      // longest in the batch
+      int64_t padded_size =
+          static_cast<int64_t>(batch.size() + 1) * lengths[batch[0]];
+
+      bool fits = max_padded_frames <= 0 || padded_size <= max_padded_frames;
+      if (fits && (max_batch_size <= 0 ||
+                   static_cast<int32_t>(batch.size()) < max_batch_size)) {
+        batch.push_back(i);
+        continue;
+      }
+    }
+
+    ans.push_back({i});
+  }
+
+  return ans;
+}
+
+std::vector<std::vector<int32_t>> GroupByLength(
+    const std::vector<int32_t> &lengths) {
+  // length -> index of its group in ans
+  std::unordered_map<int32_t, int32_t> group;
+
+  std::vector<std::vector<int32_t>> ans;
+  for (int32_t i = 0; i != static_cast<int32_t>(lengths.size()); ++i) {
+    auto it = group.find(lengths[i]);
+    if (it == group.end()) {
+      group[lengths[i]] = static_cast<int32_t>(ans.size());
+      ans.push_back({i});
+    } else {
+      ans[it->second].push_back(i);
+    }
+  }
+
+  return ans;
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,49 @@
+// sherpa-onnx/csrc/bucket-by-length.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_BUCKET_BY_LENGTH_H_
+#define SHERPA_ONNX_CSRC_BUCKET_BY_LENGTH_H_
+
+#include <cstdint>
+#include <vector>
+
+namespace sherpa_onnx {
+
+/** Split utterances into batches of similar lengths so that little
+ * computation is wasted on padding.
+ *
+ * Utterances are sorted by length in descending order and batches are
+ * filled as long as the padded size, i.e., the number of utterances times
+ * the longest length in the batch, does not exceed max_padded_frames.
+ * An utterance longer than max_padded_frames forms a batch of its own.
+ *
+ * @param lengths lengths[i] is the number of frames of utterance i.
+ * @param max_padded_frames Upper bound of the padded size of a batch.
+ *                          If it is not positive, there is no bound.
+ * @param max_batch_size If positive, upper bound of the batch size.
+ *
+ * @return Return the indexes into lengths of each batch. Batches with
+ *         longer utterances come first.
+ */
+std::vector<std::vector<int32_t>> BucketByLength(
+    const std::vector<int32_t> &lengths, int32_t max_padded_frames,
+    int32_t max_batch_size = 0);
+
+/** Group utterances of exactly the same length.
+ *
+ * It is for models that cannot mask padding, e.g., decoders without a
+ * cross-attention mask. Padding would change the results of the shorter
+ * utterances in a batch, so only utterances without padding are batched.
+ *
+ * @param lengths lengths[i] is the number of frames of utterance i.
+ *
+ * @return Return the indexes into lengths of each group. Groups are in the
+ *         order of their first utterance in lengths and indexes within a
+ *         group are in increasing order.
+ */
+std::vector<std::vector<int32_t>> GroupByLength(
+    const std::vector<int32_t> &lengths);
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_BUCKET_BY_LENGTH_H_
@@ -0,0 +1,39 @@
+// sherpa-onnx/csrc/cpu-affinity-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/cpu-affinity.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(ParseCpuList, Basic) {
+  std::vector<int32_t> cpus;
+
+  EXPECT_TRUE(ParseCpuList("", &cpus));
+  EXPECT_TRUE(cpus.empty());
+
+  EXPECT_TRUE(ParseCpuList("3", &cpus));
+  EXPECT_EQ(cpus, (std::vector<int32_t>{3}));
+
+  EXPECT_TRUE(ParseCpuList("0-3,8,10-11", &cpus));
+  EXPECT_EQ(cpus, (std::vector<int32_t>{0, 1, 2, 3, 8, 10, 11}));
+
+  // /sys/devices/system/node/nodeN/cpulist ends with a newline
+  EXPECT_TRUE(ParseCpuList("4-5\n", &cpus));
+  EXPECT_EQ(cpus, (std::vector<int32_t>{4, 5}));
+}
+
+TEST(ParseCpuList, Invalid) {
+  std::vector<int32_t> cpus;
+
+  EXPECT_FALSE(ParseCpuList("a", &cpus));
+  EXPECT_FALSE(ParseCpuList("3-1", &cpus));
+  EXPECT_FALSE(ParseCpuList("-1", &cpus));
+  EXPECT_FALSE(ParseCpuList("1-", &cpus));
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,118 @@
+// sherpa-onnx/csrc/cpu-affinity.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/cpu-affinity.h"
+
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/text-utils.h"
+
+namespace sherpa_onnx {
+
+bool ParseCpuList(const std::string &s, std::vector<int32_t> *cpus) {
+  cpus->clear();
+
+  std::vector<std::string> ranges;
+  SplitStringToVector(s, ",", true, &ranges);
+
+  for (const auto &r : ranges) {
+    auto pos = r.find('-');
+    int32_t first = 0;
+    int32_t last = 0;
+    if (pos == std::string::npos) {
+      if (!ConvertStringToInteger(r, &first)) {
+        return false;
+      }
+      last = first;
+    } else if (!ConvertStringToInteger(r.substr(0, pos), &first) ||
+               !ConvertStringToInteger(r.substr(pos + 1), &last)) {
+      return false;
+    }
+
+    if (first < 0 || last < first) {
+      return false;
+    }
+
+    for (int32_t i = first; i <= last; ++i) {
+      cpus->push_back(i);
+    }
+  }
+
+  return true;
+}
+
+bool SetCurrentThreadAffinity(const std::vector<int32_t> &cpus) {
+  if (cpus.empty()) {
+    return true;
+  }
+
+#if defined(__linux__) && !defined(__ANDROID__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (auto c : cpus) {
+    if (c >= CPU_SETSIZE) {
+      SHERPA_ONNX_LOGE("CPU %d is out of range. Max: %d", c, CPU_SETSIZE - 1);
+      return false;
+    }
+    CPU_SET(c, &set);
+  }
+
+  int ret = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  if (ret != 0) {
+    SHERPA_ONNX_LOGE("Failed to set CPU affinity. Error code: %d", ret);
+    return false;
+  }
+
+  return true;
+#else
+  SHERPA_ONNX_LOGE("Setting CPU affinity is supported only on Linux");
+  return false;
+#endif
+}
+
+std::vector<std::vector<int32_t>> GetNumaNodeCpus() {
+  std::vector<std::vector<int32_t>> ans;
+
+#if defined(__linux__) && !defined(__ANDROID__)
+  // Node ids are usually contiguous, but not necessarily, so we stop
+  // only after a few missing ones
+  int32_t num_missing = 0;
+  for (int32_t i = 0; num_missing < 8; ++i) {
+    std::ifstream is("/sys/devices/system/node/node" + std::to_string(i) +
+                     "/cpulist");
+    if (!is) {
+      ++num_missing;
+      continue;
+    }
+    num_missing = 0;
+
+    std::string line;
+    std::getline(is, line);
+
+    std::vector<int32_t> cpus;
+    if (!ParseCpuList(line, &cpus)) {
+      SHERPA_ONNX_LOGE("Failed to parse the CPUs of NUMA node %d: '%s'", i,
+                       line.c_str());
+      return {};
+    }
+
+    if (!cpus.empty()) {
+      ans.push_back(std::move(cpus));
+    }
+  }
+#endif
+
+  return ans;
+}
+
+}  // namespace sherpa_onnx
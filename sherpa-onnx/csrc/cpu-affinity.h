@@ -0,0 +1,41 @@
+// sherpa-onnx/csrc/cpu-affinity.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_CPU_AFFINITY_H_
+#define SHERPA_ONNX_CSRC_CPU_AFFINITY_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sherpa_onnx {
+
+/** Parse a list of CPUs in the format of taskset -c and
+ * /sys/devices/system/node/nodeN/cpulist, e.g., "0-3,8,10-11".
+ *
+ * @param s The string to parse. An empty string gives an empty list.
+ * @param cpus On success, it contains the CPUs in the order they are given.
+ * @return Return false if s is malformed.
+ */
+bool ParseCpuList(const std::string &s, std::vector<int32_t> *cpus);
+
+/** Restrict the calling thread to run only on the given CPUs.
+ *
+ * It is supported only on Linux. On other platforms, it prints a warning
+ * and returns false.
+ *
+ * @return Return true on success.
+ */
+bool SetCurrentThreadAffinity(const std::vector<int32_t> &cpus);
+
+/** Return the CPUs of each NUMA node, indexed by node.
+ *
+ * Nodes without CPUs, e.g., memory-only nodes, are skipped. If the NUMA
+ * topology is not available, e.g., on platforms other than Linux, it returns
+ * an empty vector.
+ */
+std::vector<std::vector<int32_t>> GetNumaNodeCpus();
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_CPU_AFFINITY_H_
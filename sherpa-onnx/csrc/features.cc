@@ -151,7 +151,7 @@ class FeatureExtractor::Impl {
     return fbank_->IsLastFrame(frame);
   }
 
-  std::vector<float> GetFrames(int32_t frame_index, int32_t n) {
+  void GetFrames(int32_t frame_index, int32_t n, float *out) {
     std::lock_guard<std::mutex> lock(mutex_);
     if (frame_index + n > fbank_->NumFramesReady()) {
       SHERPA_ONNX_LOGE("%d + %d > %d\n", frame_index, n,
@@ -159,28 +159,33 @@ class FeatureExtractor::Impl {
       exit(-1);
     }
 
-    int32_t discard_num = frame_index - last_frame_index_;
+    int32_t discard_num = frame_index - num_popped_frames_;
     if (discard_num < 0) {
-      SHERPA_ONNX_LOGE("last_frame_index_: %d, frame_index_: %d",
-                       last_frame_index_, frame_index);
+      SHERPA_ONNX_LOGE("num_popped_frames_: %d, frame_index_: %d",
+                       num_popped_frames_, frame_index);
       exit(-1);
     }
-    fbank_->Pop(discard_num);
+    // Frames before frame_index are never used again. Note that popping
+    // frames does not change the index of the remaining frames.
+    PopImpl(discard_num);
 
     int32_t feature_dim = fbank_->Dim();
-    std::vector<float> features(feature_dim * n);
-
-    float *p = features.data();
 
     for (int32_t i = 0; i != n; ++i) {
       const float *f = fbank_->GetFrame(i + frame_index);
-      std::copy(f, f + feature_dim, p);
-      p += feature_dim;
+      std::copy(f, f + feature_dim, out);
+      out += feature_dim;
     }
+  }
 
-    last_frame_index_ = frame_index;
+  void Pop(int32_t n) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PopImpl(n);
+  }
 
-    return features;
+  int32_t NumFramesPopped() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_popped_frames_;
   }
 
   int32_t FeatureDim() const {
@@ -188,6 +193,17 @@ class FeatureExtractor::Impl {
   }
 
  private:
+  // The caller must hold mutex_
+  void PopImpl(int32_t n) {
+    n = std::min(n, fbank_->NumFramesReady() - num_popped_frames_);
+    if (n <= 0) {
+      return;
+    }
+
+    fbank_->Pop(n);
+    num_popped_frames_ += n;
+  }
+
   void InitFbank() {
     opts_.frame_opts.dither = config_.dither;
     opts_.frame_opts.snip_edges = config_.snip_edges;
@@ -238,7 +254,9 @@ class FeatureExtractor::Impl {
   FeatureExtractorConfig config_;
   mutable std::mutex mutex_;
   std::unique_ptr<LinearResample> resampler_;
-  int32_t last_frame_index_ = 0;
+
+  // Frames with index less than this value have been freed
+  int32_t num_popped_frames_ = 0;
 };
 
 FeatureExtractor::FeatureExtractor(const FeatureExtractorConfig &config /*={}*/)
@@ -263,7 +281,20 @@ bool FeatureExtractor::IsLastFrame(int32_t frame) const {
 
 std::vector<float> FeatureExtractor::GetFrames(int32_t frame_index,
                                                int32_t n) const {
-  return impl_->GetFrames(frame_index, n);
+  std::vector<float> features(n * FeatureDim());
+  impl_->GetFrames(frame_index, n, features.data());
+  return features;
+}
+
+void FeatureExtractor::GetFrames(int32_t frame_index, int32_t n,
+                                 float *out) const {
+  impl_->GetFrames(frame_index, n, out);
+}
+
+void FeatureExtractor::Pop(int32_t n) const { impl_->Pop(n); }
+
+int32_t FeatureExtractor::NumFramesPopped() const {
+  return impl_->NumFramesPopped();
 }
 
 int32_t FeatureExtractor::FeatureDim() const { return impl_->FeatureDim(); }
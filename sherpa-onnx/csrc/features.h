@@ -124,6 +124,31 @@ class FeatureExtractor {
    */
   std::vector<float> GetFrames(int32_t frame_index, int32_t n) const;
 
+  /** Same as the above one, but it writes the frames to the given address.
+   *
+   * It is useful to fill a slice of a preallocated batch tensor directly.
+   *
+   * Frames before frame_index are freed, so frame_index must not decrease
+   * between calls. Frame indexes are not changed by freeing frames.
+   *
+   * @param frame_index  The starting frame index
+   * @param n  Number of frames to get.
+   * @param out  Pointer to an array of n * FeatureDim() floats.
+   */
+  void GetFrames(int32_t frame_index, int32_t n, float *out) const;
+
+  /** Free the n oldest frames that have not been freed yet.
+   *
+   * It does not change the index of the remaining frames, so
+   * NumFramesReady() is not changed either. It is a no-op for frames
+   * that have not been computed yet.
+   */
+  void Pop(int32_t n) const;
+
+  /// Number of frames freed so far. It is also the index of the
+  /// oldest frame that can still be accessed.
+  int32_t NumFramesPopped() const;
+
   /// Return feature dim of this extractor
   int32_t FeatureDim() const;
 
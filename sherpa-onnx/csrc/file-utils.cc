@@ -5,9 +5,20 @@
 #include "sherpa-onnx/csrc/file-utils.h"
 
 #include <fstream>
+#include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include "sherpa-onnx/csrc/macros.h"
 
@@ -30,6 +41,103 @@ std::vector<char> ReadFile(const std::string &filename) {
   return buffer;
 }
 
+struct MappedFile::Impl {
+  const char *data = nullptr;
+  size_t size = 0;
+
+#if defined(_WIN32)
+  std::vector<char> buffer;
+#else
+  // Used to detect that the file has been replaced
+  dev_t dev = 0;
+  ino_t ino = 0;
+  off_t file_size = 0;
+  time_t mtime = 0;
+
+  ~Impl() {
+    if (data) {
+      munmap(const_cast<char *>(data), size);
+    }
+  }
+#endif
+};
+
+const char *MappedFile::data() const { return impl_ ? impl_->data : nullptr; }
+
+size_t MappedFile::size() const { return impl_ ? impl_->size : 0; }
+
+#if defined(_WIN32)
+MappedFile MapFile(const std::string &filename) {
+  auto impl = std::make_shared<MappedFile::Impl>();
+  impl->buffer = ReadFile(filename);
+  impl->data = impl->buffer.data();
+  impl->size = impl->buffer.size();
+
+  MappedFile ans;
+  ans.impl_ = std::move(impl);
+  return ans;
+}
+#else
+MappedFile MapFile(const std::string &filename) {
+  static std::mutex mutex;
+  static std::map<std::string, std::weak_ptr<const MappedFile::Impl>> cache;
+
+  MappedFile ans;
+
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd == -1) {
+    SHERPA_ONNX_LOGE("Failed to open '%s'", filename.c_str());
+    return ans;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) == -1) {
+    SHERPA_ONNX_LOGE("Failed to stat '%s'", filename.c_str());
+    close(fd);
+    return ans;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  auto it = cache.find(filename);
+  if (it != cache.end()) {
+    auto impl = it->second.lock();
+    if (impl && impl->dev == st.st_dev && impl->ino == st.st_ino &&
+        impl->file_size == st.st_size && impl->mtime == st.st_mtime) {
+      close(fd);
+      ans.impl_ = std::move(impl);
+      return ans;
+    }
+  }
+
+  auto impl = std::make_shared<MappedFile::Impl>();
+  impl->dev = st.st_dev;
+  impl->ino = st.st_ino;
+  impl->file_size = st.st_size;
+  impl->mtime = st.st_mtime;
+
+  if (st.st_size > 0) {
+    void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+      SHERPA_ONNX_LOGE("Failed to map '%s'", filename.c_str());
+      close(fd);
+      return ans;
+    }
+
+    impl->data = static_cast<const char *>(p);
+    impl->size = st.st_size;
+  }
+
+  // The mapping stays valid after closing the file
+  close(fd);
+
+  cache[filename] = impl;
+  ans.impl_ = std::move(impl);
+
+  return ans;
+}
+#endif
+
 #if __ANDROID_API__ >= 9
 std::vector<char> ReadFile(AAssetManager *mgr, const std::string &filename) {
   AAsset *asset = AAssetManager_open(mgr, filename.c_str(), AASSET_MODE_BUFFER);
@@ -5,7 +5,9 @@
 #ifndef SHERPA_ONNX_CSRC_FILE_UTILS_H_
 #define SHERPA_ONNX_CSRC_FILE_UTILS_H_
 
+#include <cstddef>
 #include <fstream>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -35,6 +37,40 @@ void AssertFileExists(const std::string &filename);
 
 std::vector<char> ReadFile(const std::string &filename);
 
+/** Read-only contents of a file, e.g., an onnx model.
+ *
+ * On Linux and macOS, the file is memory-mapped instead of being copied to
+ * the heap. Within a process, MapFile() calls for the same file share one
+ * mapping while any of them is alive.
+ *
+ * Note that onnxruntime copies the initializers of a model while creating
+ * a session, so the mapping is needed only during that call.
+ *
+ * It is cheap to copy. The file stays mapped until the last copy is
+ * destroyed.
+ */
+class MappedFile {
+ public:
+  MappedFile() = default;
+
+  const char *data() const;
+  size_t size() const;
+  bool empty() const { return size() == 0; }
+
+ private:
+  friend MappedFile MapFile(const std::string &filename);
+
+  struct Impl;
+
+  std::shared_ptr<const Impl> impl_;
+};
+
+/** Map a file into memory. On Windows, the file is read into memory.
+ *
+ * If the file cannot be opened, an empty MappedFile is returned.
+ */
+MappedFile MapFile(const std::string &filename);
+
 #if __ANDROID_API__ >= 9
 std::vector<char> ReadFile(AAssetManager *mgr, const std::string &filename);
 #endif
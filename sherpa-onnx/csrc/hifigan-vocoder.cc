@@ -20,6 +20,7 @@
 #include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
+#include "sherpa-onnx/csrc/ort-env.h"
 #include "sherpa-onnx/csrc/session.h"
 
 namespace sherpa_onnx {
@@ -28,17 +29,17 @@ class HifiganVocoder::Impl {
  public:
   explicit Impl(int32_t num_threads, const std::string &provider,
                 const std::string &model)
-      : env_(ORT_LOGGING_LEVEL_ERROR),
+      : env_(GetOrtEnv()),
         sess_opts_(GetSessionOptions(num_threads, provider)),
         allocator_{} {
-    auto buf = ReadFile(model);
+    auto buf = MapFile(model);
     Init(buf.data(), buf.size());
   }
 
   template <typename Manager>
   explicit Impl(Manager *mgr, int32_t num_threads, const std::string &provider,
                 const std::string &model)
-      : env_(ORT_LOGGING_LEVEL_ERROR),
+      : env_(GetOrtEnv()),
         sess_opts_(GetSessionOptions(num_threads, provider)),
         allocator_{} {
     auto buf = ReadFile(mgr, model);
@@ -63,9 +64,8 @@ class HifiganVocoder::Impl {
   }
 
  private:
-  void Init(void *model_data, size_t model_data_length) {
-    sess_ = std::make_unique<Ort::Session>(env_, model_data, model_data_length,
-                                           sess_opts_);
+  void Init(const void *model_data, size_t model_data_length) {
+    sess_ = CreateSession(env_, model_data, model_data_length, sess_opts_);
 
     GetInputNames(sess_.get(), &input_names_, &input_names_ptr_);
 
@@ -73,7 +73,7 @@ class HifiganVocoder::Impl {
   }
 
  private:
-  Ort::Env env_;
+  Ort::Env &env_;
   Ort::SessionOptions sess_opts_;
   Ort::AllocatorWithDefaultOptions allocator_;
 
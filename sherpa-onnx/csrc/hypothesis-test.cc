@@ -0,0 +1,113 @@
+// sherpa-onnx/csrc/hypothesis-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/hypothesis.h"
+
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(Hypothesis, AddToken) {
+  Hypothesis a({-1, 0}, 0);
+  a.AddToken(3, 1)->SetYsProb(-0.5);
+  a.AddToken(5, 4)->SetYsProb(-0.25);
+
+  Hypothesis b({-1, 0, 3, 5}, 0);
+  EXPECT_EQ(a.Ys(), b.Ys());
+  EXPECT_EQ(a.Key(), b.Key());
+  EXPECT_TRUE(a.SameTokens(b));
+
+  EXPECT_EQ(a.NumTokens(), 4);
+  EXPECT_EQ(a.LastToken(), 5);
+  EXPECT_EQ(a.Timestamps(), std::vector<int32_t>({1, 4}));
+  EXPECT_EQ(a.YsProbs(), std::vector<float>({-0.5, -0.25}));
+  EXPECT_TRUE(a.LmProbs().empty());
+  EXPECT_TRUE(b.Timestamps().empty());
+
+  std::vector<int64_t> tokens(2);
+  a.GetTokens(1, 3, tokens.data());
+  EXPECT_EQ(tokens, std::vector<int64_t>({0, 3}));
+
+  Hypothesis c({-1, 0, 5, 3}, 0);
+  EXPECT_NE(a.Key(), c.Key());
+  EXPECT_FALSE(a.SameTokens(c));
+
+  a.SetTokens({-1, 0, 5, 3});
+  EXPECT_EQ(a.Key(), c.Key());
+}
+
+TEST(Hypothesis, SharedHistory) {
+  Hypothesis a({-1, 0}, 0);
+  a.AddToken(3, 0);
+
+  Hypothesis b = a;
+  EXPECT_EQ(a.tail, b.tail);
+
+  a.AddToken(4, 1);
+  b.AddToken(5, 1);
+  EXPECT_EQ(a.tail->parent, b.tail->parent);
+  EXPECT_EQ(a.Ys(), std::vector<int64_t>({-1, 0, 3, 4}));
+  EXPECT_EQ(b.Ys(), std::vector<int64_t>({-1, 0, 3, 5}));
+
+  // Reach the same token sequence through different paths
+  Hypothesis c({-1, 0}, 0);
+  c.AddToken(3, 0);
+  c.AddToken(4, 2);
+  EXPECT_NE(a.tail, c.tail);
+  EXPECT_TRUE(a.SameTokens(c));
+}
+
+TEST(Hypothesis, LongHistory) {
+  // Destroying a long history must not overflow the stack
+  Hypothesis a({-1, 0}, 0);
+  for (int32_t i = 0; i != 1000000; ++i) {
+    a.AddToken(i % 500 + 1, i);
+  }
+  EXPECT_EQ(a.NumTokens(), 1000002);
+}
+
+TEST(Hypotheses, MergeSameTokens) {
+  Hypotheses hyps;
+  hyps.Add({{-1, 0, 3}, -1.0});
+  hyps.Add({{-1, 0, 4}, -2.0});
+  hyps.Add({{-1, 0, 3}, -1.0});
+
+  EXPECT_EQ(hyps.Size(), 2);
+
+  auto best = hyps.GetMostProbable(false);
+  EXPECT_EQ(best.Ys(), std::vector<int64_t>({-1, 0, 3}));
+  EXPECT_NEAR(best.log_prob, -1.0 + std::log(2.0), 1e-6);
+}
+
+TEST(Hypotheses, HashCollision) {
+  Hypothesis a({-1, 0, 3}, -1.0);
+  Hypothesis b({-1, 0, 4}, -2.0);
+  Hypothesis c({-1, 0, 4}, -2.0);
+
+  // Simulate a hash collision
+  b.tail->hash = a.tail->hash;
+  c.tail->hash = a.tail->hash;
+
+  Hypotheses hyps;
+  hyps.Add(a);
+  hyps.Add(b);
+  EXPECT_EQ(hyps.Size(), 2);
+
+  hyps.Add(c);
+  EXPECT_EQ(hyps.Size(), 2);
+
+  for (const auto &p : hyps) {
+    if (p.second.SameTokens(a)) {
+      EXPECT_EQ(p.second.log_prob, a.log_prob);
+    } else {
+      EXPECT_TRUE(p.second.SameTokens(b));
+      EXPECT_NEAR(p.second.log_prob, -2.0 + std::log(2.0), 1e-6);
+    }
+  }
+}
+
+}  // namespace sherpa_onnx
@@ -10,11 +10,121 @@
 
 namespace sherpa_onnx {
 
+HypothesisNode::HypothesisNode(std::shared_ptr<HypothesisNode> parent,
+                               int64_t token, int32_t timestamp)
+    : parent(std::move(parent)), token(token), timestamp(timestamp) {
+  if (this->parent) {
+    num_tokens = this->parent->num_tokens + 1;
+    hash = UpdateTokenSeqHash(this->parent->hash, token);
+  } else {
+    num_tokens = 1;
+    hash = UpdateTokenSeqHash(kEmptyTokenSeqHash, token);
+  }
+}
+
+HypothesisNode::~HypothesisNode() {
+  // Release the chain of parents in a loop. Releasing it recursively
+  // may overflow the stack for long streams with many decoded tokens.
+  std::shared_ptr<HypothesisNode> p = std::move(parent);
+  while (p && p.use_count() == 1) {
+    p = std::move(p->parent);
+  }
+}
+
+void Hypothesis::GetTokens(int32_t start, int32_t end, int64_t *dst) const {
+  const HypothesisNode *node = tail.get();
+  int32_t i = NumTokens();
+  for (; i > end; --i) {
+    node = node->parent.get();
+  }
+
+  for (; i > start; --i) {
+    dst[i - 1 - start] = node->token;
+    node = node->parent.get();
+  }
+}
+
+std::vector<int64_t> Hypothesis::Ys() const {
+  std::vector<int64_t> ans(NumTokens());
+  GetTokens(0, NumTokens(), ans.data());
+  return ans;
+}
+
+std::vector<int32_t> Hypothesis::Timestamps() const {
+  std::vector<int32_t> ans;
+  for (const auto *node = tail.get(); node; node = node->parent.get()) {
+    if (node->timestamp >= 0) {
+      ans.push_back(node->timestamp);
+    }
+  }
+  std::reverse(ans.begin(), ans.end());
+  return ans;
+}
+
+std::vector<float> Hypothesis::YsProbs() const {
+  std::vector<float> ans;
+  for (const auto *node = tail.get(); node; node = node->parent.get()) {
+    if (node->has_ys_prob) {
+      ans.push_back(node->ys_prob);
+    }
+  }
+  std::reverse(ans.begin(), ans.end());
+  return ans;
+}
+
+std::vector<float> Hypothesis::LmProbs() const {
+  std::vector<float> ans;
+  for (const auto *node = tail.get(); node; node = node->parent.get()) {
+    if (node->has_lm_prob) {
+      ans.push_back(node->lm_prob);
+    }
+  }
+  std::reverse(ans.begin(), ans.end());
+  return ans;
+}
+
+std::vector<float> Hypothesis::ContextScores() const {
+  std::vector<float> ans;
+  for (const auto *node = tail.get(); node; node = node->parent.get()) {
+    if (node->has_context_score) {
+      ans.push_back(node->context_score);
+    }
+  }
+  std::reverse(ans.begin(), ans.end());
+  return ans;
+}
+
+bool Hypothesis::SameTokens(const Hypothesis &other) const {
+  if (NumTokens() != other.NumTokens()) {
+    return false;
+  }
+
+  // Sequences that differ usually differ in their last few tokens, so we
+  // compare them from the back. We can stop once the two histories meet
+  // at a shared node.
+  const HypothesisNode *a = tail.get();
+  const HypothesisNode *b = other.tail.get();
+  while (a != b) {
+    if (a->token != b->token) {
+      return false;
+    }
+    a = a->parent.get();
+    b = b->parent.get();
+  }
+
+  return true;
+}
+
 void Hypotheses::Add(Hypothesis hyp) {
-  auto key = hyp.Key();
+  uint64_t key = hyp.Key();
   auto it = hyps_dict_.find(key);
+  while (it != hyps_dict_.end() && !it->second.SameTokens(hyp)) {
+    // hash collision. Try the next key.
+    it = hyps_dict_.find(++key);
+  }
+
   if (it == hyps_dict_.end()) {
-    hyps_dict_[key] = std::move(hyp);
+    hyps_dict_.emplace(key, std::move(hyp));
   } else {
     it->second.log_prob = LogAdd<double>()(it->second.log_prob, hyp.log_prob);
   }
@@ -33,8 +143,8 @@ Hypothesis Hypotheses::GetMostProbable(bool length_norm) const {
     return std::max_element(
                hyps_dict_.begin(), hyps_dict_.end(),
                [](const auto &left, const auto &right) -> bool {
-                 return left.second.TotalLogProb() / left.second.ys.size() <
-                        right.second.TotalLogProb() / right.second.ys.size();
+                 return left.second.TotalLogProb() / left.second.NumTokens() <
+                        right.second.TotalLogProb() / right.second.NumTokens();
                })
         ->second;
   }
@@ -55,8 +165,8 @@ std::vector<Hypothesis> Hypotheses::GetTopK(int32_t k, bool length_norm) const {
     // for length_norm is true
     std::partial_sort(all_hyps.begin(), all_hyps.begin() + k, all_hyps.end(),
                       [](const auto &a, const auto &b) {
-                        return a.TotalLogProb() / a.ys.size() >
-                               b.TotalLogProb() / b.ys.size();
+                        return a.TotalLogProb() / a.NumTokens() >
+                               b.TotalLogProb() / b.NumTokens();
                       });
   }
 
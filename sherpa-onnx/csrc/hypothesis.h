@@ -7,6 +7,8 @@
 #ifndef SHERPA_ONNX_CSRC_HYPOTHESIS_H_
 #define SHERPA_ONNX_CSRC_HYPOTHESIS_H_
 
+#include <cstdint>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <unordered_map>
@@ -20,29 +22,97 @@
 
 namespace sherpa_onnx {
 
-struct Hypothesis {
-  // The predicted tokens so far. Newly predicated tokens are appended.
-  std::vector<int64_t> ys;
-
-  // timestamps[i] contains the frame number after subsampling
-  // on which ys[i] is decoded.
-  std::vector<int32_t> timestamps;
+// Hash of an empty token sequence. See UpdateTokenSeqHash() below.
+constexpr uint64_t kEmptyTokenSeqHash = 0xcbf29ce484222325ull;
+
+// Return the hash of the token sequence {ys..., token}, given the hash h of
+// {ys...}. It allows us to maintain the hash of a growing sequence in O(1)
+// per token.
+inline uint64_t UpdateTokenSeqHash(uint64_t h, int64_t token) {
+  h ^= static_cast<uint64_t>(token) + 0x9e3779b97f4a7c15ull;
+  h *= 0xbf58476d1ce4e5b9ull;
+  return h ^ (h >> 31);
+}
+
+// A node in a prefix tree of decoded tokens. Each node has a pointer to its
+// parent, i.e., the node of the previous token. Hypotheses that share a
+// prefix share the nodes of that prefix, so copying a hypothesis costs
+// O(1) no matter how many tokens it contains.
+//
+// A node must not be changed once it is shared by more than one hypothesis.
+struct HypothesisNode {
+  // Node of the previous token. nullptr for the first token.
+  std::shared_ptr<HypothesisNode> parent;
+
+  int64_t token = 0;
+
+  // Number of tokens from the first token up to this node, inclusive
+  int32_t num_tokens = 0;
+
+  // Hash of the tokens from the first token up to this node.
+  // See UpdateTokenSeqHash()
+  uint64_t hash = kEmptyTokenSeqHash;
+
+  // The frame number after subsampling on which the token is decoded.
+  // It is -1 for tokens that are not decoded, e.g., the leading blanks.
+  int32_t timestamp = -1;
+
+  // Per-token scores. Each one is valid only if the corresponding
+  // has_xxx is true.
+  float ys_prob = 0;
+  float lm_prob = 0;
+  float context_score = 0;
+
+  bool has_ys_prob = false;
+  bool has_lm_prob = false;
+  bool has_context_score = false;
+
+  HypothesisNode(std::shared_ptr<HypothesisNode> parent, int64_t token,
+                 int32_t timestamp);
+
+  ~HypothesisNode();
+
+  void SetYsProb(float p) {
+    ys_prob = p;
+    has_ys_prob = true;
+  }
 
-  // The acoustic probability for each token in ys.
-  // Used for keyword spotting task.
-  // For transducer mofified beam-search and greedy-search,
-  // this is filled with log_posterior scores.
-  std::vector<float> ys_probs;
+  void SetLmProb(float p) {
+    lm_prob = p;
+    has_lm_prob = true;
+  }
 
-  // lm_probs[i] contains the lm score for each token in ys.
-  // Used only in transducer mofified beam-search.
-  // Elements filled only if LM is used.
-  std::vector<float> lm_probs;
+  void SetContextScore(float s) {
+    context_score = s;
+    has_context_score = true;
+  }
+};
 
-  // context_scores[i] contains the context-graph score for each token in ys.
-  // Used only in transducer mofified beam-search.
-  // Elements filled only if `ContextGraph` is used.
-  std::vector<float> context_scores;
+struct Hypothesis {
+  // The last node of the predicted tokens so far. Newly predicted tokens
+  // are appended with AddToken().
+  //
+  // Use Ys(), Timestamps(), YsProbs(), LmProbs() and ContextScores()
+  // to get the token history as flat vectors:
+  //
+  //  - Ys(): The predicted tokens so far.
+  //
+  //  - Timestamps(): timestamps[i] contains the frame number after
+  //    subsampling on which the i-th decoded token is decoded.
+  //
+  //  - YsProbs(): The acoustic probability for each decoded token.
+  //    Used for keyword spotting task.
+  //    For transducer mofified beam-search and greedy-search,
+  //    this is filled with log_posterior scores.
+  //
+  //  - LmProbs(): the lm score for each decoded token.
+  //    Used only in transducer mofified beam-search.
+  //    Elements filled only if LM is used.
+  //
+  //  - ContextScores(): the context-graph score for each decoded token.
+  //    Used only in transducer mofified beam-search.
+  //    Elements filled only if `ContextGraph` is used.
+  std::shared_ptr<HypothesisNode> tail;
 
   // The total score of ys in log space.
   // It contains only acoustic scores
@@ -72,27 +142,63 @@ struct Hypothesis {
   Hypothesis() = default;
   Hypothesis(const std::vector<int64_t> &ys, double log_prob,
              const ContextState *context_state = nullptr)
-      : ys(ys), log_prob(log_prob), context_state(context_state) {}
+      : log_prob(log_prob), context_state(context_state) {
+    SetTokens(ys);
+  }
 
   double TotalLogProb() const { return log_prob + lm_log_prob; }
 
-  // If two Hypotheses have the same `Key`, then they contain
-  // the same token sequence.
-  std::string Key() const {
-    // TODO(fangjun): Use a hash function?
-    std::ostringstream os;
-    std::string sep;
-    for (auto i : ys) {
-      os << sep << i;
-      sep = "-";
+  // Append a decoded token. It returns the node of the new token so that
+  // the caller can fill in the per-token scores.
+  HypothesisNode *AddToken(int64_t token, int32_t timestamp) {
+    tail = std::make_shared<HypothesisNode>(std::move(tail), token, timestamp);
+    return tail.get();
+  }
+
+  // Replace all tokens with the given tokens, which have no timestamps
+  // or scores.
+  void SetTokens(const std::vector<int64_t> &tokens) {
+    tail = nullptr;
+    for (auto t : tokens) {
+      AddToken(t, -1);
     }
-    return os.str();
   }
 
+  // Number of tokens, i.e., Ys().size()
+  int32_t NumTokens() const { return tail ? tail->num_tokens : 0; }
+
+  // Return Ys().back(). Must be called only if NumTokens() > 0.
+  int64_t LastToken() const { return tail->token; }
+
+  // Copy Ys()[start:end] to dst.
+  // It visits only the last NumTokens() - start tokens.
+  void GetTokens(int32_t start, int32_t end, int64_t *dst) const;
+
+  std::vector<int64_t> Ys() const;
+  std::vector<int32_t> Timestamps() const;
+  std::vector<float> YsProbs() const;
+  std::vector<float> LmProbs() const;
+  std::vector<float> ContextScores() const;
+
+  // Return true if this hypothesis and the given one contain the same
+  // token sequence.
+  bool SameTokens(const Hypothesis &other) const;
+
+  // If two Hypotheses contain the same token sequence, then they have
+  // the same `Key`. The converse is not guaranteed, so please also
+  // use SameTokens() when two keys are equal.
+  uint64_t Key() const { return tail ? tail->hash : kEmptyTokenSeqHash; }
+
   // For debugging
   std::string ToString() const {
     std::ostringstream os;
-    os << "(" << Key() << ", " << log_prob << ")";
+    os << "(";
+    std::string sep;
+    for (auto i : Ys()) {
+      os << sep << i;
+      sep = "-";
+    }
+    os << ", " << log_prob << ")";
     return os.str();
   }
 };
@@ -103,15 +209,13 @@ class Hypotheses {
 
   explicit Hypotheses(std::vector<Hypothesis> hyps) {
     for (auto &h : hyps) {
-      hyps_dict_[h.Key()] = std::move(h);
+      Add(std::move(h));
     }
   }
 
-  explicit Hypotheses(std::unordered_map<std::string, Hypothesis> hyps_dict)
-      : hyps_dict_(std::move(hyps_dict)) {}
-
-  // Add hyp to this object. If it already exists, its log_prob
-  // is updated with the given hyp using log-sum-exp.
+  // Add hyp to this object. If a hyp with the same token sequence
+  // already exists, its log_prob is updated with the given hyp
+  // using log-sum-exp.
   void Add(Hypothesis hyp);
 
   // Get the hyp that has the largest log_prob.
@@ -153,7 +257,9 @@ class Hypotheses {
   }
 
  private:
-  using Map = std ::unordered_map<std::string, Hypothesis>;
+  // Hyps are keyed by Hypothesis::Key(). On a hash collision between
+  // different token sequences, the hyp is stored under the next free key.
+  using Map = std::unordered_map<uint64_t, Hypothesis>;
   Map hyps_dict_;
 };
 
@@ -0,0 +1,75 @@
+// sherpa-onnx/csrc/index-select-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/index-select.h"
+
+#include <array>
+#include <numeric>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(IndexSelectDim0, Basic) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  std::array<int64_t, 3> shape{3, 2, 2};
+  Ort::Value v =
+      Ort::Value::CreateTensor<float>(allocator, shape.data(), shape.size());
+  float *p = v.GetTensorMutableData<float>();
+  std::iota(p, p + 3 * 2 * 2, 0);
+
+  std::vector<int32_t> indexes = {2, 0};
+  Ort::Value ans = IndexSelectDim0(allocator, &v, indexes);
+
+  auto ans_shape = ans.GetTensorTypeAndShapeInfo().GetShape();
+  EXPECT_EQ(ans_shape, (std::vector<int64_t>{2, 2, 2}));
+
+  const float *q = ans.GetTensorData<float>();
+  for (int32_t i = 0; i != 2; ++i) {
+    for (int32_t k = 0; k != 4; ++k) {
+      EXPECT_EQ(q[i * 4 + k], p[indexes[i] * 4 + k]);
+    }
+  }
+}
+
+TEST(IndexSelectDim1, Basic) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  std::array<int64_t, 4> shape{2, 3, 2, 2};
+  Ort::Value v =
+      Ort::Value::CreateTensor<float>(allocator, shape.data(), shape.size());
+  float *p = v.GetTensorMutableData<float>();
+  std::iota(p, p + 2 * 3 * 2 * 2, 0);
+
+  // Drop the entry 1 and repeat the entry 2
+  std::vector<int32_t> indexes = {2, 0, 2};
+  Ort::Value ans = IndexSelectDim1(allocator, &v, indexes);
+
+  auto ans_shape = ans.GetTensorTypeAndShapeInfo().GetShape();
+  EXPECT_EQ(ans_shape, (std::vector<int64_t>{2, 3, 2, 2}));
+
+  const float *q = ans.GetTensorData<float>();
+  for (int32_t i = 0; i != 2; ++i) {
+    for (int32_t j = 0; j != 3; ++j) {
+      for (int32_t k = 0; k != 4; ++k) {
+        EXPECT_EQ(q[(i * 3 + j) * 4 + k], p[(i * 3 + indexes[j]) * 4 + k]);
+      }
+    }
+  }
+
+  // Write into a preallocated tensor
+  std::array<int64_t, 4> out_shape{2, 1, 2, 2};
+  Ort::Value out = Ort::Value::CreateTensor<float>(
+      allocator, out_shape.data(), out_shape.size());
+  IndexSelectDim1(&v, {1}, &out);
+
+  const float *r = out.GetTensorData<float>();
+  for (int32_t i = 0; i != 2; ++i) {
+    for (int32_t k = 0; k != 4; ++k) {
+      EXPECT_EQ(r[i * 4 + k], p[(i * 3 + 1) * 4 + k]);
+    }
+  }
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,112 @@
+// sherpa-onnx/csrc/index-select.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/index-select.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+namespace sherpa_onnx {
+
+template <typename T /*=float*/>
+Ort::Value IndexSelectDim0(OrtAllocator *allocator, const Ort::Value *v,
+                           const std::vector<int32_t> &indexes) {
+  std::vector<int64_t> shape = v->GetTensorTypeAndShapeInfo().GetShape();
+  assert(!shape.empty());
+
+  int64_t dim0 = shape[0];
+  (void)dim0;  // used only in assert()
+
+  int64_t inner = std::accumulate(shape.begin() + 1, shape.end(), int64_t{1},
+                                  std::multiplies<int64_t>());
+
+  shape[0] = indexes.size();
+
+  Ort::Value ans =
+      Ort::Value::CreateTensor<T>(allocator, shape.data(), shape.size());
+
+  const T *src = v->GetTensorData<T>();
+  T *dst = ans.GetTensorMutableData<T>();
+
+  for (auto k : indexes) {
+    assert(0 <= k && k < dim0);
+
+    const T *p = src + k * inner;
+    std::copy(p, p + inner, dst);
+    dst += inner;
+  }
+
+  return ans;
+}
+
+template <typename T /*=float*/>
+Ort::Value IndexSelectDim1(OrtAllocator *allocator, const Ort::Value *v,
+                           const std::vector<int32_t> &indexes) {
+  std::vector<int64_t> shape = v->GetTensorTypeAndShapeInfo().GetShape();
+  assert(shape.size() >= 2);
+
+  shape[1] = indexes.size();
+
+  Ort::Value ans =
+      Ort::Value::CreateTensor<T>(allocator, shape.data(), shape.size());
+
+  IndexSelectDim1<T>(v, indexes, &ans);
+
+  return ans;
+}
+
+template <typename T /*=float*/>
+void IndexSelectDim1(const Ort::Value *v, const std::vector<int32_t> &indexes,
+                     Ort::Value *out) {
+  std::vector<int64_t> shape = v->GetTensorTypeAndShapeInfo().GetShape();
+  assert(shape.size() >= 2);
+
+  int64_t dim0 = shape[0];
+  int64_t dim1 = shape[1];
+  int64_t inner = std::accumulate(shape.begin() + 2, shape.end(), int64_t{1},
+                                  std::multiplies<int64_t>());
+
+  int64_t num_indexes = indexes.size();
+  assert(out->GetTensorTypeAndShapeInfo().GetElementCount() ==
+         static_cast<size_t>(dim0 * num_indexes * inner));
+
+  const T *src = v->GetTensorData<T>();
+  T *dst = out->GetTensorMutableData<T>();
+
+  for (int64_t i = 0; i != dim0; ++i) {
+    for (auto k : indexes) {
+      assert(0 <= k && k < dim1);
+
+      const T *p = src + (i * dim1 + k) * inner;
+      std::copy(p, p + inner, dst);
+      dst += inner;
+    }
+  }
+}
+
+template Ort::Value IndexSelectDim0<float>(OrtAllocator *allocator,
+                                           const Ort::Value *v,
+                                           const std::vector<int32_t> &indexes);
+
+template Ort::Value IndexSelectDim1<float>(OrtAllocator *allocator,
+                                           const Ort::Value *v,
+                                           const std::vector<int32_t> &indexes);
+
+template Ort::Value IndexSelectDim1<int64_t>(
+    OrtAllocator *allocator, const Ort::Value *v,
+    const std::vector<int32_t> &indexes);
+
+template void IndexSelectDim1<float>(const Ort::Value *v,
+                                     const std::vector<int32_t> &indexes,
+                                     Ort::Value *out);
+
+template void IndexSelectDim1<int64_t>(const Ort::Value *v,
+                                       const std::vector<int32_t> &indexes,
+                                       Ort::Value *out);
+
+}  // namespace sherpa_onnx
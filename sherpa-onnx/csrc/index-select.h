@@ -0,0 +1,57 @@
+// sherpa-onnx/csrc/index-select.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_INDEX_SELECT_H_
+#define SHERPA_ONNX_CSRC_INDEX_SELECT_H_
+
+#include <vector>
+
+#include "onnxruntime_cxx_api.h"  // NOLINT
+
+namespace sherpa_onnx {
+
+/** Select entries along the first dimension of a tensor, e.g., to drop
+ * finished streams from decoder states of shape (batch_size, ...).
+ *
+ * It returns ans with ans[i, ...] = v[indexes[i], ...]
+ *
+ * @param allocator
+ * @param v A tensor with at least 1 dimension. Its data type is T.
+ * @param indexes Indexes into the first dimension of v. They can repeat.
+ *
+ * @return Return a tensor of shape (indexes.size(), v.shape[1:])
+ */
+template <typename T = float>
+Ort::Value IndexSelectDim0(OrtAllocator *allocator, const Ort::Value *v,
+                           const std::vector<int32_t> &indexes);
+
+/** Select entries along the second dimension of a tensor, e.g., to drop
+ * finished streams from the kv cache of shape
+ * (n_layer, batch_size, n_ctx, n_state) or to reorder it for beam search.
+ *
+ * It returns ans with ans[:, i, ...] = v[:, indexes[i], ...]
+ *
+ * @param allocator
+ * @param v A tensor with at least 2 dimensions. Its data type is T.
+ * @param indexes Indexes into the second dimension of v. They can repeat.
+ *
+ * @return Return a tensor of shape (v.shape[0], indexes.size(), v.shape[2:])
+ */
+template <typename T = float>
+Ort::Value IndexSelectDim1(OrtAllocator *allocator, const Ort::Value *v,
+                           const std::vector<int32_t> &indexes);
+
+/** Like the above one, but write the result into a preallocated tensor
+ * so that no memory is allocated, e.g., when reordering the kv cache
+ * at each decoding step.
+ *
+ * @param out Its shape must be (v.shape[0], indexes.size(), v.shape[2:]).
+ *            It must not share memory with v.
+ */
+template <typename T = float>
+void IndexSelectDim1(const Ort::Value *v, const std::vector<int32_t> &indexes,
+                     Ort::Value *out);
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_INDEX_SELECT_H_
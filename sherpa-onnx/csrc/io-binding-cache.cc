@@ -0,0 +1,136 @@
+// sherpa-onnx/csrc/io-binding-cache.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/io-binding-cache.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace sherpa_onnx {
+
+// Upper bound of recycled tensors kept for each type and shape. Each batch
+// of streams decoded in parallel holds one set of states, so a few
+// are enough.
+static constexpr int32_t kMaxFreeTensorsPerSpec = 4;
+
+IoBindingCache::IoBindingCache(Ort::Session *sess,
+                               const std::vector<const char *> &input_names,
+                               const std::vector<const char *> &output_names,
+                               OrtAllocator *allocator)
+    : sess_(sess),
+      input_names_(input_names),
+      output_names_(output_names),
+      allocator_(allocator) {}
+
+std::vector<Ort::Value> IoBindingCache::Run(const Ort::Value *inputs) {
+  std::vector<int64_t> key = inputs[0].GetTensorTypeAndShapeInfo().GetShape();
+
+  int32_t num_outputs = static_cast<int32_t>(output_names_.size());
+
+  std::unique_ptr<Ort::IoBinding> binding;
+  std::vector<Ort::Value> outputs;
+  outputs.reserve(num_outputs);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      Entry &entry = it->second;
+      if (!entry.free_bindings.empty()) {
+        binding = std::move(entry.free_bindings.back());
+        entry.free_bindings.pop_back();
+      }
+
+      for (const auto &spec : entry.output_specs) {
+        auto &free_tensors = free_tensors_[spec];
+        if (!free_tensors.empty()) {
+          outputs.push_back(std::move(free_tensors.back()));
+          free_tensors.pop_back();
+        } else {
+          outputs.push_back(Ort::Value::CreateTensor(
+              allocator_, spec.second.data(), spec.second.size(),
+              static_cast<ONNXTensorElementDataType>(spec.first)));
+        }
+      }
+    }
+  }
+
+  if (outputs.empty()) {
+    // The first run for this shape. Let onnxruntime allocate the outputs
+    // and remember their shapes.
+    auto ans = sess_->Run({}, input_names_.data(), inputs, input_names_.size(),
+                          output_names_.data(), output_names_.size());
+
+    Entry entry;
+    entry.output_specs.reserve(num_outputs);
+    for (const auto &v : ans) {
+      auto info = v.GetTensorTypeAndShapeInfo();
+      entry.output_specs.emplace_back(
+          static_cast<int32_t>(info.GetElementType()), info.GetShape());
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &spec : entry.output_specs) {
+      // So that Recycle() accepts tensors of this spec
+      free_tensors_[spec];
+    }
+    entries_.emplace(std::move(key), std::move(entry));
+
+    return ans;
+  }
+
+  if (!binding) {
+    binding = std::make_unique<Ort::IoBinding>(*sess_);
+  }
+
+  for (size_t i = 0; i != input_names_.size(); ++i) {
+    binding->BindInput(input_names_[i], inputs[i]);
+  }
+
+  for (int32_t i = 0; i != num_outputs; ++i) {
+    binding->BindOutput(output_names_[i], outputs[i]);
+  }
+
+  sess_->Run(run_options_, *binding);
+
+  // Don't keep the tensors alive after this call
+  binding->ClearBoundInputs();
+  binding->ClearBoundOutputs();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[key].free_bindings.push_back(std::move(binding));
+  }
+
+  return outputs;
+}
+
+void IoBindingCache::Recycle(Ort::Value v) {
+  if (!v || !v.IsTensor()) {
+    return;
+  }
+
+  auto info = v.GetTensorTypeAndShapeInfo();
+  TensorSpec spec(static_cast<int32_t>(info.GetElementType()),
+                  info.GetShape());
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = free_tensors_.find(spec);
+  if (it == free_tensors_.end() ||
+      static_cast<int32_t>(it->second.size()) >= kMaxFreeTensorsPerSpec) {
+    return;
+  }
+
+  it->second.push_back(std::move(v));
+}
+
+void IoBindingCache::Recycle(std::vector<Ort::Value> *values) {
+  for (auto &v : *values) {
+    Recycle(std::move(v));
+  }
+  values->clear();
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,89 @@
+// sherpa-onnx/csrc/io-binding-cache.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_IO_BINDING_CACHE_H_
+#define SHERPA_ONNX_CSRC_IO_BINDING_CACHE_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "onnxruntime_cxx_api.h"  // NOLINT
+
+namespace sherpa_onnx {
+
+/** Run a session whose output shapes depend only on the shape of its
+ * first input, e.g., the encoder of a streaming model, without allocating
+ * the outputs on every run.
+ *
+ * After the first run for a given shape of the first input, the outputs
+ * are bound with Ort::IoBinding to preallocated tensors. The tensors
+ * belong to the caller. Once the caller no longer needs a tensor, it can
+ * hand it back with Recycle() so that a later Run() writes into it.
+ * For instance, the next states of a streaming model are recycled after
+ * they have been fed back to the model.
+ *
+ * It is thread-safe.
+ */
+class IoBindingCache {
+ public:
+  /**
+   * @param sess The session to run. It must outlive this object.
+   * @param input_names Names of all inputs of sess. They must outlive this
+   *                    object.
+   * @param output_names Names of all outputs of sess. They must outlive this
+   *                     object.
+   * @param allocator To allocate the output tensors.
+   */
+  IoBindingCache(Ort::Session *sess,
+                 const std::vector<const char *> &input_names,
+                 const std::vector<const char *> &output_names,
+                 OrtAllocator *allocator);
+
+  /** Like Ort::Session::Run() with all inputs and outputs of the session.
+   *
+   * @param inputs Pointer to an array of input_names.size() tensors.
+   * @return Return the outputs in the order of output_names.
+   */
+  std::vector<Ort::Value> Run(const Ort::Value *inputs);
+
+  /** Give back a tensor that is no longer used. It is reused by a later
+   * Run() if one of the outputs has the same type and shape; otherwise,
+   * it is freed.
+   */
+  void Recycle(Ort::Value v);
+
+  void Recycle(std::vector<Ort::Value> *values);
+
+ private:
+  // (element type, shape)
+  using TensorSpec = std::pair<int32_t, std::vector<int64_t>>;
+
+  struct Entry {
+    std::vector<TensorSpec> output_specs;
+
+    // IoBinding is not thread-safe, so each concurrent Run() needs its own
+    std::vector<std::unique_ptr<Ort::IoBinding>> free_bindings;
+  };
+
+  Ort::Session *sess_;
+  std::vector<const char *> input_names_;
+  std::vector<const char *> output_names_;
+  OrtAllocator *allocator_;
+  Ort::RunOptions run_options_;
+
+  std::mutex mutex_;
+
+  // Indexed by the shape of the first input
+  std::map<std::vector<int64_t>, Entry> entries_;
+
+  // Tensors handed back by Recycle()
+  std::map<TensorSpec, std::vector<Ort::Value>> free_tensors_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_IO_BINDING_CACHE_H_
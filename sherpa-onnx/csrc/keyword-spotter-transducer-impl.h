@@ -215,23 +215,25 @@ class KeywordSpotterTransducerImpl : public KeywordSpotterImpl {
     int32_t feature_dim = ss[0]->FeatureDim();
 
     std::vector<TransducerKeywordResult> results(n);
-    std::vector<float> features_vec(n * chunk_size * feature_dim);
     std::vector<std::vector<Ort::Value>> states_vec(n);
     std::vector<int64_t> all_processed_frames(n);
 
+    // Features of each stream are written to its slice of x directly
+    std::array<int64_t, 3> x_shape{n, chunk_size, feature_dim};
+    Ort::Value x = Ort::Value::CreateTensor<float>(
+        model_->Allocator(), x_shape.data(), x_shape.size());
+    float *p_x = x.GetTensorMutableData<float>();
+
     for (int32_t i = 0; i != n; ++i) {
       SHERPA_ONNX_CHECK(ss[i]->GetContextGraph() != nullptr);
 
       const auto num_processed_frames = ss[i]->GetNumProcessedFrames();
-      std::vector<float> features =
-          ss[i]->GetFrames(num_processed_frames, chunk_size);
+      ss[i]->GetFrames(num_processed_frames, chunk_size,
+                       p_x + i * chunk_size * feature_dim);
 
       // Question: should num_processed_frames include chunk_shift?
       ss[i]->GetNumProcessedFrames() += chunk_shift;
 
-      std::copy(features.begin(), features.end(),
-                features_vec.data() + i * chunk_size * feature_dim);
-
       results[i] = std::move(ss[i]->GetKeywordResult());
       states_vec[i] = std::move(ss[i]->GetStates());
       all_processed_frames[i] = num_processed_frames;
@@ -240,12 +242,6 @@ class KeywordSpotterTransducerImpl : public KeywordSpotterImpl {
     auto memory_info =
         Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
 
-    std::array<int64_t, 3> x_shape{n, chunk_size, feature_dim};
-
-    Ort::Value x = Ort::Value::CreateTensor(memory_info, features_vec.data(),
-                                            features_vec.size(), x_shape.data(),
-                                            x_shape.size());
-
     std::array<int64_t, 1> processed_frames_shape{
         static_cast<int64_t>(all_processed_frames.size())};
 
@@ -168,12 +168,22 @@ void KeywordSpotter::Reset(OnlineStream *s) const { impl_->Reset(s); }
 
 void KeywordSpotter::DecodeStreams(OnlineStream **ss, int32_t n) const {
   impl_->DecodeStreams(ss, n);
+
+  for (int32_t i = 0; i != n; ++i) {
+    ss[i]->DiscardProcessed();
+  }
 }
 
 KeywordResult KeywordSpotter::GetResult(OnlineStream *s) const {
   return impl_->GetResult(s);
 }
 
+std::future<void> KeywordSpotter::Warmup(
+    const std::vector<WarmupShape> &shapes) const {
+  return std::async(std::launch::async,
+                    [this, shapes]() { RunStreamingWarmup(*this, shapes); });
+}
+
 #if __ANDROID_API__ >= 9
 template KeywordSpotter::KeywordSpotter(AAssetManager *mgr,
                                         const KeywordSpotterConfig &config);
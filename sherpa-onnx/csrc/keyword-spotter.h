@@ -5,6 +5,7 @@
 #ifndef SHERPA_ONNX_CSRC_KEYWORD_SPOTTER_H_
 #define SHERPA_ONNX_CSRC_KEYWORD_SPOTTER_H_
 
+#include <future>  // NOLINT
 #include <memory>
 #include <string>
 #include <vector>
@@ -14,6 +15,7 @@
 #include "sherpa-onnx/csrc/online-stream.h"
 #include "sherpa-onnx/csrc/online-transducer-model-config.h"
 #include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/warmup.h"
 
 namespace sherpa_onnx {
 
@@ -141,6 +143,18 @@ class KeywordSpotter {
 
   KeywordResult GetResult(OnlineStream *s) const;
 
+  /** Decode synthetic audio of the given shapes so that later requests
+   * do not pay for kernel selection and memory allocation in onnxruntime.
+   * For each shape, batch_size streams of num_seconds are decoded
+   * together.
+   *
+   * It returns immediately; the warmup runs in a background thread and
+   * the returned future becomes ready when it is done. Note that the
+   * destructor of the future waits for the warmup. Requests can be served
+   * while it runs. This object must outlive the warmup.
+   */
+  std::future<void> Warmup(const std::vector<WarmupShape> &shapes) const;
+
  private:
   std::unique_ptr<KeywordSpotterImpl> impl_;
 };
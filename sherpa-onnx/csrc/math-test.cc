@@ -0,0 +1,114 @@
+// sherpa-onnx/csrc/math-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/math.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+static std::vector<float> RandomVector(int32_t n, std::mt19937 *mt) {
+  std::normal_distribution<float> dist(0, 5);
+  std::vector<float> ans(n);
+  for (auto &f : ans) {
+    f = dist(*mt);
+  }
+  return ans;
+}
+
+// The previous implementation of TopkIndex(). Used as a reference.
+static std::vector<int32_t> TopkIndexWithSort(const float *vec, int32_t size,
+                                              int32_t topk) {
+  std::vector<int32_t> index(size);
+  std::iota(index.begin(), index.end(), 0);
+
+  topk = std::min(size, topk);
+  std::partial_sort(index.begin(), index.begin() + topk, index.end(),
+                    [vec](int32_t a, int32_t b) { return vec[a] > vec[b]; });
+
+  index.resize(topk);
+  return index;
+}
+
+TEST(LogSoftmax, CompareWithTemplate) {
+  std::mt19937 mt(2025);
+  for (int32_t n : {1, 3, 7, 8, 9, 31, 500, 5001}) {
+    auto a = RandomVector(n, &mt);
+    auto b = a;
+    auto c = a;
+
+    LogSoftmax(a.data(), n);
+    LogSoftmax<float>(b.data(), n);
+    LogSoftmaxPlusBias(c.data(), n, -3.5f);
+
+    for (int32_t i = 0; i != n; ++i) {
+      EXPECT_NEAR(a[i], b[i], 1e-4);
+      EXPECT_NEAR(c[i], b[i] - 3.5f, 1e-4);
+    }
+  }
+}
+
+TEST(LogSoftmax, TwoDimensional) {
+  std::mt19937 mt(2025);
+  int32_t w = 37;
+  int32_t h = 5;
+  auto a = RandomVector(w * h, &mt);
+  auto b = a;
+
+  LogSoftmax(a.data(), w, h);
+  for (int32_t i = 0; i != h; ++i) {
+    LogSoftmax<float>(b.data() + i * w, w);
+  }
+
+  for (int32_t i = 0; i != w * h; ++i) {
+    EXPECT_NEAR(a[i], b[i], 1e-4);
+  }
+}
+
+TEST(LogSumExp, Basic) {
+  std::mt19937 mt(2025);
+  for (int32_t n : {1, 7, 8, 500, 5001}) {
+    auto a = RandomVector(n, &mt);
+    for (float scale : {1.0f, 0.5f}) {
+      double expected = 0;
+      for (auto f : a) {
+        expected += std::exp(static_cast<double>(f) * scale);
+      }
+      expected = std::log(expected);
+
+      EXPECT_NEAR(LogSumExp(a.data(), n, scale), expected, 1e-4);
+    }
+  }
+}
+
+TEST(TopkIndex, CompareWithSort) {
+  std::mt19937 mt(2025);
+  for (int32_t n : {1, 5, 8, 17, 500, 5000}) {
+    auto a = RandomVector(n, &mt);
+    for (int32_t k : {1, 4, 8, 10}) {
+      EXPECT_EQ(TopkIndex(a.data(), n, k), TopkIndexWithSort(a.data(), n, k));
+
+      std::vector<double> d(a.begin(), a.end());
+      EXPECT_EQ(TopkIndex(d.data(), n, k), TopkIndexWithSort(a.data(), n, k));
+    }
+  }
+}
+
+TEST(TopkIndex, SortedInput) {
+  // Ascending input is the worst case for the min-heap
+  std::vector<float> a(100);
+  std::iota(a.begin(), a.end(), 0);
+
+  EXPECT_EQ(TopkIndex(a.data(), a.size(), 3),
+            std::vector<int32_t>({99, 98, 97}));
+  EXPECT_EQ(TopkIndex(a.data(), a.size(), 0), std::vector<int32_t>());
+}
+
+}  // namespace sherpa_onnx
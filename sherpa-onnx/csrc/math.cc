@@ -0,0 +1,413 @@
+// sherpa-onnx/csrc/math.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/math.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || \
+    defined(_M_IX86)
+#define SHERPA_ONNX_MATH_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SHERPA_ONNX_MATH_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SHERPA_ONNX_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define SHERPA_ONNX_TARGET_AVX2
+#endif
+
+namespace sherpa_onnx {
+
+namespace {
+
+struct MathKernels {
+  // max(p[0:n]). n must be positive.
+  float (*max)(const float *p, int32_t n);
+
+  // sum(exp((p[0:n] - m) * scale))
+  float (*exp_sum)(const float *p, int32_t n, float m, float scale);
+
+  // p[0:n] += b
+  void (*add)(float *p, int32_t n, float b);
+
+  // Index of the first element in p[0:n] that is larger than threshold,
+  // or n if there is no such element.
+  int32_t (*find_first_greater)(const float *p, int32_t n, float threshold);
+};
+
+float MaxScalar(const float *p, int32_t n) {
+  float m = p[0];
+  for (int32_t i = 1; i < n; ++i) {
+    m = std::max(m, p[i]);
+  }
+  return m;
+}
+
+float ExpSumScalar(const float *p, int32_t n, float m, float scale) {
+  float sum = 0;
+  for (int32_t i = 0; i < n; ++i) {
+    sum += std::exp((p[i] - m) * scale);
+  }
+  return sum;
+}
+
+void AddScalar(float *p, int32_t n, float b) {
+  for (int32_t i = 0; i < n; ++i) {
+    p[i] += b;
+  }
+}
+
+int32_t FindFirstGreaterScalar(const float *p, int32_t n, float threshold) {
+  int32_t i = 0;
+  while (i < n && !(p[i] > threshold)) {
+    ++i;
+  }
+  return i;
+}
+
+// The polynomial approximation of exp() below is from Cephes.
+// Its relative error is about 1e-7 for inputs in [-88, 88].
+constexpr float kExpHi = 88.3762626647949f;
+constexpr float kExpLo = -88.3762626647949f;
+constexpr float kLog2e = 1.44269504088896341f;
+constexpr float kExpC1 = 0.693359375f;
+constexpr float kExpC2 = -2.12194440e-4f;
+constexpr float kExpP0 = 1.9875691500e-4f;
+constexpr float kExpP1 = 1.3981999507e-3f;
+constexpr float kExpP2 = 8.3334519073e-3f;
+constexpr float kExpP3 = 4.1665795894e-2f;
+constexpr float kExpP4 = 1.6666665459e-1f;
+constexpr float kExpP5 = 5.0000001201e-1f;
+
+#if SHERPA_ONNX_MATH_X86
+
+int32_t CountTrailingZeros(uint32_t x) {
+#if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long index;  // NOLINT
+  _BitScanForward(&index, x);
+  return static_cast<int32_t>(index);
+#else
+  return __builtin_ctz(x);
+#endif
+}
+
+bool CpuSupportsAvx2() {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#elif defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7) {
+    return false;
+  }
+
+  __cpuid(info, 1);
+  bool fma = (info[2] & (1 << 12)) != 0;
+  bool osxsave = (info[2] & (1 << 27)) != 0;
+  bool avx = (info[2] & (1 << 28)) != 0;
+  if (!fma || !osxsave || !avx) {
+    return false;
+  }
+
+  // The OS must save the YMM registers on context switches
+  if ((_xgetbv(0) & 6) != 6) {
+    return false;
+  }
+
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  return false;
+#endif
+}
+
+SHERPA_ONNX_TARGET_AVX2 float HorizontalMaxAvx2(__m256 v) {
+  __m128 lo = _mm256_castps256_ps128(v);
+  __m128 hi = _mm256_extractf128_ps(v, 1);
+  lo = _mm_max_ps(lo, hi);
+  lo = _mm_max_ps(lo, _mm_movehl_ps(lo, lo));
+  lo = _mm_max_ss(lo, _mm_shuffle_ps(lo, lo, 1));
+  return _mm_cvtss_f32(lo);
+}
+
+SHERPA_ONNX_TARGET_AVX2 float HorizontalSumAvx2(__m256 v) {
+  __m128 lo = _mm256_castps256_ps128(v);
+  __m128 hi = _mm256_extractf128_ps(v, 1);
+  lo = _mm_add_ps(lo, hi);
+  lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+  lo = _mm_add_ss(lo, _mm_shuffle_ps(lo, lo, 1));
+  return _mm_cvtss_f32(lo);
+}
+
+SHERPA_ONNX_TARGET_AVX2 __m256 ExpAvx2(__m256 x) {
+  x = _mm256_min_ps(x, _mm256_set1_ps(kExpHi));
+  x = _mm256_max_ps(x, _mm256_set1_ps(kExpLo));
+
+  // exp(x) = 2^n * exp(r), where n = floor(x * log2(e) + 0.5)
+  __m256 n = _mm256_fmadd_ps(x, _mm256_set1_ps(kLog2e), _mm256_set1_ps(0.5f));
+  n = _mm256_floor_ps(n);
+
+  x = _mm256_fnmadd_ps(n, _mm256_set1_ps(kExpC1), x);
+  x = _mm256_fnmadd_ps(n, _mm256_set1_ps(kExpC2), x);
+
+  __m256 z = _mm256_mul_ps(x, x);
+  __m256 y = _mm256_set1_ps(kExpP0);
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kExpP1));
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kExpP2));
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kExpP3));
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kExpP4));
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kExpP5));
+  y = _mm256_fmadd_ps(y, z, x);
+  y = _mm256_add_ps(y, _mm256_set1_ps(1.0f));
+
+  __m256i e = _mm256_cvttps_epi32(n);
+  e = _mm256_add_epi32(e, _mm256_set1_epi32(127));
+  e = _mm256_slli_epi32(e, 23);
+
+  return _mm256_mul_ps(y, _mm256_castsi256_ps(e));
+}
+
+SHERPA_ONNX_TARGET_AVX2 float MaxAvx2(const float *p, int32_t n) {
+  if (n < 8) {
+    return MaxScalar(p, n);
+  }
+
+  __m256 m = _mm256_loadu_ps(p);
+  int32_t i = 8;
+  for (; i + 8 <= n; i += 8) {
+    m = _mm256_max_ps(m, _mm256_loadu_ps(p + i));
+  }
+
+  float ans = HorizontalMaxAvx2(m);
+  for (; i < n; ++i) {
+    ans = std::max(ans, p[i]);
+  }
+  return ans;
+}
+
+SHERPA_ONNX_TARGET_AVX2 float ExpSumAvx2(const float *p, int32_t n, float m,
+                                         float scale) {
+  __m256 vm = _mm256_set1_ps(m);
+  __m256 vscale = _mm256_set1_ps(scale);
+  __m256 sum = _mm256_setzero_ps();
+
+  int32_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256 x = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(p + i), vm), vscale);
+    sum = _mm256_add_ps(sum, ExpAvx2(x));
+  }
+
+  float ans = HorizontalSumAvx2(sum);
+  for (; i < n; ++i) {
+    ans += std::exp((p[i] - m) * scale);
+  }
+  return ans;
+}
+
+SHERPA_ONNX_TARGET_AVX2 void AddAvx2(float *p, int32_t n, float b) {
+  __m256 vb = _mm256_set1_ps(b);
+
+  int32_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps(p + i, _mm256_add_ps(_mm256_loadu_ps(p + i), vb));
+  }
+
+  for (; i < n; ++i) {
+    p[i] += b;
+  }
+}
+
+SHERPA_ONNX_TARGET_AVX2 int32_t FindFirstGreaterAvx2(const float *p,
+                                                     int32_t n,
+                                                     float threshold) {
+  __m256 t = _mm256_set1_ps(threshold);
+
+  int32_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256 c = _mm256_cmp_ps(_mm256_loadu_ps(p + i), t, _CMP_GT_OQ);
+    int32_t mask = _mm256_movemask_ps(c);
+    if (mask) {
+      return i + CountTrailingZeros(static_cast<uint32_t>(mask));
+    }
+  }
+
+  return i + FindFirstGreaterScalar(p + i, n - i, threshold);
+}
+
+#endif  // SHERPA_ONNX_MATH_X86
+
+#if SHERPA_ONNX_MATH_NEON
+
+float32x4_t ExpNeon(float32x4_t x) {
+  x = vminq_f32(x, vdupq_n_f32(kExpHi));
+  x = vmaxq_f32(x, vdupq_n_f32(kExpLo));
+
+  // exp(x) = 2^n * exp(r), where n = floor(x * log2(e) + 0.5)
+  float32x4_t n = vfmaq_f32(vdupq_n_f32(0.5f), x, vdupq_n_f32(kLog2e));
+  n = vrndmq_f32(n);
+
+  x = vfmsq_f32(x, n, vdupq_n_f32(kExpC1));
+  x = vfmsq_f32(x, n, vdupq_n_f32(kExpC2));
+
+  float32x4_t z = vmulq_f32(x, x);
+  float32x4_t y = vdupq_n_f32(kExpP0);
+  y = vfmaq_f32(vdupq_n_f32(kExpP1), y, x);
+  y = vfmaq_f32(vdupq_n_f32(kExpP2), y, x);
+  y = vfmaq_f32(vdupq_n_f32(kExpP3), y, x);
+  y = vfmaq_f32(vdupq_n_f32(kExpP4), y, x);
+  y = vfmaq_f32(vdupq_n_f32(kExpP5), y, x);
+  y = vfmaq_f32(x, y, z);
+  y = vaddq_f32(y, vdupq_n_f32(1.0f));
+
+  int32x4_t e = vcvtq_s32_f32(n);
+  e = vaddq_s32(e, vdupq_n_s32(127));
+  e = vshlq_n_s32(e, 23);
+
+  return vmulq_f32(y, vreinterpretq_f32_s32(e));
+}
+
+float MaxNeon(const float *p, int32_t n) {
+  if (n < 4) {
+    return MaxScalar(p, n);
+  }
+
+  float32x4_t m = vld1q_f32(p);
+  int32_t i = 4;
+  for (; i + 4 <= n; i += 4) {
+    m = vmaxq_f32(m, vld1q_f32(p + i));
+  }
+
+  float ans = vmaxvq_f32(m);
+  for (; i < n; ++i) {
+    ans = std::max(ans, p[i]);
+  }
+  return ans;
+}
+
+float ExpSumNeon(const float *p, int32_t n, float m, float scale) {
+  float32x4_t vm = vdupq_n_f32(m);
+  float32x4_t vscale = vdupq_n_f32(scale);
+  float32x4_t sum = vdupq_n_f32(0);
+
+  int32_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    float32x4_t x = vmulq_f32(vsubq_f32(vld1q_f32(p + i), vm), vscale);
+    sum = vaddq_f32(sum, ExpNeon(x));
+  }
+
+  float ans = vaddvq_f32(sum);
+  for (; i < n; ++i) {
+    ans += std::exp((p[i] - m) * scale);
+  }
+  return ans;
+}
+
+void AddNeon(float *p, int32_t n, float b) {
+  float32x4_t vb = vdupq_n_f32(b);
+
+  int32_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    vst1q_f32(p + i, vaddq_f32(vld1q_f32(p + i), vb));
+  }
+
+  for (; i < n; ++i) {
+    p[i] += b;
+  }
+}
+
+int32_t FindFirstGreaterNeon(const float *p, int32_t n, float threshold) {
+  float32x4_t t = vdupq_n_f32(threshold);
+
+  int32_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    uint32x4_t c = vcgtq_f32(vld1q_f32(p + i), t);
+    if (vmaxvq_u32(c)) {
+      break;
+    }
+  }
+
+  return i + FindFirstGreaterScalar(p + i, n - i, threshold);
+}
+
+#endif  // SHERPA_ONNX_MATH_NEON
+
+MathKernels SelectMathKernels() {
+  MathKernels k;
+  k.max = &MaxScalar;
+  k.exp_sum = &ExpSumScalar;
+  k.add = &AddScalar;
+  k.find_first_greater = &FindFirstGreaterScalar;
+
+#if SHERPA_ONNX_MATH_X86
+  if (CpuSupportsAvx2()) {
+    k.max = &MaxAvx2;
+    k.exp_sum = &ExpSumAvx2;
+    k.add = &AddAvx2;
+    k.find_first_greater = &FindFirstGreaterAvx2;
+  }
+#elif SHERPA_ONNX_MATH_NEON
+  k.max = &MaxNeon;
+  k.exp_sum = &ExpSumNeon;
+  k.add = &AddNeon;
+  k.find_first_greater = &FindFirstGreaterNeon;
+#endif
+
+  return k;
+}
+
+const MathKernels &GetMathKernels() {
+  static const MathKernels kernels = SelectMathKernels();
+  return kernels;
+}
+
+}  // namespace
+
+void LogSoftmax(float *input, int32_t input_len) {
+  LogSoftmaxPlusBias(input, input_len, 0);
+}
+
+void LogSoftmaxPlusBias(float *input, int32_t input_len, float bias) {
+  if (input_len <= 0) {
+    return;
+  }
+
+  const auto &k = GetMathKernels();
+
+  float m = k.max(input, input_len);
+  float sum = k.exp_sum(input, input_len, m, 1);
+  float offset = m + std::log(sum);
+
+  k.add(input, input_len, bias - offset);
+}
+
+float LogSumExp(const float *input, int32_t input_len, float scale) {
+  if (input_len <= 0) {
+    return -std::numeric_limits<float>::infinity();
+  }
+
+  const auto &k = GetMathKernels();
+
+  float m = k.max(input, input_len);
+  float sum = k.exp_sum(input, input_len, m, scale);
+
+  return m * scale + std::log(sum);
+}
+
+std::vector<int32_t> TopkIndex(const float *vec, int32_t size, int32_t topk) {
+  return PartialTopkIndex(vec, size, topk,
+                          GetMathKernels().find_first_greater);
+}
+
+}  // namespace sherpa_onnx
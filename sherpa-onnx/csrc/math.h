@@ -10,6 +10,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
 #include <numeric>
 #include <vector>
 
@@ -71,6 +72,24 @@ struct LogAdd<float> {
   }
 };
 
+// The following float overloads are implemented in math.cc. They use
+// SIMD kernels (AVX2 on x86, NEON on arm64) selected at runtime and fall
+// back to scalar code on other CPUs. They are preferred over the templates
+// below for float inputs.
+
+// Compute log_softmax of input in-place.
+void LogSoftmax(float *input, int32_t input_len);
+
+// Compute log_softmax(input) + bias in-place in a single pass.
+void LogSoftmaxPlusBias(float *input, int32_t input_len, float bias);
+
+// Return log(sum(exp(input * scale))) without modifying input.
+// scale must be positive.
+float LogSumExp(const float *input, int32_t input_len, float scale = 1);
+
+// See the template version of TopkIndex() below.
+std::vector<int32_t> TopkIndex(const float *vec, int32_t size, int32_t topk);
+
 template <class T>
 void LogSoftmax(T *input, int32_t input_len) {
   assert(input);
@@ -105,18 +124,59 @@ void SubtractBlank(T *in, int32_t w, int32_t h, int32_t blank_idx,
   }
 }
 
-template <class T>
-std::vector<int32_t> TopkIndex(const T *vec, int32_t size, int32_t topk) {
-  std::vector<int32_t> vec_index(size);
-  std::iota(vec_index.begin(), vec_index.end(), 0);
+// Return the indexes of the topk largest elements of vec, sorted by value
+// in descending order.
+//
+// find_first_greater(p, n, threshold) returns the index of the first element
+// in p[0:n] that is larger than threshold, or n if there is no such element.
+//
+// It keeps a min-heap of the topk largest elements seen so far, so the row
+// is never sorted; elements not larger than the current k-th largest
+// element are skipped by find_first_greater.
+template <class T, class FindFirstGreater>
+std::vector<int32_t> PartialTopkIndex(const T *vec, int32_t size,
+                                      int32_t topk,
+                                      FindFirstGreater find_first_greater) {
+  int32_t k = std::min<int32_t>(size, topk);
+  if (k <= 0) {
+    return {};
+  }
+
+  auto greater = [vec](int32_t a, int32_t b) { return vec[a] > vec[b]; };
 
-  std::partial_sort(vec_index.begin(), vec_index.begin() + topk,
-                    vec_index.end(), [vec](int32_t index_1, int32_t index_2) {
-                      return vec[index_1] > vec[index_2];
-                    });
+  // heap.front() is the index of the smallest element in the heap
+  std::vector<int32_t> heap(k);
+  std::iota(heap.begin(), heap.end(), 0);
+  std::make_heap(heap.begin(), heap.end(), greater);
 
-  int32_t k_num = std::min<int32_t>(size, topk);
-  return {vec_index.begin(), vec_index.begin() + k_num};
+  int32_t i = k;
+  while (i < size) {
+    i += find_first_greater(vec + i, size - i, vec[heap.front()]);
+    if (i >= size) {
+      break;
+    }
+
+    std::pop_heap(heap.begin(), heap.end(), greater);
+    heap.back() = i;
+    std::push_heap(heap.begin(), heap.end(), greater);
+    ++i;
+  }
+
+  std::sort_heap(heap.begin(), heap.end(), greater);
+
+  return heap;
+}
+
+template <class T>
+std::vector<int32_t> TopkIndex(const T *vec, int32_t size, int32_t topk) {
+  return PartialTopkIndex(vec, size, topk,
+                          [](const T *p, int32_t n, T threshold) {
+                            int32_t i = 0;
+                            while (i < n && !(p[i] > threshold)) {
+                              ++i;
+                            }
+                            return i;
+                          });
 }
 
 template <class T>
@@ -0,0 +1,43 @@
+// sherpa-onnx/csrc/model-precision-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/model-precision.h"
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(ModelPrecision, IsValid) {
+  EXPECT_TRUE(IsValidModelPrecision(""));
+  EXPECT_TRUE(IsValidModelPrecision("fp32"));
+  EXPECT_TRUE(IsValidModelPrecision("fp16"));
+  EXPECT_TRUE(IsValidModelPrecision("int8"));
+
+  EXPECT_FALSE(IsValidModelPrecision("int4"));
+  EXPECT_FALSE(IsValidModelPrecision("INT8"));
+}
+
+TEST(ModelPrecision, Filename) {
+  EXPECT_EQ(ModelFilenameForPrecision("a/encoder.onnx", ""), "a/encoder.onnx");
+
+  EXPECT_EQ(ModelFilenameForPrecision("a/encoder.onnx", "int8"),
+            "a/encoder.int8.onnx");
+  EXPECT_EQ(ModelFilenameForPrecision("a/encoder.onnx", "fp16"),
+            "a/encoder.fp16.onnx");
+  EXPECT_EQ(ModelFilenameForPrecision("a/encoder.onnx", "fp32"),
+            "a/encoder.onnx");
+
+  EXPECT_EQ(ModelFilenameForPrecision("a/encoder.int8.onnx", "fp32"),
+            "a/encoder.onnx");
+  EXPECT_EQ(ModelFilenameForPrecision("a/encoder.int8.onnx", "fp16"),
+            "a/encoder.fp16.onnx");
+  EXPECT_EQ(ModelFilenameForPrecision("a/encoder.fp16.onnx", "int8"),
+            "a/encoder.int8.onnx");
+
+  // Not an onnx file
+  EXPECT_EQ(ModelFilenameForPrecision("a/model.rknn", "int8"), "a/model.rknn");
+  EXPECT_EQ(ModelFilenameForPrecision("", "int8"), "");
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,60 @@
+// sherpa-onnx/csrc/model-precision.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/model-precision.h"
+
+#include <string>
+
+#include "sherpa-onnx/csrc/file-utils.h"
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+static bool EndsWith(const std::string &s, const std::string &suffix) {
+  return s.size() >= suffix.size() &&
+         s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+bool IsValidModelPrecision(const std::string &precision) {
+  return precision.empty() || precision == "fp32" || precision == "fp16" ||
+         precision == "int8";
+}
+
+std::string ModelFilenameForPrecision(const std::string &filename,
+                                      const std::string &precision) {
+  if (precision.empty() || !EndsWith(filename, ".onnx")) {
+    return filename;
+  }
+
+  // Remove .onnx
+  std::string stem = filename.substr(0, filename.size() - 5);
+
+  if (EndsWith(stem, ".int8") || EndsWith(stem, ".fp16")) {
+    stem.resize(stem.size() - 5);
+  }
+
+  if (precision == "fp32") {
+    return stem + ".onnx";
+  }
+
+  return stem + "." + precision + ".onnx";
+}
+
+std::string SelectModelPrecision(const std::string &filename,
+                                 const std::string &precision) {
+  std::string ans = ModelFilenameForPrecision(filename, precision);
+  if (ans == filename) {
+    return filename;
+  }
+
+  if (!FileExists(ans)) {
+    SHERPA_ONNX_LOGE("No %s model %s. Use %s", precision.c_str(), ans.c_str(),
+                     filename.c_str());
+    return filename;
+  }
+
+  return ans;
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,41 @@
+// sherpa-onnx/csrc/model-precision.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_MODEL_PRECISION_H_
+#define SHERPA_ONNX_CSRC_MODEL_PRECISION_H_
+
+#include <string>
+
+namespace sherpa_onnx {
+
+// Precisions of model files that can be selected at runtime. Files in
+// other precisions are expected next to the given one, e.g.,
+//
+//   encoder.onnx       fp32
+//   encoder.fp16.onnx  fp16
+//   encoder.int8.onnx  int8
+//
+// They can be generated with ./scripts/quantize-models.py
+//
+// An empty string means to use the given files as they are.
+bool IsValidModelPrecision(const std::string &precision);
+
+/** Return the name of the given model file in the given precision without
+ * checking whether it exists.
+ *
+ * For instance, it returns encoder.int8.onnx for encoder.onnx and
+ * encoder.fp16.onnx with precision int8. filename is returned if it
+ * does not end with .onnx or precision is empty.
+ */
+std::string ModelFilenameForPrecision(const std::string &filename,
+                                      const std::string &precision);
+
+/** Like ModelFilenameForPrecision(), but filename is returned if the file
+ * in the given precision does not exist.
+ */
+std::string SelectModelPrecision(const std::string &filename,
+                                 const std::string &precision);
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_MODEL_PRECISION_H_
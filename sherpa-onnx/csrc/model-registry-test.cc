@@ -0,0 +1,187 @@
+// sherpa-onnx/csrc/model-registry-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/model-registry.h"
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <functional>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+namespace {
+
+struct FakeConfig {
+  int64_t num_bytes = 0;
+
+  // To simulate a model that takes a while to load
+  int32_t load_ms = 0;
+
+  // Called when the model is freed
+  std::function<void()> on_free;
+};
+
+int64_t EstimateModelBytes(const FakeConfig &config) {
+  return config.num_bytes;
+}
+
+std::atomic<int32_t> num_constructed{0};
+
+struct FakeModel {
+  explicit FakeModel(const FakeConfig &config) : on_free(config.on_free) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(config.load_ms));
+    ++num_constructed;
+  }
+
+  ~FakeModel() {
+    if (on_free) {
+      on_free();
+    }
+  }
+
+  std::function<void()> on_free;
+};
+
+using FakeRegistry = ModelRegistry<FakeModel, FakeConfig>;
+
+}  // namespace
+
+TEST(ModelRegistry, LoadOnFirstUse) {
+  num_constructed = 0;
+  FakeRegistry registry(ModelRegistryConfig{});
+
+  EXPECT_TRUE(registry.Add("a", FakeConfig{10}));
+  EXPECT_FALSE(registry.Add("a", FakeConfig{10}));
+  EXPECT_EQ(registry.NumLoaded(), 0);
+  EXPECT_EQ(registry.Get("b"), nullptr);
+
+  auto a = registry.Get("a");
+  EXPECT_NE(a, nullptr);
+  EXPECT_EQ(registry.Get("a"), a);
+  EXPECT_EQ(num_constructed, 1);
+  EXPECT_EQ(registry.LoadedBytes(), 10);
+
+  EXPECT_TRUE(registry.Unload("a"));
+  EXPECT_FALSE(registry.IsLoaded("a"));
+  EXPECT_EQ(registry.LoadedBytes(), 0);
+}
+
+TEST(ModelRegistry, MemoryBudget) {
+  FakeRegistry registry(ModelRegistryConfig{3, 0});
+
+  const int64_t mb = 1 << 20;
+  registry.Add("a", FakeConfig{mb});
+  registry.Add("b", FakeConfig{mb});
+  registry.Add("c", FakeConfig{2 * mb});
+
+  registry.Get("a");
+  registry.Get("b");
+  registry.Get("a");
+
+  // b is the least recently used one
+  registry.Get("c");
+  EXPECT_TRUE(registry.IsLoaded("a"));
+  EXPECT_FALSE(registry.IsLoaded("b"));
+  EXPECT_TRUE(registry.IsLoaded("c"));
+  EXPECT_EQ(registry.LoadedBytes(), 3 * mb);
+
+  // Models in use are kept even if the budget is exceeded
+  auto a = registry.Get("a");
+  auto c = registry.Get("c");
+  auto b = registry.Get("b");
+  EXPECT_EQ(registry.NumLoaded(), 3);
+}
+
+TEST(ModelRegistry, EvictIdle) {
+  FakeRegistry registry(ModelRegistryConfig{0, 0.05});
+  registry.Add("a", FakeConfig{});
+  registry.Add("b", FakeConfig{});
+
+  auto a = registry.Get("a");
+  registry.Get("b");
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  registry.EvictIdle();
+
+  // a is still in use
+  EXPECT_TRUE(registry.IsLoaded("a"));
+  EXPECT_FALSE(registry.IsLoaded("b"));
+}
+
+TEST(ModelRegistry, ConcurrentGet) {
+  num_constructed = 0;
+  FakeRegistry registry(ModelRegistryConfig{});
+  registry.Add("a", FakeConfig{});
+
+  std::vector<std::thread> threads;
+  for (int32_t i = 0; i != 8; ++i) {
+    threads.emplace_back([&registry]() { registry.Get("a"); });
+  }
+
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  EXPECT_EQ(num_constructed, 1);
+}
+
+TEST(ModelRegistry, ConcurrentLoadsStayWithinBudget) {
+  FakeRegistry registry(ModelRegistryConfig{3, 0});
+
+  const int64_t mb = 1 << 20;
+  registry.Add("a", FakeConfig{mb, 100});
+  registry.Add("b", FakeConfig{mb, 100});
+  registry.Add("c", FakeConfig{mb});
+  registry.Add("d", FakeConfig{mb});
+
+  registry.Get("c");
+  registry.Get("d");
+
+  // The second load must see the memory reserved by the first one and
+  // unload c to make room
+  std::thread t([&registry]() { registry.Get("a"); });
+  registry.Get("b");
+  t.join();
+
+  EXPECT_EQ(registry.LoadedBytes(), 3 * mb);
+  EXPECT_EQ(registry.NumLoaded(), 3);
+  EXPECT_FALSE(registry.IsLoaded("c"));
+}
+
+TEST(ModelRegistry, FreeModelsWithoutHoldingTheLock) {
+  FakeRegistry *p = nullptr;
+  int32_t num_freed = 0;
+
+  // It would deadlock if the model were freed while holding the lock
+  FakeConfig config;
+  config.num_bytes = 1 << 20;
+  config.on_free = [&p, &num_freed]() {
+    p->NumLoaded();
+    ++num_freed;
+  };
+
+  FakeRegistry registry(ModelRegistryConfig{1, 0});
+  p = &registry;
+
+  registry.Add("a", config);
+  registry.Add("b", config);
+
+  registry.Get("a");
+  registry.Get("b");  // unloads a
+  EXPECT_EQ(num_freed, 1);
+
+  EXPECT_TRUE(registry.Unload("b"));
+  EXPECT_EQ(num_freed, 2);
+
+  registry.Get("a");
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(registry.EvictIdle(), 0);
+  EXPECT_EQ(num_freed, 2);
+}
+
+}  // namespace sherpa_onnx
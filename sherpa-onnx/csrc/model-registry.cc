@@ -0,0 +1,95 @@
+// sherpa-onnx/csrc/model-registry.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/model-registry.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "sherpa-onnx/csrc/offline-recognizer.h"
+
+#if SHERPA_ONNX_ENABLE_TTS == 1
+#include "sherpa-onnx/csrc/offline-tts.h"
+#endif
+
+namespace sherpa_onnx {
+
+bool ModelRegistryConfig::Validate() const {
+  if (max_memory_mb < 0) {
+    SHERPA_ONNX_LOGE("max_memory_mb should be >= 0. Given: %d",
+                     max_memory_mb);
+    return false;
+  }
+
+  if (max_idle_seconds < 0) {
+    SHERPA_ONNX_LOGE("max_idle_seconds should be >= 0. Given: %.3f",
+                     max_idle_seconds);
+    return false;
+  }
+
+  return true;
+}
+
+std::string ModelRegistryConfig::ToString() const {
+  std::ostringstream os;
+
+  os << "ModelRegistryConfig(";
+  os << "max_memory_mb=" << max_memory_mb << ", ";
+  os << "max_idle_seconds=" << max_idle_seconds << ")";
+
+  return os.str();
+}
+
+static int64_t FileBytes(const std::string &filename) {
+  if (filename.empty()) {
+    return 0;
+  }
+
+  std::ifstream is(filename, std::ios::binary | std::ios::ate);
+  if (!is) {
+    return 0;
+  }
+
+  return static_cast<int64_t>(is.tellg());
+}
+
+int64_t EstimateModelBytes(const OfflineRecognizerConfig &config) {
+  // The recognizer loads the files in the selected precision
+  OfflineModelConfig c = config.model_config;
+  c.ApplyPrecision();
+
+  int64_t ans = 0;
+  for (const std::string *f :
+       {&c.transducer.encoder_filename, &c.transducer.decoder_filename,
+        &c.transducer.joiner_filename, &c.paraformer.model, &c.nemo_ctc.model,
+        &c.whisper.encoder, &c.whisper.decoder, &c.fire_red_asr.encoder,
+        &c.fire_red_asr.decoder, &c.tdnn.model, &c.zipformer_ctc.model,
+        &c.wenet_ctc.model, &c.sense_voice.model, &c.moonshine.preprocessor,
+        &c.moonshine.encoder, &c.moonshine.uncached_decoder,
+        &c.moonshine.cached_decoder, &c.dolphin.model, &c.telespeech_ctc}) {
+    ans += FileBytes(*f);
+  }
+
+  ans += FileBytes(config.lm_config.model);
+
+  return ans;
+}
+
+#if SHERPA_ONNX_ENABLE_TTS == 1
+int64_t EstimateModelBytes(const OfflineTtsConfig &config) {
+  const OfflineTtsModelConfig &c = config.model;
+
+  int64_t ans = 0;
+  for (const std::string *f :
+       {&c.vits.model, &c.matcha.acoustic_model, &c.matcha.vocoder,
+        &c.kokoro.model, &c.kokoro.voices}) {
+    ans += FileBytes(*f);
+  }
+
+  return ans;
+}
+#endif
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,387 @@
+// sherpa-onnx/csrc/model-registry.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_MODEL_REGISTRY_H_
+#define SHERPA_ONNX_CSRC_MODEL_REGISTRY_H_
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+struct ModelRegistryConfig {
+  // Upper bound of the estimated memory of all loaded models. The least
+  // recently used idle models are unloaded to make room for a new one.
+  // 0 means no limit.
+  int32_t max_memory_mb = 0;
+
+  // Unload models that have not been used for this number of seconds.
+  // 0 means models are never unloaded for being idle.
+  float max_idle_seconds = 0;
+
+  ModelRegistryConfig() = default;
+
+  ModelRegistryConfig(int32_t max_memory_mb, float max_idle_seconds)
+      : max_memory_mb(max_memory_mb), max_idle_seconds(max_idle_seconds) {}
+
+  bool Validate() const;
+
+  std::string ToString() const;
+};
+
+struct OfflineRecognizerConfig;
+struct OfflineTtsConfig;
+
+/** Return the total size of the model files used by the given config.
+ *
+ * It is a rough estimate of the memory used by the loaded model.
+ */
+int64_t EstimateModelBytes(const OfflineRecognizerConfig &config);
+
+#if SHERPA_ONNX_ENABLE_TTS == 1
+int64_t EstimateModelBytes(const OfflineTtsConfig &config);
+#endif
+
+/** Create models on first use and unload them when they are idle or
+ * when the memory budget is exceeded, so that a process can serve more
+ * models, e.g., recognizers for different languages or TTS voices, than
+ * fit in memory at once.
+ *
+ * Model must be constructible from const Config &. For Config,
+ * EstimateModelBytes(const Config &) has to be declared; it is found by
+ * argument-dependent lookup.
+ *
+ * Get() returns a shared pointer. A model that is unloaded while a request
+ * still holds it is freed once the request releases it, so in-flight
+ * requests are never affected. Models that are in use are never unloaded
+ * to make room for other models.
+ *
+ * All methods are thread-safe. Concurrent Get() for a model that is not
+ * loaded yet load it only once. The memory of a model is reserved before
+ * loading it, so that models loaded in parallel do not exceed the budget
+ * together. Models are freed outside of the lock of the registry.
+ *
+ * Usage:
+ *
+ *   ModelRegistry<OfflineRecognizer, OfflineRecognizerConfig> registry(
+ *       registry_config);
+ *   registry.Add("en", en_config);
+ *   registry.Add("de", de_config);
+ *
+ *   auto recognizer = registry.Get("de");  // loads it on first use
+ */
+template <typename Model, typename Config>
+class ModelRegistry {
+ public:
+  explicit ModelRegistry(const ModelRegistryConfig &config) : config_(config) {
+    if (config_.max_idle_seconds > 0) {
+      evict_thread_ = std::thread([this]() { EvictIdleLoop(); });
+    }
+  }
+
+  ~ModelRegistry() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+
+    if (evict_thread_.joinable()) {
+      evict_thread_.join();
+    }
+  }
+
+  ModelRegistry(const ModelRegistry &) = delete;
+  ModelRegistry &operator=(const ModelRegistry &) = delete;
+
+  /** Register a model under the given name without loading it.
+   *
+   * @param name A unique name, e.g., the language.
+   * @param config To create the model.
+   * @return Return false if the name is already used.
+   */
+  bool Add(const std::string &name, const Config &config) {
+    return Add(name, config, EstimateModelBytes(config));
+  }
+
+  /** Like the above one, but with the given memory estimate in bytes. */
+  bool Add(const std::string &name, const Config &config, int64_t num_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.count(name)) {
+      SHERPA_ONNX_LOGE("Model '%s' has already been added", name.c_str());
+      return false;
+    }
+
+    Entry &entry = entries_[name];
+    entry.config = config;
+    entry.num_bytes = num_bytes;
+    entry.load_mutex = std::make_shared<std::mutex>();
+
+    return true;
+  }
+
+  bool Contains(const std::string &name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.count(name) != 0;
+  }
+
+  /** Return the model with the given name, loading it if needed.
+   *
+   * @return Return nullptr if no model with the given name was added.
+   */
+  std::shared_ptr<Model> Get(const std::string &name) {
+    std::shared_ptr<std::mutex> load_mutex;
+    const Config *config = nullptr;
+    int64_t num_bytes = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = entries_.find(name);
+      if (it == entries_.end()) {
+        SHERPA_ONNX_LOGE("Unknown model '%s'", name.c_str());
+        return nullptr;
+      }
+
+      Entry &entry = it->second;
+      entry.last_used = Clock::now();
+      if (entry.model) {
+        return entry.model;
+      }
+
+      load_mutex = entry.load_mutex;
+
+      // Entries are never removed, so it stays valid
+      config = &entry.config;
+      num_bytes = entry.num_bytes;
+    }
+
+    // So that concurrent requests for the same model load it only once.
+    // Other models can be loaded in parallel.
+    std::lock_guard<std::mutex> load_lock(*load_mutex);
+
+    std::vector<std::shared_ptr<Model>> unloaded;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      Entry &entry = entries_[name];
+      if (entry.model) {
+        return entry.model;
+      }
+
+      MakeRoomLocked(num_bytes, &unloaded);
+
+      // Reserve the memory before loading, so that other threads loading
+      // other models see it
+      loaded_bytes_ += num_bytes;
+    }
+
+    // Free the unloaded models before loading the new one
+    unloaded.clear();
+
+    if (config_.max_memory_mb > 0) {
+      SHERPA_ONNX_LOGE("Loading model '%s' (about %.1f MB)", name.c_str(),
+                       num_bytes / 1024. / 1024.);
+    }
+
+    std::shared_ptr<Model> model;
+    try {
+      model = std::make_shared<Model>(*config);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      loaded_bytes_ -= num_bytes;
+      throw;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry &entry = entries_[name];
+    entry.model = model;
+    entry.last_used = Clock::now();
+
+    return model;
+  }
+
+  /** Unload the model with the given name. Requests that are using it
+   * can continue; it is freed once they are done.
+   *
+   * @return Return true if the model was loaded.
+   */
+  bool Unload(const std::string &name) {
+    std::shared_ptr<Model> model;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = entries_.find(name);
+      if (it == entries_.end() || !it->second.model) {
+        return false;
+      }
+
+      model = UnloadLocked(&it->second);
+    }
+
+    // The model, if not in use, is freed here without holding the lock
+    return true;
+  }
+
+  /** Unload models that are not in use and have not been used for
+   * config.max_idle_seconds. It is called periodically by a background
+   * thread if config.max_idle_seconds > 0.
+   *
+   * @return Return the number of unloaded models.
+   */
+  int32_t EvictIdle() {
+    std::vector<std::shared_ptr<Model>> unloaded;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      EvictIdleLocked(&unloaded);
+    }
+
+    return static_cast<int32_t>(unloaded.size());
+  }
+
+  int32_t NumLoaded() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int32_t n = 0;
+    for (const auto &p : entries_) {
+      n += p.second.model != nullptr;
+    }
+    return n;
+  }
+
+  bool IsLoaded(const std::string &name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(name);
+    return it != entries_.end() && it->second.model != nullptr;
+  }
+
+  // Estimated memory of all loaded models in bytes
+  int64_t LoadedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return loaded_bytes_;
+  }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Entry {
+    Config config;
+    int64_t num_bytes = 0;
+
+    // nullptr if the model is not loaded
+    std::shared_ptr<Model> model;
+    Clock::time_point last_used;
+
+    std::shared_ptr<std::mutex> load_mutex;
+  };
+
+  static bool InUse(const Entry &entry) {
+    // The registry holds one reference
+    return entry.model.use_count() > 1;
+  }
+
+  // Return the model so that the caller can free it after releasing the
+  // lock; freeing a model takes a while
+  std::shared_ptr<Model> UnloadLocked(Entry *entry) {
+    loaded_bytes_ -= entry->num_bytes;
+    return std::move(entry->model);
+  }
+
+  // Unload the least recently used idle models until num_bytes more fit
+  // into the budget. If models in use take too much memory, the new model
+  // is loaded anyway. The unloaded models are appended to unloaded.
+  void MakeRoomLocked(int64_t num_bytes,
+                      std::vector<std::shared_ptr<Model>> *unloaded) {
+    if (config_.max_memory_mb <= 0) {
+      return;
+    }
+
+    int64_t budget = static_cast<int64_t>(config_.max_memory_mb) << 20;
+    while (loaded_bytes_ + num_bytes > budget) {
+      Entry *lru = nullptr;
+      for (auto &p : entries_) {
+        Entry &e = p.second;
+        if (!e.model || InUse(e)) {
+          continue;
+        }
+
+        if (!lru || e.last_used < lru->last_used) {
+          lru = &e;
+        }
+      }
+
+      if (!lru) {
+        SHERPA_ONNX_LOGE(
+            "Models in use or being loaded take %.1f MB. Loading another "
+            "one of %.1f MB exceeds max_memory_mb=%d",
+            loaded_bytes_ / 1024. / 1024., num_bytes / 1024. / 1024.,
+            config_.max_memory_mb);
+        return;
+      }
+
+      unloaded->push_back(UnloadLocked(lru));
+    }
+  }
+
+  void EvictIdleLocked(std::vector<std::shared_ptr<Model>> *unloaded) {
+    if (config_.max_idle_seconds <= 0) {
+      return;
+    }
+
+    auto deadline =
+        Clock::now() - std::chrono::duration_cast<Clock::duration>(
+                           std::chrono::duration<float>(
+                               config_.max_idle_seconds));
+
+    for (auto &p : entries_) {
+      Entry &e = p.second;
+      if (e.model && !InUse(e) && e.last_used < deadline) {
+        unloaded->push_back(UnloadLocked(&e));
+      }
+    }
+  }
+
+  void EvictIdleLoop() {
+    // Check a few times per idle period so that models are unloaded
+    // not much later than max_idle_seconds
+    auto interval = std::chrono::duration<float>(
+        std::max(config_.max_idle_seconds / 4, 0.1f));
+
+    std::vector<std::shared_ptr<Model>> unloaded;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+      cv_.wait_for(lock, interval);
+      if (!stop_) {
+        EvictIdleLocked(&unloaded);
+      }
+
+      if (!unloaded.empty()) {
+        lock.unlock();
+        unloaded.clear();
+        lock.lock();
+      }
+    }
+  }
+
+ private:
+  ModelRegistryConfig config_;
+
+  mutable std::mutex mutex_;
+  std::map<std::string, Entry> entries_;
+  int64_t loaded_bytes_ = 0;
+
+  std::condition_variable cv_;
+  bool stop_ = false;
+  std::thread evict_thread_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_MODEL_REGISTRY_H_
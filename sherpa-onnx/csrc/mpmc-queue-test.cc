@@ -0,0 +1,99 @@
+// sherpa-onnx/csrc/mpmc-queue-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/mpmc-queue.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(MpmcQueue, Basic) {
+  MpmcQueue<int32_t> q(3);
+  EXPECT_EQ(q.Capacity(), 4);
+
+  int32_t v = -1;
+  EXPECT_FALSE(q.TryPop(&v));
+
+  for (int32_t i = 0; i != 4; ++i) {
+    EXPECT_TRUE(q.TryPush(i));
+  }
+  EXPECT_FALSE(q.TryPush(4));
+
+  for (int32_t round = 0; round != 3; ++round) {
+    EXPECT_TRUE(q.TryPop(&v));
+    EXPECT_EQ(v, round);
+    EXPECT_TRUE(q.TryPush(round + 4));
+  }
+
+  for (int32_t i = 3; i != 7; ++i) {
+    EXPECT_TRUE(q.TryPop(&v));
+    EXPECT_EQ(v, i);
+  }
+  EXPECT_FALSE(q.TryPop(&v));
+}
+
+TEST(MpmcQueue, ReleaseValue) {
+  MpmcQueue<std::shared_ptr<int32_t>> q(4);
+  auto p = std::make_shared<int32_t>(10);
+  EXPECT_TRUE(q.TryPush(p));
+  EXPECT_EQ(p.use_count(), 2);
+
+  std::shared_ptr<int32_t> v;
+  EXPECT_TRUE(q.TryPop(&v));
+  EXPECT_EQ(*v, 10);
+  v.reset();
+
+  // The queue does not keep a reference to popped values
+  EXPECT_EQ(p.use_count(), 1);
+}
+
+TEST(MpmcQueue, MultiThreads) {
+  int32_t num_producers = 4;
+  int32_t num_consumers = 4;
+  int32_t n = 20000;
+
+  MpmcQueue<int32_t> q(64);
+  std::atomic<int64_t> sum{0};
+  std::atomic<int32_t> num_popped{0};
+
+  std::vector<std::thread> threads;
+  for (int32_t p = 0; p != num_producers; ++p) {
+    threads.emplace_back([&q, n, p]() {
+      for (int32_t i = 0; i != n; ++i) {
+        while (!q.TryPush(p * n + i)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  int32_t total = num_producers * n;
+  for (int32_t c = 0; c != num_consumers; ++c) {
+    threads.emplace_back([&]() {
+      int32_t v;
+      while (num_popped.load() < total) {
+        if (q.TryPop(&v)) {
+          sum += v;
+          ++num_popped;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  EXPECT_EQ(num_popped.load(), total);
+  EXPECT_EQ(sum.load(), static_cast<int64_t>(total) * (total - 1) / 2);
+}
+
+}  // namespace sherpa_onnx
@@ -5,44 +5,42 @@
 #include "sherpa-onnx/csrc/offline-fire-red-asr-greedy-search-decoder.h"
 
 #include <algorithm>
+#include <array>
+#include <numeric>
 #include <tuple>
 #include <utility>
+#include <vector>
 
+#include "sherpa-onnx/csrc/index-select.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 
 namespace sherpa_onnx {
 
-// Note: this functions works only for batch size == 1 at present
 std::vector<OfflineFireRedAsrDecoderResult>
 OfflineFireRedAsrGreedySearchDecoder::Decode(Ort::Value cross_k,
                                              Ort::Value cross_v) {
   const auto &meta_data = model_->GetModelMetadata();
 
-  auto memory_info =
-      Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+  // cross_k is of shape (num_decoder_layers, N, T, d_model)
+  int32_t batch_size = static_cast<int32_t>(
+      cross_k.GetTensorTypeAndShapeInfo().GetShape()[1]);
 
-  // For multilingual models, initial_tokens contains [sot, language, task]
-  //   - language is English by default
-  //   - task is transcribe by default
-  //
-  // For non-multilingual models, initial_tokens contains [sot]
-  std::array<int64_t, 2> token_shape = {1, 1};
-  int64_t token = meta_data.sos_id;
+  std::array<int64_t, 2> token_shape = {batch_size, 1};
+  Ort::Value tokens = Ort::Value::CreateTensor<int64_t>(
+      model_->Allocator(), token_shape.data(), token_shape.size());
 
-  int32_t batch_size = 1;
-
-  Ort::Value tokens = Ort::Value::CreateTensor(
-      memory_info, &token, 1, token_shape.data(), token_shape.size());
+  std::fill_n(tokens.GetTensorMutableData<int64_t>(), batch_size,
+              meta_data.sos_id);
 
   std::array<int64_t, 1> offset_shape{1};
   Ort::Value offset = Ort::Value::CreateTensor<int64_t>(
       model_->Allocator(), offset_shape.data(), offset_shape.size());
   *(offset.GetTensorMutableData<int64_t>()) = 0;
 
-  std::vector<OfflineFireRedAsrDecoderResult> ans(1);
+  std::vector<OfflineFireRedAsrDecoderResult> ans(batch_size);
 
-  auto self_kv_cache = model_->GetInitialSelfKVCache();
+  auto self_kv_cache = model_->GetInitialSelfKVCache(batch_size);
 
   std::tuple<Ort::Value, Ort::Value, Ort::Value, Ort::Value, Ort::Value,
              Ort::Value>
@@ -53,8 +51,20 @@ OfflineFireRedAsrGreedySearchDecoder::Decode(Ort::Value cross_k,
                      std::move(cross_v),
                      std::move(offset)};
 
+  // Utterances that are not finished yet. active[i] is the index of the
+  // utterance in row i of the current batch.
+  std::vector<int32_t> active(batch_size);
+  std::iota(active.begin(), active.end(), 0);
+
+  // Rows of the current batch to keep for the next step
+  std::vector<int32_t> keep;
+  keep.reserve(batch_size);
+
+  std::vector<int64_t> next_tokens;
+  next_tokens.reserve(batch_size);
+
   for (int32_t i = 0; i < meta_data.max_len; ++i) {
-    decoder_out = model_->ForwardDecoder(View(&tokens),
+    decoder_out = model_->ForwardDecoder(std::move(tokens),
                                          std::move(std::get<1>(decoder_out)),
                                          std::move(std::get<2>(decoder_out)),
                                          std::move(std::get<3>(decoder_out)),
@@ -67,17 +77,50 @@ OfflineFireRedAsrGreedySearchDecoder::Decode(Ort::Value cross_k,
     auto logits_shape = logits.GetTensorTypeAndShapeInfo().GetShape();
     int32_t vocab_size = logits_shape[2];
 
-    int32_t max_token_id = static_cast<int32_t>(std::distance(
-        p_logits, std::max_element(p_logits, p_logits + vocab_size)));
-    if (max_token_id == meta_data.eos_id) {
+    keep.clear();
+    next_tokens.clear();
+
+    for (int32_t k = 0; k != static_cast<int32_t>(active.size()); ++k) {
+      const float *p = p_logits + k * logits_shape[1] * vocab_size;
+
+      int32_t max_token_id = static_cast<int32_t>(
+          std::distance(p, std::max_element(p, p + vocab_size)));
+      if (max_token_id == meta_data.eos_id) {
+        continue;
+      }
+
+      ans[active[k]].tokens.push_back(max_token_id);
+
+      keep.push_back(k);
+      next_tokens.push_back(max_token_id);
+    }
+
+    if (keep.empty()) {
       break;
     }
 
-    ans[0].tokens.push_back(max_token_id);
+    if (keep.size() != active.size()) {
+      // Drop finished utterances from the batch so that they are not
+      // computed any longer
+      for (auto *v : {&std::get<1>(decoder_out), &std::get<2>(decoder_out),
+                      &std::get<3>(decoder_out), &std::get<4>(decoder_out)}) {
+        *v = IndexSelectDim1(model_->Allocator(), v, keep);
+      }
+
+      for (int32_t k = 0; k != static_cast<int32_t>(keep.size()); ++k) {
+        active[k] = active[keep[k]];
+      }
+      active.resize(keep.size());
+    }
+
+    token_shape[0] = static_cast<int64_t>(active.size());
+    tokens = Ort::Value::CreateTensor<int64_t>(
+        model_->Allocator(), token_shape.data(), token_shape.size());
 
-    token = max_token_id;
+    std::copy(next_tokens.begin(), next_tokens.end(),
+              tokens.GetTensorMutableData<int64_t>());
 
-    // increment offset
+    // All utterances share the offset, so they advance in lockstep
     *(std::get<5>(decoder_out).GetTensorMutableData<int64_t>()) += 1;
   }
 
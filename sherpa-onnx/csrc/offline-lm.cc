@@ -43,7 +43,7 @@ void OfflineLM::ComputeLMScore(float scale, int32_t context_size,
     num_hyps += h.Size();
     for (const auto &t : h) {
       max_token_seq =
-          std::max<int32_t>(max_token_seq, t.second.ys.size() - context_size);
+          std::max<int32_t>(max_token_seq, t.second.NumTokens() - context_size);
     }
   }
 
@@ -63,9 +63,9 @@ void OfflineLM::ComputeLMScore(float scale, int32_t context_size,
 
   for (const auto &h : *hyps) {
     for (const auto &t : h) {
-      const auto &ys = t.second.ys;
-      int32_t len = ys.size() - context_size;
-      std::copy(ys.begin() + context_size, ys.end(), p);
+      const auto &h = t.second;
+      int32_t len = h.NumTokens() - context_size;
+      h.GetTokens(context_size, h.NumTokens(), p);
       *p_lens = len;
 
       p += max_token_seq;
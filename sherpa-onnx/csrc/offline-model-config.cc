@@ -7,6 +7,7 @@
 
 #include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/model-precision.h"
 
 namespace sherpa_onnx {
 
@@ -53,6 +54,11 @@ void OfflineModelConfig::Register(ParseOptions *po) {
                "the log probability, you can get it from the directory where "
                "your bpe model is generated. Only used when hotwords provided "
                "and the modeling unit is bpe or cjkchar+bpe");
+
+  po->Register("precision", &precision,
+               "fp32, fp16, or int8. If not empty, use the model files in "
+               "this precision that are next to the given ones, e.g., "
+               "encoder.int8.onnx for encoder.onnx, if they exist");
 }
 
 bool OfflineModelConfig::Validate() const {
@@ -66,6 +72,12 @@ bool OfflineModelConfig::Validate() const {
     return false;
   }
 
+  if (!IsValidModelPrecision(precision)) {
+    SHERPA_ONNX_LOGE("Invalid precision: '%s'. Valid values: fp32, fp16, int8",
+                     precision.c_str());
+    return false;
+  }
+
   if (!modeling_unit.empty() &&
       (modeling_unit == "bpe" || modeling_unit == "cjkchar+bpe")) {
     if (!FileExists(bpe_vocab)) {
@@ -149,9 +161,27 @@ std::string OfflineModelConfig::ToString() const {
   os << "provider=\"" << provider << "\", ";
   os << "model_type=\"" << model_type << "\", ";
   os << "modeling_unit=\"" << modeling_unit << "\", ";
-  os << "bpe_vocab=\"" << bpe_vocab << "\")";
+  os << "bpe_vocab=\"" << bpe_vocab << "\", ";
+  os << "precision=\"" << precision << "\")";
 
   return os.str();
 }
 
+void OfflineModelConfig::ApplyPrecision() {
+  if (precision.empty()) {
+    return;
+  }
+
+  for (std::string *f :
+       {&transducer.encoder_filename, &transducer.decoder_filename,
+        &transducer.joiner_filename, &paraformer.model, &nemo_ctc.model,
+        &whisper.encoder, &whisper.decoder, &fire_red_asr.encoder,
+        &fire_red_asr.decoder, &tdnn.model, &zipformer_ctc.model,
+        &wenet_ctc.model, &sense_voice.model, &moonshine.preprocessor,
+        &moonshine.encoder, &moonshine.uncached_decoder,
+        &moonshine.cached_decoder, &dolphin.model, &telespeech_ctc}) {
+    *f = SelectModelPrecision(*f, precision);
+  }
+}
+
 }  // namespace sherpa_onnx
@@ -53,6 +53,12 @@ struct OfflineModelConfig {
   std::string modeling_unit = "cjkchar";
   std::string bpe_vocab;
 
+  // Precision of the model files to load: fp32, fp16, or int8. If the
+  // given files are in another precision, the ones in this precision
+  // next to them are used instead. Empty to use the given files.
+  // See ./model-precision.h
+  std::string precision;
+
   OfflineModelConfig() = default;
   OfflineModelConfig(const OfflineTransducerModelConfig &transducer,
                      const OfflineParaformerModelConfig &paraformer,
@@ -94,6 +100,10 @@ struct OfflineModelConfig {
   bool Validate() const;
 
   std::string ToString() const;
+
+  // Replace the model files with the ones in the given precision.
+  // It is a no-op if precision is empty.
+  void ApplyPrecision();
 };
 
 }  // namespace sherpa_onnx
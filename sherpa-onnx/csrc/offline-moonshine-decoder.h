@@ -22,7 +22,9 @@ class OfflineMoonshineDecoder {
 
   /** Run beam search given the output from the moonshine encoder model.
    *
-   * @param encoder_out A 3-D tensor of shape (batch_size, T, dim)
+   * @param encoder_out A 3-D tensor of shape (batch_size, T, dim). There
+   *                    is no padding, i.e., all utterances have T frames,
+   *                    since the decoder has no cross-attention mask.
    * @return Return a vector of size `N` containing the decoded results.
    */
   virtual std::vector<OfflineMoonshineDecoderResult> Decode(
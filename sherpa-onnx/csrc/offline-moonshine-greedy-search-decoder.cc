@@ -5,8 +5,12 @@
 #include "sherpa-onnx/csrc/offline-moonshine-greedy-search-decoder.h"
 
 #include <algorithm>
+#include <array>
+#include <numeric>
 #include <utility>
+#include <vector>
 
+#include "sherpa-onnx/csrc/index-select.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 
@@ -15,11 +19,7 @@ namespace sherpa_onnx {
 std::vector<OfflineMoonshineDecoderResult>
 OfflineMoonshineGreedySearchDecoder::Decode(Ort::Value encoder_out) {
   auto encoder_out_shape = encoder_out.GetTensorTypeAndShapeInfo().GetShape();
-  if (encoder_out_shape[0] != 1) {
-    SHERPA_ONNX_LOGE("Support only batch size == 1. Given: %d\n",
-                     static_cast<int32_t>(encoder_out_shape[0]));
-    return {};
-  }
+  int32_t batch_size = static_cast<int32_t>(encoder_out_shape[0]);
 
   auto memory_info =
       Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
@@ -34,15 +34,18 @@ OfflineMoonshineGreedySearchDecoder::Decode(Ort::Value encoder_out) {
 
   int32_t sos = 1;
   int32_t eos = 2;
+
+  // All utterances share seq_len, so they advance in lockstep
   int32_t seq_len = 1;
 
-  std::vector<int32_t> tokens;
+  std::vector<int32_t> next_tokens(batch_size, sos);
 
-  std::array<int64_t, 2> token_shape = {1, 1};
+  std::array<int64_t, 2> token_shape = {batch_size, 1};
   int64_t seq_len_shape = 1;
 
-  Ort::Value token_tensor = Ort::Value::CreateTensor(
-      memory_info, &sos, 1, token_shape.data(), token_shape.size());
+  Ort::Value token_tensor =
+      Ort::Value::CreateTensor(memory_info, next_tokens.data(), batch_size,
+                               token_shape.data(), token_shape.size());
 
   Ort::Value seq_len_tensor =
       Ort::Value::CreateTensor(memory_info, &seq_len, 1, &seq_len_shape, 1);
@@ -55,20 +58,68 @@ OfflineMoonshineGreedySearchDecoder::Decode(Ort::Value encoder_out) {
 
   int32_t vocab_size = logits.GetTensorTypeAndShapeInfo().GetShape()[2];
 
-  for (int32_t i = 0; i != max_len; ++i) {
-    const float *p = logits.GetTensorData<float>();
+  std::vector<OfflineMoonshineDecoderResult> ans(batch_size);
+
+  // Utterances that are not finished yet. active[i] is the index of the
+  // utterance in row i of the current batch.
+  std::vector<int32_t> active(batch_size);
+  std::iota(active.begin(), active.end(), 0);
+
+  // Rows of the current batch to keep for the next step
+  std::vector<int32_t> keep;
+  keep.reserve(batch_size);
+
+  while (true) {
+    const float *p_logits = logits.GetTensorData<float>();
+
+    keep.clear();
+    next_tokens.clear();
+
+    for (int32_t i = 0; i != static_cast<int32_t>(active.size()); ++i) {
+      int32_t b = active[i];
+      if (static_cast<int32_t>(ans[b].tokens.size()) >= max_len) {
+        continue;
+      }
+
+      const float *p = p_logits + i * vocab_size;
 
-    int32_t max_token_id = static_cast<int32_t>(
-        std::distance(p, std::max_element(p, p + vocab_size)));
-    if (max_token_id == eos) {
+      int32_t max_token_id = static_cast<int32_t>(
+          std::distance(p, std::max_element(p, p + vocab_size)));
+      if (max_token_id == eos) {
+        continue;
+      }
+
+      ans[b].tokens.push_back(max_token_id);
+
+      keep.push_back(i);
+      next_tokens.push_back(max_token_id);
+    }
+
+    if (keep.empty()) {
       break;
     }
-    tokens.push_back(max_token_id);
+
+    if (keep.size() != active.size()) {
+      // Drop finished utterances from the batch so that they are not
+      // computed any longer. The states are of shape (batch_size, ...)
+      encoder_out = IndexSelectDim0(model_->Allocator(), &encoder_out, keep);
+      for (auto &state : states) {
+        state = IndexSelectDim0(model_->Allocator(), &state, keep);
+      }
+
+      for (int32_t i = 0; i != static_cast<int32_t>(keep.size()); ++i) {
+        active[i] = active[keep[i]];
+      }
+      active.resize(keep.size());
+    }
 
     seq_len += 1;
 
-    token_tensor = Ort::Value::CreateTensor(
-        memory_info, &tokens.back(), 1, token_shape.data(), token_shape.size());
+    token_shape[0] = static_cast<int64_t>(active.size());
+    token_tensor =
+        Ort::Value::CreateTensor(memory_info, next_tokens.data(),
+                                 next_tokens.size(), token_shape.data(),
+                                 token_shape.size());
 
     seq_len_tensor =
         Ort::Value::CreateTensor(memory_info, &seq_len, 1, &seq_len_shape, 1);
@@ -84,10 +135,7 @@ OfflineMoonshineGreedySearchDecoder::Decode(Ort::Value encoder_out) {
         std::move(tmp_states));
   }
 
-  OfflineMoonshineDecoderResult ans;
-  ans.tokens = std::move(tokens);
-
-  return {ans};
+  return ans;
 }
 
 }  // namespace sherpa_onnx
@@ -89,6 +89,12 @@ class OfflineRecognizerCtcImpl : public OfflineRecognizerImpl {
     Init();
   }
 
+  std::unique_ptr<OfflineRecognizerImpl> Clone(
+      const OfflineRecognizerConfig &config) const override {
+    return std::unique_ptr<OfflineRecognizerImpl>(
+        new OfflineRecognizerCtcImpl(*this, config));
+  }
+
   void Init() {
     if (!config_.model_config.telespeech_ctc.empty()) {
       config_.feat_config.snip_edges = true;
@@ -230,10 +236,21 @@ class OfflineRecognizerCtcImpl : public OfflineRecognizerImpl {
 
     Ort::Value x = PadSequence(model_->Allocator(), features_pointer,
                                -23.025850929940457f);
-    auto t = model_->Forward(std::move(x), std::move(x_length));
+    PerfStats *stats = GetPerfStats().get();
+
+    std::vector<Ort::Value> t;
+    {
+      ScopedPerfTimer timer(stats, PerfStage::kEncoder);
+      t = model_->Forward(std::move(x), std::move(x_length));
+    }
 
-    auto results = decoder_->Decode(std::move(t[0]), std::move(t[1]));
+    std::vector<OfflineCtcDecoderResult> results;
+    {
+      ScopedPerfTimer timer(stats, PerfStage::kSearch);
+      results = decoder_->Decode(std::move(t[0]), std::move(t[1]));
+    }
 
+    ScopedPerfTimer timer(stats, PerfStage::kPostprocessing);
     int32_t frame_shift_ms = 10;
     for (int32_t i = 0; i != n; ++i) {
       auto r = Convert(results[i], symbol_table_, frame_shift_ms,
@@ -270,8 +287,21 @@ class OfflineRecognizerCtcImpl : public OfflineRecognizerImpl {
         Ort::Value::CreateTensor(memory_info, &x_length_scalar, 1,
                                  x_length_shape.data(), x_length_shape.size());
 
-    auto t = model_->Forward(std::move(x), std::move(x_length));
-    auto results = decoder_->Decode(std::move(t[0]), std::move(t[1]));
+    PerfStats *stats = GetPerfStats().get();
+
+    std::vector<Ort::Value> t;
+    {
+      ScopedPerfTimer timer(stats, PerfStage::kEncoder);
+      t = model_->Forward(std::move(x), std::move(x_length));
+    }
+
+    std::vector<OfflineCtcDecoderResult> results;
+    {
+      ScopedPerfTimer timer(stats, PerfStage::kSearch);
+      results = decoder_->Decode(std::move(t[0]), std::move(t[1]));
+    }
+
+    ScopedPerfTimer timer(stats, PerfStage::kPostprocessing);
     int32_t frame_shift_ms = 10;
 
     auto r = Convert(results[0], symbol_table_, frame_shift_ms,
@@ -280,10 +310,20 @@ class OfflineRecognizerCtcImpl : public OfflineRecognizerImpl {
     s->SetResult(r);
   }
 
+ private:
+  OfflineRecognizerCtcImpl(const OfflineRecognizerCtcImpl &other,
+                           const OfflineRecognizerConfig &config)
+      : OfflineRecognizerImpl(other, config),
+        config_(config),
+        symbol_table_(other.symbol_table_),
+        model_(other.model_) {
+    Init();
+  }
+
  private:
   OfflineRecognizerConfig config_;
   SymbolTable symbol_table_;
-  std::unique_ptr<OfflineCtcModel> model_;
+  std::shared_ptr<OfflineCtcModel> model_;
   std::unique_ptr<OfflineCtcDecoder> decoder_;
 };
 
@@ -6,12 +6,14 @@
 #define SHERPA_ONNX_CSRC_OFFLINE_RECOGNIZER_FIRE_RED_ASR_IMPL_H_
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "sherpa-onnx/csrc/bucket-by-length.h"
 #include "sherpa-onnx/csrc/offline-fire-red-asr-decoder.h"
 #include "sherpa-onnx/csrc/offline-fire-red-asr-greedy-search-decoder.h"
 #include "sherpa-onnx/csrc/offline-fire-red-asr-model.h"
@@ -51,7 +53,7 @@ class OfflineRecognizerFireRedAsrImpl : public OfflineRecognizerImpl {
       : OfflineRecognizerImpl(config),
         config_(config),
         symbol_table_(config_.model_config.tokens),
-        model_(std::make_unique<OfflineFireRedAsrModel>(config.model_config)) {
+        model_(std::make_shared<OfflineFireRedAsrModel>(config.model_config)) {
     Init();
   }
 
@@ -61,7 +63,7 @@ class OfflineRecognizerFireRedAsrImpl : public OfflineRecognizerImpl {
       : OfflineRecognizerImpl(mgr, config),
         config_(config),
         symbol_table_(mgr, config_.model_config.tokens),
-        model_(std::make_unique<OfflineFireRedAsrModel>(mgr,
+        model_(std::make_shared<OfflineFireRedAsrModel>(mgr,
                                                         config.model_config)) {
     Init();
   }
@@ -89,43 +91,97 @@ class OfflineRecognizerFireRedAsrImpl : public OfflineRecognizerImpl {
   }
 
   void DecodeStreams(OfflineStream **ss, int32_t n) const override {
-    // batch decoding is not implemented yet
+    if (n == 0) {
+      return;
+    }
+
+    // The decoder has no cross-attention mask, so padding would change the
+    // results of shorter utterances. Batch only utterances of the same
+    // length.
+    std::vector<int32_t> lengths(n);
     for (int32_t i = 0; i != n; ++i) {
-      DecodeStream(ss[i]);
+      lengths[i] = ss[i]->NumFrames();
     }
-  }
 
-  OfflineRecognizerConfig GetConfig() const override { return config_; }
+    auto groups = GroupByLength(lengths);
+    if (groups.size() > 1) {
+      std::vector<OfflineStream *> batch;
+      for (const auto &group : groups) {
+        batch.clear();
+        for (auto i : group) {
+          batch.push_back(ss[i]);
+        }
+
+        DecodeStreams(batch.data(), static_cast<int32_t>(batch.size()));
+      }
+      return;
+    }
+
+    int32_t feat_dim = ss[0]->FeatureDim();
+    int64_t num_frames = lengths[0];
+
+    std::array<int64_t, 3> shape{n, num_frames, feat_dim};
+
+    Ort::Value x = Ort::Value::CreateTensor<float>(
+        model_->Allocator(), shape.data(), shape.size());
+
+    float *p_x = x.GetTensorMutableData<float>();
+    for (int32_t i = 0; i != n; ++i) {
+      std::vector<float> features = ss[i]->GetFrames();
+      ApplyCMVN(&features);
+
+      std::copy(features.begin(), features.end(),
+                p_x + i * num_frames * feat_dim);
+    }
 
- private:
-  void DecodeStream(OfflineStream *s) const {
     auto memory_info =
         Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
 
-    int32_t feat_dim = s->FeatureDim();
-    std::vector<float> f = s->GetFrames();
-    ApplyCMVN(&f);
+    std::vector<int64_t> x_len_data(n, num_frames);
 
-    int64_t num_frames = f.size() / feat_dim;
+    int64_t len_shape = n;
+    Ort::Value x_len = Ort::Value::CreateTensor(
+        memory_info, x_len_data.data(), n, &len_shape, 1);
 
-    std::array<int64_t, 3> shape{1, num_frames, feat_dim};
+    PerfStats *stats = GetPerfStats().get();
 
-    Ort::Value x = Ort::Value::CreateTensor(memory_info, f.data(), f.size(),
-                                            shape.data(), shape.size());
+    auto cross_kv = [&]() {
+      ScopedPerfTimer timer(stats, PerfStage::kEncoder);
+      return model_->ForwardEncoder(std::move(x), std::move(x_len));
+    }();
 
-    int64_t len_shape = 1;
-    Ort::Value x_len =
-        Ort::Value::CreateTensor(memory_info, &num_frames, 1, &len_shape, 1);
+    std::vector<OfflineFireRedAsrDecoderResult> results;
+    {
+      ScopedPerfTimer timer(stats, PerfStage::kDecoder);
+      results = decoder_->Decode(std::move(cross_kv.first),
+                                 std::move(cross_kv.second));
+    }
 
-    auto cross_kv = model_->ForwardEncoder(std::move(x), std::move(x_len));
+    ScopedPerfTimer timer(stats, PerfStage::kPostprocessing);
+    for (int32_t i = 0; i != n; ++i) {
+      auto r = Convert(results[i], symbol_table_);
 
-    auto results =
-        decoder_->Decode(std::move(cross_kv.first), std::move(cross_kv.second));
+      r.text = ApplyInverseTextNormalization(std::move(r.text));
+      ss[i]->SetResult(r);
+    }
+  }
 
-    auto r = Convert(results[0], symbol_table_);
+  OfflineRecognizerConfig GetConfig() const override { return config_; }
 
-    r.text = ApplyInverseTextNormalization(std::move(r.text));
-    s->SetResult(r);
+  std::unique_ptr<OfflineRecognizerImpl> Clone(
+      const OfflineRecognizerConfig &config) const override {
+    return std::unique_ptr<OfflineRecognizerImpl>(
+        new OfflineRecognizerFireRedAsrImpl(*this, config));
+  }
+
+ private:
+  OfflineRecognizerFireRedAsrImpl(const OfflineRecognizerFireRedAsrImpl &other,
+                                  const OfflineRecognizerConfig &config)
+      : OfflineRecognizerImpl(other, config),
+        config_(config),
+        symbol_table_(other.symbol_table_),
+        model_(other.model_) {
+    Init();
   }
 
   void ApplyCMVN(std::vector<float> *v) const {
@@ -149,7 +205,7 @@ class OfflineRecognizerFireRedAsrImpl : public OfflineRecognizerImpl {
  private:
   OfflineRecognizerConfig config_;
   SymbolTable symbol_table_;
-  std::unique_ptr<OfflineFireRedAsrModel> model_;
+  std::shared_ptr<OfflineFireRedAsrModel> model_;
   std::unique_ptr<OfflineFireRedAsrDecoder> decoder_;
 };
 
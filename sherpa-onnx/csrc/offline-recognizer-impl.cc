@@ -32,6 +32,8 @@
 #include "sherpa-onnx/csrc/offline-recognizer-transducer-impl.h"
 #include "sherpa-onnx/csrc/offline-recognizer-transducer-nemo-impl.h"
 #include "sherpa-onnx/csrc/offline-recognizer-whisper-impl.h"
+#include "sherpa-onnx/csrc/ort-env.h"
+#include "sherpa-onnx/csrc/session.h"
 #include "sherpa-onnx/csrc/text-utils.h"
 
 namespace sherpa_onnx {
@@ -94,7 +96,7 @@ std::unique_ptr<OfflineRecognizerImpl> OfflineRecognizerImpl::Create(
     }
   }
 
-  Ort::Env env(ORT_LOGGING_LEVEL_ERROR);
+  Ort::Env &env = GetOrtEnv();
 
   Ort::SessionOptions sess_opts;
   sess_opts.SetIntraOpNumThreads(1);
@@ -122,10 +124,10 @@ std::unique_ptr<OfflineRecognizerImpl> OfflineRecognizerImpl::Create(
     exit(-1);
   }
 
-  auto buf = ReadFile(model_filename);
+  auto buf = MapFile(model_filename);
 
   auto encoder_sess =
-      std::make_unique<Ort::Session>(env, buf.data(), buf.size(), sess_opts);
+      CreateSession(env, buf.data(), buf.size(), sess_opts);
 
   Ort::ModelMetadata meta_data = encoder_sess->GetModelMetadata();
 
@@ -278,7 +280,7 @@ std::unique_ptr<OfflineRecognizerImpl> OfflineRecognizerImpl::Create(
     }
   }
 
-  Ort::Env env(ORT_LOGGING_LEVEL_ERROR);
+  Ort::Env &env = GetOrtEnv();
 
   Ort::SessionOptions sess_opts;
   sess_opts.SetIntraOpNumThreads(1);
@@ -309,7 +311,7 @@ std::unique_ptr<OfflineRecognizerImpl> OfflineRecognizerImpl::Create(
   auto buf = ReadFile(mgr, model_filename);
 
   auto encoder_sess =
-      std::make_unique<Ort::Session>(env, buf.data(), buf.size(), sess_opts);
+      CreateSession(env, buf.data(), buf.size(), sess_opts);
 
   Ort::ModelMetadata meta_data = encoder_sess->GetModelMetadata();
 
@@ -408,29 +410,44 @@ std::unique_ptr<OfflineRecognizerImpl> OfflineRecognizerImpl::Create(
 OfflineRecognizerImpl::OfflineRecognizerImpl(
     const OfflineRecognizerConfig &config)
     : config_(config) {
-  if (!config.rule_fsts.empty()) {
+  InitInverseTextNormalizers();
+}
+
+OfflineRecognizerImpl::OfflineRecognizerImpl(
+    const OfflineRecognizerImpl &other, const OfflineRecognizerConfig &config)
+    : config_(config) {
+  if (config.rule_fsts == other.config_.rule_fsts &&
+      config.rule_fars == other.config_.rule_fars) {
+    itn_list_ = other.itn_list_;
+  } else {
+    InitInverseTextNormalizers();
+  }
+}
+
+void OfflineRecognizerImpl::InitInverseTextNormalizers() {
+  if (!config_.rule_fsts.empty()) {
     std::vector<std::string> files;
-    SplitStringToVector(config.rule_fsts, ",", false, &files);
+    SplitStringToVector(config_.rule_fsts, ",", false, &files);
     itn_list_.reserve(files.size());
     for (const auto &f : files) {
-      if (config.model_config.debug) {
+      if (config_.model_config.debug) {
         SHERPA_ONNX_LOGE("rule fst: %s", f.c_str());
       }
       itn_list_.push_back(std::make_unique<kaldifst::TextNormalizer>(f));
     }
   }
 
-  if (!config.rule_fars.empty()) {
-    if (config.model_config.debug) {
+  if (!config_.rule_fars.empty()) {
+    if (config_.model_config.debug) {
       SHERPA_ONNX_LOGE("Loading FST archives");
     }
     std::vector<std::string> files;
-    SplitStringToVector(config.rule_fars, ",", false, &files);
+    SplitStringToVector(config_.rule_fars, ",", false, &files);
 
     itn_list_.reserve(files.size() + itn_list_.size());
 
     for (const auto &f : files) {
-      if (config.model_config.debug) {
+      if (config_.model_config.debug) {
         SHERPA_ONNX_LOGE("rule far: %s", f.c_str());
       }
       std::unique_ptr<fst::FarReader<fst::StdArc>> reader(
@@ -444,7 +461,7 @@ OfflineRecognizerImpl::OfflineRecognizerImpl(
       }
     }
 
-    if (config.model_config.debug) {
+    if (config_.model_config.debug) {
       SHERPA_ONNX_LOGE("FST archives loaded!");
     }
   }
@@ -510,6 +527,12 @@ std::string OfflineRecognizerImpl::ApplyInverseTextNormalization(
   return text;
 }
 
+std::unique_ptr<OfflineRecognizerImpl> OfflineRecognizerImpl::Clone(
+    const OfflineRecognizerConfig & /*config*/) const {
+  SHERPA_ONNX_LOGE("This model does not support Clone()");
+  return nullptr;
+}
+
 void OfflineRecognizerImpl::SetConfig(const OfflineRecognizerConfig &config) {
   config_ = config;
 }
@@ -13,6 +13,7 @@
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/offline-recognizer.h"
 #include "sherpa-onnx/csrc/offline-stream.h"
+#include "sherpa-onnx/csrc/perf-stats.h"
 
 namespace sherpa_onnx {
 
@@ -32,6 +33,18 @@ class OfflineRecognizerImpl {
 
   virtual ~OfflineRecognizerImpl() = default;
 
+  /** Create a recognizer that shares the models of this one, e.g., the
+   * onnxruntime sessions, but uses the decoding settings from config.
+   *
+   * Only the decoder, hotwords and inverse text normalization are built
+   * again. config.model_config should describe the same model as that of
+   * this recognizer; its file names, num_threads and provider are not used.
+   *
+   * Return nullptr if the model does not support it.
+   */
+  virtual std::unique_ptr<OfflineRecognizerImpl> Clone(
+      const OfflineRecognizerConfig &config) const;
+
   virtual std::unique_ptr<OfflineStream> CreateStream(
       const std::string &hotwords) const {
     SHERPA_ONNX_LOGE("Only transducer models support contextual biasing.");
@@ -48,12 +61,29 @@ class OfflineRecognizerImpl {
 
   std::string ApplyInverseTextNormalization(std::string text) const;
 
+  // Time spent in each stage. Streams created by this recognizer add
+  // the time of feature extraction to it.
+  const std::shared_ptr<PerfStats> &GetPerfStats() const {
+    return perf_stats_;
+  }
+
+ protected:
+  // Used by Clone() of subclasses. The inverse text normalizers of other
+  // are reused if config has the same rule_fsts and rule_fars.
+  OfflineRecognizerImpl(const OfflineRecognizerImpl &other,
+                        const OfflineRecognizerConfig &config);
+
  private:
+  void InitInverseTextNormalizers();
+
   OfflineRecognizerConfig config_;
   // for inverse text normalization. Used only if
   // config.rule_fsts is not empty or
   // config.rule_fars is not empty
-  std::vector<std::unique_ptr<kaldifst::TextNormalizer>> itn_list_;
+  std::vector<std::shared_ptr<kaldifst::TextNormalizer>> itn_list_;
+
+  // Not shared with clones
+  std::shared_ptr<PerfStats> perf_stats_ = std::make_shared<PerfStats>();
 };
 
 }  // namespace sherpa_onnx
@@ -6,12 +6,14 @@
 #define SHERPA_ONNX_CSRC_OFFLINE_RECOGNIZER_MOONSHINE_IMPL_H_
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "sherpa-onnx/csrc/bucket-by-length.h"
 #include "sherpa-onnx/csrc/offline-model-config.h"
 #include "sherpa-onnx/csrc/offline-moonshine-decoder.h"
 #include "sherpa-onnx/csrc/offline-moonshine-greedy-search-decoder.h"
@@ -50,7 +52,7 @@ class OfflineRecognizerMoonshineImpl : public OfflineRecognizerImpl {
       : OfflineRecognizerImpl(config),
         config_(config),
         symbol_table_(config_.model_config.tokens),
-        model_(std::make_unique<OfflineMoonshineModel>(config.model_config)) {
+        model_(std::make_shared<OfflineMoonshineModel>(config.model_config)) {
     Init();
   }
 
@@ -61,7 +63,7 @@ class OfflineRecognizerMoonshineImpl : public OfflineRecognizerImpl {
         config_(config),
         symbol_table_(mgr, config_.model_config.tokens),
         model_(
-            std::make_unique<OfflineMoonshineModel>(mgr, config.model_config)) {
+            std::make_shared<OfflineMoonshineModel>(mgr, config.model_config)) {
     Init();
   }
 
@@ -83,58 +85,114 @@ class OfflineRecognizerMoonshineImpl : public OfflineRecognizerImpl {
   }
 
   void DecodeStreams(OfflineStream **ss, int32_t n) const override {
-    // batch decoding is not implemented yet
+    if (n == 0) {
+      return;
+    }
+
+    // The decoder has no cross-attention mask, so padding would change the
+    // results of shorter utterances. Batch only utterances of the same
+    // length. Note that FeatureDim() is the number of samples for moonshine.
+    std::vector<int32_t> lengths(n);
     for (int32_t i = 0; i != n; ++i) {
-      DecodeStream(ss[i]);
+      lengths[i] = ss[i]->FeatureDim();
     }
-  }
 
-  OfflineRecognizerConfig GetConfig() const override { return config_; }
+    auto groups = GroupByLength(lengths);
+    if (groups.size() > 1) {
+      std::vector<OfflineStream *> batch;
+      for (const auto &group : groups) {
+        batch.clear();
+        for (auto i : group) {
+          batch.push_back(ss[i]);
+        }
+
+        DecodeStreams(batch.data(), static_cast<int32_t>(batch.size()));
+      }
+      return;
+    }
 
- private:
-  void DecodeStream(OfflineStream *s) const {
-    auto memory_info =
-        Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+    int32_t num_samples = lengths[0];
 
-    std::vector<float> audio = s->GetFrames();
+    std::array<int64_t, 2> shape{n, num_samples};
 
     try {
-      std::array<int64_t, 2> shape{1, static_cast<int64_t>(audio.size())};
+      Ort::Value audio_tensor = Ort::Value::CreateTensor<float>(
+          model_->Allocator(), shape.data(), shape.size());
+
+      float *p_audio = audio_tensor.GetTensorMutableData<float>();
+      for (int32_t i = 0; i != n; ++i) {
+        std::vector<float> audio = ss[i]->GetFrames();
+        std::copy(audio.begin(), audio.end(), p_audio + i * num_samples);
+      }
+
+      PerfStats *stats = GetPerfStats().get();
+
+      Ort::Value encoder_out{nullptr};
+      {
+        ScopedPerfTimer timer(stats, PerfStage::kEncoder);
 
-      Ort::Value audio_tensor = Ort::Value::CreateTensor(
-          memory_info, audio.data(), audio.size(), shape.data(), shape.size());
+        Ort::Value features =
+            model_->ForwardPreprocessor(std::move(audio_tensor));
 
-      Ort::Value features =
-          model_->ForwardPreprocessor(std::move(audio_tensor));
+        // All utterances have the same number of frames
+        std::vector<int32_t> features_len(
+            n, features.GetTensorTypeAndShapeInfo().GetShape()[1]);
 
-      int32_t features_len = features.GetTensorTypeAndShapeInfo().GetShape()[1];
+        auto memory_info =
+            Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
 
-      int64_t features_shape = 1;
+        int64_t features_shape = n;
 
-      Ort::Value features_len_tensor = Ort::Value::CreateTensor(
-          memory_info, &features_len, 1, &features_shape, 1);
+        Ort::Value features_len_tensor = Ort::Value::CreateTensor(
+            memory_info, features_len.data(), n, &features_shape, 1);
 
-      Ort::Value encoder_out = model_->ForwardEncoder(
-          std::move(features), std::move(features_len_tensor));
+        encoder_out = model_->ForwardEncoder(std::move(features),
+                                             std::move(features_len_tensor));
+      }
 
-      auto results = decoder_->Decode(std::move(encoder_out));
+      std::vector<OfflineMoonshineDecoderResult> results;
+      {
+        ScopedPerfTimer timer(stats, PerfStage::kDecoder);
+        results = decoder_->Decode(std::move(encoder_out));
+      }
 
-      auto r = Convert(results[0], symbol_table_);
-      r.text = ApplyInverseTextNormalization(std::move(r.text));
-      s->SetResult(r);
+      ScopedPerfTimer timer(stats, PerfStage::kPostprocessing);
+      for (int32_t i = 0; i != n; ++i) {
+        auto r = Convert(results[i], symbol_table_);
+        r.text = ApplyInverseTextNormalization(std::move(r.text));
+        ss[i]->SetResult(r);
+      }
     } catch (const Ort::Exception &ex) {
       SHERPA_ONNX_LOGE(
           "\n\nCaught exception:\n\n%s\n\nReturn an empty result. Number of "
-          "audio samples: %d",
-          ex.what(), static_cast<int32_t>(audio.size()));
+          "streams: %d, number of audio samples: %d",
+          ex.what(), n, num_samples);
       return;
     }
   }
 
+  OfflineRecognizerConfig GetConfig() const override { return config_; }
+
+  std::unique_ptr<OfflineRecognizerImpl> Clone(
+      const OfflineRecognizerConfig &config) const override {
+    return std::unique_ptr<OfflineRecognizerImpl>(
+        new OfflineRecognizerMoonshineImpl(*this, config));
+  }
+
+ private:
+  OfflineRecognizerMoonshineImpl(const OfflineRecognizerMoonshineImpl &other,
+                                 const OfflineRecognizerConfig &config)
+      : OfflineRecognizerImpl(other, config),
+        config_(config),
+        symbol_table_(other.symbol_table_),
+        model_(other.model_) {
+    Init();
+  }
+
  private:
   OfflineRecognizerConfig config_;
   SymbolTable symbol_table_;
-  std::unique_ptr<OfflineMoonshineModel> model_;
+  std::shared_ptr<OfflineMoonshineModel> model_;
   std::unique_ptr<OfflineMoonshineDecoder> decoder_;
 };
 
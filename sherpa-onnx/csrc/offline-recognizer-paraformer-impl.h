@@ -87,15 +87,8 @@ class OfflineRecognizerParaformerImpl : public OfflineRecognizerImpl {
       : OfflineRecognizerImpl(config),
         config_(config),
         symbol_table_(config_.model_config.tokens),
-        model_(std::make_unique<OfflineParaformerModel>(config.model_config)) {
-    if (config.decoding_method == "greedy_search") {
-      int32_t eos_id = symbol_table_["</s>"];
-      decoder_ = std::make_unique<OfflineParaformerGreedySearchDecoder>(eos_id);
-    } else {
-      SHERPA_ONNX_LOGE("Only greedy_search is supported at present. Given %s",
-                       config.decoding_method.c_str());
-      exit(-1);
-    }
+        model_(std::make_shared<OfflineParaformerModel>(config.model_config)) {
+    InitDecoder();
 
     InitFeatConfig();
   }
@@ -106,16 +99,9 @@ class OfflineRecognizerParaformerImpl : public OfflineRecognizerImpl {
       : OfflineRecognizerImpl(mgr, config),
         config_(config),
         symbol_table_(mgr, config_.model_config.tokens),
-        model_(std::make_unique<OfflineParaformerModel>(mgr,
+        model_(std::make_shared<OfflineParaformerModel>(mgr,
                                                         config.model_config)) {
-    if (config.decoding_method == "greedy_search") {
-      int32_t eos_id = symbol_table_["</s>"];
-      decoder_ = std::make_unique<OfflineParaformerGreedySearchDecoder>(eos_id);
-    } else {
-      SHERPA_ONNX_LOGE("Only greedy_search is supported at present. Given %s",
-                       config.decoding_method.c_str());
-      exit(-1);
-    }
+    InitDecoder();
 
     InitFeatConfig();
   }
@@ -203,7 +189,34 @@ class OfflineRecognizerParaformerImpl : public OfflineRecognizerImpl {
 
   OfflineRecognizerConfig GetConfig() const override { return config_; }
 
+  std::unique_ptr<OfflineRecognizerImpl> Clone(
+      const OfflineRecognizerConfig &config) const override {
+    return std::unique_ptr<OfflineRecognizerImpl>(
+        new OfflineRecognizerParaformerImpl(*this, config));
+  }
+
  private:
+  OfflineRecognizerParaformerImpl(const OfflineRecognizerParaformerImpl &other,
+                                  const OfflineRecognizerConfig &config)
+      : OfflineRecognizerImpl(other, config),
+        config_(config),
+        symbol_table_(other.symbol_table_),
+        model_(other.model_) {
+    InitDecoder();
+    InitFeatConfig();
+  }
+
+  void InitDecoder() {
+    if (config_.decoding_method == "greedy_search") {
+      int32_t eos_id = symbol_table_["</s>"];
+      decoder_ = std::make_unique<OfflineParaformerGreedySearchDecoder>(eos_id);
+    } else {
+      SHERPA_ONNX_LOGE("Only greedy_search is supported at present. Given %s",
+                       config_.decoding_method.c_str());
+      exit(-1);
+    }
+  }
+
   void InitFeatConfig() {
     // Paraformer models assume input samples are in the range
     // [-32768, 32767], so we set normalize_samples to false
@@ -258,7 +271,7 @@ class OfflineRecognizerParaformerImpl : public OfflineRecognizerImpl {
 
   OfflineRecognizerConfig config_;
   SymbolTable symbol_table_;
-  std::unique_ptr<OfflineParaformerModel> model_;
+  std::shared_ptr<OfflineParaformerModel> model_;
   std::unique_ptr<OfflineParaformerDecoder> decoder_;
 };
 
@@ -64,16 +64,8 @@ class OfflineRecognizerSenseVoiceImpl : public OfflineRecognizerImpl {
       : OfflineRecognizerImpl(config),
         config_(config),
         symbol_table_(config_.model_config.tokens),
-        model_(std::make_unique<OfflineSenseVoiceModel>(config.model_config)) {
-    const auto &meta_data = model_->GetModelMetadata();
-    if (config.decoding_method == "greedy_search") {
-      decoder_ =
-          std::make_unique<OfflineCtcGreedySearchDecoder>(meta_data.blank_id);
-    } else {
-      SHERPA_ONNX_LOGE("Only greedy_search is supported at present. Given %s",
-                       config.decoding_method.c_str());
-      exit(-1);
-    }
+        model_(std::make_shared<OfflineSenseVoiceModel>(config.model_config)) {
+    InitDecoder();
 
     InitFeatConfig();
   }
@@ -84,17 +76,9 @@ class OfflineRecognizerSenseVoiceImpl : public OfflineRecognizerImpl {
       : OfflineRecognizerImpl(mgr, config),
         config_(config),
         symbol_table_(mgr, config_.model_config.tokens),
-        model_(std::make_unique<OfflineSenseVoiceModel>(mgr,
+        model_(std::make_shared<OfflineSenseVoiceModel>(mgr,
                                                         config.model_config)) {
-    const auto &meta_data = model_->GetModelMetadata();
-    if (config.decoding_method == "greedy_search") {
-      decoder_ =
-          std::make_unique<OfflineCtcGreedySearchDecoder>(meta_data.blank_id);
-    } else {
-      SHERPA_ONNX_LOGE("Only greedy_search is supported at present. Given %s",
-                       config.decoding_method.c_str());
-      exit(-1);
-    }
+    InitDecoder();
 
     InitFeatConfig();
   }
@@ -228,7 +212,35 @@ class OfflineRecognizerSenseVoiceImpl : public OfflineRecognizerImpl {
 
   OfflineRecognizerConfig GetConfig() const override { return config_; }
 
+  std::unique_ptr<OfflineRecognizerImpl> Clone(
+      const OfflineRecognizerConfig &config) const override {
+    return std::unique_ptr<OfflineRecognizerImpl>(
+        new OfflineRecognizerSenseVoiceImpl(*this, config));
+  }
+
  private:
+  OfflineRecognizerSenseVoiceImpl(const OfflineRecognizerSenseVoiceImpl &other,
+                                  const OfflineRecognizerConfig &config)
+      : OfflineRecognizerImpl(other, config),
+        config_(config),
+        symbol_table_(other.symbol_table_),
+        model_(other.model_) {
+    InitDecoder();
+    InitFeatConfig();
+  }
+
+  void InitDecoder() {
+    const auto &meta_data = model_->GetModelMetadata();
+    if (config_.decoding_method == "greedy_search") {
+      decoder_ =
+          std::make_unique<OfflineCtcGreedySearchDecoder>(meta_data.blank_id);
+    } else {
+      SHERPA_ONNX_LOGE("Only greedy_search is supported at present. Given %s",
+                       config_.decoding_method.c_str());
+      exit(-1);
+    }
+  }
+
   void DecodeOneStream(OfflineStream *s) const {
     const auto &meta_data = model_->GetModelMetadata();
 
@@ -355,7 +367,7 @@ class OfflineRecognizerSenseVoiceImpl : public OfflineRecognizerImpl {
 
   OfflineRecognizerConfig config_;
   SymbolTable symbol_table_;
-  std::unique_ptr<OfflineSenseVoiceModel> model_;
+  std::shared_ptr<OfflineSenseVoiceModel> model_;
   std::unique_ptr<OfflineCtcDecoder> decoder_;
 };
 
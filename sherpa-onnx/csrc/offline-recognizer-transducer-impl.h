@@ -76,36 +76,12 @@ class OfflineRecognizerTransducerImpl : public OfflineRecognizerImpl {
       : OfflineRecognizerImpl(config),
         config_(config),
         symbol_table_(config_.model_config.tokens),
-        model_(std::make_unique<OfflineTransducerModel>(config_.model_config)) {
+        model_(std::make_shared<OfflineTransducerModel>(config_.model_config)) {
     if (symbol_table_.Contains("<unk>")) {
       unk_id_ = symbol_table_["<unk>"];
     }
 
-    if (config_.decoding_method == "greedy_search") {
-      decoder_ = std::make_unique<OfflineTransducerGreedySearchDecoder>(
-          model_.get(), unk_id_, config_.blank_penalty);
-    } else if (config_.decoding_method == "modified_beam_search") {
-      if (!config_.lm_config.model.empty()) {
-        lm_ = OfflineLM::Create(config.lm_config);
-      }
-
-      if (!config_.model_config.bpe_vocab.empty()) {
-        bpe_encoder_ = std::make_unique<ssentencepiece::Ssentencepiece>(
-            config_.model_config.bpe_vocab);
-      }
-
-      if (!config_.hotwords_file.empty()) {
-        InitHotwords();
-      }
-
-      decoder_ = std::make_unique<OfflineTransducerModifiedBeamSearchDecoder>(
-          model_.get(), lm_.get(), config_.max_active_paths,
-          config_.lm_config.scale, unk_id_, config_.blank_penalty);
-    } else {
-      SHERPA_ONNX_LOGE("Unsupported decoding method: %s",
-                       config_.decoding_method.c_str());
-      exit(-1);
-    }
+    InitDecoder();
   }
 
   template <typename Manager>
@@ -114,7 +90,7 @@ class OfflineRecognizerTransducerImpl : public OfflineRecognizerImpl {
       : OfflineRecognizerImpl(mgr, config),
         config_(config),
         symbol_table_(mgr, config_.model_config.tokens),
-        model_(std::make_unique<OfflineTransducerModel>(mgr,
+        model_(std::make_shared<OfflineTransducerModel>(mgr,
                                                         config_.model_config)) {
     if (symbol_table_.Contains("<unk>")) {
       unk_id_ = symbol_table_["<unk>"];
@@ -146,6 +122,14 @@ class OfflineRecognizerTransducerImpl : public OfflineRecognizerImpl {
                        config_.decoding_method.c_str());
       exit(-1);
     }
+
+    decoder_->SetPerfStats(GetPerfStats().get());
+  }
+
+  std::unique_ptr<OfflineRecognizerImpl> Clone(
+      const OfflineRecognizerConfig &config) const override {
+    return std::unique_ptr<OfflineRecognizerImpl>(
+        new OfflineRecognizerTransducerImpl(*this, config));
   }
 
   std::unique_ptr<OfflineStream> CreateStream(
@@ -230,10 +214,22 @@ class OfflineRecognizerTransducerImpl : public OfflineRecognizerImpl {
     Ort::Value x = PadSequence(model_->Allocator(), features_pointer,
                                -23.025850929940457f);
 
-    auto t = model_->RunEncoder(std::move(x), std::move(x_length));
-    auto results =
-        decoder_->Decode(std::move(t.first), std::move(t.second), ss, n);
+    PerfStats *stats = GetPerfStats().get();
+
+    auto t = [&]() {
+      ScopedPerfTimer timer(stats, PerfStage::kEncoder);
+      return model_->RunEncoder(std::move(x), std::move(x_length));
+    }();
 
+    std::vector<OfflineTransducerDecoderResult> results;
+    {
+      // It includes the time of the decoder and the joiner
+      ScopedPerfTimer timer(stats, PerfStage::kSearch);
+      results =
+          decoder_->Decode(std::move(t.first), std::move(t.second), ss, n);
+    }
+
+    ScopedPerfTimer timer(stats, PerfStage::kPostprocessing);
     int32_t frame_shift_ms = 10;
     for (int32_t i = 0; i != n; ++i) {
       auto r = Convert(results[i], symbol_table_, frame_shift_ms,
@@ -290,6 +286,51 @@ class OfflineRecognizerTransducerImpl : public OfflineRecognizerImpl {
         hotwords_, config_.hotwords_score, boost_scores_);
   }
 
+ private:
+  OfflineRecognizerTransducerImpl(const OfflineRecognizerTransducerImpl &other,
+                                  const OfflineRecognizerConfig &config)
+      : OfflineRecognizerImpl(other, config),
+        config_(config),
+        symbol_table_(other.symbol_table_),
+        model_(other.model_),
+        unk_id_(other.unk_id_) {
+    if (config_.lm_config.model == other.config_.lm_config.model) {
+      lm_ = other.lm_;
+    }
+
+    InitDecoder();
+  }
+
+  void InitDecoder() {
+    if (config_.decoding_method == "greedy_search") {
+      decoder_ = std::make_unique<OfflineTransducerGreedySearchDecoder>(
+          model_.get(), unk_id_, config_.blank_penalty);
+    } else if (config_.decoding_method == "modified_beam_search") {
+      if (!lm_ && !config_.lm_config.model.empty()) {
+        lm_ = OfflineLM::Create(config_.lm_config);
+      }
+
+      if (!config_.model_config.bpe_vocab.empty()) {
+        bpe_encoder_ = std::make_unique<ssentencepiece::Ssentencepiece>(
+            config_.model_config.bpe_vocab);
+      }
+
+      if (!config_.hotwords_file.empty()) {
+        InitHotwords();
+      }
+
+      decoder_ = std::make_unique<OfflineTransducerModifiedBeamSearchDecoder>(
+          model_.get(), lm_.get(), config_.max_active_paths,
+          config_.lm_config.scale, unk_id_, config_.blank_penalty);
+    } else {
+      SHERPA_ONNX_LOGE("Unsupported decoding method: %s",
+                       config_.decoding_method.c_str());
+      exit(-1);
+    }
+
+    decoder_->SetPerfStats(GetPerfStats().get());
+  }
+
  private:
   OfflineRecognizerConfig config_;
   SymbolTable symbol_table_;
@@ -297,9 +338,9 @@ class OfflineRecognizerTransducerImpl : public OfflineRecognizerImpl {
   std::vector<float> boost_scores_;
   ContextGraphPtr hotwords_graph_;
   std::unique_ptr<ssentencepiece::Ssentencepiece> bpe_encoder_;
-  std::unique_ptr<OfflineTransducerModel> model_;
+  std::shared_ptr<OfflineTransducerModel> model_;
   std::unique_ptr<OfflineTransducerDecoder> decoder_;
-  std::unique_ptr<OfflineLM> lm_;
+  std::shared_ptr<OfflineLM> lm_;
   int32_t unk_id_ = -1;
 };
 
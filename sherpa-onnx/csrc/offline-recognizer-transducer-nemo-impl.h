@@ -39,16 +39,9 @@ class OfflineRecognizerTransducerNeMoImpl : public OfflineRecognizerImpl {
       : OfflineRecognizerImpl(config),
         config_(config),
         symbol_table_(config_.model_config.tokens),
-        model_(std::make_unique<OfflineTransducerNeMoModel>(
+        model_(std::make_shared<OfflineTransducerNeMoModel>(
             config_.model_config)) {
-    if (config_.decoding_method == "greedy_search") {
-      decoder_ = std::make_unique<OfflineTransducerGreedySearchNeMoDecoder>(
-          model_.get(), config_.blank_penalty);
-    } else {
-      SHERPA_ONNX_LOGE("Unsupported decoding method: %s",
-                       config_.decoding_method.c_str());
-      exit(-1);
-    }
+    InitDecoder();
     PostInit();
   }
 
@@ -58,16 +51,9 @@ class OfflineRecognizerTransducerNeMoImpl : public OfflineRecognizerImpl {
       : OfflineRecognizerImpl(mgr, config),
         config_(config),
         symbol_table_(mgr, config_.model_config.tokens),
-        model_(std::make_unique<OfflineTransducerNeMoModel>(
+        model_(std::make_shared<OfflineTransducerNeMoModel>(
             mgr, config_.model_config)) {
-    if (config_.decoding_method == "greedy_search") {
-      decoder_ = std::make_unique<OfflineTransducerGreedySearchNeMoDecoder>(
-          model_.get(), config_.blank_penalty);
-    } else {
-      SHERPA_ONNX_LOGE("Unsupported decoding method: %s",
-                       config_.decoding_method.c_str());
-      exit(-1);
-    }
+    InitDecoder();
 
     PostInit();
   }
@@ -135,7 +121,35 @@ class OfflineRecognizerTransducerNeMoImpl : public OfflineRecognizerImpl {
 
   OfflineRecognizerConfig GetConfig() const override { return config_; }
 
+  std::unique_ptr<OfflineRecognizerImpl> Clone(
+      const OfflineRecognizerConfig &config) const override {
+    return std::unique_ptr<OfflineRecognizerImpl>(
+        new OfflineRecognizerTransducerNeMoImpl(*this, config));
+  }
+
  private:
+  OfflineRecognizerTransducerNeMoImpl(
+      const OfflineRecognizerTransducerNeMoImpl &other,
+      const OfflineRecognizerConfig &config)
+      : OfflineRecognizerImpl(other, config),
+        config_(config),
+        symbol_table_(other.symbol_table_),
+        model_(other.model_) {
+    InitDecoder();
+    PostInit();
+  }
+
+  void InitDecoder() {
+    if (config_.decoding_method == "greedy_search") {
+      decoder_ = std::make_unique<OfflineTransducerGreedySearchNeMoDecoder>(
+          model_.get(), config_.blank_penalty);
+    } else {
+      SHERPA_ONNX_LOGE("Unsupported decoding method: %s",
+                       config_.decoding_method.c_str());
+      exit(-1);
+    }
+  }
+
   void PostInit() {
     config_.feat_config.nemo_normalize_type =
         model_->FeatureNormalizationMethod();
@@ -180,7 +194,7 @@ class OfflineRecognizerTransducerNeMoImpl : public OfflineRecognizerImpl {
  private:
   OfflineRecognizerConfig config_;
   SymbolTable symbol_table_;
-  std::unique_ptr<OfflineTransducerNeMoModel> model_;
+  std::shared_ptr<OfflineTransducerNeMoModel> model_;
   std::unique_ptr<OfflineTransducerDecoder> decoder_;
 };
 
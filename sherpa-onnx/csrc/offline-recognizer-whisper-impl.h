@@ -12,12 +12,14 @@
 #include <utility>
 #include <vector>
 
+#include "sherpa-onnx/csrc/bucket-by-length.h"
 #include "sherpa-onnx/csrc/offline-model-config.h"
 #include "sherpa-onnx/csrc/offline-recognizer-impl.h"
 #include "sherpa-onnx/csrc/offline-recognizer.h"
 #include "sherpa-onnx/csrc/offline-whisper-decoder.h"
 #include "sherpa-onnx/csrc/offline-whisper-greedy-search-decoder.h"
 #include "sherpa-onnx/csrc/offline-whisper-model.h"
+#include "sherpa-onnx/csrc/offline-whisper-modified-beam-search-decoder.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
 #include "sherpa-onnx/csrc/transpose.h"
 
@@ -29,7 +31,7 @@ class OfflineRecognizerWhisperImpl : public OfflineRecognizerImpl {
       : OfflineRecognizerImpl(config),
         config_(config),
         symbol_table_(config_.model_config.tokens),
-        model_(std::make_unique<OfflineWhisperModel>(config.model_config)) {
+        model_(std::make_shared<OfflineWhisperModel>(config.model_config)) {
     Init();
   }
 
@@ -40,7 +42,7 @@ class OfflineRecognizerWhisperImpl : public OfflineRecognizerImpl {
         config_(config),
         symbol_table_(mgr, config_.model_config.tokens),
         model_(
-            std::make_unique<OfflineWhisperModel>(mgr, config.model_config)) {
+            std::make_shared<OfflineWhisperModel>(mgr, config.model_config)) {
     Init();
   }
 
@@ -48,12 +50,21 @@ class OfflineRecognizerWhisperImpl : public OfflineRecognizerImpl {
     // tokens.txt from whisper is base64 encoded, so we need to decode it
     symbol_table_.ApplyBase64Decode();
 
+    InitDecoder();
+  }
+
+  void InitDecoder() {
     if (config_.decoding_method == "greedy_search") {
       decoder_ = std::make_unique<OfflineWhisperGreedySearchDecoder>(
           config_.model_config.whisper, model_.get());
+    } else if (config_.decoding_method == "modified_beam_search") {
+      decoder_ = std::make_unique<OfflineWhisperModifiedBeamSearchDecoder>(
+          config_.model_config.whisper, model_.get(),
+          config_.max_active_paths);
     } else {
       SHERPA_ONNX_LOGE(
-          "Only greedy_search is supported at present for whisper. Given %s",
+          "Only greedy_search and modified_beam_search are supported at "
+          "present for whisper. Given %s",
           config_.decoding_method.c_str());
       exit(-1);
     }
@@ -66,39 +77,13 @@ class OfflineRecognizerWhisperImpl : public OfflineRecognizerImpl {
   }
 
   void DecodeStreams(OfflineStream **ss, int32_t n) const override {
-    // batch decoding is not implemented yet
-    for (int32_t i = 0; i != n; ++i) {
-      DecodeStream(ss[i]);
+    if (n == 0) {
+      return;
     }
-  }
 
-  void SetConfig(const OfflineRecognizerConfig &config) override {
-    config_.model_config.whisper = config.model_config.whisper;
-  }
-
-  OfflineRecognizerConfig GetConfig() const override { return config_; }
-
- private:
-  void DecodeStream(OfflineStream *s) const {
     decoder_->SetConfig(config_.model_config.whisper);
 
     int32_t max_num_frames = 3000;
-    auto memory_info =
-        Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
-
-    int32_t feat_dim = s->FeatureDim();
-    std::vector<float> f = s->GetFrames();
-    int32_t num_frames = f.size() / feat_dim;
-
-    // we use 50 here so that there will be some zero tail paddings
-    if (num_frames >= max_num_frames - 50) {
-      SHERPA_ONNX_LOGE(
-          "Only waves less than 30 seconds are supported. We process only the "
-          "first 30 seconds and discard the remaining data");
-      num_frames = max_num_frames - 50;
-    }
-
-    model_->NormalizeFeatures(f.data(), num_frames, feat_dim);
 
     // note that 1000 is an experience-value.
     // You can replace 1000 by other values, say, 100.
@@ -111,41 +96,135 @@ class OfflineRecognizerWhisperImpl : public OfflineRecognizerImpl {
       tail_padding_frames = config_.model_config.whisper.tail_paddings;
     }
 
-    int32_t actual_frames =
-        std::min(num_frames + tail_padding_frames, max_num_frames);
+    // The decoder has no cross-attention mask, so extra zero paddings
+    // would change the results of shorter utterances. Batch only
+    // utterances with the same number of frames after tail padding.
+    // See below for the 50.
+    std::vector<int32_t> padded_frames(n);
+    for (int32_t i = 0; i != n; ++i) {
+      int32_t num_frames = std::min(ss[i]->NumFrames(), max_num_frames - 50);
+      padded_frames[i] =
+          std::min(num_frames + tail_padding_frames, max_num_frames);
+    }
+
+    auto groups = GroupByLength(padded_frames);
+    if (groups.size() > 1) {
+      std::vector<OfflineStream *> batch;
+      for (const auto &group : groups) {
+        batch.clear();
+        for (auto i : group) {
+          batch.push_back(ss[i]);
+        }
+
+        DecodeStreams(batch.data(), static_cast<int32_t>(batch.size()));
+      }
+      return;
+    }
+
+    int32_t actual_frames = padded_frames[0];
+
+    int32_t feat_dim = ss[0]->FeatureDim();
 
-    std::array<int64_t, 3> shape{1, actual_frames, feat_dim};
+    std::vector<std::vector<float>> features(n);
+    std::vector<int32_t> num_frames(n);
+
+    for (int32_t i = 0; i != n; ++i) {
+      features[i] = ss[i]->GetFrames();
+      num_frames[i] = features[i].size() / feat_dim;
+
+      // we use 50 here so that there will be some zero tail paddings
+      if (num_frames[i] >= max_num_frames - 50) {
+        SHERPA_ONNX_LOGE(
+            "Only waves less than 30 seconds are supported. We process only "
+            "the first 30 seconds and discard the remaining data");
+        num_frames[i] = max_num_frames - 50;
+      }
+
+      model_->NormalizeFeatures(features[i].data(), num_frames[i], feat_dim);
+    }
+
+    std::array<int64_t, 3> shape{n, actual_frames, feat_dim};
 
     Ort::Value mel = Ort::Value::CreateTensor<float>(
         model_->Allocator(), shape.data(), shape.size());
 
     float *p_mel = mel.GetTensorMutableData<float>();
-    std::copy(f.data(), f.data() + num_frames * feat_dim, p_mel);
+    std::fill_n(p_mel, n * actual_frames * feat_dim, 0);
 
-    std::fill_n(p_mel + num_frames * feat_dim,
-                (actual_frames - num_frames) * feat_dim, 0);
+    for (int32_t i = 0; i != n; ++i) {
+      std::copy(features[i].data(),
+                features[i].data() + num_frames[i] * feat_dim,
+                p_mel + i * actual_frames * feat_dim);
+    }
 
     mel = Transpose12(model_->Allocator(), &mel);
 
     try {
-      auto cross_kv = model_->ForwardEncoder(std::move(mel));
-
-      auto results = decoder_->Decode(std::move(cross_kv.first),
-                                      std::move(cross_kv.second), num_frames);
+      PerfStats *stats = GetPerfStats().get();
+
+      auto cross_kv = [&]() {
+        ScopedPerfTimer timer(stats, PerfStage::kEncoder);
+        return model_->ForwardEncoder(std::move(mel));
+      }();
+
+      std::vector<OfflineWhisperDecoderResult> results;
+      {
+        ScopedPerfTimer timer(stats, PerfStage::kDecoder);
+        results = decoder_->Decode(std::move(cross_kv.first),
+                                   std::move(cross_kv.second), num_frames);
+      }
 
-      auto r = Convert(results[0], symbol_table_);
-      s->SetResult(r);
+      ScopedPerfTimer timer(stats, PerfStage::kPostprocessing);
+      for (int32_t i = 0; i != n; ++i) {
+        auto r = Convert(results[i], symbol_table_);
+        ss[i]->SetResult(r);
+      }
     } catch (const Ort::Exception &ex) {
+      if (n > 1) {
+        // Don't let one stream cost the results of the others in the batch
+        SHERPA_ONNX_LOGE(
+            "\n\nCaught exception:\n\n%s\n\nDecode the %d streams of the "
+            "batch one by one",
+            ex.what(), n);
+
+        for (int32_t i = 0; i != n; ++i) {
+          DecodeStreams(ss + i, 1);
+        }
+        return;
+      }
+
       SHERPA_ONNX_LOGE(
-          "\n\nCaught exception:\n\n%s\n\nReturn an empty result. Number of "
-          "input frames: %d, Current tail "
+          "\n\nCaught exception:\n\n%s\n\nReturn an empty result. Number "
+          "of streams: %d, number of input frames: %d, Current tail "
           "paddings: %d. If you see a lot of such exceptions, please consider "
           "using a larger --whisper-tail-paddings",
-          ex.what(), num_frames, tail_padding_frames);
+          ex.what(), n, actual_frames, tail_padding_frames);
       return;
     }
   }
 
+  void SetConfig(const OfflineRecognizerConfig &config) override {
+    config_.model_config.whisper = config.model_config.whisper;
+  }
+
+  OfflineRecognizerConfig GetConfig() const override { return config_; }
+
+  std::unique_ptr<OfflineRecognizerImpl> Clone(
+      const OfflineRecognizerConfig &config) const override {
+    return std::unique_ptr<OfflineRecognizerImpl>(
+        new OfflineRecognizerWhisperImpl(*this, config));
+  }
+
+ private:
+  OfflineRecognizerWhisperImpl(const OfflineRecognizerWhisperImpl &other,
+                               const OfflineRecognizerConfig &config)
+      : OfflineRecognizerImpl(other, config),
+        config_(config),
+        symbol_table_(other.symbol_table_),
+        model_(other.model_) {
+    InitDecoder();
+  }
+
  private:
   OfflineRecognitionResult Convert(const OfflineWhisperDecoderResult &src,
                                    const SymbolTable &sym_table) const {
@@ -174,7 +253,7 @@ class OfflineRecognizerWhisperImpl : public OfflineRecognizerImpl {
  private:
   OfflineRecognizerConfig config_;
   SymbolTable symbol_table_;
-  std::unique_ptr<OfflineWhisperModel> model_;
+  std::shared_ptr<OfflineWhisperModel> model_;
   std::unique_ptr<OfflineWhisperDecoder> decoder_;
 };
 
@@ -5,6 +5,8 @@
 #include "sherpa-onnx/csrc/offline-recognizer.h"
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 #if __ANDROID_API__ >= 9
 #include "android/asset_manager.h"
@@ -15,6 +17,7 @@
 #include "rawfile/raw_file_manager.h"
 #endif
 
+#include "sherpa-onnx/csrc/bucket-by-length.h"
 #include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/offline-lm-config.h"
@@ -33,7 +36,8 @@ void OfflineRecognizerConfig::Register(ParseOptions *po) {
       "decoding-method", &decoding_method,
       "decoding method,"
       "Valid values: greedy_search, modified_beam_search. "
-      "modified_beam_search is applicable only for transducer models.");
+      "modified_beam_search is applicable only for transducer and whisper "
+      "models.");
 
   po->Register("max-active-paths", &max_active_paths,
                "Used only when decoding_method is modified_beam_search");
@@ -67,13 +71,14 @@ void OfflineRecognizerConfig::Register(ParseOptions *po) {
 }
 
 bool OfflineRecognizerConfig::Validate() const {
-  if (decoding_method == "modified_beam_search" && !lm_config.model.empty()) {
+  if (decoding_method == "modified_beam_search") {
     if (max_active_paths <= 0) {
-      SHERPA_ONNX_LOGE("max_active_paths is less than 0! Given: %d",
+      SHERPA_ONNX_LOGE("max_active_paths should be positive! Given: %d",
                        max_active_paths);
       return false;
     }
-    if (!lm_config.Validate()) {
+
+    if (!lm_config.model.empty() && !lm_config.Validate()) {
       return false;
     }
   }
@@ -147,24 +152,60 @@ OfflineRecognizer::OfflineRecognizer(Manager *mgr,
                                      const OfflineRecognizerConfig &config)
     : impl_(OfflineRecognizerImpl::Create(mgr, config)) {}
 
+// The model files in model_config.precision are loaded if it is set
+static OfflineRecognizerConfig ApplyPrecision(OfflineRecognizerConfig config) {
+  config.model_config.ApplyPrecision();
+  return config;
+}
+
 OfflineRecognizer::OfflineRecognizer(const OfflineRecognizerConfig &config)
-    : impl_(OfflineRecognizerImpl::Create(config)) {}
+    : impl_(OfflineRecognizerImpl::Create(ApplyPrecision(config))) {}
+
+OfflineRecognizer::OfflineRecognizer(
+    std::unique_ptr<OfflineRecognizerImpl> impl)
+    : impl_(std::move(impl)) {}
 
 OfflineRecognizer::~OfflineRecognizer() = default;
 
 std::unique_ptr<OfflineStream> OfflineRecognizer::CreateStream(
     const std::string &hotwords) const {
-  return impl_->CreateStream(hotwords);
+  auto s = impl_->CreateStream(hotwords);
+  s->SetPerfStats(impl_->GetPerfStats());
+  return s;
 }
 
 std::unique_ptr<OfflineStream> OfflineRecognizer::CreateStream() const {
-  return impl_->CreateStream();
+  auto s = impl_->CreateStream();
+  s->SetPerfStats(impl_->GetPerfStats());
+  return s;
 }
 
 void OfflineRecognizer::DecodeStreams(OfflineStream **ss, int32_t n) const {
+  ScopedPerfTimer timer(impl_->GetPerfStats().get(), PerfStage::kDecodeStreams);
   impl_->DecodeStreams(ss, n);
 }
 
+void OfflineRecognizer::DecodeStreamsBucketed(
+    OfflineStream **ss, int32_t n, int32_t max_padded_frames,
+    int32_t max_batch_size /*= 0*/) const {
+  std::vector<int32_t> lengths(n);
+  for (int32_t i = 0; i != n; ++i) {
+    lengths[i] = ss[i]->NumFrames();
+  }
+
+  auto batches = BucketByLength(lengths, max_padded_frames, max_batch_size);
+
+  std::vector<OfflineStream *> batch_ss;
+  for (const auto &batch : batches) {
+    batch_ss.clear();
+    for (auto i : batch) {
+      batch_ss.push_back(ss[i]);
+    }
+
+    DecodeStreams(batch_ss.data(), batch_ss.size());
+  }
+}
+
 void OfflineRecognizer::SetConfig(const OfflineRecognizerConfig &config) {
   impl_->SetConfig(config);
 }
@@ -173,6 +214,45 @@ OfflineRecognizerConfig OfflineRecognizer::GetConfig() const {
   return impl_->GetConfig();
 }
 
+std::unique_ptr<OfflineRecognizer> OfflineRecognizer::Clone(
+    const OfflineRecognizerConfig &config) const {
+  auto impl = impl_->Clone(config);
+  if (!impl) {
+    return nullptr;
+  }
+
+  return std::unique_ptr<OfflineRecognizer>(
+      new OfflineRecognizer(std::move(impl)));
+}
+
+std::map<std::string, StageStats> OfflineRecognizer::GetStats() const {
+  return impl_->GetPerfStats()->Get();
+}
+
+void OfflineRecognizer::ResetStats() const { impl_->GetPerfStats()->Reset(); }
+
+std::future<void> OfflineRecognizer::Warmup(
+    const std::vector<WarmupShape> &shapes) const {
+  return std::async(std::launch::async, [this, shapes]() {
+    int32_t sample_rate = GetConfig().feat_config.sampling_rate;
+
+    for (const auto &shape : shapes) {
+      auto samples = GenerateWarmupSamples(sample_rate, shape.num_seconds);
+
+      std::vector<std::unique_ptr<OfflineStream>> ss;
+      std::vector<OfflineStream *> ss_pointers;
+      for (int32_t i = 0; i != shape.batch_size; ++i) {
+        auto s = CreateStream();
+        s->AcceptWaveform(sample_rate, samples.data(), samples.size());
+        ss_pointers.push_back(s.get());
+        ss.push_back(std::move(s));
+      }
+
+      DecodeStreams(ss_pointers.data(), ss_pointers.size());
+    }
+  });
+}
+
 #if __ANDROID_API__ >= 9
 template OfflineRecognizer::OfflineRecognizer(
     AAssetManager *mgr, const OfflineRecognizerConfig &config);
@@ -5,6 +5,8 @@
 #ifndef SHERPA_ONNX_CSRC_OFFLINE_RECOGNIZER_H_
 #define SHERPA_ONNX_CSRC_OFFLINE_RECOGNIZER_H_
 
+#include <future>  // NOLINT
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -16,6 +18,8 @@
 #include "sherpa-onnx/csrc/offline-stream.h"
 #include "sherpa-onnx/csrc/offline-transducer-model-config.h"
 #include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/perf-stats.h"
+#include "sherpa-onnx/csrc/warmup.h"
 
 namespace sherpa_onnx {
 
@@ -113,6 +117,24 @@ class OfflineRecognizer {
    */
   void DecodeStreams(OfflineStream **ss, int32_t n) const;
 
+  /** Like DecodeStreams(), but streams of similar lengths are decoded
+   * together in batches so that little computation is wasted on padding.
+   * See BucketByLength() in bucket-by-length.h.
+   *
+   * The result of each stream is set as usual, so the order of the
+   * input array does not matter.
+   *
+   * @param ss Pointer to an array of streams.
+   * @param n  Size of the input array.
+   * @param max_padded_frames Upper bound of the number of frames of a batch
+   *                          after padding, i.e., batch size times the
+   *                          longest stream in it.
+   * @param max_batch_size If positive, upper bound of the batch size.
+   */
+  void DecodeStreamsBucketed(OfflineStream **ss, int32_t n,
+                             int32_t max_padded_frames,
+                             int32_t max_batch_size = 0) const;
+
   /** Onnxruntime Session objects are not affected by this method.
    * The exact behavior can be defined by a specific recognizer impl.
    * For instance, for the whisper recognizer, you can retrieve the language and
@@ -122,7 +144,45 @@ class OfflineRecognizer {
 
   OfflineRecognizerConfig GetConfig() const;
 
+  /** Create a recognizer that shares the onnxruntime sessions of this one
+   * but uses the decoding settings from config, e.g., decoding_method,
+   * hotwords, blank_penalty and the language of whisper models.
+   *
+   * It is much cheaper than loading the model again. config.model_config
+   * should describe the same model, e.g., it is from GetConfig(); the model
+   * files in it are not loaded.
+   *
+   * This recognizer can be destroyed before the returned one.
+   *
+   * @return Return nullptr if the model does not support it.
+   */
+  std::unique_ptr<OfflineRecognizer> Clone(
+      const OfflineRecognizerConfig &config) const;
+
+  /** Return the cumulative time and number of calls of each stage since
+   * this recognizer was created or ResetStats() was called, e.g.,
+   * feature_extraction, encoder, decoder, joiner and postprocessing.
+   * See perf-stats.h. The stages depend on the model.
+   */
+  std::map<std::string, StageStats> GetStats() const;
+
+  void ResetStats() const;
+
+  /** Decode synthetic audio of the given shapes so that later requests
+   * of similar shapes do not pay for kernel selection and memory
+   * allocation in onnxruntime. For each shape, batch_size streams of
+   * num_seconds are decoded together.
+   *
+   * It returns immediately; the warmup runs in a background thread and
+   * the returned future becomes ready when it is done. Note that the
+   * destructor of the future waits for the warmup. Requests can be served
+   * while it runs. This object must outlive the warmup.
+   */
+  std::future<void> Warmup(const std::vector<WarmupShape> &shapes) const;
+
  private:
+  explicit OfflineRecognizer(std::unique_ptr<OfflineRecognizerImpl> impl);
+
   std::unique_ptr<OfflineRecognizerImpl> impl_;
 };
 
@@ -20,6 +20,7 @@
 
 #include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
+#include "sherpa-onnx/csrc/ort-env.h"
 #include "sherpa-onnx/csrc/session.h"
 #include "sherpa-onnx/csrc/text-utils.h"
 
@@ -29,11 +30,11 @@ class OfflineSpeechDenoiserGtcrnModel::Impl {
  public:
   explicit Impl(const OfflineSpeechDenoiserModelConfig &config)
       : config_(config),
-        env_(ORT_LOGGING_LEVEL_ERROR),
+        env_(GetOrtEnv()),
         sess_opts_(GetSessionOptions(config)),
         allocator_{} {
     {
-      auto buf = ReadFile(config.gtcrn.model);
+      auto buf = MapFile(config.gtcrn.model);
       Init(buf.data(), buf.size());
     }
   }
@@ -41,7 +42,7 @@ class OfflineSpeechDenoiserGtcrnModel::Impl {
   template <typename Manager>
   Impl(Manager *mgr, const OfflineSpeechDenoiserModelConfig &config)
       : config_(config),
-        env_(ORT_LOGGING_LEVEL_ERROR),
+        env_(GetOrtEnv()),
         sess_opts_(GetSessionOptions(config)),
         allocator_{} {
     {
@@ -102,9 +103,8 @@ class OfflineSpeechDenoiserGtcrnModel::Impl {
   }
 
  private:
-  void Init(void *model_data, size_t model_data_length) {
-    sess_ = std::make_unique<Ort::Session>(env_, model_data, model_data_length,
-                                           sess_opts_);
+  void Init(const void *model_data, size_t model_data_length) {
+    sess_ = CreateSession(env_, model_data, model_data_length, sess_opts_);
 
     GetInputNames(sess_.get(), &input_names_, &input_names_ptr_);
 
@@ -163,7 +163,7 @@ class OfflineSpeechDenoiserGtcrnModel::Impl {
   OfflineSpeechDenoiserModelConfig config_;
   OfflineSpeechDenoiserGtcrnModelMetaData meta_;
 
-  Ort::Env env_;
+  Ort::Env &env_;
   Ort::SessionOptions sess_opts_;
   Ort::AllocatorWithDefaultOptions allocator_;
 
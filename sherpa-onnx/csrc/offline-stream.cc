@@ -209,6 +209,17 @@ class OfflineStream::Impl {
     return mfcc_ ? mfcc_opts_.num_ceps : opts_.mel_opts.num_bins;
   }
 
+  int32_t NumFrames() const {
+    if (is_moonshine_) {
+      // 10 ms per frame
+      return samples_.size() / (config_.sampling_rate / 100);
+    }
+
+    return fbank_  ? fbank_->NumFramesReady()
+           : mfcc_ ? mfcc_->NumFramesReady()
+                   : whisper_fbank_->NumFramesReady();
+  }
+
   std::vector<float> GetFrames() const {
     if (is_moonshine_) {
       return samples_;
@@ -338,11 +349,14 @@ OfflineStream::~OfflineStream() = default;
 
 void OfflineStream::AcceptWaveform(int32_t sampling_rate, const float *waveform,
                                    int32_t n) const {
+  ScopedPerfTimer timer(perf_stats_.get(), PerfStage::kFeatureExtraction);
   impl_->AcceptWaveform(sampling_rate, waveform, n);
 }
 
 int32_t OfflineStream::FeatureDim() const { return impl_->FeatureDim(); }
 
+int32_t OfflineStream::NumFrames() const { return impl_->NumFrames(); }
+
 std::vector<float> OfflineStream::GetFrames() const {
   return impl_->GetFrames();
 }
@@ -355,6 +369,10 @@ const ContextGraphPtr &OfflineStream::GetContextGraph() const {
   return impl_->GetContextGraph();
 }
 
+void OfflineStream::SetPerfStats(std::shared_ptr<PerfStats> stats) {
+  perf_stats_ = std::move(stats);
+}
+
 const OfflineRecognitionResult &OfflineStream::GetResult() const {
   return impl_->GetResult();
 }
@@ -13,6 +13,7 @@
 #include "sherpa-onnx/csrc/context-graph.h"
 #include "sherpa-onnx/csrc/features.h"
 #include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/perf-stats.h"
 
 namespace sherpa_onnx {
 
@@ -83,6 +84,12 @@ class OfflineStream {
   /// currently received.
   int32_t FeatureDim() const;
 
+  /// Return the number of feature frames of this stream.
+  ///
+  /// Note: if it is Moonshine, then it returns the duration of the
+  /// received audio in frames of 10 ms.
+  int32_t NumFrames() const;
+
   // Get all the feature frames of this stream in a 1-D array, which is
   // flattened from a 2-D array of shape (num_frames, feat_dim).
   std::vector<float> GetFrames() const;
@@ -96,9 +103,15 @@ class OfflineStream {
   /** Get the ContextGraph of this stream */
   const ContextGraphPtr &GetContextGraph() const;
 
+  // If not null, the time of AcceptWaveform() is added to the stage
+  // feature_extraction of stats. OfflineRecognizer sets it to its own
+  // stats.
+  void SetPerfStats(std::shared_ptr<PerfStats> stats);
+
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
+  std::shared_ptr<PerfStats> perf_stats_;
 };
 
 }  // namespace sherpa_onnx
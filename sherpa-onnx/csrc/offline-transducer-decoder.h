@@ -9,6 +9,7 @@
 
 #include "onnxruntime_cxx_api.h"  // NOLINT
 #include "sherpa-onnx/csrc/offline-stream.h"
+#include "sherpa-onnx/csrc/perf-stats.h"
 
 namespace sherpa_onnx {
 
@@ -36,6 +37,13 @@ class OfflineTransducerDecoder {
   virtual std::vector<OfflineTransducerDecoderResult> Decode(
       Ort::Value encoder_out, Ort::Value encoder_out_length,
       OfflineStream **ss = nullptr, int32_t n = 0) = 0;
+
+  // If not null, the time of running the decoder and the joiner, etc.,
+  // is added to stats. It must outlive this object.
+  void SetPerfStats(PerfStats *stats) { perf_stats_ = stats; }
+
+ protected:
+  PerfStats *perf_stats_ = nullptr;
 };
 
 }  // namespace sherpa_onnx
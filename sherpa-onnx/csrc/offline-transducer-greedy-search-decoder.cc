@@ -36,7 +36,11 @@ OfflineTransducerGreedySearchDecoder::Decode(Ort::Value encoder_out,
   }
 
   auto decoder_input = model_->BuildDecoderInput(ans, ans.size());
-  Ort::Value decoder_out = model_->RunDecoder(std::move(decoder_input));
+  Ort::Value decoder_out{nullptr};
+  {
+    ScopedPerfTimer timer(perf_stats_, PerfStage::kDecoder);
+    decoder_out = model_->RunDecoder(std::move(decoder_input));
+  }
 
   int32_t start = 0;
   int32_t t = 0;
@@ -44,8 +48,12 @@ OfflineTransducerGreedySearchDecoder::Decode(Ort::Value encoder_out,
     Ort::Value cur_encoder_out = packed_encoder_out.Get(start, n);
     Ort::Value cur_decoder_out = Slice(model_->Allocator(), &decoder_out, 0, n);
     start += n;
-    Ort::Value logit = model_->RunJoiner(std::move(cur_encoder_out),
-                                         std::move(cur_decoder_out));
+    Ort::Value logit{nullptr};
+    {
+      ScopedPerfTimer timer(perf_stats_, PerfStage::kJoiner);
+      logit = model_->RunJoiner(std::move(cur_encoder_out),
+                                std::move(cur_decoder_out));
+    }
     float *p_logit = logit.GetTensorMutableData<float>();
     bool emitted = false;
     for (int32_t i = 0; i != n; ++i) {
@@ -67,6 +75,7 @@ OfflineTransducerGreedySearchDecoder::Decode(Ort::Value encoder_out,
     }
     if (emitted) {
       Ort::Value decoder_input = model_->BuildDecoderInput(ans, n);
+      ScopedPerfTimer timer(perf_stats_, PerfStage::kDecoder);
       decoder_out = model_->RunDecoder(std::move(decoder_input));
     }
     ++t;
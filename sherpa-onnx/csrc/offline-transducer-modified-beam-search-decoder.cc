@@ -86,35 +86,40 @@ OfflineTransducerModifiedBeamSearchDecoder::Decode(
     auto decoder_input = model_->BuildDecoderInput(prev, num_hyps);
     // decoder_input shape: (num_hyps, context_size)
 
-    auto decoder_out = model_->RunDecoder(std::move(decoder_input));
+    Ort::Value decoder_out{nullptr};
+    {
+      ScopedPerfTimer timer(perf_stats_, PerfStage::kDecoder);
+      decoder_out = model_->RunDecoder(std::move(decoder_input));
+    }
     // decoder_out is (num_hyps, joiner_dim)
 
     cur_encoder_out =
         Repeat(model_->Allocator(), &cur_encoder_out, hyps_row_splits);
     // now cur_encoder_out is of shape (num_hyps, joiner_dim)
 
-    Ort::Value logit =
-        model_->RunJoiner(std::move(cur_encoder_out), View(&decoder_out));
+    Ort::Value logit{nullptr};
+    {
+      ScopedPerfTimer timer(perf_stats_, PerfStage::kJoiner);
+      logit =
+          model_->RunJoiner(std::move(cur_encoder_out), View(&decoder_out));
+    }
 
     float *p_logit = logit.GetTensorMutableData<float>();
     if (blank_penalty_ > 0.0) {
       // assuming blank id is 0
       SubtractBlank(p_logit, vocab_size, num_hyps, 0, blank_penalty_);
     }
-    LogSoftmax(p_logit, vocab_size, num_hyps);
-
-    // now p_logit contains log_softmax output, we rename it to p_logprob
-    // to match what it actually contains
-    float *p_logprob = p_logit;
 
-    // add log_prob of each hypothesis to p_logprob before taking top_k
+    // compute log_softmax and add log_prob of each hypothesis to it
+    // before taking top_k
     for (int32_t i = 0; i != num_hyps; ++i) {
       float log_prob = prev[i].log_prob;
-      for (int32_t k = 0; k != vocab_size; ++k, ++p_logprob) {
-        *p_logprob += log_prob;
-      }
+      LogSoftmaxPlusBias(p_logit + i * vocab_size, vocab_size, log_prob);
     }
-    p_logprob = p_logit;  // we changed p_logprob in the above for loop
+
+    // now p_logit contains log_softmax output plus the log_prob of each
+    // hypothesis, we rename it to p_logprob to match what it actually contains
+    float *p_logprob = p_logit;
 
     // Now compute top_k for each utterance
     for (int32_t i = 0; i != n; ++i) {
@@ -134,8 +139,9 @@ OfflineTransducerModifiedBeamSearchDecoder::Decode(
         // blank is hardcoded to 0
         // also, it treats unk as blank
         if (new_token != 0 && new_token != unk_id_) {
-          new_hyp.ys.push_back(new_token);
-          new_hyp.timestamps.push_back(t);
+          new_hyp.AddToken(new_token, t);
+          // Not timed since it takes about as long as reading the clock.
+          // Its time is part of search.
           if (context_graphs[i] != nullptr) {
             auto context_res =
                 context_graphs[i]->ForwardOneStep(context_state,
@@ -174,6 +180,7 @@ OfflineTransducerModifiedBeamSearchDecoder::Decode(
 
   if (lm_) {
     // use LM for rescoring
+    ScopedPerfTimer timer(perf_stats_, PerfStage::kLm);
     lm_->ComputeLMScore(lm_scale_, context_size, &cur);
   }
 
@@ -184,8 +191,9 @@ OfflineTransducerModifiedBeamSearchDecoder::Decode(
     auto &r = unsorted_ans[packed_encoder_out.sorted_indexes[i]];
 
     // strip leading blanks
-    r.tokens = {hyp.ys.begin() + context_size, hyp.ys.end()};
-    r.timestamps = std::move(hyp.timestamps);
+    r.tokens.resize(hyp.NumTokens() - context_size);
+    hyp.GetTokens(context_size, hyp.NumTokens(), r.tokens.data());
+    r.timestamps = hyp.Timestamps();
   }
 
   return unsorted_ans;
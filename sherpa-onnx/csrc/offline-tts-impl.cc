@@ -16,12 +16,19 @@
 #include "rawfile/raw_file_manager.h"
 #endif
 
+#include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/offline-tts-kokoro-impl.h"
 #include "sherpa-onnx/csrc/offline-tts-matcha-impl.h"
 #include "sherpa-onnx/csrc/offline-tts-vits-impl.h"
 
 namespace sherpa_onnx {
 
+std::unique_ptr<OfflineTtsImpl> OfflineTtsImpl::Clone(
+    const OfflineTtsConfig & /*config*/) const {
+  SHERPA_ONNX_LOGE("This model does not support Clone()");
+  return nullptr;
+}
+
 std::vector<int64_t> OfflineTtsImpl::AddBlank(const std::vector<int64_t> &x,
                                               int32_t blank_id /*= 0*/) const {
   // we assume the blank ID is 0
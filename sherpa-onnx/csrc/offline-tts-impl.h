@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "sherpa-onnx/csrc/offline-tts.h"
+#include "sherpa-onnx/csrc/perf-stats.h"
 
 namespace sherpa_onnx {
 
@@ -23,6 +24,15 @@ class OfflineTtsImpl {
   static std::unique_ptr<OfflineTtsImpl> Create(Manager *mgr,
                                                 const OfflineTtsConfig &config);
 
+  /** Create a TTS engine that shares the models, frontend and vocoder of
+   * this one but uses rule_fsts, rule_fars, max_num_sentences and
+   * silence_scale from config. Other fields of config.model are not used.
+   *
+   * Return nullptr if the model does not support it.
+   */
+  virtual std::unique_ptr<OfflineTtsImpl> Clone(
+      const OfflineTtsConfig &config) const;
+
   virtual GeneratedAudio Generate(
       const std::string &text, int64_t sid = 0, float speed = 1.0,
       GeneratedAudioCallback callback = nullptr) const = 0;
@@ -36,6 +46,12 @@ class OfflineTtsImpl {
 
   std::vector<int64_t> AddBlank(const std::vector<int64_t> &x,
                                 int32_t blank_id = 0) const;
+
+  // Time spent in each stage. It is not shared with clones.
+  PerfStats *GetPerfStats() const { return perf_stats_.get(); }
+
+ private:
+  std::unique_ptr<PerfStats> perf_stats_ = std::make_unique<PerfStats>();
 };
 
 }  // namespace sherpa_onnx
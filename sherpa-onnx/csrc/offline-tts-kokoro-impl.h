@@ -31,63 +31,16 @@ class OfflineTtsKokoroImpl : public OfflineTtsImpl {
  public:
   explicit OfflineTtsKokoroImpl(const OfflineTtsConfig &config)
       : config_(config),
-        model_(std::make_unique<OfflineTtsKokoroModel>(config.model)) {
+        model_(std::make_shared<OfflineTtsKokoroModel>(config.model)) {
     InitFrontend();
 
-    if (!config.rule_fsts.empty()) {
-      std::vector<std::string> files;
-      SplitStringToVector(config.rule_fsts, ",", false, &files);
-      tn_list_.reserve(files.size());
-      for (const auto &f : files) {
-        if (config.model.debug) {
-#if __OHOS__
-          SHERPA_ONNX_LOGE("rule fst: %{public}s", f.c_str());
-#else
-          SHERPA_ONNX_LOGE("rule fst: %s", f.c_str());
-#endif
-        }
-        tn_list_.push_back(std::make_unique<kaldifst::TextNormalizer>(f));
-      }
-    }
-
-    if (!config.rule_fars.empty()) {
-      if (config.model.debug) {
-        SHERPA_ONNX_LOGE("Loading FST archives");
-      }
-      std::vector<std::string> files;
-      SplitStringToVector(config.rule_fars, ",", false, &files);
-
-      tn_list_.reserve(files.size() + tn_list_.size());
-
-      for (const auto &f : files) {
-        if (config.model.debug) {
-#if __OHOS__
-          SHERPA_ONNX_LOGE("rule far: %{public}s", f.c_str());
-#else
-          SHERPA_ONNX_LOGE("rule far: %s", f.c_str());
-#endif
-        }
-        std::unique_ptr<fst::FarReader<fst::StdArc>> reader(
-            fst::FarReader<fst::StdArc>::Open(f));
-        for (; !reader->Done(); reader->Next()) {
-          std::unique_ptr<fst::StdConstFst> r(
-              fst::CastOrConvertToConstFst(reader->GetFst()->Copy()));
-
-          tn_list_.push_back(
-              std::make_unique<kaldifst::TextNormalizer>(std::move(r)));
-        }
-      }
-
-      if (config.model.debug) {
-        SHERPA_ONNX_LOGE("FST archives loaded!");
-      }
-    }
+    InitTextNormalizers();
   }
 
   template <typename Manager>
   OfflineTtsKokoroImpl(Manager *mgr, const OfflineTtsConfig &config)
       : config_(config),
-        model_(std::make_unique<OfflineTtsKokoroModel>(mgr, config.model)) {
+        model_(std::make_shared<OfflineTtsKokoroModel>(mgr, config.model)) {
     InitFrontend(mgr);
 
     if (!config.rule_fsts.empty()) {
@@ -141,6 +94,12 @@ class OfflineTtsKokoroImpl : public OfflineTtsImpl {
     }      // if (!config.rule_fars.empty())
   }
 
+  std::unique_ptr<OfflineTtsImpl> Clone(
+      const OfflineTtsConfig &config) const override {
+    return std::unique_ptr<OfflineTtsImpl>(
+        new OfflineTtsKokoroImpl(*this, config));
+  }
+
   int32_t SampleRate() const override {
     return model_->GetMetaData().sample_rate;
   }
@@ -220,8 +179,11 @@ class OfflineTtsKokoroImpl : public OfflineTtsImpl {
       }
     }
 
-    std::vector<TokenIDs> token_ids =
-        frontend_->ConvertTextToTokenIds(text, meta_data.voice);
+    std::vector<TokenIDs> token_ids;
+    {
+      ScopedPerfTimer timer(GetPerfStats(), PerfStage::kFrontend);
+      token_ids = frontend_->ConvertTextToTokenIds(text, meta_data.voice);
+    }
 
     if (token_ids.empty() ||
         (token_ids.size() == 1 && token_ids[0].tokens.empty())) {
@@ -328,6 +290,70 @@ class OfflineTtsKokoroImpl : public OfflineTtsImpl {
   }
 
  private:
+  OfflineTtsKokoroImpl(const OfflineTtsKokoroImpl &other,
+                       const OfflineTtsConfig &config)
+      : config_(config),
+        model_(other.model_),
+        frontend_(other.frontend_) {
+    if (config_.rule_fsts == other.config_.rule_fsts &&
+        config_.rule_fars == other.config_.rule_fars) {
+      tn_list_ = other.tn_list_;
+    } else {
+      InitTextNormalizers();
+    }
+  }
+
+  void InitTextNormalizers() {
+    if (!config_.rule_fsts.empty()) {
+      std::vector<std::string> files;
+      SplitStringToVector(config_.rule_fsts, ",", false, &files);
+      tn_list_.reserve(files.size());
+      for (const auto &f : files) {
+        if (config_.model.debug) {
+#if __OHOS__
+          SHERPA_ONNX_LOGE("rule fst: %{public}s", f.c_str());
+#else
+          SHERPA_ONNX_LOGE("rule fst: %s", f.c_str());
+#endif
+        }
+        tn_list_.push_back(std::make_unique<kaldifst::TextNormalizer>(f));
+      }
+    }
+
+    if (!config_.rule_fars.empty()) {
+      if (config_.model.debug) {
+        SHERPA_ONNX_LOGE("Loading FST archives");
+      }
+      std::vector<std::string> files;
+      SplitStringToVector(config_.rule_fars, ",", false, &files);
+
+      tn_list_.reserve(files.size() + tn_list_.size());
+
+      for (const auto &f : files) {
+        if (config_.model.debug) {
+#if __OHOS__
+          SHERPA_ONNX_LOGE("rule far: %{public}s", f.c_str());
+#else
+          SHERPA_ONNX_LOGE("rule far: %s", f.c_str());
+#endif
+        }
+        std::unique_ptr<fst::FarReader<fst::StdArc>> reader(
+            fst::FarReader<fst::StdArc>::Open(f));
+        for (; !reader->Done(); reader->Next()) {
+          std::unique_ptr<fst::StdConstFst> r(
+              fst::CastOrConvertToConstFst(reader->GetFst()->Copy()));
+
+          tn_list_.push_back(
+              std::make_unique<kaldifst::TextNormalizer>(std::move(r)));
+        }
+      }
+
+      if (config_.model.debug) {
+        SHERPA_ONNX_LOGE("FST archives loaded!");
+      }
+    }
+  }
+
   template <typename Manager>
   void InitFrontend(Manager *mgr) {
     const auto &meta_data = model_->GetMetaData();
@@ -404,7 +430,11 @@ class OfflineTtsKokoroImpl : public OfflineTtsImpl {
     Ort::Value x_tensor = Ort::Value::CreateTensor(
         memory_info, x.data(), x.size(), x_shape.data(), x_shape.size());
 
-    Ort::Value audio = model_->Run(std::move(x_tensor), sid, speed);
+    Ort::Value audio{nullptr};
+    {
+      ScopedPerfTimer timer(GetPerfStats(), PerfStage::kAcousticModel);
+      audio = model_->Run(std::move(x_tensor), sid, speed);
+    }
 
     std::vector<int64_t> audio_shape =
         audio.GetTensorTypeAndShapeInfo().GetShape();
@@ -431,9 +461,9 @@ class OfflineTtsKokoroImpl : public OfflineTtsImpl {
 
  private:
   OfflineTtsConfig config_;
-  std::unique_ptr<OfflineTtsKokoroModel> model_;
-  std::vector<std::unique_ptr<kaldifst::TextNormalizer>> tn_list_;
-  std::unique_ptr<OfflineTtsFrontend> frontend_;
+  std::shared_ptr<OfflineTtsKokoroModel> model_;
+  std::vector<std::shared_ptr<kaldifst::TextNormalizer>> tn_list_;
+  std::shared_ptr<OfflineTtsFrontend> frontend_;
 };
 
 }  // namespace sherpa_onnx
@@ -32,64 +32,17 @@ class OfflineTtsMatchaImpl : public OfflineTtsImpl {
  public:
   explicit OfflineTtsMatchaImpl(const OfflineTtsConfig &config)
       : config_(config),
-        model_(std::make_unique<OfflineTtsMatchaModel>(config.model)),
+        model_(std::make_shared<OfflineTtsMatchaModel>(config.model)),
         vocoder_(Vocoder::Create(config.model)) {
     InitFrontend();
 
-    if (!config.rule_fsts.empty()) {
-      std::vector<std::string> files;
-      SplitStringToVector(config.rule_fsts, ",", false, &files);
-      tn_list_.reserve(files.size());
-      for (const auto &f : files) {
-        if (config.model.debug) {
-#if __OHOS__
-          SHERPA_ONNX_LOGE("rule fst: %{public}s", f.c_str());
-#else
-          SHERPA_ONNX_LOGE("rule fst: %s", f.c_str());
-#endif
-        }
-        tn_list_.push_back(std::make_unique<kaldifst::TextNormalizer>(f));
-      }
-    }
-
-    if (!config.rule_fars.empty()) {
-      if (config.model.debug) {
-        SHERPA_ONNX_LOGE("Loading FST archives");
-      }
-      std::vector<std::string> files;
-      SplitStringToVector(config.rule_fars, ",", false, &files);
-
-      tn_list_.reserve(files.size() + tn_list_.size());
-
-      for (const auto &f : files) {
-        if (config.model.debug) {
-#if __OHOS__
-          SHERPA_ONNX_LOGE("rule far: %{public}s", f.c_str());
-#else
-          SHERPA_ONNX_LOGE("rule far: %s", f.c_str());
-#endif
-        }
-        std::unique_ptr<fst::FarReader<fst::StdArc>> reader(
-            fst::FarReader<fst::StdArc>::Open(f));
-        for (; !reader->Done(); reader->Next()) {
-          std::unique_ptr<fst::StdConstFst> r(
-              fst::CastOrConvertToConstFst(reader->GetFst()->Copy()));
-
-          tn_list_.push_back(
-              std::make_unique<kaldifst::TextNormalizer>(std::move(r)));
-        }
-      }
-
-      if (config.model.debug) {
-        SHERPA_ONNX_LOGE("FST archives loaded!");
-      }
-    }
+    InitTextNormalizers();
   }
 
   template <typename Manager>
   OfflineTtsMatchaImpl(Manager *mgr, const OfflineTtsConfig &config)
       : config_(config),
-        model_(std::make_unique<OfflineTtsMatchaModel>(mgr, config.model)),
+        model_(std::make_shared<OfflineTtsMatchaModel>(mgr, config.model)),
         vocoder_(Vocoder::Create(mgr, config.model)) {
     InitFrontend(mgr);
 
@@ -144,6 +97,12 @@ class OfflineTtsMatchaImpl : public OfflineTtsImpl {
     }      // if (!config.rule_fars.empty())
   }
 
+  std::unique_ptr<OfflineTtsImpl> Clone(
+      const OfflineTtsConfig &config) const override {
+    return std::unique_ptr<OfflineTtsImpl>(
+        new OfflineTtsMatchaImpl(*this, config));
+  }
+
   int32_t SampleRate() const override {
     return model_->GetMetaData().sample_rate;
   }
@@ -209,8 +168,11 @@ class OfflineTtsMatchaImpl : public OfflineTtsImpl {
       }
     }
 
-    std::vector<TokenIDs> token_ids =
-        frontend_->ConvertTextToTokenIds(text, meta_data.voice);
+    std::vector<TokenIDs> token_ids;
+    {
+      ScopedPerfTimer timer(GetPerfStats(), PerfStage::kFrontend);
+      token_ids = frontend_->ConvertTextToTokenIds(text, meta_data.voice);
+    }
 
     if (token_ids.empty() ||
         (token_ids.size() == 1 && token_ids[0].tokens.empty())) {
@@ -316,6 +278,71 @@ class OfflineTtsMatchaImpl : public OfflineTtsImpl {
   }
 
  private:
+  OfflineTtsMatchaImpl(const OfflineTtsMatchaImpl &other,
+                       const OfflineTtsConfig &config)
+      : config_(config),
+        model_(other.model_),
+        vocoder_(other.vocoder_),
+        frontend_(other.frontend_) {
+    if (config_.rule_fsts == other.config_.rule_fsts &&
+        config_.rule_fars == other.config_.rule_fars) {
+      tn_list_ = other.tn_list_;
+    } else {
+      InitTextNormalizers();
+    }
+  }
+
+  void InitTextNormalizers() {
+    if (!config_.rule_fsts.empty()) {
+      std::vector<std::string> files;
+      SplitStringToVector(config_.rule_fsts, ",", false, &files);
+      tn_list_.reserve(files.size());
+      for (const auto &f : files) {
+        if (config_.model.debug) {
+#if __OHOS__
+          SHERPA_ONNX_LOGE("rule fst: %{public}s", f.c_str());
+#else
+          SHERPA_ONNX_LOGE("rule fst: %s", f.c_str());
+#endif
+        }
+        tn_list_.push_back(std::make_unique<kaldifst::TextNormalizer>(f));
+      }
+    }
+
+    if (!config_.rule_fars.empty()) {
+      if (config_.model.debug) {
+        SHERPA_ONNX_LOGE("Loading FST archives");
+      }
+      std::vector<std::string> files;
+      SplitStringToVector(config_.rule_fars, ",", false, &files);
+
+      tn_list_.reserve(files.size() + tn_list_.size());
+
+      for (const auto &f : files) {
+        if (config_.model.debug) {
+#if __OHOS__
+          SHERPA_ONNX_LOGE("rule far: %{public}s", f.c_str());
+#else
+          SHERPA_ONNX_LOGE("rule far: %s", f.c_str());
+#endif
+        }
+        std::unique_ptr<fst::FarReader<fst::StdArc>> reader(
+            fst::FarReader<fst::StdArc>::Open(f));
+        for (; !reader->Done(); reader->Next()) {
+          std::unique_ptr<fst::StdConstFst> r(
+              fst::CastOrConvertToConstFst(reader->GetFst()->Copy()));
+
+          tn_list_.push_back(
+              std::make_unique<kaldifst::TextNormalizer>(std::move(r)));
+        }
+      }
+
+      if (config_.model.debug) {
+        SHERPA_ONNX_LOGE("FST archives loaded!");
+      }
+    }
+  }
+
   template <typename Manager>
   void InitFrontend(Manager *mgr) {
     // for piper phonemizer
@@ -377,11 +404,18 @@ class OfflineTtsMatchaImpl : public OfflineTtsImpl {
     Ort::Value x_tensor = Ort::Value::CreateTensor(
         memory_info, x.data(), x.size(), x_shape.data(), x_shape.size());
 
-    Ort::Value mel = model_->Run(std::move(x_tensor), sid, speed);
+    Ort::Value mel{nullptr};
+    {
+      ScopedPerfTimer timer(GetPerfStats(), PerfStage::kAcousticModel);
+      mel = model_->Run(std::move(x_tensor), sid, speed);
+    }
 
     GeneratedAudio ans;
 
-    ans.samples = vocoder_->Run(std::move(mel));
+    {
+      ScopedPerfTimer timer(GetPerfStats(), PerfStage::kVocoder);
+      ans.samples = vocoder_->Run(std::move(mel));
+    }
     ans.sample_rate = model_->GetMetaData().sample_rate;
 
     float silence_scale = config_.silence_scale;
@@ -394,10 +428,10 @@ class OfflineTtsMatchaImpl : public OfflineTtsImpl {
 
  private:
   OfflineTtsConfig config_;
-  std::unique_ptr<OfflineTtsMatchaModel> model_;
-  std::unique_ptr<Vocoder> vocoder_;
-  std::vector<std::unique_ptr<kaldifst::TextNormalizer>> tn_list_;
-  std::unique_ptr<OfflineTtsFrontend> frontend_;
+  std::shared_ptr<OfflineTtsMatchaModel> model_;
+  std::shared_ptr<Vocoder> vocoder_;
+  std::vector<std::shared_ptr<kaldifst::TextNormalizer>> tn_list_;
+  std::shared_ptr<OfflineTtsFrontend> frontend_;
 };
 
 }  // namespace sherpa_onnx
@@ -5,8 +5,10 @@
 #include "sherpa-onnx/csrc/offline-tts.h"
 
 #include <cmath>
+#include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #if __ANDROID_API__ >= 9
 #include "android/asset_manager.h"
@@ -168,11 +170,15 @@ template <typename Manager>
 OfflineTts::OfflineTts(Manager *mgr, const OfflineTtsConfig &config)
     : impl_(OfflineTtsImpl::Create(mgr, config)) {}
 
+OfflineTts::OfflineTts(std::unique_ptr<OfflineTtsImpl> impl)
+    : impl_(std::move(impl)) {}
+
 OfflineTts::~OfflineTts() = default;
 
 GeneratedAudio OfflineTts::Generate(
     const std::string &text, int64_t sid /*=0*/, float speed /*= 1.0*/,
     GeneratedAudioCallback callback /*= nullptr*/) const {
+  ScopedPerfTimer timer(impl_->GetPerfStats(), PerfStage::kGenerate);
 #if !defined(_WIN32)
   return impl_->Generate(text, sid, speed, std::move(callback));
 #else
@@ -200,6 +206,31 @@ int32_t OfflineTts::SampleRate() const { return impl_->SampleRate(); }
 
 int32_t OfflineTts::NumSpeakers() const { return impl_->NumSpeakers(); }
 
+std::unique_ptr<OfflineTts> OfflineTts::Clone(
+    const OfflineTtsConfig &config) const {
+  auto impl = impl_->Clone(config);
+  if (!impl) {
+    return nullptr;
+  }
+
+  return std::unique_ptr<OfflineTts>(new OfflineTts(std::move(impl)));
+}
+
+std::map<std::string, StageStats> OfflineTts::GetStats() const {
+  return impl_->GetPerfStats()->Get();
+}
+
+void OfflineTts::ResetStats() const { impl_->GetPerfStats()->Reset(); }
+
+std::future<void> OfflineTts::Warmup(
+    const std::vector<std::string> &texts) const {
+  return std::async(std::launch::async, [this, texts]() {
+    for (const auto &text : texts) {
+      Generate(text);
+    }
+  });
+}
+
 #if __ANDROID_API__ >= 9
 template OfflineTts::OfflineTts(AAssetManager *mgr,
                                 const OfflineTtsConfig &config);
@@ -6,12 +6,15 @@
 
 #include <cstdint>
 #include <functional>
+#include <future>  // NOLINT
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "sherpa-onnx/csrc/offline-tts-model-config.h"
 #include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/perf-stats.h"
 
 namespace sherpa_onnx {
 
@@ -102,7 +105,36 @@ class OfflineTts {
   // If it supports only a single speaker, then it return 0 or 1.
   int32_t NumSpeakers() const;
 
+  // Create a TTS engine that shares the models of this one but uses
+  // rule_fsts, rule_fars, max_num_sentences and silence_scale from config.
+  // It is much cheaper than loading the models again.
+  //
+  // Return nullptr if the model does not support it.
+  std::unique_ptr<OfflineTts> Clone(const OfflineTtsConfig &config) const;
+
+  // Return the cumulative time and number of calls of each stage since
+  // this engine was created or ResetStats() was called, e.g., frontend,
+  // acoustic_model and vocoder. See perf-stats.h. The time of generate
+  // includes that of the callback.
+  std::map<std::string, StageStats> GetStats() const;
+
+  void ResetStats() const;
+
+  // Generate audio for the given texts, e.g., a short and a long sentence
+  // in the language of the model, so that later requests do not pay for
+  // kernel selection and memory allocation in onnxruntime. Since the
+  // length of the model input depends on the text, texts are used
+  // instead of WarmupShape.
+  //
+  // It returns immediately; the warmup runs in a background thread and
+  // the returned future becomes ready when it is done. Note that the
+  // destructor of the future waits for the warmup. Requests can be served
+  // while it runs. This object must outlive the warmup.
+  std::future<void> Warmup(const std::vector<std::string> &texts) const;
+
  private:
+  explicit OfflineTts(std::unique_ptr<OfflineTtsImpl> impl);
+
   std::unique_ptr<OfflineTtsImpl> impl_;
 };
 
@@ -0,0 +1,334 @@
+// sherpa-onnx/csrc/offline-whisper-decoder-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/offline-whisper-decoder.h"
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/offline-whisper-greedy-search-decoder.h"
+#include "sherpa-onnx/csrc/offline-whisper-model.h"
+#include "sherpa-onnx/csrc/offline-whisper-modified-beam-search-decoder.h"
+
+namespace sherpa_onnx {
+
+// A fake model to test the decoding algorithms without onnx models.
+//
+// There is a single layer and n_text_state is 1. The decoder saves the
+// input tokens in the self k cache so that it can see all previous tokens.
+// cross_k of an utterance contains the number of tokens to decode before
+// eot. The predicted token depends on it and on all previous tokens.
+class FakeWhisperModel : public OfflineWhisperModel {
+ public:
+  static constexpr int32_t kEot = 1;
+  static constexpr int32_t kSot = 2;
+  static constexpr int32_t kNoTimeStamps = 3;
+  static constexpr int32_t kTranscribe = 4;
+  static constexpr int32_t kTranslate = 5;
+  static constexpr int32_t kTextCtx = 64;
+  static constexpr int32_t kVocabSize = 100;
+
+  explicit FakeWhisperModel(bool is_multilingual)
+      : is_multilingual_(is_multilingual),
+        lang_ids_({60, 61, 62}),
+        lang2id_({{"en", 60}, {"de", 61}, {"fr", 62}}),
+        id2lang_({{60, "en"}, {61, "de"}, {62, "fr"}}) {
+    initial_tokens_.push_back(kSot);
+    if (is_multilingual_) {
+      initial_tokens_.push_back(lang_ids_[0]);
+      initial_tokens_.push_back(kTranscribe);
+    }
+  }
+
+  // Return the cross kv cache of N utterances. Utterance i decodes
+  // num_tokens[i] tokens before eot.
+  Ort::Value CrossKV(const std::vector<int32_t> &num_tokens) const {
+    std::array<int64_t, 4> shape{1, static_cast<int64_t>(num_tokens.size()),
+                                 1, 1};
+    Ort::Value ans = Ort::Value::CreateTensor<float>(allocator_, shape.data(),
+                                                     shape.size());
+    std::copy(num_tokens.begin(), num_tokens.end(),
+              ans.GetTensorMutableData<float>());
+    return ans;
+  }
+
+  std::tuple<Ort::Value, Ort::Value, Ort::Value, Ort::Value, Ort::Value,
+             Ort::Value>
+  ForwardDecoder(Ort::Value tokens, Ort::Value n_layer_self_k_cache,
+                 Ort::Value n_layer_self_v_cache, Ort::Value n_layer_cross_k,
+                 Ort::Value n_layer_cross_v,
+                 Ort::Value offset) const override {
+    auto shape = tokens.GetTensorTypeAndShapeInfo().GetShape();
+    int32_t batch_size = shape[0];
+    int32_t num_tokens = shape[1];
+    int64_t n = offset.GetTensorData<int64_t>()[0];
+
+    // Like the exported decoder, which gives wrong results otherwise
+    if (num_tokens > 1 && n > 0) {
+      ADD_FAILURE() << "Several tokens can be processed only at offset 0. "
+                    << "Given " << num_tokens << " tokens at offset " << n;
+    }
+
+    // The cross kv cache of a single utterance is shared by the batch
+    int64_t cross_batch_size =
+        n_layer_cross_k.GetTensorTypeAndShapeInfo().GetShape()[1];
+
+    Ort::Value self_k = Copy(n_layer_self_k_cache);
+    Ort::Value self_v = Copy(n_layer_self_v_cache);
+
+    std::array<int64_t, 3> logits_shape{batch_size, num_tokens, kVocabSize};
+    Ort::Value logits = Ort::Value::CreateTensor<float>(
+        allocator_, logits_shape.data(), logits_shape.size());
+
+    float *p_logits = logits.GetTensorMutableData<float>();
+    std::fill_n(p_logits, batch_size * num_tokens * kVocabSize, 0);
+
+    const int64_t *p_tokens = tokens.GetTensorData<int64_t>();
+    const float *p_cross_k = n_layer_cross_k.GetTensorData<float>();
+
+    for (int32_t b = 0; b != batch_size; ++b) {
+      float *p_k = self_k.GetTensorMutableData<float>() + b * kTextCtx;
+      std::copy(p_tokens + b * num_tokens, p_tokens + (b + 1) * num_tokens,
+                p_k + n);
+
+      int32_t r = p_cross_k[cross_batch_size == 1 ? 0 : b];
+
+      int32_t sum = 0;
+      for (int32_t i = 0; i != n + num_tokens; ++i) {
+        sum += static_cast<int32_t>(p_k[i]);
+      }
+
+      // Number of decoded tokens, excluding the initial tokens
+      int32_t len = n + num_tokens - NumInitialTokens();
+
+      int32_t target = len >= r ? kEot : (7 * r + sum) % 50 + 10;
+
+      float *p = p_logits + ((b + 1) * num_tokens - 1) * kVocabSize;
+
+      // eot is unlikely unless it is predicted, so all beams end together
+      p[kEot] = -10;
+      p[target] = 10;
+    }
+
+    return {std::move(logits),          std::move(self_k),
+            std::move(self_v),          std::move(n_layer_cross_k),
+            std::move(n_layer_cross_v), std::move(offset)};
+  }
+
+  std::vector<int32_t> DetectLanguages(
+      Ort::Value &cross_k,              // NOLINT
+      Ort::Value &cross_v) override {  // NOLINT
+    int32_t batch_size = cross_k.GetTensorTypeAndShapeInfo().GetShape()[1];
+
+    std::array<int64_t, 2> token_shape{batch_size, 1};
+    Ort::Value tokens = Ort::Value::CreateTensor<int64_t>(
+        allocator_, token_shape.data(), token_shape.size());
+    std::fill_n(tokens.GetTensorMutableData<int64_t>(), batch_size, kSot);
+
+    std::array<int64_t, 1> offset_shape{1};
+    Ort::Value offset = Ort::Value::CreateTensor<int64_t>(
+        allocator_, offset_shape.data(), offset_shape.size());
+    *offset.GetTensorMutableData<int64_t>() = 0;
+
+    auto self_kv = GetInitialSelfKVCache(batch_size);
+    auto decoder_out = ForwardDecoder(
+        std::move(tokens), std::move(self_kv.first), std::move(self_kv.second),
+        std::move(cross_k), std::move(cross_v), std::move(offset));
+
+    cross_k = std::move(std::get<3>(decoder_out));
+    cross_v = std::move(std::get<4>(decoder_out));
+
+    std::vector<int32_t> ans(batch_size);
+    const float *p = cross_k.GetTensorData<float>();
+    for (int32_t b = 0; b != batch_size; ++b) {
+      ans[b] = lang_ids_[static_cast<int32_t>(p[b]) % lang_ids_.size()];
+    }
+
+    return ans;
+  }
+
+  std::pair<Ort::Value, Ort::Value> GetInitialSelfKVCache(
+      int32_t batch_size = 1) const override {
+    std::array<int64_t, 4> shape{1, batch_size, kTextCtx, 1};
+
+    Ort::Value k = Ort::Value::CreateTensor<float>(allocator_, shape.data(),
+                                                   shape.size());
+    Ort::Value v = Ort::Value::CreateTensor<float>(allocator_, shape.data(),
+                                                   shape.size());
+
+    std::fill_n(k.GetTensorMutableData<float>(), batch_size * kTextCtx, 0);
+    std::fill_n(v.GetTensorMutableData<float>(), batch_size * kTextCtx, 0);
+
+    return {std::move(k), std::move(v)};
+  }
+
+  const std::vector<int64_t> &GetInitialTokens() const override {
+    return initial_tokens_;
+  }
+
+  const std::vector<int32_t> &GetAllLanguageIDs() const override {
+    return lang_ids_;
+  }
+
+  const std::unordered_map<std::string, int32_t> &GetLang2ID()
+      const override {
+    return lang2id_;
+  }
+
+  const std::unordered_map<int32_t, std::string> &GetID2Lang()
+      const override {
+    return id2lang_;
+  }
+
+  OrtAllocator *Allocator() const override { return allocator_; }
+
+  int32_t NoTimeStampsToken() const override { return kNoTimeStamps; }
+  int32_t EOT() const override { return kEot; }
+  int32_t SOT() const override { return kSot; }
+  int32_t TextCtx() const override { return kTextCtx; }
+  int32_t VocabSize() const override { return kVocabSize; }
+  int32_t Translate() const override { return kTranslate; }
+  bool IsMultiLingual() const override { return is_multilingual_; }
+
+ private:
+  // Including no_timestamps
+  int32_t NumInitialTokens() const { return initial_tokens_.size() + 1; }
+
+  Ort::Value Copy(const Ort::Value &v) const {
+    auto shape = v.GetTensorTypeAndShapeInfo().GetShape();
+    Ort::Value ans = Ort::Value::CreateTensor<float>(allocator_, shape.data(),
+                                                     shape.size());
+
+    int64_t n = shape[0] * shape[1] * shape[2] * shape[3];
+    const float *p = v.GetTensorData<float>();
+    std::copy(p, p + n, ans.GetTensorMutableData<float>());
+
+    return ans;
+  }
+
+ private:
+  bool is_multilingual_;
+  std::vector<int64_t> initial_tokens_;
+  std::vector<int32_t> lang_ids_;
+  std::unordered_map<std::string, int32_t> lang2id_;
+  std::unordered_map<int32_t, std::string> id2lang_;
+  mutable Ort::AllocatorWithDefaultOptions allocator_;
+};
+
+static std::vector<OfflineWhisperDecoderResult> Decode(
+    FakeWhisperModel *model, OfflineWhisperDecoder *decoder,
+    const std::vector<int32_t> &num_tokens,
+    const std::vector<int32_t> &num_feature_frames) {
+  return decoder->Decode(model->CrossKV(num_tokens), model->CrossKV(num_tokens),
+                         num_feature_frames);
+}
+
+TEST(OfflineWhisperDecoder, BeamSize1EqualsGreedySearch) {
+  // Utterance i decodes num_tokens[i] tokens before eot if
+  // num_feature_frames[i] allows it. Audio shorter than 1 second decodes
+  // nothing.
+  std::vector<int32_t> num_tokens = {5, 5, 20, 40, 3};
+  std::vector<int32_t> num_feature_frames = {1000, 50, 200, 3000, 99};
+  std::vector<int32_t> expected_sizes = {5, 0, 12, 32, 0};
+
+  for (bool is_multilingual : {false, true}) {
+    for (const std::string &language : {"", "de"}) {
+      if (!is_multilingual && !language.empty()) {
+        continue;
+      }
+
+      FakeWhisperModel model(is_multilingual);
+
+      OfflineWhisperModelConfig config;
+      config.language = language;
+
+      OfflineWhisperGreedySearchDecoder greedy(config, &model);
+      auto expected =
+          Decode(&model, &greedy, num_tokens, num_feature_frames);
+
+      ASSERT_EQ(expected.size(), num_tokens.size());
+      for (int32_t i = 0; i != static_cast<int32_t>(num_tokens.size()); ++i) {
+        EXPECT_EQ(expected[i].tokens.size(), expected_sizes[i]);
+      }
+
+      OfflineWhisperModifiedBeamSearchDecoder beam_search(config, &model, 1);
+
+      auto results =
+          Decode(&model, &beam_search, num_tokens, num_feature_frames);
+
+      ASSERT_EQ(results.size(), num_tokens.size());
+      for (int32_t i = 0; i != static_cast<int32_t>(num_tokens.size()); ++i) {
+        EXPECT_EQ(results[i].tokens, expected[i].tokens);
+        EXPECT_EQ(results[i].lang, expected[i].lang);
+
+        // Decoding an utterance on its own gives the same result
+        auto r = Decode(&model, &beam_search, {num_tokens[i]},
+                        {num_feature_frames[i]});
+        EXPECT_EQ(r[0].tokens, expected[i].tokens);
+      }
+    }
+  }
+}
+
+TEST(OfflineWhisperDecoder, ModifiedBeamSearch) {
+  // The best path of the fake model is the one of greedy search
+  std::vector<int32_t> num_tokens = {5, 5, 20};
+  std::vector<int32_t> num_feature_frames = {1000, 50, 200};
+
+  FakeWhisperModel model(/*is_multilingual*/ true);
+
+  OfflineWhisperModelConfig config;
+  OfflineWhisperGreedySearchDecoder greedy(config, &model);
+  auto expected = Decode(&model, &greedy, num_tokens, num_feature_frames);
+
+  OfflineWhisperModifiedBeamSearchDecoder beam_search(config, &model, 4);
+  auto results = Decode(&model, &beam_search, num_tokens, num_feature_frames);
+
+  ASSERT_EQ(results.size(), num_tokens.size());
+  for (int32_t i = 0; i != static_cast<int32_t>(num_tokens.size()); ++i) {
+    EXPECT_EQ(results[i].tokens, expected[i].tokens);
+  }
+
+  EXPECT_EQ(results[0].tokens.size(), 5);
+  EXPECT_TRUE(results[1].tokens.empty());
+}
+
+TEST(OfflineWhisperDecoder, DetectLanguage) {
+  // The fake model detects de for all of them
+  std::vector<int32_t> num_tokens = {7, 4, 10};
+  std::vector<int32_t> num_feature_frames = {1000, 1000, 1000};
+
+  FakeWhisperModel model(/*is_multilingual*/ true);
+
+  OfflineWhisperModelConfig config;
+  config.language = "de";
+
+  OfflineWhisperGreedySearchDecoder greedy(config, &model);
+  auto expected = Decode(&model, &greedy, num_tokens, num_feature_frames);
+
+  config.language = "";
+  greedy.SetConfig(config);
+  auto results = Decode(&model, &greedy, num_tokens, num_feature_frames);
+
+  OfflineWhisperModifiedBeamSearchDecoder beam_search(config, &model, 1);
+  auto beam_results =
+      Decode(&model, &beam_search, num_tokens, num_feature_frames);
+
+  ASSERT_EQ(results.size(), num_tokens.size());
+  ASSERT_EQ(beam_results.size(), num_tokens.size());
+  for (int32_t i = 0; i != static_cast<int32_t>(num_tokens.size()); ++i) {
+    EXPECT_EQ(results[i].lang, "de");
+    EXPECT_EQ(results[i].tokens, expected[i].tokens);
+    EXPECT_EQ(beam_results[i].lang, "de");
+    EXPECT_EQ(beam_results[i].tokens, expected[i].tokens);
+  }
+}
+
+}  // namespace sherpa_onnx
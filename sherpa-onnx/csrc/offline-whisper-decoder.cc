@@ -0,0 +1,73 @@
+// sherpa-onnx/csrc/offline-whisper-decoder.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/offline-whisper-decoder.h"
+
+#include <vector>
+
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/offline-whisper-model.h"
+
+namespace sherpa_onnx {
+
+std::vector<int64_t> BuildInitialTokens(
+    const OfflineWhisperModelConfig &config, OfflineWhisperModel *model,
+    Ort::Value &cross_k, Ort::Value &cross_v) {  // NOLINT
+  int32_t batch_size =
+      static_cast<int32_t>(cross_k.GetTensorTypeAndShapeInfo().GetShape()[1]);
+
+  // For multilingual models, initial_tokens contains [sot, language, task]
+  //   - language is English by default
+  //   - task is transcribe by default
+  //
+  // For non-multilingual models, initial_tokens contains [sot]
+  std::vector<int64_t> initial_tokens = model->GetInitialTokens();
+
+  // Language of each utterance
+  std::vector<int32_t> lang_ids;
+
+  if (model->IsMultiLingual()) {
+    if (!config.language.empty()) {
+      const auto &lang2id = model->GetLang2ID();
+
+      if (!lang2id.count(config.language)) {
+        SHERPA_ONNX_LOGE("Invalid language: %s", config.language.c_str());
+        exit(-1);
+      }
+
+      lang_ids.resize(batch_size, lang2id.at(config.language));
+    } else {
+      lang_ids = model->DetectLanguages(cross_k, cross_v);
+    }
+
+    if (config.task == "translate") {
+      initial_tokens[2] = model->Translate();
+    } else if (config.task != "transcribe") {
+      // initial_tokens[2] is transcribe by default
+      SHERPA_ONNX_LOGE(
+          "Unsupported task: %s. Valid values are: transcribe, translate.",
+          config.task.c_str());
+    }
+  }
+
+  initial_tokens.push_back(model->NoTimeStampsToken());
+
+  int32_t num_initial_tokens = static_cast<int32_t>(initial_tokens.size());
+
+  std::vector<int64_t> batch_initial_tokens;
+  batch_initial_tokens.reserve(batch_size * num_initial_tokens);
+  for (int32_t b = 0; b != batch_size; ++b) {
+    batch_initial_tokens.insert(batch_initial_tokens.end(),
+                                initial_tokens.begin(), initial_tokens.end());
+
+    if (!lang_ids.empty()) {
+      // 0: sot, 1: lang_id, 2: task, 3: no_timestamps
+      batch_initial_tokens[b * num_initial_tokens + 1] = lang_ids[b];
+    }
+  }
+
+  return batch_initial_tokens;
+}
+
+}  // namespace sherpa_onnx
@@ -13,6 +13,8 @@
 
 namespace sherpa_onnx {
 
+class OfflineWhisperModel;
+
 struct OfflineWhisperDecoderResult {
   /// The decoded token IDs
   std::vector<int32_t> tokens;
@@ -29,16 +31,32 @@ class OfflineWhisperDecoder {
    *                              (n_text_layer, N, n_audio_ctx, n_text_state).
    * @param n_layer_cross_v       A 4-D tensor of shape
    *                              (n_text_layer, N, n_audio_ctx, n_text_state).
+   * @param num_feature_frames    A vector of size N. Number of feature frames
+   *                              of each utterance without paddings.
    *
    * @return Return a vector of size `N` containing the decoded results.
    */
   virtual std::vector<OfflineWhisperDecoderResult> Decode(
       Ort::Value n_layer_cross_k, Ort::Value n_layer_cross_v,
-      int32_t num_feature_frames) = 0;
+      const std::vector<int32_t> &num_feature_frames) = 0;
 
   virtual void SetConfig(const OfflineWhisperModelConfig &config) = 0;
 };
 
+/** Return the initial tokens of each of the N utterances, e.g.,
+ * [sot, language, task, no_timestamps] for multilingual models and
+ * [sot, no_timestamps] otherwise.
+ *
+ * If config.language is empty, the language of each utterance is
+ * detected with model->DetectLanguages().
+ *
+ * @return Return a vector of size N * num_initial_tokens. The initial
+ *         tokens of utterance i start at i * num_initial_tokens.
+ */
+std::vector<int64_t> BuildInitialTokens(
+    const OfflineWhisperModelConfig &config, OfflineWhisperModel *model,
+    Ort::Value &cross_k, Ort::Value &cross_v);  // NOLINT
+
 }  // namespace sherpa_onnx
 
 #endif  // SHERPA_ONNX_CSRC_OFFLINE_WHISPER_DECODER_H_
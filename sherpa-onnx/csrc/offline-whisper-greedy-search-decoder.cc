@@ -7,7 +7,7 @@
 #include <algorithm>
 #include <utility>
 
-#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/index-select.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 
 namespace sherpa_onnx {
@@ -18,57 +18,24 @@ void OfflineWhisperGreedySearchDecoder::SetConfig(
 }
 
 std::vector<OfflineWhisperDecoderResult>
-OfflineWhisperGreedySearchDecoder::Decode(Ort::Value cross_k,
-                                          Ort::Value cross_v,
-                                          int32_t num_feature_frames) {
+OfflineWhisperGreedySearchDecoder::Decode(
+    Ort::Value cross_k, Ort::Value cross_v,
+    const std::vector<int32_t> &num_feature_frames) {
   auto memory_info =
       Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
 
-  // For multilingual models, initial_tokens contains [sot, language, task]
-  //   - language is English by default
-  //   - task is transcribe by default
-  //
-  // For non-multilingual models, initial_tokens contains [sot]
-  std::vector<int64_t> initial_tokens = model_->GetInitialTokens();
+  int32_t batch_size = static_cast<int32_t>(num_feature_frames.size());
 
-  if (model_->IsMultiLingual()) {
-    if (!config_.language.empty()) {
-      const auto &lang2id = model_->GetLang2ID();
+  std::vector<int64_t> batch_initial_tokens =
+      BuildInitialTokens(config_, model_, cross_k, cross_v);
 
-      if (!lang2id.count(config_.language)) {
-        SHERPA_ONNX_LOGE("Invalid language: %s", config_.language.c_str());
-        exit(-1);
-      }
-
-      int32_t lang_id = lang2id.at(config_.language);
-
-      // 0: sot, 1: lang_id, 2: task, 3: no_timestamps
-      initial_tokens[1] = lang_id;
-    } else {
-      int32_t lang_id = model_->DetectLanguage(cross_k, cross_v);
-
-      // 0: sot, 1: lang_id, 2: task, 3: no_timestamps
-      initial_tokens[1] = lang_id;
-    }
-
-    if (config_.task == "translate") {
-      initial_tokens[2] = model_->Translate();
-    } else if (config_.task != "transcribe") {
-      // initial_tokens[2] is transcribe by default
-      SHERPA_ONNX_LOGE(
-          "Unsupported task: %s. Valid values are: transcribe, translate.",
-          config_.task.c_str());
-    }
-  }
+  int32_t num_initial_tokens =
+      static_cast<int32_t>(batch_initial_tokens.size()) / batch_size;
 
-  initial_tokens.push_back(model_->NoTimeStampsToken());
-
-  int32_t batch_size = 1;
-  std::array<int64_t, 2> token_shape{
-      batch_size, static_cast<int64_t>(initial_tokens.size())};
+  std::array<int64_t, 2> token_shape{batch_size, num_initial_tokens};
 
   Ort::Value tokens = Ort::Value::CreateTensor(
-      memory_info, initial_tokens.data(), initial_tokens.size(),
+      memory_info, batch_initial_tokens.data(), batch_initial_tokens.size(),
       token_shape.data(), token_shape.size());
 
   std::array<int64_t, 1> offset_shape{1};
@@ -76,15 +43,16 @@ OfflineWhisperGreedySearchDecoder::Decode(Ort::Value cross_k,
       model_->Allocator(), offset_shape.data(), offset_shape.size());
   *(offset.GetTensorMutableData<int64_t>()) = 0;
 
-  auto self_kv_cache = model_->GetInitialSelfKVCache();
+  auto self_kv_cache = model_->GetInitialSelfKVCache(batch_size);
 
   auto decoder_out = model_->ForwardDecoder(
       std::move(tokens), std::move(self_kv_cache.first),
       std::move(self_kv_cache.second), std::move(cross_k), std::move(cross_v),
       std::move(offset));
 
+  // All utterances share the offset, so they advance in lockstep
   *(std::get<5>(decoder_out).GetTensorMutableData<int64_t>()) =
-      initial_tokens.size();
+      num_initial_tokens;
 
   const auto &logits = std::get<0>(decoder_out);
   const float *p_logits = logits.GetTensorData<float>();
@@ -92,32 +60,85 @@ OfflineWhisperGreedySearchDecoder::Decode(Ort::Value cross_k,
   auto logits_shape = logits.GetTensorTypeAndShapeInfo().GetShape();
   int32_t vocab_size = logits_shape[2];
 
-  const float *p_start = p_logits + (logits_shape[1] - 1) * vocab_size;
+  // Utterances that are not finished yet. active[i] is the index of the
+  // utterance in row i of the current batch.
+  std::vector<int32_t> active(batch_size);
+
+  // The predicted token of each row of the current batch
+  std::vector<int32_t> max_token_ids(batch_size);
+
+  for (int32_t b = 0; b != batch_size; ++b) {
+    active[b] = b;
+
+    const float *p_start =
+        p_logits + (b * logits_shape[1] + logits_shape[1] - 1) * vocab_size;
 
-  int32_t max_token_id = static_cast<int32_t>(
-      std::distance(p_start, std::max_element(p_start, p_start + vocab_size)));
+    max_token_ids[b] = static_cast<int32_t>(std::distance(
+        p_start, std::max_element(p_start, p_start + vocab_size)));
+  }
 
   int32_t n_text_ctx = model_->TextCtx();
 
-  std::vector<int32_t> predicted_tokens;
+  std::vector<int32_t> num_possible_tokens(batch_size);
+  for (int32_t b = 0; b != batch_size; ++b) {
+    // assume at most 6 tokens per second
+    num_possible_tokens[b] = std::min<int32_t>(
+        num_feature_frames[b] / 100 * 6, n_text_ctx / 2);
+  }
+
+  std::vector<std::vector<int32_t>> predicted_tokens(batch_size);
+
+  // Rows of the current batch to keep for the next step
+  std::vector<int32_t> keep;
+  keep.reserve(batch_size);
 
-  // assume at most 6 tokens per second
-  int32_t num_possible_tokens = num_feature_frames / 100 * 6;
-  num_possible_tokens = std::min<int32_t>(num_possible_tokens, n_text_ctx / 2);
+  std::vector<int64_t> next_tokens;
+  next_tokens.reserve(batch_size);
 
-  for (int32_t i = 0; i < num_possible_tokens; ++i) {
-    if (max_token_id == model_->EOT()) {
+  while (true) {
+    keep.clear();
+    next_tokens.clear();
+
+    for (int32_t i = 0; i != static_cast<int32_t>(active.size()); ++i) {
+      int32_t b = active[i];
+      if (max_token_ids[i] == model_->EOT() ||
+          static_cast<int32_t>(predicted_tokens[b].size()) >=
+              num_possible_tokens[b]) {
+        continue;
+      }
+
+      predicted_tokens[b].push_back(max_token_ids[i]);
+
+      keep.push_back(i);
+      next_tokens.push_back(max_token_ids[i]);
+    }
+
+    if (keep.empty()) {
       break;
     }
 
-    predicted_tokens.push_back(max_token_id);
+    if (keep.size() != active.size()) {
+      // Drop finished utterances from the batch so that they are not
+      // computed any longer
+      for (auto *v : {&std::get<1>(decoder_out), &std::get<2>(decoder_out),
+                      &std::get<3>(decoder_out), &std::get<4>(decoder_out)}) {
+        *v = IndexSelectDim1(model_->Allocator(), v, keep);
+      }
 
-    std::array<int64_t, 2> token_shape{1, 1};
+      for (int32_t i = 0; i != static_cast<int32_t>(keep.size()); ++i) {
+        active[i] = active[keep[i]];
+      }
+      active.resize(keep.size());
+    }
+
+    int32_t cur_batch_size = static_cast<int32_t>(active.size());
+
+    std::array<int64_t, 2> token_shape{cur_batch_size, 1};
     Ort::Value tokens = Ort::Value::CreateTensor<int64_t>(
         model_->Allocator(), token_shape.data(), token_shape.size());
 
-    int64_t *p_tokens = tokens.GetTensorMutableData<int64_t>();
-    p_tokens[0] = max_token_id;
+    std::copy(next_tokens.begin(), next_tokens.end(),
+              tokens.GetTensorMutableData<int64_t>());
 
     decoder_out = model_->ForwardDecoder(std::move(tokens),
                                          std::move(std::get<1>(decoder_out)),
@@ -137,20 +158,24 @@ OfflineWhisperGreedySearchDecoder::Decode(Ort::Value cross_k,
     const auto &logits = std::get<0>(decoder_out);
     const float *p_logits = logits.GetTensorData<float>();
 
-    max_token_id = static_cast<int64_t>(std::distance(
-        p_logits, std::max_element(p_logits, p_logits + vocab_size)));
+    for (int32_t i = 0; i != cur_batch_size; ++i) {
+      const float *p = p_logits + i * vocab_size;
+      max_token_ids[i] = static_cast<int32_t>(
+          std::distance(p, std::max_element(p, p + vocab_size)));
+    }
   }
 
-  std::vector<OfflineWhisperDecoderResult> ans(1);
+  std::vector<OfflineWhisperDecoderResult> ans(batch_size);
 
   const auto &id2lang = model_->GetID2Lang();
-  if (id2lang.count(initial_tokens[1])) {
-    ans[0].lang = id2lang.at(initial_tokens[1]);
-  } else {
-    ans[0].lang = "";
-  }
+  for (int32_t b = 0; b != batch_size; ++b) {
+    int32_t lang_id = batch_initial_tokens[b * num_initial_tokens + 1];
+    if (model_->IsMultiLingual() && id2lang.count(lang_id)) {
+      ans[b].lang = id2lang.at(lang_id);
+    }
 
-  ans[0].tokens = std::move(predicted_tokens);
+    ans[b].tokens = std::move(predicted_tokens[b]);
+  }
 
   return ans;
 }
@@ -31,7 +31,7 @@ class OfflineWhisperModel {
   OfflineWhisperModel(Manager *mgr,
                       const SpokenLanguageIdentificationConfig &config);
 
-  ~OfflineWhisperModel();
+  virtual ~OfflineWhisperModel();
 
   /** Run the encoder model.
    *
@@ -44,7 +44,8 @@ class OfflineWhisperModel {
    *  - n_layer_cross_v: A 4-D tensor of shape
    *                     (n_text_layer, N, n_audio_ctx, n_text_state)
    */
-  std::pair<Ort::Value, Ort::Value> ForwardEncoder(Ort::Value features) const;
+  virtual std::pair<Ort::Value, Ort::Value> ForwardEncoder(
+      Ort::Value features) const;
 
   /** Run the decoder model.
    *
@@ -57,7 +58,9 @@ class OfflineWhisperModel {
    *                              (n_text_layer, N, n_audio_ctx, n_text_state).
    * @param n_layer_cross_v       A 4-D tensor of shape
    *                              (n_text_layer, N, n_audio_ctx, n_text_state).
-   * @param offset A int64 tensor of shape (N,)
+   * @param offset A int64 tensor of shape (1,). The number of tokens
+   *               already in the self kv cache. It is shared by all N
+   *               utterances, so they have to be decoded in lockstep.
    *
    * @return Return a tuple containing 6 tensors:
    *
@@ -68,8 +71,8 @@ class OfflineWhisperModel {
    *  - out_n_layer_cross_v Same as n_layer_cross_v
    *  - out_offset Same as offset
    */
-  std::tuple<Ort::Value, Ort::Value, Ort::Value, Ort::Value, Ort::Value,
-             Ort::Value>
+  virtual std::tuple<Ort::Value, Ort::Value, Ort::Value, Ort::Value,
+                     Ort::Value, Ort::Value>
   ForwardDecoder(Ort::Value tokens, Ort::Value n_layer_self_k_cache,
                  Ort::Value n_layer_self_v_cache, Ort::Value n_layer_cross_k,
                  Ort::Value n_layer_cross_v, Ort::Value offset) const;
@@ -77,34 +80,53 @@ class OfflineWhisperModel {
   int32_t DetectLanguage(Ort::Value &cross_k,   // NOLINT
                          Ort::Value &cross_v);  // NOLINT
 
+  /** Detect the language of each of the N utterances in a single run of
+   * the decoder.
+   *
+   * @param cross_k Output of ForwardEncoder() for N utterances.
+   * @param cross_v Output of ForwardEncoder() for N utterances.
+   *
+   * @return Return a vector of size N containing the language token IDs.
+   */
+  virtual std::vector<int32_t> DetectLanguages(
+      Ort::Value &cross_k,   // NOLINT
+      Ort::Value &cross_v);  // NOLINT
+
   /** Return the initial self kv cache in a pair
    *  - n_layer_self_k_cache A 4-D tensor of shape
-   *                         (n_text_layer, N, n_audio_ctx, n_text_state).
+   *                         (n_text_layer, N, n_text_ctx, n_text_state).
    *  - n_layer_self_v_cache A 4-D tensor of shape
-   *                         (n_text_layer, N, n_audio_ctx, n_text_state).
+   *                         (n_text_layer, N, n_text_ctx, n_text_state).
+   *
+   * @param batch_size N
    */
-  std::pair<Ort::Value, Ort::Value> GetInitialSelfKVCache() const;
-  const std::vector<int64_t> &GetInitialTokens() const;
-  const std::vector<int32_t> &GetAllLanguageIDs() const;
-  const std::unordered_map<std::string, int32_t> &GetLang2ID() const;
-  const std::unordered_map<int32_t, std::string> &GetID2Lang() const;
+  virtual std::pair<Ort::Value, Ort::Value> GetInitialSelfKVCache(
+      int32_t batch_size = 1) const;
+  virtual const std::vector<int64_t> &GetInitialTokens() const;
+  virtual const std::vector<int32_t> &GetAllLanguageIDs() const;
+  virtual const std::unordered_map<std::string, int32_t> &GetLang2ID() const;
+  virtual const std::unordered_map<int32_t, std::string> &GetID2Lang() const;
 
   /** Return an allocator for allocating memory
    */
-  OrtAllocator *Allocator() const;
+  virtual OrtAllocator *Allocator() const;
 
-  int32_t NoTimeStampsToken() const;
-  int32_t EOT() const;
-  int32_t SOT() const;
-  int32_t TextCtx() const;
-  int32_t VocabSize() const;
-  int32_t FeatureDim() const;
-  int32_t Translate() const;
-  bool IsMultiLingual() const;
+  virtual int32_t NoTimeStampsToken() const;
+  virtual int32_t EOT() const;
+  virtual int32_t SOT() const;
+  virtual int32_t TextCtx() const;
+  virtual int32_t VocabSize() const;
+  virtual int32_t FeatureDim() const;
+  virtual int32_t Translate() const;
+  virtual bool IsMultiLingual() const;
 
   static void NormalizeFeatures(float *features, int32_t num_frames,
                                 int32_t feat_dim);
 
+ protected:
+  // For subclasses that don't load a model, e.g., fakes in tests
+  OfflineWhisperModel();
+
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
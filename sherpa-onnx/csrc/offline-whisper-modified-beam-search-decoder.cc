@@ -0,0 +1,301 @@
+// sherpa-onnx/csrc/offline-whisper-modified-beam-search-decoder.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/offline-whisper-modified-beam-search-decoder.h"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/index-select.h"
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/math.h"
+#include "sherpa-onnx/csrc/onnx-utils.h"
+
+namespace sherpa_onnx {
+
+namespace {
+
+struct BeamHypothesis {
+  std::vector<int32_t> tokens;
+  float log_prob = 0;
+};
+
+struct BeamCandidate {
+  float log_prob;
+  int32_t row;  // index of the hypothesis it extends
+  int32_t token;
+};
+
+// dst[:, i, :num_valid, :] = src[:, parents[i], :num_valid, :]
+//
+// src and dst are of shape (n_text_layer, N, n_text_ctx, n_text_state).
+// Entries after num_valid are not used by the decoder, so they are not
+// copied.
+void ReorderSelfKVCache(const Ort::Value &src,
+                        const std::vector<int32_t> &parents,
+                        int32_t num_valid, Ort::Value *dst) {
+  auto src_shape = src.GetTensorTypeAndShapeInfo().GetShape();
+  auto dst_shape = dst->GetTensorTypeAndShapeInfo().GetShape();
+
+  int64_t n_layer = src_shape[0];
+  int64_t src_batch_size = src_shape[1];
+  int64_t dst_batch_size = dst_shape[1];
+  int64_t stride = src_shape[2] * src_shape[3];
+  int64_t n = num_valid * src_shape[3];
+
+  const float *p_src = src.GetTensorData<float>();
+  float *p_dst = dst->GetTensorMutableData<float>();
+
+  for (int64_t l = 0; l != n_layer; ++l) {
+    for (int32_t i = 0; i != static_cast<int32_t>(parents.size()); ++i) {
+      const float *p = p_src + (l * src_batch_size + parents[i]) * stride;
+      std::copy(p, p + n, p_dst + (l * dst_batch_size + i) * stride);
+    }
+  }
+}
+
+}  // namespace
+
+void OfflineWhisperModifiedBeamSearchDecoder::SetConfig(
+    const OfflineWhisperModelConfig &config) {
+  config_ = config;
+}
+
+std::vector<OfflineWhisperDecoderResult>
+OfflineWhisperModifiedBeamSearchDecoder::Decode(
+    Ort::Value cross_k, Ort::Value cross_v,
+    const std::vector<int32_t> &num_feature_frames) {
+  int32_t batch_size = static_cast<int32_t>(num_feature_frames.size());
+
+  std::vector<int64_t> batch_initial_tokens =
+      BuildInitialTokens(config_, model_, cross_k, cross_v);
+
+  int32_t num_initial_tokens =
+      static_cast<int32_t>(batch_initial_tokens.size()) / batch_size;
+
+  int32_t n_text_ctx = model_->TextCtx();
+
+  const auto &id2lang = model_->GetID2Lang();
+
+  std::vector<OfflineWhisperDecoderResult> ans(batch_size);
+
+  for (int32_t b = 0; b != batch_size; ++b) {
+    // assume at most 6 tokens per second
+    int32_t max_num_tokens =
+        std::min<int32_t>(num_feature_frames[b] / 100 * 6, n_text_ctx / 2);
+
+    const int64_t *initial_tokens =
+        batch_initial_tokens.data() + b * num_initial_tokens;
+
+    if (batch_size == 1) {
+      ans[b].tokens = DecodeOne(&cross_k, &cross_v, initial_tokens,
+                                num_initial_tokens, max_num_tokens);
+    } else {
+      Ort::Value this_cross_k =
+          IndexSelectDim1(model_->Allocator(), &cross_k, {b});
+      Ort::Value this_cross_v =
+          IndexSelectDim1(model_->Allocator(), &cross_v, {b});
+
+      ans[b].tokens = DecodeOne(&this_cross_k, &this_cross_v, initial_tokens,
+                                num_initial_tokens, max_num_tokens);
+    }
+
+    int32_t lang_id = initial_tokens[1];
+    if (model_->IsMultiLingual() && id2lang.count(lang_id)) {
+      ans[b].lang = id2lang.at(lang_id);
+    }
+  }
+
+  return ans;
+}
+
+std::vector<int32_t> OfflineWhisperModifiedBeamSearchDecoder::DecodeOne(
+    Ort::Value *cross_k, Ort::Value *cross_v, const int64_t *initial_tokens,
+    int32_t num_initial_tokens, int32_t max_num_tokens) {
+  OrtAllocator *allocator = model_->Allocator();
+
+  int32_t beam_size = max_active_paths_;
+  int32_t eot = model_->EOT();
+  int32_t n_text_ctx = model_->TextCtx();
+
+  std::array<int64_t, 2> token_shape{1, num_initial_tokens};
+  Ort::Value tokens = Ort::Value::CreateTensor<int64_t>(
+      allocator, token_shape.data(), token_shape.size());
+
+  std::copy(initial_tokens, initial_tokens + num_initial_tokens,
+            tokens.GetTensorMutableData<int64_t>());
+
+  std::array<int64_t, 1> offset_shape{1};
+  Ort::Value offset = Ort::Value::CreateTensor<int64_t>(
+      allocator, offset_shape.data(), offset_shape.size());
+
+  int64_t *p_offset = offset.GetTensorMutableData<int64_t>();
+  *p_offset = 0;
+
+  auto self_kv_cache = model_->GetInitialSelfKVCache(1);
+
+  // The initial tokens are processed for a single hypothesis
+  auto decoder_out = model_->ForwardDecoder(
+      std::move(tokens), std::move(self_kv_cache.first),
+      std::move(self_kv_cache.second), View(cross_k), View(cross_v),
+      View(&offset));
+
+  *p_offset = num_initial_tokens;
+
+  // The self kv cache of all beams. The output of the decoder is reordered
+  // into it at each step, so it is allocated only once.
+  auto kv_shape =
+      std::get<1>(decoder_out).GetTensorTypeAndShapeInfo().GetShape();
+  kv_shape[1] = beam_size;
+
+  Ort::Value self_k = Ort::Value::CreateTensor<float>(
+      allocator, kv_shape.data(), kv_shape.size());
+  Ort::Value self_v = Ort::Value::CreateTensor<float>(
+      allocator, kv_shape.data(), kv_shape.size());
+
+  int64_t kv_size = kv_shape[0] * kv_shape[1] * kv_shape[2] * kv_shape[3];
+  std::fill_n(self_k.GetTensorMutableData<float>(), kv_size, 0);
+  std::fill_n(self_v.GetTensorMutableData<float>(), kv_size, 0);
+
+  // Used only if the decoder cannot share cross_k and cross_v among beams
+  Ort::Value repeated_cross_k{nullptr};
+  Ort::Value repeated_cross_v{nullptr};
+
+  std::vector<BeamHypothesis> hyps(1);
+  std::vector<BeamHypothesis> finished;
+
+  std::vector<BeamCandidate> candidates;
+  std::vector<BeamHypothesis> next_hyps;
+  std::vector<int32_t> parents;
+
+  while (true) {
+    // Check the limits before expanding so that, like greedy search, no
+    // token is decoded if max_num_tokens is 0. All hypotheses have the
+    // same number of tokens.
+    if (static_cast<int32_t>(hyps[0].tokens.size()) >= max_num_tokens ||
+        *p_offset >= n_text_ctx - 1) {
+      finished.insert(finished.end(), hyps.begin(), hyps.end());
+      break;
+    }
+
+    const auto &logits = std::get<0>(decoder_out);
+    const float *p_logits = logits.GetTensorData<float>();
+
+    // (num_hyps, num_tokens, vocab_size)
+    auto logits_shape = logits.GetTensorTypeAndShapeInfo().GetShape();
+    int32_t num_tokens = logits_shape[1];
+    int32_t vocab_size = logits_shape[2];
+
+    candidates.clear();
+    for (int32_t i = 0; i != static_cast<int32_t>(hyps.size()); ++i) {
+      // logits of the last token
+      const float *p =
+          p_logits + (i * num_tokens + num_tokens - 1) * vocab_size;
+      float log_sum = LogSumExp(p, vocab_size);
+
+      // At most one of them is eot, so there are always enough candidates
+      // to fill the beam
+      for (auto t : TopkIndex(p, vocab_size, beam_size + 1)) {
+        candidates.push_back({hyps[i].log_prob + p[t] - log_sum, i, t});
+      }
+    }
+
+    std::sort(candidates.begin(), candidates.end(),
+              [](const BeamCandidate &a, const BeamCandidate &b) {
+                return a.log_prob > b.log_prob;
+              });
+
+    next_hyps.clear();
+    parents.clear();
+    for (const auto &c : candidates) {
+      if (c.token == eot) {
+        if (static_cast<int32_t>(finished.size()) < beam_size) {
+          finished.push_back({hyps[c.row].tokens, c.log_prob});
+        }
+        continue;
+      }
+
+      BeamHypothesis h{hyps[c.row].tokens, c.log_prob};
+      h.tokens.push_back(c.token);
+
+      next_hyps.push_back(std::move(h));
+      parents.push_back(c.row);
+
+      if (static_cast<int32_t>(next_hyps.size()) == beam_size) {
+        break;
+      }
+    }
+
+    if (static_cast<int32_t>(finished.size()) >= beam_size) {
+      break;
+    }
+
+    ReorderSelfKVCache(std::get<1>(decoder_out), parents, *p_offset, &self_k);
+    ReorderSelfKVCache(std::get<2>(decoder_out), parents, *p_offset, &self_v);
+
+    std::swap(hyps, next_hyps);
+
+    token_shape = {static_cast<int64_t>(hyps.size()), 1};
+    tokens = Ort::Value::CreateTensor<int64_t>(allocator, token_shape.data(),
+                                               token_shape.size());
+
+    int64_t *p_tokens = tokens.GetTensorMutableData<int64_t>();
+    for (const auto &h : hyps) {
+      *p_tokens++ = h.tokens.back();
+    }
+
+    // All beams are expanded in a single run. The inputs are views, so
+    // nothing is lost if the run fails.
+    auto run = [&](Ort::Value *k, Ort::Value *v) {
+      return model_->ForwardDecoder(View(&tokens), View(&self_k),
+                                    View(&self_v), View(k), View(v),
+                                    View(&offset));
+    };
+
+    bool done = false;
+    if (!repeat_cross_kv_) {
+      try {
+        // cross_k and cross_v have a batch size of 1 and are broadcast
+        // over the beams
+        decoder_out = run(cross_k, cross_v);
+        done = true;
+      } catch (const Ort::Exception &ex) {
+        SHERPA_ONNX_LOGE(
+            "The decoder cannot share the cross kv cache among beams: %s\n"
+            "Repeat it for each beam instead",
+            ex.what());
+        repeat_cross_kv_ = true;
+      }
+    }
+
+    if (!done) {
+      if (!repeated_cross_k) {
+        std::vector<int32_t> indexes(beam_size, 0);
+        repeated_cross_k = IndexSelectDim1(allocator, cross_k, indexes);
+        repeated_cross_v = IndexSelectDim1(allocator, cross_v, indexes);
+      }
+
+      decoder_out = run(&repeated_cross_k, &repeated_cross_v);
+    }
+
+    *p_offset += 1;
+  }
+
+  // Normalize by length so that short hypotheses are not preferred
+  auto score = [](const BeamHypothesis &h) {
+    return h.log_prob / std::max<int32_t>(1, h.tokens.size());
+  };
+
+  auto best = std::max_element(
+      finished.begin(), finished.end(),
+      [&score](const BeamHypothesis &a, const BeamHypothesis &b) {
+        return score(a) < score(b);
+      });
+
+  return std::move(best->tokens);
+}
+
+}  // namespace sherpa_onnx
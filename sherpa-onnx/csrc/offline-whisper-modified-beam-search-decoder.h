@@ -0,0 +1,67 @@
+// sherpa-onnx/csrc/offline-whisper-modified-beam-search-decoder.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_CSRC_OFFLINE_WHISPER_MODIFIED_BEAM_SEARCH_DECODER_H_
+#define SHERPA_ONNX_CSRC_OFFLINE_WHISPER_MODIFIED_BEAM_SEARCH_DECODER_H_
+
+#include <atomic>
+#include <vector>
+
+#include "sherpa-onnx/csrc/offline-whisper-decoder.h"
+#include "sherpa-onnx/csrc/offline-whisper-model.h"
+
+namespace sherpa_onnx {
+
+/** Beam search for whisper.
+ *
+ * All beams of an utterance are expanded in a single run of the decoder.
+ * The self kv cache is reordered by beam into preallocated buffers and
+ * the cross kv cache of the utterance is shared by all beams.
+ */
+class OfflineWhisperModifiedBeamSearchDecoder : public OfflineWhisperDecoder {
+ public:
+  OfflineWhisperModifiedBeamSearchDecoder(
+      const OfflineWhisperModelConfig &config, OfflineWhisperModel *model,
+      int32_t max_active_paths)
+      : config_(config), model_(model), max_active_paths_(max_active_paths) {}
+
+  std::vector<OfflineWhisperDecoderResult> Decode(
+      Ort::Value cross_k, Ort::Value cross_v,
+      const std::vector<int32_t> &num_feature_frames) override;
+
+  void SetConfig(const OfflineWhisperModelConfig &config) override;
+
+ private:
+  /** Decode a single utterance.
+   *
+   * @param cross_k A 4-D tensor of shape
+   *                (n_text_layer, 1, n_audio_ctx, n_text_state).
+   * @param cross_v A 4-D tensor of shape
+   *                (n_text_layer, 1, n_audio_ctx, n_text_state).
+   * @param initial_tokens Pointer to num_initial_tokens tokens, e.g.,
+   *                       [sot, language, task, no_timestamps]
+   * @param num_initial_tokens
+   * @param max_num_tokens Maximum number of tokens to decode.
+   *
+   * @return Return the decoded tokens of the best hypothesis.
+   */
+  std::vector<int32_t> DecodeOne(Ort::Value *cross_k, Ort::Value *cross_v,
+                                 const int64_t *initial_tokens,
+                                 int32_t num_initial_tokens,
+                                 int32_t max_num_tokens);
+
+ private:
+  OfflineWhisperModelConfig config_;
+  OfflineWhisperModel *model_;  // not owned
+  int32_t max_active_paths_;
+
+  // Set to true if the decoder model cannot broadcast the cross kv cache
+  // of a single utterance over the beams. The cross kv cache is then
+  // repeated for each beam.
+  std::atomic<bool> repeat_cross_kv_{false};
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_OFFLINE_WHISPER_MODIFIED_BEAM_SEARCH_DECODER_H_
@@ -59,6 +59,16 @@ class OnlineCtcModel {
   virtual std::vector<Ort::Value> Forward(
       Ort::Value x, std::vector<Ort::Value> states) const = 0;
 
+  /** Give back tensors that are no longer used, e.g., the states passed to
+   * Forward() and the log_probs returned by it, so that a later Forward()
+   * can write its outputs into them instead of allocating new ones.
+   *
+   * The caller must own the tensors, i.e., they must not be views of
+   * other tensors. The default implementation frees them.
+   */
+  virtual void RecycleTensors(
+      std::vector<Ort::Value> /*tensors*/) const {}  // NOLINT
+
   /** Return the vocabulary size of the model
    */
   virtual int32_t VocabSize() const = 0;
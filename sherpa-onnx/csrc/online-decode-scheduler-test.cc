@@ -0,0 +1,373 @@
+// sherpa-onnx/csrc/online-decode-scheduler-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/online-decode-scheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <sched.h>
+#endif
+
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/online-recognizer-impl.h"
+
+namespace sherpa_onnx {
+
+// A fake recognizer to test the scheduler without onnx models.
+//
+// A stream is ready if it has at least kChunkSize unprocessed frames, or
+// any unprocessed frames after its input is finished. Each decoding
+// processes at most kChunkSize frames of a stream. The result is the
+// number of processed frames.
+class FakeRecognizerImpl : public OnlineRecognizerImpl {
+ public:
+  static constexpr int32_t kChunkSize = 10;
+
+  explicit FakeRecognizerImpl(int32_t decode_ms = 0)
+      : OnlineRecognizerImpl(OnlineRecognizerConfig{}),
+        decode_ms_(decode_ms) {}
+
+  std::unique_ptr<OnlineStream> CreateStream() const override {
+    return std::make_unique<OnlineStream>();
+  }
+
+  bool IsReady(OnlineStream *s) const override {
+    int32_t num_frames = s->NumFramesReady();
+    int32_t remaining = num_frames - s->GetNumProcessedFrames();
+    return remaining >= kChunkSize ||
+           (remaining > 0 && s->IsLastFrame(num_frames - 1));
+  }
+
+  void DecodeStreams(OnlineStream **ss, int32_t n) const override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      batch_sizes_.push_back(n);
+    }
+
+    if (decode_ms_ > 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(decode_ms_));
+    }
+
+    for (int32_t i = 0; i != n; ++i) {
+      int32_t &processed = ss[i]->GetNumProcessedFrames();
+      processed = std::min(processed + kChunkSize, ss[i]->NumFramesReady());
+    }
+  }
+
+  OnlineRecognizerResult GetResult(OnlineStream *s) const override {
+    OnlineRecognizerResult r;
+    r.text = std::to_string(s->GetNumProcessedFrames());
+    return r;
+  }
+
+  bool IsEndpoint(OnlineStream * /*s*/) const override { return false; }
+
+  void Reset(OnlineStream * /*s*/) const override {}
+
+  std::vector<int32_t> BatchSizes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return batch_sizes_;
+  }
+
+ private:
+  int32_t decode_ms_;
+  mutable std::mutex mutex_;
+  mutable std::vector<int32_t> batch_sizes_;
+};
+
+// Collect the results passed to the callback of the scheduler
+class ResultCollector {
+ public:
+  OnlineDecodeScheduler::Callback Callback() {
+    return [this](const OnlineRecognizerResult &r, bool is_last) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      results_.emplace_back(r.text, is_last);
+      if (is_last) {
+        EXPECT_TRUE(r.is_final);
+      }
+      cond_.notify_all();
+    };
+  }
+
+  // Return false if there are fewer than n results after timeout_ms
+  bool Wait(int32_t n, int32_t timeout_ms = 5000) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cond_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&]() {
+      return static_cast<int32_t>(results_.size()) >= n;
+    });
+  }
+
+  std::vector<std::pair<std::string, bool>> Results() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return results_;
+  }
+
+  int32_t NumLast() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::count_if(results_.begin(), results_.end(),
+                         [](const auto &p) { return p.second; });
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  std::vector<std::pair<std::string, bool>> results_;
+};
+
+// 0.15 seconds at 16 kHz. It is more than one chunk but less than two.
+static const std::vector<float> kSamples(2400, 0.1);
+
+static int64_t ElapsedMs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+TEST(OnlineDecodeScheduler, FullBatchIsDecodedRightAway) {
+  auto *impl = new FakeRecognizerImpl;
+  OnlineRecognizer recognizer{std::unique_ptr<OnlineRecognizerImpl>(impl)};
+
+  ResultCollector collector;
+
+  // The deadline is never reached in this test
+  OnlineDecodeScheduler scheduler({1, 4, 60000});
+
+  std::vector<std::shared_ptr<OnlineStream>> streams;
+  for (int32_t i = 0; i != 4; ++i) {
+    streams.push_back(recognizer.CreateStream());
+    scheduler.AddStream(&recognizer, streams.back(), collector.Callback());
+  }
+  EXPECT_EQ(scheduler.NumStreams(), 4);
+
+  auto start = std::chrono::steady_clock::now();
+  for (auto &s : streams) {
+    scheduler.AcceptWaveform(s.get(), 16000, kSamples.data(),
+                             kSamples.size());
+  }
+
+  ASSERT_TRUE(collector.Wait(4));
+  EXPECT_LT(ElapsedMs(start), 5000);
+
+  EXPECT_EQ(impl->BatchSizes(), std::vector<int32_t>({4}));
+  for (const auto &r : collector.Results()) {
+    EXPECT_EQ(r.first, std::to_string(FakeRecognizerImpl::kChunkSize));
+    EXPECT_FALSE(r.second);
+  }
+
+  auto stats = scheduler.GetStats();
+  EXPECT_EQ(stats.batch_size_histogram, std::vector<int64_t>({0, 0, 0, 1}));
+  ASSERT_EQ(stats.queue_depth_histogram.size(), 9);
+  EXPECT_EQ(stats.queue_depth_histogram[4], 1);
+  EXPECT_EQ(stats.num_late_streams, 0);
+  EXPECT_FALSE(stats.ToString().empty());
+}
+
+TEST(OnlineDecodeScheduler, PartialBatchWaitsForDeadline) {
+  auto *impl = new FakeRecognizerImpl;
+  OnlineRecognizer recognizer{std::unique_ptr<OnlineRecognizerImpl>(impl)};
+
+  ResultCollector collector;
+
+  int32_t latency_ms = 100;
+  OnlineDecodeScheduler scheduler({1, 4, static_cast<float>(latency_ms)});
+
+  std::shared_ptr<OnlineStream> s = recognizer.CreateStream();
+  scheduler.AddStream(&recognizer, s, collector.Callback());
+
+  auto start = std::chrono::steady_clock::now();
+  scheduler.AcceptWaveform(s.get(), 16000, kSamples.data(), kSamples.size());
+
+  ASSERT_TRUE(collector.Wait(1));
+
+  // Allow some tolerance for the clock of the condition variable
+  EXPECT_GE(ElapsedMs(start), latency_ms - 10);
+
+  EXPECT_EQ(impl->BatchSizes(), std::vector<int32_t>({1}));
+  EXPECT_EQ(scheduler.GetStats().batch_size_histogram[0], 1);
+}
+
+TEST(OnlineDecodeScheduler, StreamsOfDifferentRecognizersAreNotMixed) {
+  auto *impl1 = new FakeRecognizerImpl;
+  auto *impl2 = new FakeRecognizerImpl;
+  OnlineRecognizer recognizer1{std::unique_ptr<OnlineRecognizerImpl>(impl1)};
+  OnlineRecognizer recognizer2{std::unique_ptr<OnlineRecognizerImpl>(impl2)};
+
+  ResultCollector collector;
+  OnlineDecodeScheduler scheduler({1, 4, 200});
+
+  std::vector<std::shared_ptr<OnlineStream>> streams;
+  for (auto *r : {&recognizer1, &recognizer2, &recognizer1, &recognizer2}) {
+    streams.push_back(r->CreateStream());
+    scheduler.AddStream(r, streams.back(), collector.Callback());
+    scheduler.AcceptWaveform(streams.back().get(), 16000, kSamples.data(),
+                             kSamples.size());
+  }
+
+  ASSERT_TRUE(collector.Wait(4));
+
+  EXPECT_EQ(impl1->BatchSizes(), std::vector<int32_t>({2}));
+  EXPECT_EQ(impl2->BatchSizes(), std::vector<int32_t>({2}));
+}
+
+TEST(OnlineDecodeScheduler, InputFinished) {
+  auto *impl = new FakeRecognizerImpl;
+  OnlineRecognizer recognizer{std::unique_ptr<OnlineRecognizerImpl>(impl)};
+
+  ResultCollector collector;
+  OnlineDecodeScheduler scheduler({2, 4, 0});
+
+  std::shared_ptr<OnlineStream> s = recognizer.CreateStream();
+  scheduler.AddStream(&recognizer, s, collector.Callback());
+  scheduler.AcceptWaveform(s.get(), 16000, kSamples.data(), kSamples.size());
+  scheduler.InputFinished(s.get());
+
+  ASSERT_TRUE(collector.Wait(2));
+
+  auto results = collector.Results();
+  ASSERT_EQ(results.size(), 2);
+  EXPECT_FALSE(results[0].second);
+  EXPECT_TRUE(results[1].second);
+
+  // All frames are decoded
+  EXPECT_EQ(results[1].first, std::to_string(s->NumFramesReady()));
+  EXPECT_EQ(scheduler.NumStreams(), 0);
+
+  // There is nothing to decode for a stream without any audio, so its last
+  // result is sent right away
+  std::shared_ptr<OnlineStream> empty = recognizer.CreateStream();
+  scheduler.AddStream(&recognizer, empty, collector.Callback());
+  scheduler.InputFinished(empty.get());
+
+  results = collector.Results();
+  ASSERT_EQ(results.size(), 3);
+  EXPECT_EQ(results[2].first, "0");
+  EXPECT_TRUE(results[2].second);
+  EXPECT_EQ(scheduler.NumStreams(), 0);
+}
+
+TEST(OnlineDecodeScheduler, InputFinishedRacesWithRemoveStream) {
+  auto *impl = new FakeRecognizerImpl;
+  OnlineRecognizer recognizer{std::unique_ptr<OnlineRecognizerImpl>(impl)};
+
+  // Callbacks of decodings in progress may be invoked after RemoveStream()
+  // returns, so the collectors have to outlive the scheduler
+  std::vector<std::unique_ptr<ResultCollector>> collectors;
+
+  {
+    OnlineDecodeScheduler scheduler({2, 4, 0});
+
+    for (int32_t i = 0; i != 50; ++i) {
+      collectors.push_back(std::make_unique<ResultCollector>());
+
+      std::shared_ptr<OnlineStream> s = recognizer.CreateStream();
+      scheduler.AddStream(&recognizer, s, collectors.back()->Callback());
+      scheduler.AcceptWaveform(s.get(), 16000, kSamples.data(),
+                               kSamples.size());
+
+      std::thread t1([&]() { scheduler.InputFinished(s.get()); });
+      std::thread t2([&]() { scheduler.RemoveStream(s.get()); });
+      t1.join();
+      t2.join();
+
+      EXPECT_EQ(scheduler.NumStreams(), 0);
+    }
+  }
+
+  for (const auto &c : collectors) {
+    EXPECT_LE(c->NumLast(), 1);
+  }
+}
+
+TEST(OnlineDecodeScheduler, ShutdownWithPendingStreams) {
+  auto *impl = new FakeRecognizerImpl(/*decode_ms*/ 100);
+  OnlineRecognizer recognizer{std::unique_ptr<OnlineRecognizerImpl>(impl)};
+
+  ResultCollector collector;
+  std::vector<std::shared_ptr<OnlineStream>> streams;
+
+  auto start = std::chrono::steady_clock::now();
+  {
+    // Decode at most one stream at a time so that the others stay queued
+    OnlineDecodeScheduler scheduler({1, 1, 0});
+
+    for (int32_t i = 0; i != 4; ++i) {
+      streams.push_back(recognizer.CreateStream());
+      scheduler.AddStream(&recognizer, streams.back(), collector.Callback());
+      scheduler.AcceptWaveform(streams.back().get(), 16000, kSamples.data(),
+                               kSamples.size());
+    }
+
+    while (impl->BatchSizes().empty()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  // The destructor waits only for the decoding in progress
+  EXPECT_LT(ElapsedMs(start), 350);
+  EXPECT_EQ(impl->BatchSizes().size(), 1);
+  EXPECT_EQ(collector.Results().size(), 1);
+}
+
+TEST(OnlineDecodeScheduler, InvalidThreadCpus) {
+  OnlineDecodeSchedulerConfig config(2, 4, 10, "0-3");
+  EXPECT_TRUE(config.Validate());
+
+  config.thread_cpus = "3-1";
+  EXPECT_FALSE(config.Validate());
+}
+
+#if defined(__linux__) && !defined(__ANDROID__)
+TEST(OnlineDecodeScheduler, PinWorkers) {
+  // Use a CPU that this process is allowed to run on
+  cpu_set_t set;
+  ASSERT_EQ(sched_getaffinity(0, sizeof(set), &set), 0);
+  int32_t cpu = 0;
+  while (!CPU_ISSET(cpu, &set)) {
+    ++cpu;
+  }
+
+  auto *impl = new FakeRecognizerImpl;
+  OnlineRecognizer recognizer{std::unique_ptr<OnlineRecognizerImpl>(impl)};
+
+  std::atomic<int32_t> num_results{0};
+  std::atomic<int32_t> num_wrong_cpus{0};
+
+  OnlineDecodeScheduler scheduler({2, 1, 0, std::to_string(cpu)});
+
+  std::vector<std::shared_ptr<OnlineStream>> streams;
+  for (int32_t i = 0; i != 4; ++i) {
+    streams.push_back(recognizer.CreateStream());
+    scheduler.AddStream(
+        &recognizer, streams.back(),
+        [&](const OnlineRecognizerResult & /*r*/, bool /*is_last*/) {
+          if (sched_getcpu() != cpu) {
+            ++num_wrong_cpus;
+          }
+          ++num_results;
+        });
+    scheduler.AcceptWaveform(streams.back().get(), 16000, kSamples.data(),
+                             kSamples.size());
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  while (num_results < 4 && ElapsedMs(start) < 5000) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  EXPECT_EQ(num_results, 4);
+  EXPECT_EQ(num_wrong_cpus, 0);
+}
+#endif
+
+}  // namespace sherpa_onnx
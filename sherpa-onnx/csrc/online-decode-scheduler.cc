@@ -0,0 +1,473 @@
+// sherpa-onnx/csrc/online-decode-scheduler.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/online-decode-scheduler.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/cpu-affinity.h"
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+void OnlineDecodeSchedulerConfig::Register(ParseOptions *po) {
+  po->Register("scheduler-num-threads", &num_threads,
+               "Number of worker threads for decoding");
+
+  po->Register("scheduler-max-batch-size", &max_batch_size,
+               "Max number of streams in a batch");
+
+  po->Register("scheduler-target-latency-ms", &target_latency_ms,
+               "A ready stream waits at most this number of milliseconds "
+               "for other streams to join its batch");
+
+  po->Register("scheduler-thread-cpus", &thread_cpus,
+               "If not empty, pin the worker threads to these CPUs, e.g., "
+               "4-7. Thread i is pinned to the i-th CPU, wrapping around if "
+               "there are more threads than CPUs.");
+}
+
+bool OnlineDecodeSchedulerConfig::Validate() const {
+  if (num_threads < 1) {
+    SHERPA_ONNX_LOGE("num_threads should be > 0. Given %d", num_threads);
+    return false;
+  }
+
+  if (max_batch_size < 1) {
+    SHERPA_ONNX_LOGE("max_batch_size should be > 0. Given %d", max_batch_size);
+    return false;
+  }
+
+  if (target_latency_ms < 0) {
+    SHERPA_ONNX_LOGE("target_latency_ms should be >= 0. Given %.3f",
+                     target_latency_ms);
+    return false;
+  }
+
+  std::vector<int32_t> cpus;
+  if (!ParseCpuList(thread_cpus, &cpus)) {
+    SHERPA_ONNX_LOGE("Invalid thread_cpus: '%s'", thread_cpus.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+std::string OnlineDecodeSchedulerConfig::ToString() const {
+  std::ostringstream os;
+
+  os << "OnlineDecodeSchedulerConfig(";
+  os << "num_threads=" << num_threads << ", ";
+  os << "max_batch_size=" << max_batch_size << ", ";
+  os << "target_latency_ms=" << target_latency_ms << ", ";
+  os << "thread_cpus=\"" << thread_cpus << "\")";
+
+  return os.str();
+}
+
+static std::string VecToString(const std::vector<int64_t> &v) {
+  std::ostringstream os;
+  std::string sep;
+  os << "[";
+  for (auto i : v) {
+    os << sep << i;
+    sep = ", ";
+  }
+  os << "]";
+  return os.str();
+}
+
+std::string OnlineDecodeSchedulerStats::ToString() const {
+  std::ostringstream os;
+
+  os << "OnlineDecodeSchedulerStats(";
+  os << "batch_size_histogram=" << VecToString(batch_size_histogram) << ", ";
+  os << "queue_depth_histogram=" << VecToString(queue_depth_histogram)
+     << ", ";
+  os << "num_late_streams=" << num_late_streams << ")";
+
+  return os.str();
+}
+
+// Capacity of the inbox. It is large enough for all streams of a server
+// in practice. If it is full, streams take the slow path under the lock.
+static constexpr int32_t kInboxCapacity = 4096;
+
+OnlineDecodeScheduler::OnlineDecodeScheduler(
+    const OnlineDecodeSchedulerConfig &config)
+    : config_(config), inbox_(kInboxCapacity) {
+  if (!config_.Validate()) {
+    SHERPA_ONNX_LOGE("Errors in config: %s", config_.ToString().c_str());
+    SHERPA_ONNX_EXIT(-1);
+  }
+
+  stats_.batch_size_histogram.resize(config_.max_batch_size);
+  stats_.queue_depth_histogram.resize(2 * config_.max_batch_size + 1);
+
+  std::vector<int32_t> cpus;
+  ParseCpuList(config_.thread_cpus, &cpus);
+
+  workers_.reserve(config_.num_threads);
+  for (int32_t i = 0; i != config_.num_threads; ++i) {
+    std::vector<int32_t> worker_cpus;
+    if (!cpus.empty()) {
+      worker_cpus.push_back(cpus[i % cpus.size()]);
+    }
+
+    workers_.emplace_back([this, worker_cpus]() { Worker(worker_cpus); });
+  }
+}
+
+OnlineDecodeScheduler::~OnlineDecodeScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cond_.notify_all();
+
+  for (auto &t : workers_) {
+    t.join();
+  }
+}
+
+void OnlineDecodeScheduler::AddStream(const OnlineRecognizer *recognizer,
+                                      std::shared_ptr<OnlineStream> s,
+                                      Callback callback,
+                                      float latency_ms /*= -1*/) {
+  if (latency_ms < 0) {
+    latency_ms = config_.target_latency_ms;
+  }
+
+  auto e = std::make_shared<Entry>();
+  e->recognizer = recognizer;
+  e->stream = std::move(s);
+  e->callback = std::move(callback);
+  e->latency = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<float, std::milli>(latency_ms));
+
+  {
+    Shard &shard = GetShard(e->stream.get());
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.entries[e->stream.get()] = e;
+  }
+
+  ScheduleIfReady(e);
+}
+
+void OnlineDecodeScheduler::AcceptWaveform(OnlineStream *s,
+                                           int32_t sampling_rate,
+                                           const float *waveform, int32_t n) {
+  auto e = Find(s);
+  if (!e) {
+    // It has been removed or its input is finished
+    return;
+  }
+
+  // The feature extractor is thread-safe, so it is fine if the stream is
+  // being decoded by a worker
+  s->AcceptWaveform(sampling_rate, waveform, n);
+
+  ScheduleIfReady(e);
+}
+
+void OnlineDecodeScheduler::InputFinished(OnlineStream *s) {
+  auto e = Find(s);
+  if (!e || e->eof.exchange(true)) {
+    // It has been removed or its input is finished
+    return;
+  }
+
+  s->InputFinished();
+
+  // If a worker is decoding it, the worker sends the last result
+  ScheduleIfReady(e);
+}
+
+void OnlineDecodeScheduler::RemoveStream(OnlineStream *s) {
+  auto e = Take(s);
+  if (!e) {
+    return;
+  }
+
+  // If it is in the inbox or in a ready queue, a worker drops it
+  e->removed = true;
+}
+
+int32_t OnlineDecodeScheduler::NumStreams() const {
+  int32_t ans = 0;
+  for (const auto &shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    ans += static_cast<int32_t>(shard.entries.size());
+  }
+  return ans;
+}
+
+OnlineDecodeSchedulerStats OnlineDecodeScheduler::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+OnlineDecodeScheduler::Shard &OnlineDecodeScheduler::GetShard(
+    OnlineStream *s) {
+  // Discard low bits, which are always 0 due to alignment
+  return shards_[(reinterpret_cast<uintptr_t>(s) >> 6) % kNumShards];
+}
+
+std::shared_ptr<OnlineDecodeScheduler::Entry> OnlineDecodeScheduler::Find(
+    OnlineStream *s) {
+  Shard &shard = GetShard(s);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.entries.find(s);
+  if (it == shard.entries.end()) {
+    return nullptr;
+  }
+  return it->second;
+}
+
+std::shared_ptr<OnlineDecodeScheduler::Entry> OnlineDecodeScheduler::Take(
+    OnlineStream *s) {
+  Shard &shard = GetShard(s);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.entries.find(s);
+  if (it == shard.entries.end()) {
+    return nullptr;
+  }
+
+  auto e = std::move(it->second);
+  shard.entries.erase(it);
+  return e;
+}
+
+void OnlineDecodeScheduler::ScheduleIfReady(const std::shared_ptr<Entry> &e) {
+  OnlineStream *s = e->stream.get();
+  while (!e->removed) {
+    bool expected = false;
+    if (!e->scheduled.compare_exchange_strong(expected, true)) {
+      // It is in the inbox, in a ready queue or being decoded. The worker
+      // decoding it checks it again afterwards.
+      return;
+    }
+
+    if (e->recognizer->IsReady(s)) {
+      Push(e);
+      return;
+    }
+
+    if (e->eof) {
+      // There is nothing left to decode. Note that scheduled stays true,
+      // so the stream is never scheduled again.
+      if (Take(s)) {
+        auto r = e->recognizer->GetResult(s);
+        r.is_final = true;
+        e->callback(r, true);
+      }
+      return;
+    }
+
+    e->scheduled = false;
+
+    // Frames or the end of input may have arrived after the checks above
+    // and before resetting scheduled, in which case the thread receiving
+    // them returned early. Check again so that they are not left behind.
+    if (!e->recognizer->IsReady(s) && !e->eof) {
+      return;
+    }
+  }
+}
+
+void OnlineDecodeScheduler::Push(std::shared_ptr<Entry> e) {
+  e->deadline = Clock::now() + e->latency;
+
+  if (!inbox_.TryPush(e)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    AddToQueue(std::move(e));
+    cond_.notify_one();
+    return;
+  }
+
+  // Pairs with the fence in Worker(). Either the worker sees the entry
+  // before waiting or we see the worker waiting.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (num_waiting_.load(std::memory_order_relaxed) == 0) {
+    // Busy workers check the inbox after each batch
+    return;
+  }
+
+  // Taking the lock makes sure the worker is waiting on cond_, so the
+  // notification is not lost
+  std::lock_guard<std::mutex> lock(mutex_);
+  cond_.notify_one();
+}
+
+int32_t OnlineDecodeScheduler::DrainInbox() {
+  int32_t n = 0;
+  std::shared_ptr<Entry> e;
+  while (inbox_.TryPop(&e)) {
+    ++n;
+    if (!e->removed) {
+      AddToQueue(std::move(e));
+    }
+  }
+  return n;
+}
+
+void OnlineDecodeScheduler::AddToQueue(std::shared_ptr<Entry> e) {
+  auto &q = queues_[e->recognizer];
+  q.push_back(std::move(e));
+  ++num_queued_;
+}
+
+std::vector<std::shared_ptr<OnlineDecodeScheduler::Entry>> *
+OnlineDecodeScheduler::SelectQueue(Clock::time_point now,
+                                   Clock::time_point *next_deadline) {
+  std::vector<std::shared_ptr<Entry>> *ans = nullptr;
+  Clock::time_point ans_deadline = Clock::time_point::max();
+
+  *next_deadline = Clock::time_point::max();
+
+  for (auto &p : queues_) {
+    auto &q = p.second;
+    if (q.empty()) {
+      continue;
+    }
+
+    Clock::time_point deadline = q[0]->deadline;
+    for (const auto &e : q) {
+      deadline = std::min(deadline, e->deadline);
+    }
+
+    bool due = static_cast<int32_t>(q.size()) >= config_.max_batch_size ||
+               deadline <= now;
+
+    if (due && deadline < ans_deadline) {
+      ans = &q;
+      ans_deadline = deadline;
+    }
+
+    *next_deadline = std::min(*next_deadline, deadline);
+  }
+
+  return ans;
+}
+
+void OnlineDecodeScheduler::Worker(const std::vector<int32_t> &cpus) {
+  SetCurrentThreadAffinity(cpus);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_) {
+    DrainInbox();
+
+    Clock::time_point now = Clock::now();
+    Clock::time_point next_deadline;
+    auto q = SelectQueue(now, &next_deadline);
+    if (!q) {
+      num_waiting_.fetch_add(1);
+
+      // Pairs with the fence in Push()
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+
+      if (DrainInbox() == 0) {
+        if (next_deadline == Clock::time_point::max()) {
+          cond_.wait(lock);
+        } else {
+          cond_.wait_until(lock, next_deadline);
+        }
+      }
+
+      num_waiting_.fetch_sub(1);
+      continue;
+    }
+
+    // Earliest deadline first
+    int32_t n = std::min<int32_t>(q->size(), config_.max_batch_size);
+    std::partial_sort(q->begin(), q->begin() + n, q->end(),
+                      [](const std::shared_ptr<Entry> &a,
+                         const std::shared_ptr<Entry> &b) {
+                        return a->deadline < b->deadline;
+                      });
+
+    auto &depth = stats_.queue_depth_histogram;
+    depth[std::min<int32_t>(num_queued_, depth.size() - 1)] += 1;
+
+    std::vector<std::shared_ptr<Entry>> batch;
+    batch.reserve(n);
+    for (int32_t i = 0; i != n; ++i) {
+      auto &e = (*q)[i];
+      if (e->removed) {
+        continue;
+      }
+
+      if (e->deadline < now) {
+        stats_.num_late_streams += 1;
+      }
+      batch.push_back(std::move(e));
+    }
+
+    q->erase(q->begin(), q->begin() + n);
+    num_queued_ -= n;
+
+    if (!q->empty()) {
+      // Let another worker handle the remaining streams
+      cond_.notify_one();
+    }
+
+    if (batch.empty()) {
+      continue;
+    }
+
+    stats_.batch_size_histogram[batch.size() - 1] += 1;
+
+    lock.unlock();
+    DecodeBatch(batch);
+    lock.lock();
+  }
+}
+
+void OnlineDecodeScheduler::DecodeBatch(
+    const std::vector<std::shared_ptr<Entry>> &batch) {
+  int32_t n = static_cast<int32_t>(batch.size());
+  const OnlineRecognizer *recognizer = batch[0]->recognizer;
+
+  std::vector<OnlineStream *> ss(n);
+  for (int32_t i = 0; i != n; ++i) {
+    ss[i] = batch[i]->stream.get();
+  }
+
+  recognizer->DecodeStreams(ss.data(), n);
+
+  // The streams are still scheduled, so no other thread can touch them
+  for (int32_t i = 0; i != n; ++i) {
+    const auto &e = batch[i];
+    OnlineStream *s = ss[i];
+
+    auto r = recognizer->GetResult(s);
+    if (recognizer->IsEndpoint(s)) {
+      r.is_final = true;
+      recognizer->Reset(s);
+    }
+
+    bool is_last = e->eof && !recognizer->IsReady(s);
+    if (is_last) {
+      // scheduled stays true, so the stream is never scheduled again
+      r.is_final = true;
+      Take(s);
+    }
+
+    e->callback(r, is_last);
+
+    if (!is_last) {
+      e->scheduled = false;
+
+      // Decode it again if it has received enough frames in the meantime
+      ScheduleIfReady(e);
+    }
+  }
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,253 @@
+// sherpa-onnx/csrc/online-decode-scheduler.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_ONLINE_DECODE_SCHEDULER_H_
+#define SHERPA_ONNX_CSRC_ONLINE_DECODE_SCHEDULER_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "sherpa-onnx/csrc/mpmc-queue.h"
+#include "sherpa-onnx/csrc/online-recognizer.h"
+#include "sherpa-onnx/csrc/online-stream.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+
+namespace sherpa_onnx {
+
+struct OnlineDecodeSchedulerConfig {
+  // Number of worker threads that call OnlineRecognizer::DecodeStreams()
+  int32_t num_threads = 1;
+
+  int32_t max_batch_size = 8;
+
+  // Default latency budget of a stream, in milliseconds. A ready stream
+  // waits at most this long for other streams to join its batch. A batch
+  // is decoded as soon as it is full or the earliest deadline in it has
+  // been reached. Use 0 to decode ready streams as soon as a worker is free.
+  float target_latency_ms = 10;
+
+  // If not empty, pin the worker threads to these CPUs, e.g., "4-7".
+  // Worker i is pinned to the i-th CPU, wrapping around if there are more
+  // workers than CPUs. See ParseCpuList() for the format.
+  std::string thread_cpus;
+
+  OnlineDecodeSchedulerConfig() = default;
+
+  OnlineDecodeSchedulerConfig(int32_t num_threads, int32_t max_batch_size,
+                              float target_latency_ms,
+                              const std::string &thread_cpus = "")
+      : num_threads(num_threads),
+        max_batch_size(max_batch_size),
+        target_latency_ms(target_latency_ms),
+        thread_cpus(thread_cpus) {}
+
+  void Register(ParseOptions *po);
+  bool Validate() const;
+
+  std::string ToString() const;
+};
+
+struct OnlineDecodeSchedulerStats {
+  // batch_size_histogram[i] is the number of batches containing i + 1
+  // streams. Its size is max_batch_size.
+  std::vector<int64_t> batch_size_histogram;
+
+  // queue_depth_histogram[i] is the number of times a batch was formed
+  // while i streams were ready for decoding. Its size is
+  // 2 * max_batch_size + 1 and the last bin counts all larger depths.
+  std::vector<int64_t> queue_depth_histogram;
+
+  // Number of streams decoded after their deadline
+  int64_t num_late_streams = 0;
+
+  std::string ToString() const;
+};
+
+/** Decode streams of one or more OnlineRecognizers with dynamic batching.
+ *
+ * Instead of writing a loop of IsReady() and DecodeStreams(), callers add
+ * their streams to the scheduler, feed audio through it and receive
+ * results in a callback.
+ *
+ * Whenever a stream has enough frames, it is pushed into a lock-free
+ * inbox by the thread that fed the audio. The workers move streams from
+ * the inbox into a ready queue per OnlineRecognizer, so that streams of
+ * models with different chunk sizes never share a batch. A worker takes
+ * up to max_batch_size streams with the earliest deadlines from a queue
+ * when the queue is full or its earliest deadline has been reached.
+ *
+ * Feeding audio never waits for the workers. It locks only the shard of
+ * the stream table that holds the stream, and the lock of the workers
+ * only if one of them has to be woken up.
+ *
+ * All methods are thread-safe.
+ */
+class OnlineDecodeScheduler {
+ public:
+  /** It is invoked in a worker thread after each decoding of a stream.
+   *
+   * Callbacks of the same stream are never invoked concurrently.
+   * is_last is true for the last result of a stream, after which the
+   * stream is removed from the scheduler. The result then has is_final
+   * set to true. Also, is_final is true when an endpoint is detected, in
+   * which case the stream is reset and decoding continues.
+   */
+  using Callback =
+      std::function<void(const OnlineRecognizerResult &r, bool is_last)>;
+
+  explicit OnlineDecodeScheduler(const OnlineDecodeSchedulerConfig &config);
+
+  // Stop the workers. Pending streams are not decoded.
+  ~OnlineDecodeScheduler();
+
+  OnlineDecodeScheduler(const OnlineDecodeScheduler &) = delete;
+  OnlineDecodeScheduler &operator=(const OnlineDecodeScheduler &) = delete;
+
+  /** Add a stream to the scheduler.
+   *
+   * @param recognizer It is used to decode the stream. It must be alive
+   *                   until the stream is removed from the scheduler.
+   * @param s A stream created by the recognizer.
+   * @param callback  It is called with the result of each decoding.
+   * @param latency_ms Latency budget of this stream in milliseconds.
+   *                   If it is negative, config.target_latency_ms is used.
+   */
+  void AddStream(const OnlineRecognizer *recognizer,
+                 std::shared_ptr<OnlineStream> s, Callback callback,
+                 float latency_ms = -1);
+
+  /** Feed audio samples to a stream that was added by AddStream().
+   *
+   * See OnlineStream::AcceptWaveform(). It does nothing if the stream has
+   * been removed, so it may race with RemoveStream().
+   */
+  void AcceptWaveform(OnlineStream *s, int32_t sampling_rate,
+                      const float *waveform, int32_t n);
+
+  /** Signal that there are no more samples for a stream.
+   *
+   * The remaining frames are decoded and the last result is passed to the
+   * callback with is_last set to true. If nothing is left to decode, the
+   * callback is invoked in the calling thread. It does nothing if the
+   * stream has been removed.
+   */
+  void InputFinished(OnlineStream *s);
+
+  /** Remove a stream without waiting for its remaining frames.
+   *
+   * Its callback is not invoked after this function returns, except for a
+   * decoding that is already in progress.
+   */
+  void RemoveStream(OnlineStream *s);
+
+  // Number of streams in the scheduler
+  int32_t NumStreams() const;
+
+  OnlineDecodeSchedulerStats GetStats() const;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Entry {
+    const OnlineRecognizer *recognizer;
+    std::shared_ptr<OnlineStream> stream;
+    Callback callback;
+    Clock::duration latency;
+
+    // It is true while the entry is in the inbox, in a ready queue or
+    // being decoded, or after its last result has been sent. Only the
+    // thread that changes it from false to true may push the entry into
+    // the inbox.
+    std::atomic<bool> scheduled{false};
+
+    std::atomic<bool> eof{false};
+    std::atomic<bool> removed{false};
+
+    // Set before the entry is pushed into the inbox
+    Clock::time_point deadline;
+  };
+
+  struct Shard {
+    mutable std::mutex mutex;
+    std::unordered_map<OnlineStream *, std::shared_ptr<Entry>> entries;
+  };
+
+  Shard &GetShard(OnlineStream *s);
+
+  // Return nullptr if the stream is not in the scheduler
+  std::shared_ptr<Entry> Find(OnlineStream *s);
+
+  // Remove the stream from its shard. Return nullptr if it is not there.
+  std::shared_ptr<Entry> Take(OnlineStream *s);
+
+  // Push the entry into the inbox if it has enough frames. If its input
+  // is finished and there are no frames to decode, send the last result.
+  // It can be called by any thread without holding mutex_.
+  void ScheduleIfReady(const std::shared_ptr<Entry> &e);
+
+  void Push(std::shared_ptr<Entry> e);
+
+  // Move entries from the inbox to the ready queues. Return the number
+  // of entries taken from the inbox.
+  //
+  // The caller must hold mutex_.
+  int32_t DrainInbox();
+
+  // The caller must hold mutex_.
+  void AddToQueue(std::shared_ptr<Entry> e);
+
+  // Return the queue to decode next, or nullptr if no queue is due.
+  // On return, next_deadline is the earliest deadline of all queues.
+  //
+  // The caller must hold mutex_.
+  std::vector<std::shared_ptr<Entry>> *SelectQueue(
+      Clock::time_point now, Clock::time_point *next_deadline);
+
+  // cpus is the CPU to pin the worker to, or empty to not pin it
+  void Worker(const std::vector<int32_t> &cpus);
+
+  void DecodeBatch(const std::vector<std::shared_ptr<Entry>> &batch);
+
+ private:
+  OnlineDecodeSchedulerConfig config_;
+
+  // Streams are spread over shards so that threads feeding audio to
+  // different streams seldom wait for the same lock
+  static constexpr int32_t kNumShards = 16;
+  std::array<Shard, kNumShards> shards_;
+
+  // Entries that are ready for decoding. If it is full, entries are added
+  // to the ready queues directly under mutex_.
+  MpmcQueue<std::shared_ptr<Entry>> inbox_;
+
+  // Number of workers waiting on cond_
+  std::atomic<int32_t> num_waiting_{0};
+
+  // It protects the members below
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  bool stop_ = false;
+
+  // Ready streams of each recognizer
+  std::map<const OnlineRecognizer *, std::vector<std::shared_ptr<Entry>>>
+      queues_;
+  int32_t num_queued_ = 0;
+
+  OnlineDecodeSchedulerStats stats_;
+
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_ONLINE_DECODE_SCHEDULER_H_
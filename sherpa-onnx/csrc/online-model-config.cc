@@ -7,6 +7,7 @@
 
 #include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/model-precision.h"
 #include "sherpa-onnx/csrc/text-utils.h"
 
 namespace sherpa_onnx {
@@ -49,6 +50,11 @@ void OnlineModelConfig::Register(ParseOptions *po) {
                "Valid values are: conformer, lstm, zipformer, zipformer2, "
                "wenet_ctc, nemo_ctc. "
                "All other values lead to loading the model twice.");
+
+  po->Register("precision", &precision,
+               "fp32, fp16, or int8. If not empty, use the model files in "
+               "this precision that are next to the given ones, e.g., "
+               "encoder.int8.onnx for encoder.onnx, if they exist");
 }
 
 bool OnlineModelConfig::Validate() const {
@@ -125,6 +131,12 @@ bool OnlineModelConfig::Validate() const {
     return false;
   }
 
+  if (!IsValidModelPrecision(precision)) {
+    SHERPA_ONNX_LOGE("Invalid precision: '%s'. Valid values: fp32, fp16, int8",
+                     precision.c_str());
+    return false;
+  }
+
   if (!modeling_unit.empty() &&
       (modeling_unit == "bpe" || modeling_unit == "cjkchar+bpe")) {
     if (!FileExists(bpe_vocab)) {
@@ -172,9 +184,23 @@ std::string OnlineModelConfig::ToString() const {
   os << "debug=" << (debug ? "True" : "False") << ", ";
   os << "model_type=\"" << model_type << "\", ";
   os << "modeling_unit=\"" << modeling_unit << "\", ";
-  os << "bpe_vocab=\"" << bpe_vocab << "\")";
+  os << "bpe_vocab=\"" << bpe_vocab << "\", ";
+  os << "precision=\"" << precision << "\")";
 
   return os.str();
 }
 
+void OnlineModelConfig::ApplyPrecision() {
+  if (precision.empty()) {
+    return;
+  }
+
+  for (std::string *f :
+       {&transducer.encoder, &transducer.decoder, &transducer.joiner,
+        &paraformer.encoder, &paraformer.decoder, &wenet_ctc.model,
+        &zipformer2_ctc.model, &nemo_ctc.model}) {
+    *f = SelectModelPrecision(*f, precision);
+  }
+}
+
 }  // namespace sherpa_onnx
@@ -50,6 +50,12 @@ struct OnlineModelConfig {
   /// "tokens" file
   std::string tokens_buf;
 
+  // Precision of the model files to load: fp32, fp16, or int8. If the
+  // given files are in another precision, the ones in this precision
+  // next to them are used instead. Empty to use the given files.
+  // See ./model-precision.h
+  std::string precision;
+
   OnlineModelConfig() = default;
   OnlineModelConfig(const OnlineTransducerModelConfig &transducer,
                     const OnlineParaformerModelConfig &paraformer,
@@ -79,6 +85,10 @@ struct OnlineModelConfig {
   bool Validate() const;
 
   std::string ToString() const;
+
+  // Replace the model files with the ones in the given precision.
+  // It is a no-op if precision is empty.
+  void ApplyPrecision();
 };
 
 }  // namespace sherpa_onnx
@@ -6,7 +6,10 @@
 
 #include <algorithm>
 #include <cmath>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #if __ANDROID_API__ >= 9
 #include "android/asset_manager.h"
@@ -18,8 +21,10 @@
 #endif
 
 #include "sherpa-onnx/csrc/file-utils.h"
+#include "sherpa-onnx/csrc/io-binding-cache.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
+#include "sherpa-onnx/csrc/ort-env.h"
 #include "sherpa-onnx/csrc/session.h"
 #include "sherpa-onnx/csrc/text-utils.h"
 
@@ -29,16 +34,16 @@ class OnlineParaformerModel::Impl {
  public:
   explicit Impl(const OnlineModelConfig &config)
       : config_(config),
-        env_(ORT_LOGGING_LEVEL_ERROR),
+        env_(GetOrtEnv()),
         sess_opts_(GetSessionOptions(config)),
         allocator_{} {
     {
-      auto buf = ReadFile(config.paraformer.encoder);
+      auto buf = MapFile(config.paraformer.encoder);
       InitEncoder(buf.data(), buf.size());
     }
 
     {
-      auto buf = ReadFile(config.paraformer.decoder);
+      auto buf = MapFile(config.paraformer.decoder);
       InitDecoder(buf.data(), buf.size());
     }
   }
@@ -46,7 +51,7 @@ class OnlineParaformerModel::Impl {
   template <typename Manager>
   Impl(Manager *mgr, const OnlineModelConfig &config)
       : config_(config),
-        env_(ORT_LOGGING_LEVEL_ERROR),
+        env_(GetOrtEnv()),
         sess_opts_(GetSessionOptions(config)),
         allocator_{} {
     {
@@ -65,9 +70,11 @@ class OnlineParaformerModel::Impl {
     std::array<Ort::Value, 2> inputs = {std::move(features),
                                         std::move(features_length)};
 
-    return encoder_sess_->Run(
-        {}, encoder_input_names_ptr_.data(), inputs.data(), inputs.size(),
-        encoder_output_names_ptr_.data(), encoder_output_names_ptr_.size());
+    return encoder_cache_->Run(inputs.data());
+  }
+
+  void RecycleEncoderTensors(std::vector<Ort::Value> tensors) {
+    encoder_cache_->Recycle(&tensors);
   }
 
   std::vector<Ort::Value> ForwardDecoder(Ort::Value encoder_out,
@@ -112,9 +119,9 @@ class OnlineParaformerModel::Impl {
   OrtAllocator *Allocator() { return allocator_; }
 
  private:
-  void InitEncoder(void *model_data, size_t model_data_length) {
-    encoder_sess_ = std::make_unique<Ort::Session>(
-        env_, model_data, model_data_length, sess_opts_);
+  void InitEncoder(const void *model_data, size_t model_data_length) {
+    encoder_sess_ = CreateSession(env_, model_data, model_data_length,
+                                  sess_opts_);
 
     GetInputNames(encoder_sess_.get(), &encoder_input_names_,
                   &encoder_input_names_ptr_);
@@ -122,6 +129,10 @@ class OnlineParaformerModel::Impl {
     GetOutputNames(encoder_sess_.get(), &encoder_output_names_,
                    &encoder_output_names_ptr_);
 
+    encoder_cache_ = std::make_unique<IoBindingCache>(
+        encoder_sess_.get(), encoder_input_names_ptr_,
+        encoder_output_names_ptr_, allocator_);
+
     // get meta data
     Ort::ModelMetadata meta_data = encoder_sess_->GetModelMetadata();
     if (config_.debug) {
@@ -151,9 +162,9 @@ class OnlineParaformerModel::Impl {
     }
   }
 
-  void InitDecoder(void *model_data, size_t model_data_length) {
-    decoder_sess_ = std::make_unique<Ort::Session>(
-        env_, model_data, model_data_length, sess_opts_);
+  void InitDecoder(const void *model_data, size_t model_data_length) {
+    decoder_sess_ = CreateSession(env_, model_data, model_data_length,
+                                  sess_opts_);
 
     GetInputNames(decoder_sess_.get(), &decoder_input_names_,
                   &decoder_input_names_ptr_);
@@ -164,7 +175,7 @@ class OnlineParaformerModel::Impl {
 
  private:
   OnlineModelConfig config_;
-  Ort::Env env_;
+  Ort::Env &env_;
   Ort::SessionOptions sess_opts_;
   Ort::AllocatorWithDefaultOptions allocator_;
 
@@ -176,6 +187,9 @@ class OnlineParaformerModel::Impl {
   std::vector<std::string> encoder_output_names_;
   std::vector<const char *> encoder_output_names_ptr_;
 
+  // Writes encoder outputs into recycled tensors
+  std::unique_ptr<IoBindingCache> encoder_cache_;
+
   std::unique_ptr<Ort::Session> decoder_sess_;
 
   std::vector<std::string> decoder_input_names_;
@@ -221,6 +235,11 @@ std::vector<Ort::Value> OnlineParaformerModel::ForwardDecoder(
       std::move(states));
 }
 
+void OnlineParaformerModel::RecycleEncoderTensors(
+    std::vector<Ort::Value> tensors) const {
+  impl_->RecycleEncoderTensors(std::move(tensors));
+}
+
 int32_t OnlineParaformerModel::VocabSize() const { return impl_->VocabSize(); }
 
 int32_t OnlineParaformerModel::LfrWindowSize() const {
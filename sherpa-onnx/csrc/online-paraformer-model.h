@@ -31,6 +31,12 @@ class OnlineParaformerModel {
                                          Ort::Value acoustic_embedding_length,
                                          std::vector<Ort::Value> states) const;
 
+  /** Give back outputs of ForwardEncoder() that are no longer used, so
+   * that a later ForwardEncoder() can write its outputs into them instead
+   * of allocating new ones. They must not be views of other tensors.
+   */
+  void RecycleEncoderTensors(std::vector<Ort::Value> tensors) const;
+
   /** Return the vocabulary size of the model
    */
   int32_t VocabSize() const;
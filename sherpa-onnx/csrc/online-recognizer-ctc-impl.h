@@ -20,6 +20,8 @@
 #include "sherpa-onnx/csrc/online-ctc-greedy-search-decoder.h"
 #include "sherpa-onnx/csrc/online-ctc-model.h"
 #include "sherpa-onnx/csrc/online-recognizer-impl.h"
+#include "sherpa-onnx/csrc/online-state-slab.h"
+#include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
 
 namespace sherpa_onnx {
@@ -111,6 +113,12 @@ class OnlineRecognizerCtcImpl : public OnlineRecognizerImpl {
     InitDecoder();
   }
 
+  std::unique_ptr<OnlineRecognizerImpl> Clone(
+      const OnlineRecognizerConfig &config) const override {
+    return std::unique_ptr<OnlineRecognizerImpl>(
+        new OnlineRecognizerCtcImpl(*this, config));
+  }
+
   std::unique_ptr<OnlineStream> CreateStream() const override {
     auto stream = std::make_unique<OnlineStream>(config_.feat_config);
     stream->SetStates(model_->GetInitStates());
@@ -139,38 +147,54 @@ class OnlineRecognizerCtcImpl : public OnlineRecognizerImpl {
     int32_t feat_dim = ss[0]->FeatureDim();
 
     std::vector<OnlineCtcDecoderResult> results(n);
-    std::vector<float> features_vec(n * chunk_length * feat_dim);
-    std::vector<std::vector<Ort::Value>> states_vec(n);
     std::vector<int64_t> all_processed_frames(n);
 
+    // Features of each stream are written to its slice of x directly
+    std::array<int64_t, 3> x_shape{n, chunk_length, feat_dim};
+    Ort::Value x = Ort::Value::CreateTensor<float>(
+        model_->Allocator(), x_shape.data(), x_shape.size());
+    float *p_x = x.GetTensorMutableData<float>();
+
+    // If the streams are the same as in the previous call, their states
+    // are still batched and we don't need to stack them
+    OnlineStateSlab *slab = GetSharedStateSlab(ss, n);
+    std::vector<std::vector<Ort::Value>> states_vec(slab ? 0 : n);
+
     for (int32_t i = 0; i != n; ++i) {
       const auto num_processed_frames = ss[i]->GetNumProcessedFrames();
-      std::vector<float> features =
-          ss[i]->GetFrames(num_processed_frames, chunk_length);
+      ss[i]->GetFrames(num_processed_frames, chunk_length,
+                       p_x + i * chunk_length * feat_dim);
 
       // Question: should num_processed_frames include chunk_shift?
       ss[i]->GetNumProcessedFrames() += chunk_shift;
 
-      std::copy(features.begin(), features.end(),
-                features_vec.data() + i * chunk_length * feat_dim);
-
       results[i] = std::move(ss[i]->GetCtcResult());
-      states_vec[i] = std::move(ss[i]->GetStates());
+      if (!slab) {
+        states_vec[i] = std::move(ss[i]->GetStates());
+      }
       all_processed_frames[i] = num_processed_frames;
     }
 
-    auto memory_info =
-        Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+    std::vector<Ort::Value> states =
+        slab ? std::move(slab->GetBatchedStates())
+             : model_->StackStates(std::move(states_vec));
+    int32_t num_states = states.size();
 
-    std::array<int64_t, 3> x_shape{n, chunk_length, feat_dim};
+    // The model gets views of the states, so that we can recycle the
+    // states afterwards. Both slab and StackStates() own their tensors.
+    std::vector<Ort::Value> states_view;
+    states_view.reserve(num_states);
+    for (auto &v : states) {
+      states_view.push_back(View(&v));
+    }
 
-    Ort::Value x = Ort::Value::CreateTensor(memory_info, features_vec.data(),
-                                            features_vec.size(), x_shape.data(),
-                                            x_shape.size());
+    PerfStats *stats = GetPerfStats().get();
 
-    auto states = model_->StackStates(std::move(states_vec));
-    int32_t num_states = states.size();
-    auto out = model_->Forward(std::move(x), std::move(states));
+    std::vector<Ort::Value> out;
+    {
+      ScopedPerfTimer timer(stats, PerfStage::kEncoder);
+      out = model_->Forward(std::move(x), std::move(states_view));
+    }
     std::vector<Ort::Value> out_states;
     out_states.reserve(num_states);
 
@@ -178,17 +202,37 @@ class OnlineRecognizerCtcImpl : public OnlineRecognizerImpl {
       out_states.push_back(std::move(out[k]));
     }
 
-    std::vector<std::vector<Ort::Value>> next_states =
-        model_->UnStackStates(std::move(out_states));
-
     std::vector<int64_t> log_probs_shape =
         out[0].GetTensorTypeAndShapeInfo().GetShape();
-    decoder_->Decode(out[0].GetTensorData<float>(), log_probs_shape[0],
-                     log_probs_shape[1], log_probs_shape[2], &results, ss, n);
+    {
+      ScopedPerfTimer timer(stats, PerfStage::kSearch);
+      decoder_->Decode(out[0].GetTensorData<float>(), log_probs_shape[0],
+                       log_probs_shape[1], log_probs_shape[2], &results, ss,
+                       n);
+    }
+
+    // Let the next Forward() write its outputs into them
+    states.push_back(std::move(out[0]));
+    model_->RecycleTensors(std::move(states));
+
+    // The next states stay batched. They are unstacked only when
+    // the streams are decoded in a different batch.
+    if (slab) {
+      slab->GetBatchedStates() = std::move(out_states);
+    } else {
+      auto model = model_.get();
+      auto new_slab = std::make_shared<OnlineStateSlab>(
+          std::move(out_states), n, [model](std::vector<Ort::Value> states) {
+            return model->UnStackStates(std::move(states));
+          });
+
+      for (int32_t k = 0; k != n; ++k) {
+        ss[k]->SetStateSlab(new_slab, k);
+      }
+    }
 
     for (int32_t k = 0; k != n; ++k) {
       ss[k]->SetCtcResult(results[k]);
-      ss[k]->SetStates(std::move(next_states[k]));
     }
   }
 
@@ -244,6 +288,20 @@ class OnlineRecognizerCtcImpl : public OnlineRecognizerImpl {
   }
 
  private:
+  OnlineRecognizerCtcImpl(const OnlineRecognizerCtcImpl &other,
+                          const OnlineRecognizerConfig &config)
+      : OnlineRecognizerImpl(other, config),
+        config_(config),
+        model_(other.model_),
+        sym_(other.sym_),
+        endpoint_(config_.endpoint_config) {
+    if (!config.model_config.wenet_ctc.model.empty()) {
+      config_.feat_config.normalize_samples = false;
+    }
+
+    InitDecoder();
+  }
+
   void InitDecoder() {
     if (!sym_.Contains("<blk>") && !sym_.Contains("<eps>") &&
         !sym_.Contains("<blank>")) {
@@ -283,19 +341,21 @@ class OnlineRecognizerCtcImpl : public OnlineRecognizerImpl {
 
     int32_t feat_dim = s->FeatureDim();
 
+    std::array<int64_t, 3> x_shape{1, chunk_length, feat_dim};
+    Ort::Value x = Ort::Value::CreateTensor<float>(
+        model_->Allocator(), x_shape.data(), x_shape.size());
+
     const auto num_processed_frames = s->GetNumProcessedFrames();
-    std::vector<float> frames =
-        s->GetFrames(num_processed_frames, chunk_length);
+    s->GetFrames(num_processed_frames, chunk_length,
+                 x.GetTensorMutableData<float>());
     s->GetNumProcessedFrames() += chunk_shift;
+    PerfStats *stats = GetPerfStats().get();
 
-    auto memory_info =
-        Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
-
-    std::array<int64_t, 3> x_shape{1, chunk_length, feat_dim};
-    Ort::Value x =
-        Ort::Value::CreateTensor(memory_info, frames.data(), frames.size(),
-                                 x_shape.data(), x_shape.size());
-    auto out = model_->Forward(std::move(x), std::move(s->GetStates()));
+    std::vector<Ort::Value> out;
+    {
+      ScopedPerfTimer timer(stats, PerfStage::kEncoder);
+      out = model_->Forward(std::move(x), std::move(s->GetStates()));
+    }
     int32_t num_states = static_cast<int32_t>(out.size()) - 1;
 
     std::vector<Ort::Value> states;
@@ -311,14 +371,18 @@ class OnlineRecognizerCtcImpl : public OnlineRecognizerImpl {
 
     std::vector<int64_t> log_probs_shape =
         out[0].GetTensorTypeAndShapeInfo().GetShape();
-    decoder_->Decode(out[0].GetTensorData<float>(), log_probs_shape[0],
-                     log_probs_shape[1], log_probs_shape[2], &results, &s, 1);
+    {
+      ScopedPerfTimer timer(stats, PerfStage::kSearch);
+      decoder_->Decode(out[0].GetTensorData<float>(), log_probs_shape[0],
+                       log_probs_shape[1], log_probs_shape[2], &results, &s,
+                       1);
+    }
     s->SetCtcResult(results[0]);
   }
 
  private:
   OnlineRecognizerConfig config_;
-  std::unique_ptr<OnlineCtcModel> model_;
+  std::shared_ptr<OnlineCtcModel> model_;
   std::unique_ptr<OnlineCtcDecoder> decoder_;
   SymbolTable sym_;
   Endpoint endpoint_;
@@ -18,12 +18,15 @@
 
 #include "fst/extensions/far/far.h"
 #include "kaldifst/csrc/kaldi-fst-io.h"
+#include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/online-recognizer-ctc-impl.h"
 #include "sherpa-onnx/csrc/online-recognizer-paraformer-impl.h"
 #include "sherpa-onnx/csrc/online-recognizer-transducer-impl.h"
 #include "sherpa-onnx/csrc/online-recognizer-transducer-nemo-impl.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
+#include "sherpa-onnx/csrc/ort-env.h"
+#include "sherpa-onnx/csrc/session.h"
 #include "sherpa-onnx/csrc/text-utils.h"
 
 #if SHERPA_ONNX_ENABLE_RKNN
@@ -56,15 +59,15 @@ std::unique_ptr<OnlineRecognizerImpl> OnlineRecognizerImpl::Create(
   }
 
   if (!config.model_config.transducer.encoder.empty()) {
-    Ort::Env env(ORT_LOGGING_LEVEL_ERROR);
+    Ort::Env &env = GetOrtEnv();
 
     Ort::SessionOptions sess_opts;
     sess_opts.SetIntraOpNumThreads(1);
     sess_opts.SetInterOpNumThreads(1);
 
-    auto decoder_model = ReadFile(config.model_config.transducer.decoder);
-    auto sess = std::make_unique<Ort::Session>(env, decoder_model.data(),
-                                               decoder_model.size(), sess_opts);
+    auto decoder_model = MapFile(config.model_config.transducer.decoder);
+    auto sess = CreateSession(env, decoder_model.data(), decoder_model.size(),
+                              sess_opts);
 
     size_t node_count = sess->GetOutputCount();
 
@@ -113,15 +116,15 @@ std::unique_ptr<OnlineRecognizerImpl> OnlineRecognizerImpl::Create(
   }
 
   if (!config.model_config.transducer.encoder.empty()) {
-    Ort::Env env(ORT_LOGGING_LEVEL_ERROR);
+    Ort::Env &env = GetOrtEnv();
 
     Ort::SessionOptions sess_opts;
     sess_opts.SetIntraOpNumThreads(1);
     sess_opts.SetInterOpNumThreads(1);
 
     auto decoder_model = ReadFile(mgr, config.model_config.transducer.decoder);
-    auto sess = std::make_unique<Ort::Session>(env, decoder_model.data(),
-                                               decoder_model.size(), sess_opts);
+    auto sess = CreateSession(env, decoder_model.data(), decoder_model.size(),
+                              sess_opts);
 
     size_t node_count = sess->GetOutputCount();
 
@@ -148,29 +151,44 @@ std::unique_ptr<OnlineRecognizerImpl> OnlineRecognizerImpl::Create(
 
 OnlineRecognizerImpl::OnlineRecognizerImpl(const OnlineRecognizerConfig &config)
     : config_(config) {
-  if (!config.rule_fsts.empty()) {
+  InitInverseTextNormalizers();
+}
+
+OnlineRecognizerImpl::OnlineRecognizerImpl(const OnlineRecognizerImpl &other,
+                                           const OnlineRecognizerConfig &config)
+    : config_(config) {
+  if (config.rule_fsts == other.config_.rule_fsts &&
+      config.rule_fars == other.config_.rule_fars) {
+    itn_list_ = other.itn_list_;
+  } else {
+    InitInverseTextNormalizers();
+  }
+}
+
+void OnlineRecognizerImpl::InitInverseTextNormalizers() {
+  if (!config_.rule_fsts.empty()) {
     std::vector<std::string> files;
-    SplitStringToVector(config.rule_fsts, ",", false, &files);
+    SplitStringToVector(config_.rule_fsts, ",", false, &files);
     itn_list_.reserve(files.size());
     for (const auto &f : files) {
-      if (config.model_config.debug) {
+      if (config_.model_config.debug) {
         SHERPA_ONNX_LOGE("rule fst: %s", f.c_str());
       }
       itn_list_.push_back(std::make_unique<kaldifst::TextNormalizer>(f));
     }
   }
 
-  if (!config.rule_fars.empty()) {
-    if (config.model_config.debug) {
+  if (!config_.rule_fars.empty()) {
+    if (config_.model_config.debug) {
       SHERPA_ONNX_LOGE("Loading FST archives");
     }
     std::vector<std::string> files;
-    SplitStringToVector(config.rule_fars, ",", false, &files);
+    SplitStringToVector(config_.rule_fars, ",", false, &files);
 
     itn_list_.reserve(files.size() + itn_list_.size());
 
     for (const auto &f : files) {
-      if (config.model_config.debug) {
+      if (config_.model_config.debug) {
         SHERPA_ONNX_LOGE("rule far: %s", f.c_str());
       }
       std::unique_ptr<fst::FarReader<fst::StdArc>> reader(
@@ -184,7 +202,7 @@ OnlineRecognizerImpl::OnlineRecognizerImpl(const OnlineRecognizerConfig &config)
       }
     }
 
-    if (config.model_config.debug) {
+    if (config_.model_config.debug) {
       SHERPA_ONNX_LOGE("FST archives loaded!");
     }
   }
@@ -237,6 +255,12 @@ OnlineRecognizerImpl::OnlineRecognizerImpl(Manager *mgr,
   }      // if (!config.rule_fars.empty())
 }
 
+std::unique_ptr<OnlineRecognizerImpl> OnlineRecognizerImpl::Clone(
+    const OnlineRecognizerConfig & /*config*/) const {
+  SHERPA_ONNX_LOGE("This model does not support Clone()");
+  return nullptr;
+}
+
 std::string OnlineRecognizerImpl::ApplyInverseTextNormalization(
     std::string text) const {
   text = RemoveInvalidUtf8Sequences(text);
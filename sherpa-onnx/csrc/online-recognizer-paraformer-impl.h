@@ -18,6 +18,7 @@
 #include "sherpa-onnx/csrc/online-paraformer-model.h"
 #include "sherpa-onnx/csrc/online-recognizer-impl.h"
 #include "sherpa-onnx/csrc/online-recognizer.h"
+#include "sherpa-onnx/csrc/onnx-utils.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
 
 namespace sherpa_onnx {
@@ -98,7 +99,7 @@ class OnlineRecognizerParaformerImpl : public OnlineRecognizerImpl {
   explicit OnlineRecognizerParaformerImpl(const OnlineRecognizerConfig &config)
       : OnlineRecognizerImpl(config),
         config_(config),
-        model_(config.model_config),
+        model_(std::make_shared<OnlineParaformerModel>(config.model_config)),
         endpoint_(config_.endpoint_config) {
     if (!config.model_config.tokens_buf.empty()) {
       sym_ = SymbolTable(config.model_config.tokens_buf, false);
@@ -125,7 +126,8 @@ class OnlineRecognizerParaformerImpl : public OnlineRecognizerImpl {
                                           const OnlineRecognizerConfig &config)
       : OnlineRecognizerImpl(mgr, config),
         config_(config),
-        model_(mgr, config.model_config),
+        model_(std::make_shared<OnlineParaformerModel>(mgr,
+                                                       config.model_config)),
         sym_(mgr, config.model_config.tokens),
         endpoint_(config_.endpoint_config) {
     if (config.decoding_method != "greedy_search") {
@@ -145,6 +147,12 @@ class OnlineRecognizerParaformerImpl : public OnlineRecognizerImpl {
   OnlineRecognizerParaformerImpl operator=(
       const OnlineRecognizerParaformerImpl &) = delete;
 
+  std::unique_ptr<OnlineRecognizerImpl> Clone(
+      const OnlineRecognizerConfig &config) const override {
+    return std::unique_ptr<OnlineRecognizerImpl>(
+        new OnlineRecognizerParaformerImpl(*this, config));
+  }
+
   std::unique_ptr<OnlineStream> CreateStream() const override {
     auto stream = std::make_unique<OnlineStream>(config_.feat_config);
 
@@ -208,6 +216,22 @@ class OnlineRecognizerParaformerImpl : public OnlineRecognizerImpl {
   }
 
  private:
+  OnlineRecognizerParaformerImpl(const OnlineRecognizerParaformerImpl &other,
+                                 const OnlineRecognizerConfig &config)
+      : OnlineRecognizerImpl(other, config),
+        config_(config),
+        model_(other.model_),
+        sym_(other.sym_),
+        endpoint_(config_.endpoint_config) {
+    if (config.decoding_method != "greedy_search") {
+      SHERPA_ONNX_LOGE("Unsupported decoding method: %s",
+                       config.decoding_method.c_str());
+      exit(-1);
+    }
+
+    config_.feat_config.normalize_samples = false;
+  }
+
   void DecodeStream(OnlineStream *s) const {
     const auto num_processed_frames = s->GetNumProcessedFrames();
     std::vector<float> frames = s->GetFrames(num_processed_frames, chunk_size_);
@@ -215,9 +239,10 @@ class OnlineRecognizerParaformerImpl : public OnlineRecognizerImpl {
 
     frames = ApplyLFR(frames);
     ApplyCMVN(&frames);
-    PositionalEncoding(&frames, num_processed_frames / model_.LfrWindowShift());
+    PositionalEncoding(&frames,
+                       num_processed_frames / model_->LfrWindowShift());
 
-    int32_t feat_dim = model_.NegativeMean().size();
+    int32_t feat_dim = model_->NegativeMean().size();
 
     // We have scaled inv_stddev by sqrt(encoder_output_size)
     // so the following line can be commented out
@@ -250,8 +275,14 @@ class OnlineRecognizerParaformerImpl : public OnlineRecognizerImpl {
     Ort::Value x_length =
         Ort::Value::CreateTensor(memory_info, &x_len_val, 1, &x_len_shape, 1);
 
-    auto encoder_out_vec =
-        model_.ForwardEncoder(std::move(x), std::move(x_length));
+    PerfStats *stats = GetPerfStats().get();
+
+    std::vector<Ort::Value> encoder_out_vec;
+    {
+      ScopedPerfTimer timer(stats, PerfStage::kEncoder);
+      encoder_out_vec =
+          model_->ForwardEncoder(std::move(x), std::move(x_length));
+    }
 
     // CIF search
     auto &encoder_out = encoder_out_vec[0];
@@ -319,16 +350,16 @@ class OnlineRecognizerParaformerImpl : public OnlineRecognizerImpl {
 
     auto &states = s->GetStates();
     if (states.empty()) {
-      states.reserve(model_.DecoderNumBlocks());
+      states.reserve(model_->DecoderNumBlocks());
 
-      std::array<int64_t, 3> shape{1, model_.EncoderOutputSize(),
-                                   model_.DecoderKernelSize() - 1};
+      std::array<int64_t, 3> shape{1, model_->EncoderOutputSize(),
+                                   model_->DecoderKernelSize() - 1};
 
       int32_t num_bytes = sizeof(float) * shape[0] * shape[1] * shape[2];
 
-      for (int32_t i = 0; i != model_.DecoderNumBlocks(); ++i) {
+      for (int32_t i = 0; i != model_->DecoderNumBlocks(); ++i) {
         Ort::Value this_state = Ort::Value::CreateTensor<float>(
-            model_.Allocator(), shape.data(), shape.size());
+            model_->Allocator(), shape.data(), shape.size());
 
         memset(this_state.GetTensorMutableData<float>(), 0, num_bytes);
 
@@ -349,12 +380,20 @@ class OnlineRecognizerParaformerImpl : public OnlineRecognizerImpl {
         memory_info, &num_tokens, 1, acoustic_embedding_length_shape.data(),
         acoustic_embedding_length_shape.size());
 
-    auto decoder_out_vec = model_.ForwardDecoder(
-        std::move(encoder_out), std::move(encoder_out_len),
-        std::move(acoustic_embedding_tensor),
-        std::move(acoustic_embedding_length_tensor), std::move(states));
+    // Views, so that we can recycle the encoder outputs afterwards
+    std::vector<Ort::Value> decoder_out_vec;
+    {
+      ScopedPerfTimer timer(stats, PerfStage::kDecoder);
+      decoder_out_vec = model_->ForwardDecoder(
+          View(&encoder_out), View(&encoder_out_len),
+          std::move(acoustic_embedding_tensor),
+          std::move(acoustic_embedding_length_tensor), std::move(states));
+    }
+
+    // Let the next ForwardEncoder() write its outputs into them
+    model_->RecycleEncoderTensors(std::move(encoder_out_vec));
 
-    states.reserve(model_.DecoderNumBlocks());
+    states.reserve(model_->DecoderNumBlocks());
     for (int32_t i = 2; i != decoder_out_vec.size(); ++i) {
       // TODO(fangjun): When we change chunk_size_, we need to
       // slice decoder_out_vec[i] accordingly.
@@ -384,8 +423,8 @@ class OnlineRecognizerParaformerImpl : public OnlineRecognizerImpl {
   }
 
   std::vector<float> ApplyLFR(const std::vector<float> &in) const {
-    int32_t lfr_window_size = model_.LfrWindowSize();
-    int32_t lfr_window_shift = model_.LfrWindowShift();
+    int32_t lfr_window_size = model_->LfrWindowSize();
+    int32_t lfr_window_shift = model_->LfrWindowShift();
     int32_t in_feat_dim = config_.feat_config.feature_dim;
 
     int32_t in_num_frames = in.size() / in_feat_dim;
@@ -409,8 +448,8 @@ class OnlineRecognizerParaformerImpl : public OnlineRecognizerImpl {
   }
 
   void ApplyCMVN(std::vector<float> *v) const {
-    const std::vector<float> &neg_mean = model_.NegativeMean();
-    const std::vector<float> &inv_stddev = model_.InverseStdDev();
+    const std::vector<float> &neg_mean = model_->NegativeMean();
+    const std::vector<float> &inv_stddev = model_->InverseStdDev();
 
     int32_t dim = neg_mean.size();
     int32_t num_frames = v->size() / dim;
@@ -427,7 +466,7 @@ class OnlineRecognizerParaformerImpl : public OnlineRecognizerImpl {
   }
 
   void PositionalEncoding(std::vector<float> *v, int32_t t_offset) const {
-    int32_t lfr_window_size = model_.LfrWindowSize();
+    int32_t lfr_window_size = model_->LfrWindowSize();
     int32_t in_feat_dim = config_.feat_config.feature_dim;
 
     int32_t feat_dim = in_feat_dim * lfr_window_size;
@@ -458,7 +497,7 @@ class OnlineRecognizerParaformerImpl : public OnlineRecognizerImpl {
 
  private:
   OnlineRecognizerConfig config_;
-  OnlineParaformerModel model_;
+  std::shared_ptr<OnlineParaformerModel> model_;
   SymbolTable sym_;
   Endpoint endpoint_;
 
@@ -19,6 +19,7 @@
 #include "sherpa-onnx/csrc/online-lm.h"
 #include "sherpa-onnx/csrc/online-recognizer-impl.h"
 #include "sherpa-onnx/csrc/online-recognizer.h"
+#include "sherpa-onnx/csrc/online-state-slab.h"
 #include "sherpa-onnx/csrc/online-transducer-decoder.h"
 #include "sherpa-onnx/csrc/online-transducer-greedy-search-decoder.h"
 #include "sherpa-onnx/csrc/online-transducer-model.h"
@@ -102,37 +103,7 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
 
     model_->SetFeatureDim(config.feat_config.feature_dim);
 
-    if (config.decoding_method == "modified_beam_search") {
-      if (!config_.model_config.bpe_vocab.empty()) {
-        bpe_encoder_ = std::make_unique<ssentencepiece::Ssentencepiece>(
-            config_.model_config.bpe_vocab);
-      }
-
-      if (!config_.hotwords_buf.empty()) {
-        InitHotwordsFromBufStr();
-      } else if (!config_.hotwords_file.empty()) {
-        InitHotwords();
-      }
-
-      if (!config_.lm_config.model.empty()) {
-        lm_ = OnlineLM::Create(config.lm_config);
-      }
-
-      decoder_ = std::make_unique<OnlineTransducerModifiedBeamSearchDecoder>(
-          model_.get(), lm_.get(), config_.max_active_paths,
-          config_.lm_config.scale, config_.lm_config.shallow_fusion, unk_id_,
-          config_.blank_penalty, config_.temperature_scale);
-
-    } else if (config.decoding_method == "greedy_search") {
-      decoder_ = std::make_unique<OnlineTransducerGreedySearchDecoder>(
-          model_.get(), unk_id_, config_.blank_penalty,
-          config_.temperature_scale);
-
-    } else {
-      SHERPA_ONNX_LOGE("Unsupported decoding method: %s",
-                       config.decoding_method.c_str());
-      exit(-1);
-    }
+    InitDecoder();
   }
 
   template <typename Manager>
@@ -182,6 +153,14 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
                        config.decoding_method.c_str());
       exit(-1);
     }
+
+    decoder_->SetPerfStats(GetPerfStats().get());
+  }
+
+  std::unique_ptr<OnlineRecognizerImpl> Clone(
+      const OnlineRecognizerConfig &config) const override {
+    return std::unique_ptr<OnlineRecognizerImpl>(
+        new OnlineRecognizerTransducerImpl(*this, config));
   }
 
   std::unique_ptr<OnlineStream> CreateStream() const override {
@@ -264,7 +243,7 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
       Ort::Value x = Ort::Value::CreateTensor(memory_info, features_vec.data(),
                                               features_vec.size(),
                                               x_shape.data(), x_shape.size());
-      auto x_copy = Clone(model_->Allocator(), &x);
+      auto x_copy = sherpa_onnx::Clone(model_->Allocator(), &x);
       auto pair = model_->RunEncoder(std::move(x), std::move(states),
                                      std::move(x_copy));
       decoder_->Decode(std::move(pair.first), &results);
@@ -278,40 +257,42 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
     int32_t feature_dim = ss[0]->FeatureDim();
 
     std::vector<OnlineTransducerDecoderResult> results(n);
-    std::vector<float> features_vec(n * chunk_size * feature_dim);
-    std::vector<std::vector<Ort::Value>> states_vec(n);
     std::vector<int64_t> all_processed_frames(n);
     bool has_context_graph = false;
 
+    // Features of each stream are written to its slice of x directly
+    std::array<int64_t, 3> x_shape{n, chunk_size, feature_dim};
+    Ort::Value x = Ort::Value::CreateTensor<float>(
+        model_->Allocator(), x_shape.data(), x_shape.size());
+    float *p_x = x.GetTensorMutableData<float>();
+
+    // If the streams are the same as in the previous call, their states
+    // are still batched and we don't need to stack them
+    OnlineStateSlab *slab = GetSharedStateSlab(ss, n);
+    std::vector<std::vector<Ort::Value>> states_vec(slab ? 0 : n);
+
     for (int32_t i = 0; i != n; ++i) {
       if (!has_context_graph && ss[i]->GetContextGraph()) {
         has_context_graph = true;
       }
 
       const auto num_processed_frames = ss[i]->GetNumProcessedFrames();
-      std::vector<float> features =
-          ss[i]->GetFrames(num_processed_frames, chunk_size);
+      ss[i]->GetFrames(num_processed_frames, chunk_size,
+                       p_x + i * chunk_size * feature_dim);
 
       // Question: should num_processed_frames include chunk_shift?
       ss[i]->GetNumProcessedFrames() += chunk_shift;
 
-      std::copy(features.begin(), features.end(),
-                features_vec.data() + i * chunk_size * feature_dim);
-
       results[i] = std::move(ss[i]->GetResult());
-      states_vec[i] = std::move(ss[i]->GetStates());
+      if (!slab) {
+        states_vec[i] = std::move(ss[i]->GetStates());
+      }
       all_processed_frames[i] = num_processed_frames;
     }
 
     auto memory_info =
         Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
 
-    std::array<int64_t, 3> x_shape{n, chunk_size, feature_dim};
-
-    Ort::Value x = Ort::Value::CreateTensor(memory_info, features_vec.data(),
-                                            features_vec.size(), x_shape.data(),
-                                            x_shape.size());
-
     std::array<int64_t, 1> processed_frames_shape{
         static_cast<int64_t>(all_processed_frames.size())};
 
@@ -319,23 +300,59 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
         memory_info, all_processed_frames.data(), all_processed_frames.size(),
         processed_frames_shape.data(), processed_frames_shape.size());
 
-    auto states = model_->StackStates(states_vec);
+    std::vector<Ort::Value> states = slab
+                                         ? std::move(slab->GetBatchedStates())
+                                         : model_->StackStates(states_vec);
 
-    auto pair = model_->RunEncoder(std::move(x), std::move(states),
-                                   std::move(processed_frames));
+    // The encoder gets views of the states, so that we can recycle the
+    // states afterwards. Both slab and StackStates() own their tensors.
+    std::vector<Ort::Value> states_view;
+    states_view.reserve(states.size());
+    for (auto &v : states) {
+      states_view.push_back(View(&v));
+    }
 
-    if (has_context_graph) {
-      decoder_->Decode(std::move(pair.first), ss, &results);
-    } else {
-      decoder_->Decode(std::move(pair.first), &results);
+    PerfStats *stats = GetPerfStats().get();
+
+    auto pair = [&]() {
+      ScopedPerfTimer timer(stats, PerfStage::kEncoder);
+      return model_->RunEncoder(std::move(x), std::move(states_view),
+                                std::move(processed_frames));
+    }();
+
+    {
+      // It includes the time of the decoder and the joiner
+      ScopedPerfTimer timer(stats, PerfStage::kSearch);
+      if (has_context_graph) {
+        decoder_->Decode(View(&pair.first), ss, &results);
+      } else {
+        decoder_->Decode(View(&pair.first), &results);
+      }
     }
 
-    std::vector<std::vector<Ort::Value>> next_states =
-        model_->UnStackStates(pair.second);
+    // Let the next RunEncoder() write its outputs into them
+    states.push_back(std::move(pair.first));
+    model_->RecycleEncoderTensors(std::move(states));
+
+    // The next states stay batched. They are unstacked only when
+    // the streams are decoded in a different batch.
+    if (slab) {
+      slab->GetBatchedStates() = std::move(pair.second);
+    } else {
+      auto model = model_.get();
+      auto new_slab = std::make_shared<OnlineStateSlab>(
+          std::move(pair.second), n,
+          [model](std::vector<Ort::Value> states) {
+            return model->UnStackStates(states);
+          });
+
+      for (int32_t i = 0; i != n; ++i) {
+        ss[i]->SetStateSlab(new_slab, i);
+      }
+    }
 
     for (int32_t i = 0; i != n; ++i) {
       ss[i]->SetResult(results[i]);
-      ss[i]->SetStates(std::move(next_states[i]));
     }
   }
 
@@ -391,10 +408,10 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
     // truncate all last hyps and save as the context for next result
     if (static_cast<int32_t>(last_result.tokens.size()) > context_size) {
       for (const auto &it : last_result.hyps) {
-        auto h = it.second;
-        r.hyps.Add({std::vector<int64_t>(h.ys.end() - context_size,
-                                         h.ys.end()),
-                    h.log_prob});
+        const auto &h = it.second;
+        std::vector<int64_t> ys(context_size);
+        h.GetTokens(h.NumTokens() - context_size, h.NumTokens(), ys.data());
+        r.hyps.Add({ys, h.log_prob});
       }
 
       r.tokens = std::vector<int64_t> (last_result.tokens.end() - context_size,
@@ -417,6 +434,57 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
   }
 
  private:
+  OnlineRecognizerTransducerImpl(const OnlineRecognizerTransducerImpl &other,
+                                 const OnlineRecognizerConfig &config)
+      : OnlineRecognizerImpl(other, config),
+        config_(config),
+        model_(other.model_),
+        sym_(other.sym_),
+        endpoint_(config_.endpoint_config),
+        unk_id_(other.unk_id_) {
+    if (config_.lm_config.model == other.config_.lm_config.model) {
+      lm_ = other.lm_;
+    }
+
+    InitDecoder();
+  }
+
+  void InitDecoder() {
+    if (config_.decoding_method == "modified_beam_search") {
+      if (!config_.model_config.bpe_vocab.empty()) {
+        bpe_encoder_ = std::make_unique<ssentencepiece::Ssentencepiece>(
+            config_.model_config.bpe_vocab);
+      }
+
+      if (!config_.hotwords_buf.empty()) {
+        InitHotwordsFromBufStr();
+      } else if (!config_.hotwords_file.empty()) {
+        InitHotwords();
+      }
+
+      if (!lm_ && !config_.lm_config.model.empty()) {
+        lm_ = OnlineLM::Create(config_.lm_config);
+      }
+
+      decoder_ = std::make_unique<OnlineTransducerModifiedBeamSearchDecoder>(
+          model_.get(), lm_.get(), config_.max_active_paths,
+          config_.lm_config.scale, config_.lm_config.shallow_fusion, unk_id_,
+          config_.blank_penalty, config_.temperature_scale);
+
+    } else if (config_.decoding_method == "greedy_search") {
+      decoder_ = std::make_unique<OnlineTransducerGreedySearchDecoder>(
+          model_.get(), unk_id_, config_.blank_penalty,
+          config_.temperature_scale);
+
+    } else {
+      SHERPA_ONNX_LOGE("Unsupported decoding method: %s",
+                       config_.decoding_method.c_str());
+      exit(-1);
+    }
+
+    decoder_->SetPerfStats(GetPerfStats().get());
+  }
+
   void InitHotwords() {
     // each line in hotwords_file contains space-separated words
 
@@ -496,8 +564,8 @@ class OnlineRecognizerTransducerImpl : public OnlineRecognizerImpl {
   std::vector<float> boost_scores_;
   ContextGraphPtr hotwords_graph_;
   std::unique_ptr<ssentencepiece::Ssentencepiece> bpe_encoder_;
-  std::unique_ptr<OnlineTransducerModel> model_;
-  std::unique_ptr<OnlineLM> lm_;
+  std::shared_ptr<OnlineTransducerModel> model_;
+  std::shared_ptr<OnlineLM> lm_;
   std::unique_ptr<OnlineTransducerDecoder> decoder_;
   SymbolTable sym_;
   Endpoint endpoint_;
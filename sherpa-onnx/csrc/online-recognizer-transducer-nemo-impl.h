@@ -41,7 +41,7 @@ class OnlineRecognizerTransducerNeMoImpl : public OnlineRecognizerImpl {
         config_(config),
         endpoint_(config_.endpoint_config),
         model_(
-            std::make_unique<OnlineTransducerNeMoModel>(config.model_config)) {
+            std::make_shared<OnlineTransducerNeMoModel>(config.model_config)) {
     if (!config.model_config.tokens_buf.empty()) {
       symbol_table_ = SymbolTable(config.model_config.tokens_buf, false);
     } else {
@@ -49,14 +49,7 @@ class OnlineRecognizerTransducerNeMoImpl : public OnlineRecognizerImpl {
       symbol_table_ = SymbolTable(config.model_config.tokens, true);
     }
 
-    if (config.decoding_method == "greedy_search") {
-      decoder_ = std::make_unique<OnlineTransducerGreedySearchNeMoDecoder>(
-          model_.get(), config_.blank_penalty);
-    } else {
-      SHERPA_ONNX_LOGE("Unsupported decoding method: %s",
-                       config.decoding_method.c_str());
-      exit(-1);
-    }
+    InitDecoder();
     PostInit();
   }
 
@@ -67,20 +60,19 @@ class OnlineRecognizerTransducerNeMoImpl : public OnlineRecognizerImpl {
         config_(config),
         symbol_table_(mgr, config.model_config.tokens),
         endpoint_(config_.endpoint_config),
-        model_(std::make_unique<OnlineTransducerNeMoModel>(
+        model_(std::make_shared<OnlineTransducerNeMoModel>(
             mgr, config.model_config)) {
-    if (config.decoding_method == "greedy_search") {
-      decoder_ = std::make_unique<OnlineTransducerGreedySearchNeMoDecoder>(
-          model_.get(), config_.blank_penalty);
-    } else {
-      SHERPA_ONNX_LOGE("Unsupported decoding method: %s",
-                       config.decoding_method.c_str());
-      exit(-1);
-    }
+    InitDecoder();
 
     PostInit();
   }
 
+  std::unique_ptr<OnlineRecognizerImpl> Clone(
+      const OnlineRecognizerConfig &config) const override {
+    return std::unique_ptr<OnlineRecognizerImpl>(
+        new OnlineRecognizerTransducerNeMoImpl(*this, config));
+  }
+
   std::unique_ptr<OnlineStream> CreateStream() const override {
     auto stream = std::make_unique<OnlineStream>(config_.feat_config);
     InitOnlineStream(stream.get());
@@ -147,35 +139,34 @@ class OnlineRecognizerTransducerNeMoImpl : public OnlineRecognizerImpl {
 
     int32_t feature_dim = ss[0]->FeatureDim();
 
-    std::vector<float> features_vec(n * chunk_size * feature_dim);
     std::vector<std::vector<Ort::Value>> encoder_states(n);
 
+    // Features of each stream are written to its slice of x directly
+    std::array<int64_t, 3> x_shape{n, chunk_size, feature_dim};
+    Ort::Value x = Ort::Value::CreateTensor<float>(
+        model_->Allocator(), x_shape.data(), x_shape.size());
+    float *p_x = x.GetTensorMutableData<float>();
+
     for (int32_t i = 0; i != n; ++i) {
       const auto num_processed_frames = ss[i]->GetNumProcessedFrames();
-      std::vector<float> features =
-          ss[i]->GetFrames(num_processed_frames, chunk_size);
+      ss[i]->GetFrames(num_processed_frames, chunk_size,
+                       p_x + i * chunk_size * feature_dim);
 
       // Question: should num_processed_frames include chunk_shift?
       ss[i]->GetNumProcessedFrames() += chunk_shift;
 
-      std::copy(features.begin(), features.end(),
-                features_vec.data() + i * chunk_size * feature_dim);
-
       encoder_states[i] = std::move(ss[i]->GetStates());
     }
 
-    auto memory_info =
-        Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
-
-    std::array<int64_t, 3> x_shape{n, chunk_size, feature_dim};
-
-    Ort::Value x = Ort::Value::CreateTensor(memory_info, features_vec.data(),
-                                            features_vec.size(), x_shape.data(),
-                                            x_shape.size());
-
     auto states = model_->StackStates(std::move(encoder_states));
     int32_t num_states = states.size();  // num_states = 3
-    auto t = model_->RunEncoder(std::move(x), std::move(states));
+    PerfStats *stats = GetPerfStats().get();
+
+    std::vector<Ort::Value> t;
+    {
+      ScopedPerfTimer timer(stats, PerfStage::kEncoder);
+      t = model_->RunEncoder(std::move(x), std::move(states));
+    }
     // t[0] encoder_out, float tensor, (batch_size, dim, T)
     // t[1] next states
 
@@ -193,6 +184,7 @@ class OnlineRecognizerTransducerNeMoImpl : public OnlineRecognizerImpl {
 
     Ort::Value encoder_out = Transpose12(model_->Allocator(), &t[0]);
 
+    ScopedPerfTimer timer(stats, PerfStage::kSearch);
     decoder_->Decode(std::move(encoder_out), ss, n);
   }
 
@@ -205,6 +197,29 @@ class OnlineRecognizerTransducerNeMoImpl : public OnlineRecognizerImpl {
   }
 
  private:
+  OnlineRecognizerTransducerNeMoImpl(
+      const OnlineRecognizerTransducerNeMoImpl &other,
+      const OnlineRecognizerConfig &config)
+      : OnlineRecognizerImpl(other, config),
+        config_(config),
+        symbol_table_(other.symbol_table_),
+        model_(other.model_),
+        endpoint_(config_.endpoint_config) {
+    InitDecoder();
+    PostInit();
+  }
+
+  void InitDecoder() {
+    if (config_.decoding_method == "greedy_search") {
+      decoder_ = std::make_unique<OnlineTransducerGreedySearchNeMoDecoder>(
+          model_.get(), config_.blank_penalty);
+    } else {
+      SHERPA_ONNX_LOGE("Unsupported decoding method: %s",
+                       config_.decoding_method.c_str());
+      exit(-1);
+    }
+  }
+
   void PostInit() {
     config_.feat_config.nemo_normalize_type =
         model_->FeatureNormalizationMethod();
@@ -241,7 +256,7 @@ class OnlineRecognizerTransducerNeMoImpl : public OnlineRecognizerImpl {
  private:
   OnlineRecognizerConfig config_;
   SymbolTable symbol_table_;
-  std::unique_ptr<OnlineTransducerNeMoModel> model_;
+  std::shared_ptr<OnlineTransducerNeMoModel> model_;
   std::unique_ptr<OnlineTransducerGreedySearchNeMoDecoder> decoder_;
   Endpoint endpoint_;
 };
@@ -203,23 +203,36 @@ std::string OnlineRecognizerConfig::ToString() const {
   return os.str();
 }
 
+// The model files in model_config.precision are loaded if it is set
+static OnlineRecognizerConfig ApplyPrecision(OnlineRecognizerConfig config) {
+  config.model_config.ApplyPrecision();
+  return config;
+}
+
 OnlineRecognizer::OnlineRecognizer(const OnlineRecognizerConfig &config)
-    : impl_(OnlineRecognizerImpl::Create(config)) {}
+    : impl_(OnlineRecognizerImpl::Create(ApplyPrecision(config))) {}
 
 template <typename Manager>
 OnlineRecognizer::OnlineRecognizer(Manager *mgr,
                                    const OnlineRecognizerConfig &config)
     : impl_(OnlineRecognizerImpl::Create(mgr, config)) {}
 
+OnlineRecognizer::OnlineRecognizer(std::unique_ptr<OnlineRecognizerImpl> impl)
+    : impl_(std::move(impl)) {}
+
 OnlineRecognizer::~OnlineRecognizer() = default;
 
 std::unique_ptr<OnlineStream> OnlineRecognizer::CreateStream() const {
-  return impl_->CreateStream();
+  auto s = impl_->CreateStream();
+  s->SetPerfStats(impl_->GetPerfStats());
+  return s;
 }
 
 std::unique_ptr<OnlineStream> OnlineRecognizer::CreateStream(
     const std::string &hotwords) const {
-  return impl_->CreateStream(hotwords);
+  auto s = impl_->CreateStream(hotwords);
+  s->SetPerfStats(impl_->GetPerfStats());
+  return s;
 }
 
 bool OnlineRecognizer::IsReady(OnlineStream *s) const {
@@ -233,10 +246,17 @@ void OnlineRecognizer::WarmpUpRecognizer(int32_t warmup, int32_t mbs) const {
 }
 
 void OnlineRecognizer::DecodeStreams(OnlineStream **ss, int32_t n) const {
+  ScopedPerfTimer timer(impl_->GetPerfStats().get(), PerfStage::kDecodeStreams);
   impl_->DecodeStreams(ss, n);
+
+  for (int32_t i = 0; i != n; ++i) {
+    ss[i]->DiscardProcessed();
+  }
 }
 
 OnlineRecognizerResult OnlineRecognizer::GetResult(OnlineStream *s) const {
+  ScopedPerfTimer timer(impl_->GetPerfStats().get(),
+                        PerfStage::kPostprocessing);
   return impl_->GetResult(s);
 }
 
@@ -246,6 +266,29 @@ bool OnlineRecognizer::IsEndpoint(OnlineStream *s) const {
 
 void OnlineRecognizer::Reset(OnlineStream *s) const { impl_->Reset(s); }
 
+std::unique_ptr<OnlineRecognizer> OnlineRecognizer::Clone(
+    const OnlineRecognizerConfig &config) const {
+  auto impl = impl_->Clone(config);
+  if (!impl) {
+    return nullptr;
+  }
+
+  return std::unique_ptr<OnlineRecognizer>(
+      new OnlineRecognizer(std::move(impl)));
+}
+
+std::map<std::string, StageStats> OnlineRecognizer::GetStats() const {
+  return impl_->GetPerfStats()->Get();
+}
+
+void OnlineRecognizer::ResetStats() const { impl_->GetPerfStats()->Reset(); }
+
+std::future<void> OnlineRecognizer::Warmup(
+    const std::vector<WarmupShape> &shapes) const {
+  return std::async(std::launch::async,
+                    [this, shapes]() { RunStreamingWarmup(*this, shapes); });
+}
+
 #if __ANDROID_API__ >= 9
 template OnlineRecognizer::OnlineRecognizer(
     AAssetManager *mgr, const OnlineRecognizerConfig &config);
@@ -5,6 +5,8 @@
 #ifndef SHERPA_ONNX_CSRC_ONLINE_RECOGNIZER_H_
 #define SHERPA_ONNX_CSRC_ONLINE_RECOGNIZER_H_
 
+#include <future>  // NOLINT
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -17,6 +19,8 @@
 #include "sherpa-onnx/csrc/online-stream.h"
 #include "sherpa-onnx/csrc/online-transducer-model-config.h"
 #include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/perf-stats.h"
+#include "sherpa-onnx/csrc/warmup.h"
 
 namespace sherpa_onnx {
 
@@ -147,6 +151,9 @@ class OnlineRecognizer {
   template <typename Manager>
   OnlineRecognizer(Manager *mgr, const OnlineRecognizerConfig &config);
 
+  // Create a recognizer from an implementation, e.g., a fake one in tests
+  explicit OnlineRecognizer(std::unique_ptr<OnlineRecognizerImpl> impl);
+
   ~OnlineRecognizer();
 
   /// Create a stream for decoding.
@@ -202,6 +209,44 @@ class OnlineRecognizer {
   // after calling this function, IsEndpoint(s) will return false
   void Reset(OnlineStream *s) const;
 
+  /** Create a recognizer that shares the onnxruntime sessions of this one
+   * but uses the decoding settings from config, e.g., decoding_method,
+   * hotwords, blank_penalty and endpoint rules.
+   *
+   * It is much cheaper than loading the model again. config.model_config
+   * should describe the same model as the config of this recognizer; the
+   * model files in it are not loaded.
+   *
+   * This recognizer can be destroyed before the returned one. Streams
+   * must be decoded by the recognizer that created them.
+   *
+   * @return Return nullptr if the model does not support it.
+   */
+  std::unique_ptr<OnlineRecognizer> Clone(
+      const OnlineRecognizerConfig &config) const;
+
+  /** Return the cumulative time and number of calls of each stage since
+   * this recognizer was created or ResetStats() was called, e.g.,
+   * feature_extraction, encoder, decoder, joiner and postprocessing.
+   * See perf-stats.h. The stages depend on the model.
+   */
+  std::map<std::string, StageStats> GetStats() const;
+
+  void ResetStats() const;
+
+  /** Decode synthetic audio of the given shapes so that later requests
+   * do not pay for kernel selection and memory allocation in onnxruntime.
+   * For each shape, batch_size streams of num_seconds are decoded
+   * together chunk by chunk. Unlike WarmpUpRecognizer(), it works with
+   * all models.
+   *
+   * It returns immediately; the warmup runs in a background thread and
+   * the returned future becomes ready when it is done. Note that the
+   * destructor of the future waits for the warmup. Requests can be served
+   * while it runs. This object must outlive the warmup.
+   */
+  std::future<void> Warmup(const std::vector<WarmupShape> &shapes) const;
+
  private:
   std::unique_ptr<OnlineRecognizerImpl> impl_;
 };
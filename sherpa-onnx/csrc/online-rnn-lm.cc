@@ -14,6 +14,7 @@
 #include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
+#include "sherpa-onnx/csrc/ort-env.h"
 #include "sherpa-onnx/csrc/session.h"
 #include "sherpa-onnx/csrc/text-utils.h"
 
@@ -23,7 +24,7 @@ class OnlineRnnLM::Impl {
  public:
   explicit Impl(const OnlineLMConfig &config)
       : config_(config),
-        env_(ORT_LOGGING_LEVEL_ERROR),
+        env_(GetOrtEnv()),
         sess_opts_{GetSessionOptions(config)},
         allocator_{} {
     Init(config);
@@ -39,14 +40,14 @@ class OnlineRnnLM::Impl {
 
     // get lm score for cur token given the hyp->ys[:-1] and save to lm_log_prob
     const float *nn_lm_scores = hyp->nn_lm_scores.value.GetTensorData<float>();
-    hyp->lm_log_prob += nn_lm_scores[hyp->ys.back()] * scale;
+    hyp->lm_log_prob += nn_lm_scores[hyp->LastToken()] * scale;
 
     // get lm scores for next tokens given the hyp->ys[:] and save to
     // nn_lm_scores
     std::array<int64_t, 2> x_shape{1, 1};
     Ort::Value x = Ort::Value::CreateTensor<int64_t>(allocator_, x_shape.data(),
                                                      x_shape.size());
-    *x.GetTensorMutableData<int64_t>() = hyp->ys.back();
+    *x.GetTensorMutableData<int64_t>() = hyp->LastToken();
     auto lm_out = ScoreToken(std::move(x), Convert(hyp->nn_lm_states));
     hyp->nn_lm_scores.value = std::move(lm_out.first);
     hyp->nn_lm_states = Convert(std::move(lm_out.second));
@@ -60,9 +61,9 @@ class OnlineRnnLM::Impl {
     for (auto &hyp : *hyps) {
       for (auto &h_m : hyp) {
         auto &h = h_m.second;
-        auto &ys = h.ys;
+        const int32_t num_tokens = h.NumTokens();
         const int32_t token_num_in_chunk =
-            ys.size() - context_size - h.cur_scored_pos - 1;
+            num_tokens - context_size - h.cur_scored_pos - 1;
 
         if (token_num_in_chunk < 1) {
           continue;
@@ -78,8 +79,7 @@ class OnlineRnnLM::Impl {
           Ort::Value x = Ort::Value::CreateTensor<int64_t>(
               allocator, x_shape.data(), x_shape.size());
           int64_t *p_x = x.GetTensorMutableData<int64_t>();
-          std::copy(ys.begin() + context_size + h.cur_scored_pos, ys.end() - 1,
-                    p_x);
+          h.GetTokens(context_size + h.cur_scored_pos, num_tokens - 1, p_x);
 
           // streaming forward by NN LM
           auto out =
@@ -139,10 +139,9 @@ class OnlineRnnLM::Impl {
 
  private:
   void Init(const OnlineLMConfig &config) {
-    auto buf = ReadFile(config_.model);
+    auto buf = MapFile(config_.model);
 
-    sess_ = std::make_unique<Ort::Session>(env_, buf.data(), buf.size(),
-                                           sess_opts_);
+    sess_ = CreateSession(env_, buf.data(), buf.size(), sess_opts_);
 
     GetInputNames(sess_.get(), &input_names_, &input_names_ptr_);
     GetOutputNames(sess_.get(), &output_names_, &output_names_ptr_);
@@ -185,7 +184,7 @@ class OnlineRnnLM::Impl {
 
  private:
   OnlineLMConfig config_;
-  Ort::Env env_;
+  Ort::Env &env_;
   Ort::SessionOptions sess_opts_;
   Ort::AllocatorWithDefaultOptions allocator_;
 
@@ -0,0 +1,99 @@
+// sherpa-onnx/csrc/online-state-slab-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/online-state-slab.h"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/online-stream.h"
+#include "sherpa-onnx/csrc/onnx-utils.h"
+#include "sherpa-onnx/csrc/unbind.h"
+
+namespace sherpa_onnx {
+
+// Each stream has a single state of shape (1, 3)
+static std::shared_ptr<OnlineStateSlab> CreateSlab(OrtAllocator *allocator,
+                                                   int32_t batch_size) {
+  std::array<int64_t, 2> shape{batch_size, 3};
+  Ort::Value v =
+      Ort::Value::CreateTensor<float>(allocator, shape.data(), shape.size());
+  float *p = v.GetTensorMutableData<float>();
+  for (int32_t i = 0; i != batch_size * 3; ++i) {
+    p[i] = i;
+  }
+
+  std::vector<Ort::Value> states;
+  states.push_back(std::move(v));
+
+  return std::make_shared<OnlineStateSlab>(
+      std::move(states), batch_size,
+      [allocator](std::vector<Ort::Value> states) {
+        auto v = Unbind(allocator, &states[0], 0);
+
+        std::vector<std::vector<Ort::Value>> ans(v.size());
+        for (int32_t i = 0; i != static_cast<int32_t>(v.size()); ++i) {
+          ans[i].push_back(std::move(v[i]));
+        }
+        return ans;
+      });
+}
+
+TEST(OnlineStateSlab, TakeStates) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  auto slab = CreateSlab(allocator, 2);
+  EXPECT_TRUE(slab->IsBatched());
+  EXPECT_EQ(slab->GetBatchedStates().size(), 1);
+
+  auto s1 = slab->TakeStates(1);
+  EXPECT_FALSE(slab->IsBatched());
+  ASSERT_EQ(s1.size(), 1);
+  EXPECT_EQ(s1[0].GetTensorTypeAndShapeInfo().GetShape(),
+            std::vector<int64_t>({1, 3}));
+  EXPECT_EQ(s1[0].GetTensorData<float>()[0], 3);
+
+  auto s0 = slab->TakeStates(0);
+  ASSERT_EQ(s0.size(), 1);
+  EXPECT_EQ(s0[0].GetTensorData<float>()[2], 2);
+}
+
+TEST(OnlineStateSlab, SharedBySameStreams) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  auto slab = CreateSlab(allocator, 2);
+
+  OnlineStream a;
+  OnlineStream b;
+  OnlineStream c;
+  a.SetStateSlab(slab, 0);
+  b.SetStateSlab(slab, 1);
+
+  std::vector<OnlineStream *> ss = {&a, &b};
+  EXPECT_EQ(GetSharedStateSlab(ss.data(), 2), slab.get());
+
+  // different order
+  ss = {&b, &a};
+  EXPECT_EQ(GetSharedStateSlab(ss.data(), 2), nullptr);
+
+  // different streams
+  ss = {&a};
+  EXPECT_EQ(GetSharedStateSlab(ss.data(), 1), nullptr);
+
+  ss = {&a, &c};
+  EXPECT_EQ(GetSharedStateSlab(ss.data(), 2), nullptr);
+
+  // b leaves the slab
+  EXPECT_EQ(b.GetStates()[0].GetTensorData<float>()[0], 3);
+  EXPECT_EQ(b.GetStateSlab(), nullptr);
+
+  ss = {&a, &b};
+  EXPECT_EQ(GetSharedStateSlab(ss.data(), 2), nullptr);
+
+  // a can still get its states
+  EXPECT_EQ(a.GetStates()[0].GetTensorData<float>()[1], 1);
+  EXPECT_EQ(a.GetStateSlab(), nullptr);
+}
+
+}  // namespace sherpa_onnx
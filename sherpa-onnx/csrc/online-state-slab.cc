@@ -0,0 +1,57 @@
+// sherpa-onnx/csrc/online-state-slab.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/online-state-slab.h"
+
+#include <utility>
+#include <vector>
+
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/online-stream.h"
+
+namespace sherpa_onnx {
+
+OnlineStateSlab::OnlineStateSlab(std::vector<Ort::Value> states,
+                                 int32_t batch_size, UnStackFunc unstack)
+    : states_(std::move(states)),
+      batch_size_(batch_size),
+      unstack_(std::move(unstack)) {}
+
+bool OnlineStateSlab::IsBatched() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return unstacked_.empty();
+}
+
+std::vector<Ort::Value> OnlineStateSlab::TakeStates(int32_t slot) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (unstacked_.empty()) {
+    unstacked_ = unstack_(std::move(states_));
+    states_.clear();
+
+    if (static_cast<int32_t>(unstacked_.size()) != batch_size_) {
+      SHERPA_ONNX_LOGE("Expect %d states after unstacking. Given: %d",
+                       batch_size_, static_cast<int32_t>(unstacked_.size()));
+      SHERPA_ONNX_EXIT(-1);
+    }
+  }
+
+  return std::move(unstacked_[slot]);
+}
+
+OnlineStateSlab *GetSharedStateSlab(OnlineStream **ss, int32_t n) {
+  OnlineStateSlab *slab = ss[0]->GetStateSlab().get();
+  if (!slab || slab->BatchSize() != n || !slab->IsBatched()) {
+    return nullptr;
+  }
+
+  for (int32_t i = 0; i != n; ++i) {
+    if (ss[i]->GetStateSlab().get() != slab || ss[i]->GetStateSlot() != i) {
+      return nullptr;
+    }
+  }
+
+  return slab;
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,80 @@
+// sherpa-onnx/csrc/online-state-slab.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_ONLINE_STATE_SLAB_H_
+#define SHERPA_ONNX_CSRC_ONLINE_STATE_SLAB_H_
+
+#include <functional>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "onnxruntime_cxx_api.h"  // NOLINT
+
+namespace sherpa_onnx {
+
+class OnlineStream;
+
+/** Batched encoder states shared by the streams of a batch.
+ *
+ * A streaming recognizer stacks the states of all streams before running
+ * the encoder and unstacks the output states afterwards. When the same
+ * streams are decoded together chunk after chunk, which is the usual case
+ * for a server, the output states of one run are exactly the input states
+ * of the next run, so both copies are wasted.
+ *
+ * An OnlineStateSlab keeps the batched output states of a run and each
+ * stream remembers its slot in it. If the next batch contains the same
+ * streams in the same slots, the batched states are fed to the encoder
+ * as they are. Otherwise, the slab is unstacked once, the first time a
+ * stream asks for its states, and each stream takes its own slot.
+ */
+class OnlineStateSlab {
+ public:
+  using UnStackFunc = std::function<std::vector<std::vector<Ort::Value>>(
+      std::vector<Ort::Value>)>;
+
+  /**
+   * @param states Batched states, e.g., returned by the encoder.
+   * @param batch_size Number of streams in states.
+   * @param unstack It is called to split states into individual states.
+   *                It must remain valid as long as this object is alive.
+   */
+  OnlineStateSlab(std::vector<Ort::Value> states, int32_t batch_size,
+                  UnStackFunc unstack);
+
+  int32_t BatchSize() const { return batch_size_; }
+
+  // Return true if no stream has taken its states out of this slab,
+  // i.e., GetBatchedStates() can be used.
+  bool IsBatched() const;
+
+  // Return a reference to the batched states. The caller can move them
+  // into the encoder and assign the output states back.
+  std::vector<Ort::Value> &GetBatchedStates() { return states_; }
+
+  // Return the states of the given slot. The first call unstacks the
+  // batched states, after which IsBatched() returns false.
+  std::vector<Ort::Value> TakeStates(int32_t slot);
+
+ private:
+  std::vector<Ort::Value> states_;
+  int32_t batch_size_ = 0;
+  UnStackFunc unstack_;
+
+  // Non-empty after the batched states have been unstacked
+  std::vector<std::vector<Ort::Value>> unstacked_;
+
+  // Streams sharing a slab may be used from different threads
+  mutable std::mutex mutex_;
+};
+
+/** Check whether the batched states of ss can be used without copying.
+ *
+ * @return Return the slab if ss[i] is in slot i of it for all i and the slab
+ *         contains exactly n streams; return nullptr otherwise.
+ */
+OnlineStateSlab *GetSharedStateSlab(OnlineStream **ss, int32_t n);
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_ONLINE_STATE_SLAB_H_
@@ -36,6 +36,18 @@ class OnlineStream::Impl {
     return feat_extractor_.GetFrames(frame_index + start_frame_index_, n);
   }
 
+  void GetFrames(int32_t frame_index, int32_t n, float *out) const {
+    feat_extractor_.GetFrames(frame_index + start_frame_index_, n, out);
+  }
+
+  void DiscardProcessed() {
+    int32_t n = start_frame_index_ + num_processed_frames_ -
+                feat_extractor_.NumFramesPopped();
+    if (n > 0) {
+      feat_extractor_.Pop(n);
+    }
+  }
+
   void Reset() {
     // we don't reset the feature extractor
     start_frame_index_ += num_processed_frames_;
@@ -86,10 +98,29 @@ class OnlineStream::Impl {
   int32_t FeatureDim() const { return feat_extractor_.FeatureDim(); }
 
   void SetStates(std::vector<Ort::Value> states) {
+    state_slab_.reset();
     states_ = std::move(states);
   }
 
-  std::vector<Ort::Value> &GetStates() { return states_; }
+  std::vector<Ort::Value> &GetStates() {
+    if (state_slab_) {
+      states_ = state_slab_->TakeStates(state_slot_);
+      state_slab_.reset();
+    }
+    return states_;
+  }
+
+  void SetStateSlab(std::shared_ptr<OnlineStateSlab> slab, int32_t slot) {
+    states_.clear();
+    state_slab_ = std::move(slab);
+    state_slot_ = slot;
+  }
+
+  const std::shared_ptr<OnlineStateSlab> &GetStateSlab() const {
+    return state_slab_;
+  }
+
+  int32_t GetStateSlot() const { return state_slot_; }
 
   void SetNeMoDecoderStates(std::vector<Ort::Value> decoder_states) {
     decoder_states_ = std::move(decoder_states);
@@ -136,6 +167,10 @@ class OnlineStream::Impl {
   TransducerKeywordResult empty_keyword_result_;
   OnlineCtcDecoderResult ctc_result_;
   std::vector<Ort::Value> states_;  // states for transducer or ctc models
+  // If not null, states_ is empty and the states are kept in
+  // slot state_slot_ of the slab
+  std::shared_ptr<OnlineStateSlab> state_slab_;
+  int32_t state_slot_ = 0;
   std::vector<Ort::Value> decoder_states_;  // states for nemo transducer models
   std::vector<float> paraformer_feat_cache_;
   std::vector<float> paraformer_encoder_out_cache_;
@@ -153,10 +188,14 @@ OnlineStream::~OnlineStream() = default;
 
 void OnlineStream::AcceptWaveform(int32_t sampling_rate, const float *waveform,
                                   int32_t n) const {
+  ScopedPerfTimer timer(perf_stats_.get(), PerfStage::kFeatureExtraction);
   impl_->AcceptWaveform(sampling_rate, waveform, n);
 }
 
-void OnlineStream::InputFinished() const { impl_->InputFinished(); }
+void OnlineStream::InputFinished() const {
+  ScopedPerfTimer timer(perf_stats_.get(), PerfStage::kFeatureExtraction);
+  impl_->InputFinished();
+}
 
 int32_t OnlineStream::NumFramesReady() const { return impl_->NumFramesReady(); }
 
@@ -169,6 +208,13 @@ std::vector<float> OnlineStream::GetFrames(int32_t frame_index,
   return impl_->GetFrames(frame_index, n);
 }
 
+void OnlineStream::GetFrames(int32_t frame_index, int32_t n,
+                             float *out) const {
+  impl_->GetFrames(frame_index, n, out);
+}
+
+void OnlineStream::DiscardProcessed() { impl_->DiscardProcessed(); }
+
 void OnlineStream::Reset() { impl_->Reset(); }
 
 int32_t OnlineStream::FeatureDim() const { return impl_->FeatureDim(); }
@@ -226,6 +272,17 @@ std::vector<Ort::Value> &OnlineStream::GetStates() {
   return impl_->GetStates();
 }
 
+void OnlineStream::SetStateSlab(std::shared_ptr<OnlineStateSlab> slab,
+                                int32_t slot) {
+  impl_->SetStateSlab(std::move(slab), slot);
+}
+
+const std::shared_ptr<OnlineStateSlab> &OnlineStream::GetStateSlab() const {
+  return impl_->GetStateSlab();
+}
+
+int32_t OnlineStream::GetStateSlot() const { return impl_->GetStateSlot(); }
+
 void OnlineStream::SetNeMoDecoderStates(
     std::vector<Ort::Value> decoder_states) {
   return impl_->SetNeMoDecoderStates(std::move(decoder_states));
@@ -264,4 +321,8 @@ std::vector<float> &OnlineStream::GetParaformerAlphaCache() {
   return impl_->GetParaformerAlphaCache();
 }
 
+void OnlineStream::SetPerfStats(std::shared_ptr<PerfStats> stats) {
+  perf_stats_ = std::move(stats);
+}
+
 }  // namespace sherpa_onnx
@@ -14,7 +14,9 @@
 #include "sherpa-onnx/csrc/features.h"
 #include "sherpa-onnx/csrc/online-ctc-decoder.h"
 #include "sherpa-onnx/csrc/online-paraformer-decoder.h"
+#include "sherpa-onnx/csrc/online-state-slab.h"
 #include "sherpa-onnx/csrc/online-transducer-decoder.h"
+#include "sherpa-onnx/csrc/perf-stats.h"
 
 namespace sherpa_onnx {
 
@@ -61,6 +63,20 @@ class OnlineStream {
    */
   std::vector<float> GetFrames(int32_t frame_index, int32_t n) const;
 
+  /** Same as the above one, but it writes n * FeatureDim() floats to the
+   * given address, e.g., to a slice of the input tensor of a batch.
+   */
+  void GetFrames(int32_t frame_index, int32_t n, float *out) const;
+
+  /** Free feature frames that have been processed, i.e., frames before
+   * GetNumProcessedFrames(). Frame indexes are not changed, so timestamps
+   * are not affected.
+   *
+   * OnlineRecognizer and KeywordSpotter call it after each decoding, so
+   * long-running streams use memory only for frames not yet decoded.
+   */
+  void DiscardProcessed();
+
   void Reset();
 
   int32_t FeatureDim() const;
@@ -88,9 +104,25 @@ class OnlineStream {
   void SetParaformerResult(const OnlineParaformerDecoderResult &r);
   OnlineParaformerDecoderResult &GetParaformerResult();
 
+  // SetStates() detaches this stream from its state slab, if any.
+  // GetStates() takes the states of this stream out of its state slab,
+  // if any.
   void SetStates(std::vector<Ort::Value> states);
   std::vector<Ort::Value> &GetStates();
 
+  /** Keep the encoder states of this stream in a slot of a batched slab.
+   *
+   * See online-state-slab.h. It replaces the states set by SetStates().
+   *
+   * @param slab The batched states.
+   * @param slot Index of this stream in the batch.
+   */
+  void SetStateSlab(std::shared_ptr<OnlineStateSlab> slab, int32_t slot);
+
+  // Return nullptr if the states of this stream are not in a slab
+  const std::shared_ptr<OnlineStateSlab> &GetStateSlab() const;
+  int32_t GetStateSlot() const;
+
   void SetNeMoDecoderStates(std::vector<Ort::Value> decoder_states);
   std::vector<Ort::Value> &GetNeMoDecoderStates();
 
@@ -111,9 +143,15 @@ class OnlineStream {
   std::vector<float> &GetParaformerEncoderOutCache();
   std::vector<float> &GetParaformerAlphaCache();
 
+  // If not null, the time of AcceptWaveform() and InputFinished() is added
+  // to the stage feature_extraction of stats. OnlineRecognizer sets it to
+  // its own stats.
+  void SetPerfStats(std::shared_ptr<PerfStats> stats);
+
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
+  std::shared_ptr<PerfStats> perf_stats_;
 };
 
 }  // namespace sherpa_onnx
@@ -10,6 +10,7 @@
 #include "onnxruntime_cxx_api.h"  // NOLINT
 #include "sherpa-onnx/csrc/hypothesis.h"
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/perf-stats.h"
 
 namespace sherpa_onnx {
 
@@ -104,6 +105,13 @@ class OnlineTransducerDecoder {
 
   // used for endpointing. We need to keep decoder_out after reset
   virtual void UpdateDecoderOut(OnlineTransducerDecoderResult * /*result*/) {}
+
+  // If not null, the time of running the decoder and the joiner, etc.,
+  // is added to stats. It must outlive this object.
+  void SetPerfStats(PerfStats *stats) { perf_stats_ = stats; }
+
+ protected:
+  PerfStats *perf_stats_ = nullptr;
 };
 
 }  // namespace sherpa_onnx
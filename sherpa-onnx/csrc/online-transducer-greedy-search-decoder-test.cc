@@ -0,0 +1,290 @@
+// sherpa-onnx/csrc/online-transducer-greedy-search-decoder-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/online-transducer-greedy-search-decoder.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>  // NOLINT
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/onnx-utils.h"
+
+namespace sherpa_onnx {
+
+// A fake model to test the decoding algorithm without onnx models.
+//
+// encoder_out_dim, decoder_out_dim and vocab_size are equal. The joiner
+// computes W * (encoder_out + decoder_out) + encoder_out + decoder_out,
+// where the matrix-vector product only simulates the cost of a real
+// network and is scaled to be negligible. The decoder discourages
+// repeating the last token.
+class FakeTransducerModel : public OnlineTransducerModel {
+ public:
+  explicit FakeTransducerModel(int32_t vocab_size)
+      : vocab_size_(vocab_size), w_(vocab_size * vocab_size, 1e-6) {}
+
+  std::vector<Ort::Value> StackStates(
+      const std::vector<std::vector<Ort::Value>> & /*states*/) const override {
+    return {};
+  }
+
+  std::vector<std::vector<Ort::Value>> UnStackStates(
+      const std::vector<Ort::Value> & /*states*/) const override {
+    return {};
+  }
+
+  std::vector<Ort::Value> GetEncoderInitStates() override { return {}; }
+
+  std::pair<Ort::Value, std::vector<Ort::Value>> RunEncoder(
+      Ort::Value features, std::vector<Ort::Value> /*states*/,
+      Ort::Value /*processed_frames*/) override {
+    return {std::move(features), std::vector<Ort::Value>{}};
+  }
+
+  Ort::Value RunDecoder(Ort::Value decoder_input) override {
+    auto shape = decoder_input.GetTensorTypeAndShapeInfo().GetShape();
+    const int64_t *p = decoder_input.GetTensorData<int64_t>();
+
+    std::array<int64_t, 2> out_shape{shape[0], vocab_size_};
+    Ort::Value out = Ort::Value::CreateTensor<float>(
+        allocator_, out_shape.data(), out_shape.size());
+    float *q = out.GetTensorMutableData<float>();
+
+    for (int32_t i = 0; i != shape[0]; ++i) {
+      std::fill(q, q + vocab_size_, 0);
+      int64_t y = p[(i + 1) * shape[1] - 1];
+      if (y > 0) {
+        q[y] = -2;
+      }
+      Simulate(q);
+      q += vocab_size_;
+    }
+
+    num_decoder_rows += shape[0];
+    return out;
+  }
+
+  Ort::Value RunJoiner(Ort::Value encoder_out,
+                       Ort::Value decoder_out) override {
+    auto shape = encoder_out.GetTensorTypeAndShapeInfo().GetShape();
+    Ort::Value out = Ort::Value::CreateTensor<float>(allocator_, shape.data(),
+                                                     shape.size());
+
+    const float *a = encoder_out.GetTensorData<float>();
+    const float *b = decoder_out.GetTensorData<float>();
+    float *q = out.GetTensorMutableData<float>();
+    for (int32_t i = 0; i != shape[0] * shape[1]; ++i) {
+      q[i] = a[i] + b[i];
+    }
+
+    for (int32_t i = 0; i != shape[0]; ++i) {
+      Simulate(q + i * vocab_size_);
+    }
+
+    return out;
+  }
+
+  int32_t ContextSize() const override { return 2; }
+
+  int32_t ChunkSize() const override { return 1; }
+
+  int32_t ChunkShift() const override { return 1; }
+
+  int32_t VocabSize() const override { return vocab_size_; }
+
+  OrtAllocator *Allocator() override { return allocator_; }
+
+  int64_t num_decoder_rows = 0;
+
+ private:
+  void Simulate(float *x) const {
+    std::vector<float> y(vocab_size_);
+    for (int32_t r = 0; r != vocab_size_; ++r) {
+      const float *w = w_.data() + r * vocab_size_;
+      float sum = 0;
+      for (int32_t c = 0; c != vocab_size_; ++c) {
+        sum += w[c] * x[c];
+      }
+      y[r] = sum;
+    }
+
+    for (int32_t r = 0; r != vocab_size_; ++r) {
+      x[r] += y[r];
+    }
+  }
+
+ private:
+  Ort::AllocatorWithDefaultOptions allocator_;
+  int32_t vocab_size_;
+  std::vector<float> w_;
+};
+
+// The previous implementation, which runs the decoder on the whole batch
+// whenever any stream emits a token. Used as a reference.
+static void ReferenceDecode(OnlineTransducerModel *model,
+                            Ort::Value encoder_out,
+                            std::vector<OnlineTransducerDecoderResult> *result) {
+  auto shape = encoder_out.GetTensorTypeAndShapeInfo().GetShape();
+  int32_t batch_size = shape[0];
+  int32_t num_frames = shape[1];
+  int32_t vocab_size = model->VocabSize();
+
+  Ort::Value decoder_out = model->RunDecoder(model->BuildDecoderInput(*result));
+  for (int32_t t = 0; t != num_frames; ++t) {
+    Ort::Value cur_encoder_out =
+        GetEncoderOutFrame(model->Allocator(), &encoder_out, t);
+    Ort::Value logit =
+        model->RunJoiner(std::move(cur_encoder_out), View(&decoder_out));
+    const float *p_logit = logit.GetTensorData<float>();
+
+    bool emitted = false;
+    for (int32_t i = 0; i != batch_size; ++i, p_logit += vocab_size) {
+      auto &r = (*result)[i];
+      auto y = static_cast<int32_t>(std::distance(
+          p_logit, std::max_element(p_logit, p_logit + vocab_size)));
+      if (y != 0) {
+        emitted = true;
+        r.tokens.push_back(y);
+        r.timestamps.push_back(t + r.frame_offset);
+      }
+    }
+
+    if (emitted) {
+      decoder_out = model->RunDecoder(model->BuildDecoderInput(*result));
+    }
+  }
+
+  for (auto &r : *result) {
+    r.frame_offset += num_frames;
+  }
+}
+
+// About 10% of the frames emit a non-blank token
+static Ort::Value RandomEncoderOut(OrtAllocator *allocator, int32_t batch_size,
+                                   int32_t num_frames, int32_t vocab_size,
+                                   std::mt19937 *mt) {
+  std::array<int64_t, 3> shape{batch_size, num_frames, vocab_size};
+  Ort::Value ans =
+      Ort::Value::CreateTensor<float>(allocator, shape.data(), shape.size());
+  float *p = ans.GetTensorMutableData<float>();
+
+  std::uniform_real_distribution<float> noise(-0.1, 0.1);
+  std::uniform_real_distribution<float> u(0, 1);
+  std::uniform_int_distribution<int32_t> token(1, vocab_size - 1);
+
+  for (int32_t i = 0; i != batch_size * num_frames; ++i) {
+    for (int32_t k = 0; k != vocab_size; ++k) {
+      p[k] = noise(*mt);
+    }
+
+    if (u(*mt) < 0.1) {
+      p[token(*mt)] = 5;
+    } else {
+      p[0] = 1;
+    }
+    p += vocab_size;
+  }
+
+  return ans;
+}
+
+TEST(OnlineTransducerGreedySearchDecoder, CompareWithReference) {
+  std::mt19937 mt(2025);
+  int32_t vocab_size = 20;
+  int32_t batch_size = 5;
+  int32_t num_frames = 16;
+  int32_t num_chunks = 4;
+
+  FakeTransducerModel model(vocab_size);
+  OnlineTransducerGreedySearchDecoder decoder(&model, -1, 0, 1.0);
+
+  std::vector<OnlineTransducerDecoderResult> results(batch_size);
+  std::vector<OnlineTransducerDecoderResult> expected(batch_size);
+  for (int32_t i = 0; i != batch_size; ++i) {
+    results[i] = decoder.GetEmptyResult();
+    expected[i] = decoder.GetEmptyResult();
+  }
+
+  for (int32_t c = 0; c != num_chunks; ++c) {
+    if (c == 2) {
+      // A new stream joins the batch and has no cached decoder_out
+      results[1] = decoder.GetEmptyResult();
+      expected[1] = decoder.GetEmptyResult();
+    }
+
+    Ort::Value encoder_out = RandomEncoderOut(
+        model.Allocator(), batch_size, num_frames, vocab_size, &mt);
+    Ort::Value encoder_out_copy = Clone(model.Allocator(), &encoder_out);
+
+    decoder.Decode(std::move(encoder_out), &results);
+    ReferenceDecode(&model, std::move(encoder_out_copy), &expected);
+
+    for (int32_t i = 0; i != batch_size; ++i) {
+      EXPECT_EQ(results[i].tokens, expected[i].tokens);
+      EXPECT_EQ(results[i].timestamps, expected[i].timestamps);
+      EXPECT_EQ(results[i].ys_probs.size(), results[i].timestamps.size());
+    }
+  }
+}
+
+TEST(OnlineTransducerGreedySearchDecoder, Benchmark) {
+  std::mt19937 mt(2025);
+  int32_t vocab_size = 128;
+  int32_t num_frames = 16;
+  int32_t num_chunks = 10;
+
+  for (int32_t batch_size : {1, 16, 64}) {
+    FakeTransducerModel model(vocab_size);
+    OnlineTransducerGreedySearchDecoder decoder(&model, -1, 0, 1.0);
+
+    std::vector<Ort::Value> encoder_outs;
+    for (int32_t c = 0; c != num_chunks; ++c) {
+      encoder_outs.push_back(RandomEncoderOut(model.Allocator(), batch_size,
+                                              num_frames, vocab_size, &mt));
+    }
+
+    std::vector<OnlineTransducerDecoderResult> results(batch_size);
+    for (auto &r : results) {
+      r = decoder.GetEmptyResult();
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (auto &e : encoder_outs) {
+      ReferenceDecode(&model, Clone(model.Allocator(), &e), &results);
+    }
+    auto stop = std::chrono::high_resolution_clock::now();
+    auto full_us =
+        std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
+    int64_t full_rows = model.num_decoder_rows;
+
+    for (auto &r : results) {
+      r = decoder.GetEmptyResult();
+    }
+    model.num_decoder_rows = 0;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (auto &e : encoder_outs) {
+      decoder.Decode(Clone(model.Allocator(), &e), &results);
+    }
+    stop = std::chrono::high_resolution_clock::now();
+    auto sparse_us =
+        std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
+    int64_t sparse_rows = model.num_decoder_rows;
+
+    SHERPA_ONNX_LOGE(
+        "%d streams, %d frames: whole batch decoder %d us (%d rows), "
+        "emitted rows only %d us (%d rows)",
+        batch_size, num_chunks * num_frames,
+        static_cast<int32_t>(full_us.count()), static_cast<int32_t>(full_rows),
+        static_cast<int32_t>(sparse_us.count()),
+        static_cast<int32_t>(sparse_rows));
+  }
+}
+
+}  // namespace sherpa_onnx
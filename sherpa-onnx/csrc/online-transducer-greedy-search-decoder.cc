@@ -5,10 +5,12 @@
 #include "sherpa-onnx/csrc/online-transducer-greedy-search-decoder.h"
 
 #include <algorithm>
+#include <array>
 #include <utility>
 #include <vector>
 
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/math.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
 
 namespace sherpa_onnx {
@@ -50,6 +52,30 @@ static void UpdateCachedDecoderOut(
   }
 }
 
+// Run the decoder only on the given rows of results and write its output
+// to the corresponding rows of decoder_out.
+static void RunDecoderForRows(
+    OnlineTransducerModel *model,
+    const std::vector<OnlineTransducerDecoderResult> &results,
+    const std::vector<int32_t> &rows, Ort::Value *decoder_out,
+    PerfStats *stats) {
+  Ort::Value decoder_input = model->BuildDecoderInput(results, rows);
+  Ort::Value rows_decoder_out{nullptr};
+  {
+    ScopedPerfTimer timer(stats, PerfStage::kDecoder);
+    rows_decoder_out = model->RunDecoder(std::move(decoder_input));
+  }
+
+  std::vector<int64_t> shape =
+      decoder_out->GetTensorTypeAndShapeInfo().GetShape();
+  const float *src = rows_decoder_out.GetTensorData<float>();
+  float *dst = decoder_out->GetTensorMutableData<float>();
+  for (auto i : rows) {
+    std::copy(src, src + shape[1], dst + i * shape[1]);
+    src += shape[1];
+  }
+}
+
 OnlineTransducerDecoderResult
 OnlineTransducerGreedySearchDecoder::GetEmptyResult() const {
   int32_t context_size = model_->ContextSize();
@@ -89,38 +115,63 @@ void OnlineTransducerGreedySearchDecoder::Decode(
   int32_t num_frames = static_cast<int32_t>(encoder_out_shape[1]);
   int32_t vocab_size = model_->VocabSize();
 
-  Ort::Value decoder_out{nullptr};
-  bool is_batch_decoder_out_cached = true;
-  for (const auto &r : *result) {
-    if (!r.decoder_out) {
-      is_batch_decoder_out_cached = false;
-      break;
+  // Rows of the batch whose decoder_out is not cached, e.g., streams
+  // that are decoded for the first time
+  std::vector<int32_t> rows;
+  rows.reserve(batch_size);
+  const OnlineTransducerDecoderResult *cached = nullptr;
+  for (int32_t i = 0; i != batch_size; ++i) {
+    const auto &r = (*result)[i];
+    if (r.decoder_out) {
+      cached = &r;
+    } else {
+      rows.push_back(i);
     }
   }
 
-  if (is_batch_decoder_out_cached) {
-    auto &r = result->front();
+  Ort::Value decoder_out{nullptr};
+  if (cached) {
     std::vector<int64_t> decoder_out_shape =
-        r.decoder_out.GetTensorTypeAndShapeInfo().GetShape();
+        cached->decoder_out.GetTensorTypeAndShapeInfo().GetShape();
     decoder_out_shape[0] = batch_size;
     decoder_out = Ort::Value::CreateTensor<float>(model_->Allocator(),
                                                   decoder_out_shape.data(),
                                                   decoder_out_shape.size());
     UseCachedDecoderOut(*result, &decoder_out);
+
+    if (!rows.empty()) {
+      RunDecoderForRows(model_, *result, rows, &decoder_out, perf_stats_);
+    }
   } else {
     Ort::Value decoder_input = model_->BuildDecoderInput(*result);
+    ScopedPerfTimer timer(perf_stats_, PerfStage::kDecoder);
     decoder_out = model_->RunDecoder(std::move(decoder_input));
   }
 
+  // It is reused for all frames
+  std::array<int64_t, 2> cur_encoder_out_shape{batch_size,
+                                               encoder_out_shape[2]};
+  Ort::Value cur_encoder_out = Ort::Value::CreateTensor<float>(
+      model_->Allocator(), cur_encoder_out_shape.data(),
+      cur_encoder_out_shape.size());
+
+  // Rows of the batch that have emitted a token in the current frame
+  std::vector<int32_t> emitted_rows;
+  emitted_rows.reserve(batch_size);
+
+  float inv_temperature = 1.0f / temperature_scale_;
+
   for (int32_t t = 0; t != num_frames; ++t) {
-    Ort::Value cur_encoder_out =
-        GetEncoderOutFrame(model_->Allocator(), &encoder_out, t);
-    Ort::Value logit =
-        model_->RunJoiner(std::move(cur_encoder_out), View(&decoder_out));
+    GetEncoderOutFrame(&encoder_out, t, &cur_encoder_out);
+    Ort::Value logit{nullptr};
+    {
+      ScopedPerfTimer timer(perf_stats_, PerfStage::kJoiner);
+      logit = model_->RunJoiner(View(&cur_encoder_out), View(&decoder_out));
+    }
 
     float *p_logit = logit.GetTensorMutableData<float>();
 
-    bool emitted = false;
+    emitted_rows.clear();
     for (int32_t i = 0; i < batch_size; ++i, p_logit += vocab_size) {
       auto &r = (*result)[i];
       if (blank_penalty_ > 0.0) {
@@ -134,33 +185,36 @@ void OnlineTransducerGreedySearchDecoder::Decode(
       // blank id is hardcoded to 0
       // also, it treats unk as blank
       if (y != 0 && y != unk_id_) {
-        emitted = true;
+        emitted_rows.push_back(i);
         r.tokens.push_back(y);
         r.timestamps.push_back(t + r.frame_offset);
         r.num_trailing_blanks = 0;
+
+        // export the per-token log scores after temperature scaling.
+        // It is computed only for emitted symbols to save time.
+        float y_prob = p_logit[y] * inv_temperature -
+                       LogSumExp(p_logit, vocab_size, inv_temperature);
+        r.ys_probs.push_back(y_prob);
       } else {
         ++r.num_trailing_blanks;
       }
+    }
 
-      // export the per-token log scores
-      if (y != 0 && y != unk_id_) {
-        // apply temperature-scaling
-        for (int32_t n = 0; n < vocab_size; ++n) {
-          p_logit[n] /= temperature_scale_;
-        }
-        LogSoftmax(p_logit, vocab_size);   // renormalize probabilities,
-                                           // save time by doing it only for
-                                           // emitted symbols
-        const float *p_logprob = p_logit;  // rename p_logit as p_logprob,
-                                           // now it contains normalized
-                                           // probability
-        r.ys_probs.push_back(p_logprob[y]);
-      }
+    if (emitted_rows.empty()) {
+      continue;
     }
-    if (emitted) {
+
+    if (static_cast<int32_t>(emitted_rows.size()) == batch_size) {
       Ort::Value decoder_input = model_->BuildDecoderInput(*result);
+      ScopedPerfTimer timer(perf_stats_, PerfStage::kDecoder);
       decoder_out = model_->RunDecoder(std::move(decoder_input));
+      continue;
     }
+
+    // Emission is sparse in practice, so we run the decoder only on the
+    // rows that have emitted a token
+    RunDecoderForRows(model_, *result, emitted_rows, &decoder_out,
+                      perf_stats_);
   }
 
   UpdateCachedDecoderOut(model_->Allocator(), &decoder_out, result);
@@ -26,6 +26,8 @@
 #include "sherpa-onnx/csrc/online-zipformer-transducer-model.h"
 #include "sherpa-onnx/csrc/online-zipformer2-transducer-model.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
+#include "sherpa-onnx/csrc/ort-env.h"
+#include "sherpa-onnx/csrc/session.h"
 
 namespace {
 
@@ -42,15 +44,14 @@ enum class ModelType : std::uint8_t {
 
 namespace sherpa_onnx {
 
-static ModelType GetModelType(char *model_data, size_t model_data_length,
+static ModelType GetModelType(const char *model_data, size_t model_data_length,
                               bool debug) {
-  Ort::Env env(ORT_LOGGING_LEVEL_ERROR);
+  Ort::Env &env = GetOrtEnv();
   Ort::SessionOptions sess_opts;
   sess_opts.SetIntraOpNumThreads(1);
   sess_opts.SetInterOpNumThreads(1);
 
-  auto sess = std::make_unique<Ort::Session>(env, model_data, model_data_length,
-                                             sess_opts);
+  auto sess = CreateSession(env, model_data, model_data_length, sess_opts);
 
   Ort::ModelMetadata meta_data = sess->GetModelMetadata();
   if (debug) {
@@ -113,7 +114,7 @@ std::unique_ptr<OnlineTransducerModel> OnlineTransducerModel::Create(
   ModelType model_type = ModelType::kUnknown;
 
   {
-    auto buffer = ReadFile(config.transducer.encoder);
+    auto buffer = MapFile(config.transducer.encoder);
 
     model_type = GetModelType(buffer.data(), buffer.size(), config.debug);
   }
@@ -156,6 +157,26 @@ Ort::Value OnlineTransducerModel::BuildDecoderInput(
   return decoder_input;
 }
 
+Ort::Value OnlineTransducerModel::BuildDecoderInput(
+    const std::vector<OnlineTransducerDecoderResult> &results,
+    const std::vector<int32_t> &rows) {
+  int32_t batch_size = static_cast<int32_t>(rows.size());
+  int32_t context_size = ContextSize();
+  std::array<int64_t, 2> shape{batch_size, context_size};
+  Ort::Value decoder_input = Ort::Value::CreateTensor<int64_t>(
+      Allocator(), shape.data(), shape.size());
+  int64_t *p = decoder_input.GetTensorMutableData<int64_t>();
+
+  for (auto i : rows) {
+    const auto &r = results[i];
+    const int64_t *begin = r.tokens.data() + r.tokens.size() - context_size;
+    const int64_t *end = r.tokens.data() + r.tokens.size();
+    std::copy(begin, end, p);
+    p += context_size;
+  }
+  return decoder_input;
+}
+
 Ort::Value OnlineTransducerModel::BuildDecoderInput(
     const std::vector<Hypothesis> &hyps) {
   int32_t batch_size = static_cast<int32_t>(hyps.size());
@@ -166,7 +187,7 @@ Ort::Value OnlineTransducerModel::BuildDecoderInput(
   int64_t *p = decoder_input.GetTensorMutableData<int64_t>();
 
   for (const auto &h : hyps) {
-    std::copy(h.ys.end() - context_size, h.ys.end(), p);
+    h.GetTokens(h.NumTokens() - context_size, h.NumTokens(), p);
     p += context_size;
   }
   return decoder_input;
@@ -80,6 +80,17 @@ class OnlineTransducerModel {
       Ort::Value features, std::vector<Ort::Value> states,
       Ort::Value processed_frames) = 0;  // NOLINT
 
+  /** Give back tensors that are no longer used, e.g., the states passed to
+   * RunEncoder() and the encoder_out returned by it, so that a later
+   * RunEncoder() can write its outputs into them instead of allocating
+   * new ones.
+   *
+   * The caller must own the tensors, i.e., they must not be views of
+   * other tensors. The default implementation frees them.
+   */
+  virtual void RecycleEncoderTensors(
+      std::vector<Ort::Value> /*tensors*/) {}  // NOLINT
+
   /** Run the decoder network.
    *
    * Caution: We assume there are no recurrent connections in the decoder and
@@ -137,6 +148,16 @@ class OnlineTransducerModel {
   Ort::Value BuildDecoderInput(
       const std::vector<OnlineTransducerDecoderResult> &results);
 
+  /** Build the decoder input only for the given rows of results.
+   *
+   * @param results The decoding results of a batch.
+   * @param rows Indexes into results.
+   * @return Return a tensor of shape (rows.size(), context_size).
+   */
+  Ort::Value BuildDecoderInput(
+      const std::vector<OnlineTransducerDecoderResult> &results,
+      const std::vector<int32_t> &rows);
+
   Ort::Value BuildDecoderInput(const std::vector<Hypothesis> &hyps);
 };
 
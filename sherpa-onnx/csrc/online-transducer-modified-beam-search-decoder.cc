@@ -37,6 +37,25 @@ static void UseCachedDecoderOut(
   }
 }
 
+// Return log(sum(exp(logit / temperature))) for one row of the joiner output,
+// up to a constant.
+//
+// row contains log_softmax(logit) plus a constant, where blank_penalty has
+// been subtracted from logit[0] (the blank). Since log_softmax is invariant
+// to adding a constant to its input, row[k] * scale - the returned value is
+// log_softmax(logit / temperature)[k] for k != 0, where scale is
+// 1 / temperature.
+static float LogSumExpWithTemperature(const float *row, int32_t vocab_size,
+                                      float scale, float blank_penalty) {
+  float blank = row[0];
+  if (blank_penalty > 0.0) {
+    blank += blank_penalty;
+  }
+
+  return LogAdd<float>()(blank * scale,
+                         LogSumExp(row + 1, vocab_size - 1, scale));
+}
+
 OnlineTransducerDecoderResult
 OnlineTransducerModifiedBeamSearchDecoder::GetEmptyResult() const {
   int32_t context_size = model_->ContextSize();
@@ -56,14 +75,15 @@ void OnlineTransducerModifiedBeamSearchDecoder::StripLeadingBlanks(
   int32_t context_size = model_->ContextSize();
   auto hyp = r->hyps.GetMostProbable(true);
 
-  std::vector<int64_t> tokens(hyp.ys.begin() + context_size, hyp.ys.end());
+  std::vector<int64_t> tokens(hyp.NumTokens() - context_size);
+  hyp.GetTokens(context_size, hyp.NumTokens(), tokens.data());
   r->tokens = std::move(tokens);
-  r->timestamps = std::move(hyp.timestamps);
+  r->timestamps = hyp.Timestamps();
 
   // export per-token scores
-  r->ys_probs = std::move(hyp.ys_probs);
-  r->lm_probs = std::move(hyp.lm_probs);
-  r->context_scores = std::move(hyp.context_scores);
+  r->ys_probs = hyp.YsProbs();
+  r->lm_probs = hyp.LmProbs();
+  r->context_scores = hyp.ContextScores();
 
   r->num_trailing_blanks = hyp.num_trailing_blanks;
 }
@@ -100,6 +120,16 @@ void OnlineTransducerModifiedBeamSearchDecoder::Decode(
   }
   std::vector<Hypothesis> prev;
 
+  // Temperature scaling is used only for the confidences in ys_probs,
+  // the decoding algorithm uses the original logits.
+  //
+  // Confidences are needed only for non-blank tokens that survive top_k,
+  // so we compute them lazily. row_lse[i] caches the output of
+  // LogSumExpWithTemperature() for the i-th row of the joiner output.
+  float inv_temperature = 1.0f / temperature_scale_;
+  std::vector<float> row_lse;
+  std::vector<bool> has_row_lse;
+
   for (int32_t t = 0; t != num_frames; ++t) {
     // Due to merging paths with identical token sequences,
     // not all utterances have "num_active_paths" paths.
@@ -116,7 +146,11 @@ void OnlineTransducerModifiedBeamSearchDecoder::Decode(
     cur.reserve(batch_size);
 
     Ort::Value decoder_input = model_->BuildDecoderInput(prev);
-    Ort::Value decoder_out = model_->RunDecoder(std::move(decoder_input));
+    Ort::Value decoder_out{nullptr};
+    {
+      ScopedPerfTimer timer(perf_stats_, PerfStage::kDecoder);
+      decoder_out = model_->RunDecoder(std::move(decoder_input));
+    }
     if (t == 0) {
       UseCachedDecoderOut(hyps_row_splits, *result, &decoder_out);
     }
@@ -125,47 +159,37 @@ void OnlineTransducerModifiedBeamSearchDecoder::Decode(
         GetEncoderOutFrame(model_->Allocator(), &encoder_out, t);
     cur_encoder_out =
         Repeat(model_->Allocator(), &cur_encoder_out, hyps_row_splits);
-    Ort::Value logit =
-        model_->RunJoiner(std::move(cur_encoder_out), View(&decoder_out));
+    Ort::Value logit{nullptr};
+    {
+      ScopedPerfTimer timer(perf_stats_, PerfStage::kJoiner);
+      logit =
+          model_->RunJoiner(std::move(cur_encoder_out), View(&decoder_out));
+    }
 
     float *p_logit = logit.GetTensorMutableData<float>();
 
-    // copy raw logits, apply temperature-scaling  (for confidences)
-    // Note: temperature scaling is used only for the confidences,
-    //       the decoding algorithm uses the original logits
-    int32_t p_logit_items = vocab_size * num_hyps;
-    std::vector<float> logit_with_temperature(p_logit_items);
-    {
-      std::copy(p_logit, p_logit + p_logit_items,
-                logit_with_temperature.begin());
-      for (float &elem : logit_with_temperature) {
-        elem /= temperature_scale_;
-      }
-      LogSoftmax(logit_with_temperature.data(), vocab_size, num_hyps);
-    }
+    row_lse.resize(num_hyps);
+    has_row_lse.assign(num_hyps, false);
 
     if (blank_penalty_ > 0.0) {
       // assuming blank id is 0
       SubtractBlank(p_logit, vocab_size, num_hyps, 0, blank_penalty_);
     }
-    LogSoftmax(p_logit, vocab_size, num_hyps);
 
-    // now p_logit contains log_softmax output, we rename it to p_logprob
-    // to match what it actually contains
-    float *p_logprob = p_logit;
-
-    // add log_prob of each hypothesis to p_logprob before taking top_k
+    // compute log_softmax and add log_prob of each hypothesis to it
+    // before taking top_k
     for (int32_t i = 0; i != num_hyps; ++i) {
       float log_prob = prev[i].log_prob;
       if (lm_ && shallow_fusion_) {
          log_prob += prev[i].lm_log_prob;
       }
 
-      for (int32_t k = 0; k != vocab_size; ++k, ++p_logprob) {
-        *p_logprob += log_prob;
-      }
+      LogSoftmaxPlusBias(p_logit + i * vocab_size, vocab_size, log_prob);
     }
-    p_logprob = p_logit;  // we changed p_logprob in the above for loop
+
+    // now p_logit contains log_softmax output plus the log_prob of each
+    // hypothesis, we rename it to p_logprob to match what it actually contains
+    float *p_logprob = p_logit;
 
     for (int32_t b = 0; b != batch_size; ++b) {
       int32_t frame_offset = (*result)[b].frame_offset;
@@ -179,23 +203,28 @@ void OnlineTransducerModifiedBeamSearchDecoder::Decode(
         int32_t hyp_index = k / vocab_size + start;
         int32_t new_token = k % vocab_size;
 
+        // It shares the token history with prev[hyp_index]
         Hypothesis new_hyp = prev[hyp_index];
         const float prev_lm_log_prob = new_hyp.lm_log_prob;
         float context_score = 0;
         auto context_state = new_hyp.context_state;
+        HypothesisNode *new_node = nullptr;
 
         // blank is hardcoded to 0
         // also, it treats unk as blank
         if (new_token != 0 && new_token != unk_id_) {
-          new_hyp.ys.push_back(new_token);
-          new_hyp.timestamps.push_back(t + frame_offset);
+          new_node = new_hyp.AddToken(new_token, t + frame_offset);
           new_hyp.num_trailing_blanks = 0;
+          // Not timed since it takes about as long as reading the clock.
+          // Its time is part of search.
           if (ss != nullptr && ss[b]->GetContextGraph() != nullptr) {
             auto context_res = ss[b]->GetContextGraph()->ForwardOneStep(
                 context_state, new_token, false /*strict mode*/);
             context_score = std::get<0>(context_res);
             new_hyp.context_state = std::get<1>(context_res);
           }
+          // It runs for each new token, so its time is part of search
+          // instead of lm, which is only for rescoring
           if (lm_ && shallow_fusion_) {
             lm_->ComputeLMScoreSF(lm_scale_, &new_hyp);
           }
@@ -213,9 +242,16 @@ void OnlineTransducerModifiedBeamSearchDecoder::Decode(
         }
 
         // export the per-token log scores
-        if (new_token != 0 && new_token != unk_id_) {
-          float y_prob = logit_with_temperature[start * vocab_size + k];
-          new_hyp.ys_probs.push_back(y_prob);
+        if (new_node != nullptr) {
+          const float *row = p_logit + hyp_index * vocab_size;
+          if (!has_row_lse[hyp_index]) {
+            row_lse[hyp_index] = LogSumExpWithTemperature(
+                row, vocab_size, inv_temperature, blank_penalty_);
+            has_row_lse[hyp_index] = true;
+          }
+
+          float y_prob = row[new_token] * inv_temperature - row_lse[hyp_index];
+          new_node->SetYsProb(y_prob);
 
           if (lm_ && shallow_fusion_) {  // export only if
                                          // LM shallow fusion is used
@@ -224,12 +260,12 @@ void OnlineTransducerModifiedBeamSearchDecoder::Decode(
             if (lm_scale_ != 0.0) {
               lm_prob /= lm_scale_;  // remove lm-scale
             }
-            new_hyp.lm_probs.push_back(lm_prob);
+            new_node->SetLmProb(lm_prob);
           }
 
           // export only when `ContextGraph` is used
           if (ss != nullptr && ss[b]->GetContextGraph() != nullptr) {
-            new_hyp.context_scores.push_back(context_score);
+            new_node->SetContextScore(context_score);
           }
         }
 
@@ -242,6 +278,7 @@ void OnlineTransducerModifiedBeamSearchDecoder::Decode(
 
   // classic lm rescore
   if (lm_ && !shallow_fusion_) {
+    ScopedPerfTimer timer(perf_stats_, PerfStage::kLm);
     lm_->ComputeLMScore(lm_scale_, model_->ContextSize(), &cur);
   }
 
@@ -251,7 +288,7 @@ void OnlineTransducerModifiedBeamSearchDecoder::Decode(
     auto &r = (*result)[b];
 
     r.hyps = std::move(hyps);
-    r.tokens = std::move(best_hyp.ys);
+    r.tokens = best_hyp.Ys();
     r.num_trailing_blanks = best_hyp.num_trailing_blanks;
     r.frame_offset += num_frames;
   }
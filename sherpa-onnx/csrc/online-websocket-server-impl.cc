@@ -4,8 +4,11 @@
 
 #include "sherpa-onnx/csrc/online-websocket-server-impl.h"
 
+#include <cstdint>
+#include <utility>
 #include <vector>
 
+#include "sherpa-onnx/csrc/cpu-affinity.h"
 #include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/log.h"
 
@@ -15,20 +18,42 @@ void OnlineWebsocketDecoderConfig::Register(ParseOptions *po) {
   recognizer_config.Register(po);
 
   po->Register("loop-interval-ms", &loop_interval_ms,
-               "It determines how often the decoder loop runs. ");
+               "Deprecated and unused. Please use --target-latency-ms.");
 
   po->Register("max-batch-size", &max_batch_size,
                "Max batch size for recognition.");
 
+  po->Register("num-decode-threads", &num_decode_threads,
+               "Number of threads that run the neural network. The work "
+               "threads only compute features.");
+
+  po->Register("target-latency-ms", &target_latency_ms,
+               "A connection with enough frames waits at most this number "
+               "of milliseconds for other connections to join its batch. "
+               "Use 0 to decode it as soon as a decode thread is free.");
+
+  po->Register("decode-thread-cpus", &decode_thread_cpus,
+               "If not empty, pin the decode threads to these CPUs, "
+               "e.g., 4-7. Thread i is pinned to the i-th CPU, wrapping "
+               "around if there are more threads than CPUs.");
+
   po->Register("end-tail-padding", &end_tail_padding,
                "It determines the length of tail_padding at the end of audio.");
 }
 
 void OnlineWebsocketDecoderConfig::Validate() const {
   recognizer_config.Validate();
-  SHERPA_ONNX_CHECK_GT(loop_interval_ms, 0);
   SHERPA_ONNX_CHECK_GT(max_batch_size, 0);
+  SHERPA_ONNX_CHECK_GT(num_decode_threads, 0);
+  SHERPA_ONNX_CHECK_GE(target_latency_ms, 0);
   SHERPA_ONNX_CHECK_GT(end_tail_padding, 0);
+
+  std::vector<int32_t> cpus;
+  if (!ParseCpuList(decode_thread_cpus, &cpus)) {
+    SHERPA_ONNX_LOGE("Invalid --decode-thread-cpus: '%s'",
+                     decode_thread_cpus.c_str());
+    exit(-1);
+  }
 }
 
 void OnlineWebsocketServerConfig::Register(sherpa_onnx::ParseOptions *po) {
@@ -46,177 +71,135 @@ void OnlineWebsocketServerConfig::Validate() const {
 OnlineWebsocketDecoder::OnlineWebsocketDecoder(OnlineWebsocketServer *server)
     : server_(server),
       config_(server->GetConfig().decoder_config),
-      timer_(server->GetWorkContext()) {
-  recognizer_ = std::make_unique<OnlineRecognizer>(config_.recognizer_config);
+      recognizer_(
+          std::make_unique<OnlineRecognizer>(config_.recognizer_config)),
+      scheduler_({config_.num_decode_threads, config_.max_batch_size,
+                  config_.target_latency_ms, config_.decode_thread_cpus}) {}
+
+OnlineWebsocketDecoder::Shard *OnlineWebsocketDecoder::GetShard(
+    connection_hdl hdl) {
+  // The address of the connection is a stable key while the connection is
+  // alive. If it has been destroyed, OnClose() has already removed it
+  auto p = reinterpret_cast<uintptr_t>(hdl.lock().get());
+  if (!p) {
+    return nullptr;
+  }
+
+  // Discard low bits, which are always 0 due to alignment
+  return &shards_[(p >> 6) % kNumShards];
 }
 
 std::shared_ptr<Connection> OnlineWebsocketDecoder::GetOrCreateConnection(
     connection_hdl hdl) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  auto it = connections_.find(hdl);
-  if (it != connections_.end()) {
+  Shard *shard = GetShard(hdl);
+  if (!shard) {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(shard->mutex);
+  auto it = shard->connections.find(hdl);
+  if (it != shard->connections.end()) {
     return it->second;
   } else {
     // create a new connection
     std::shared_ptr<OnlineStream> s = recognizer_->CreateStream();
     auto c = std::make_shared<Connection>(hdl, s);
-    connections_.insert({hdl, c});
+    shard->connections.insert({hdl, c});
+
+    scheduler_.AddStream(recognizer_.get(), s,
+                         [this, hdl](const OnlineRecognizerResult &r,
+                                     bool is_last) {
+                           OnResult(hdl, r, is_last);
+                         });
     return c;
   }
 }
 
-void OnlineWebsocketDecoder::AcceptWaveform(std::shared_ptr<Connection> c) {
-  std::lock_guard<std::mutex> lock(c->mutex);
-  float sample_rate = config_.recognizer_config.feat_config.sampling_rate;
-  while (!c->samples.empty()) {
-    const auto &s = c->samples.front();
-    c->s->AcceptWaveform(sample_rate, s.data(), s.size());
-    c->samples.pop_front();
+void OnlineWebsocketDecoder::RemoveConnection(connection_hdl hdl) {
+  Shard *shard = GetShard(hdl);
+  if (!shard) {
+    return;
+  }
+
+  std::shared_ptr<Connection> c;
+  {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    auto it = shard->connections.find(hdl);
+    if (it == shard->connections.end()) {
+      return;
+    }
+
+    c = std::move(it->second);
+    shard->connections.erase(it);
   }
+
+  c->closed = true;
+  scheduler_.RemoveStream(c->s.get());
 }
 
-void OnlineWebsocketDecoder::InputFinished(std::shared_ptr<Connection> c) {
+void OnlineWebsocketDecoder::AcceptWaveform(std::shared_ptr<Connection> c) {
   std::lock_guard<std::mutex> lock(c->mutex);
+  if (c->closed || c->eof) {
+    c->samples.clear();
+    return;
+  }
 
   float sample_rate = config_.recognizer_config.feat_config.sampling_rate;
-
   while (!c->samples.empty()) {
     const auto &s = c->samples.front();
-    c->s->AcceptWaveform(sample_rate, s.data(), s.size());
+    scheduler_.AcceptWaveform(c->s.get(), sample_rate, s.data(), s.size());
     c->samples.pop_front();
   }
-
-  std::vector<float> tail_padding(
-      static_cast<int64_t>(config_.end_tail_padding * sample_rate));
-
-  c->s->AcceptWaveform(sample_rate, tail_padding.data(), tail_padding.size());
-
-  c->s->InputFinished();
-  c->eof = true;
-}
-
-void OnlineWebsocketDecoder::Warmup() const {
-  recognizer_->WarmpUpRecognizer(config_.recognizer_config.model_config.warm_up,
-                                 config_.max_batch_size);
 }
 
-void OnlineWebsocketDecoder::Run() {
-  timer_.expires_after(std::chrono::milliseconds(config_.loop_interval_ms));
-
-  timer_.async_wait(
-      [this](const asio::error_code &ec) { ProcessConnections(ec); });
-}
-
-void OnlineWebsocketDecoder::ProcessConnections(const asio::error_code &ec) {
-  if (ec) {
-    SHERPA_ONNX_LOG(FATAL) << "The decoder loop is aborted!";
-  }
-
-  std::lock_guard<std::mutex> lock(mutex_);
-  std::vector<connection_hdl> to_remove;
-  for (auto &p : connections_) {
-    auto hdl = p.first;
-    auto c = p.second;
-
-    // The order of `if` below matters!
-    if (!server_->Contains(hdl)) {
-      // If the connection is disconnected, we stop processing it
-      to_remove.push_back(hdl);
-      continue;
-    }
-
-    if (active_.count(hdl)) {
-      // Another thread is decoding this stream, so skip it
-      continue;
-    }
-
-    if (!recognizer_->IsReady(c->s.get()) && !c->eof) {
-      // this stream has not enough frames to decode, so skip it
-      continue;
+void OnlineWebsocketDecoder::InputFinished(std::shared_ptr<Connection> c) {
+  {
+    std::lock_guard<std::mutex> lock(c->mutex);
+    if (c->closed || c->eof) {
+      return;
     }
 
-    if (!recognizer_->IsReady(c->s.get()) && c->eof) {
-      // We won't receive samples from the client, so send a Done! to client
-
-      asio::post(server_->GetWorkContext(),
-                 [this, hdl = c->hdl]() { server_->Send(hdl, "Done!"); });
+    float sample_rate = config_.recognizer_config.feat_config.sampling_rate;
 
-      to_remove.push_back(hdl);
-      continue;
+    while (!c->samples.empty()) {
+      const auto &s = c->samples.front();
+      scheduler_.AcceptWaveform(c->s.get(), sample_rate, s.data(), s.size());
+      c->samples.pop_front();
     }
 
-    // TODO(fangun): If the connection is timed out, we need to also
-    // add it to `to_remove`
+    std::vector<float> tail_padding(
+        static_cast<int64_t>(config_.end_tail_padding * sample_rate));
 
-    // this stream has enough frames and is currently not processed by any
-    // threads, so put it into the ready queue
-    ready_connections_.push_back(c);
-
-    // In `Decode()`, it will remove hdl from `active_`
-    active_.insert(c->hdl);
-  }
+    scheduler_.AcceptWaveform(c->s.get(), sample_rate, tail_padding.data(),
+                              tail_padding.size());
 
-  for (auto hdl : to_remove) {
-    connections_.erase(hdl);
+    c->eof = true;
   }
 
-  if (!ready_connections_.empty()) {
-    asio::post(server_->GetWorkContext(), [this]() { Decode(); });
-  }
-
-  // Schedule another call
-  timer_.expires_after(std::chrono::milliseconds(config_.loop_interval_ms));
-
-  timer_.async_wait(
-      [this](const asio::error_code &ec) { ProcessConnections(ec); });
+  // It may invoke OnResult() in this thread, so c->mutex must not be held
+  scheduler_.InputFinished(c->s.get());
 }
 
-void OnlineWebsocketDecoder::Decode() {
-  std::unique_lock<std::mutex> lock(mutex_);
-  if (ready_connections_.empty()) {
-    // There are no connections that are ready for decoding,
-    // so we return directly
-    return;
-  }
-
-  std::vector<std::shared_ptr<Connection>> c_vec;
-  std::vector<OnlineStream *> s_vec;
-  while (!ready_connections_.empty() &&
-         static_cast<int32_t>(s_vec.size()) < config_.max_batch_size) {
-    auto c = ready_connections_.front();
-    ready_connections_.pop_front();
-
-    c_vec.push_back(c);
-    s_vec.push_back(c->s.get());
-  }
-
-  if (!ready_connections_.empty()) {
-    // there are too many ready connections but this thread can only handle
-    // max_batch_size connections at a time, so we schedule another call
-    // to Decode() and let other threads to process the ready connections
-    asio::post(server_->GetWorkContext(), [this]() { Decode(); });
-  }
-
-  lock.unlock();
-  recognizer_->DecodeStreams(s_vec.data(), s_vec.size());
-  lock.lock();
-
-  for (auto c : c_vec) {
-    auto result = recognizer_->GetResult(c->s.get());
-    if (recognizer_->IsEndpoint(c->s.get())) {
-      result.is_final = true;
-      recognizer_->Reset(c->s.get());
-    }
-
-    if (!recognizer_->IsReady(c->s.get()) && c->eof) {
-      result.is_final = true;
-    }
+void OnlineWebsocketDecoder::Warmup() const {
+  recognizer_->WarmpUpRecognizer(config_.recognizer_config.model_config.warm_up,
+                                 config_.max_batch_size);
+}
 
-    asio::post(server_->GetConnectionContext(),
-               [this, hdl = c->hdl, str = result.AsJsonString()]() {
-                 server_->Send(hdl, str);
-               });
-    active_.erase(c->hdl);
+void OnlineWebsocketDecoder::OnResult(connection_hdl hdl,
+                                      const OnlineRecognizerResult &r,
+                                      bool is_last) {
+  asio::post(server_->GetConnectionContext(),
+             [this, hdl, str = r.AsJsonString(), is_last]() {
+               server_->Send(hdl, str);
+               if (is_last) {
+                 // We won't receive samples from the client, so send a
+                 // Done! to the client.
+                 server_->Send(hdl, "Done!");
+               }
+             });
+
+  if (is_last) {
+    RemoveConnection(hdl);
   }
 }
 
@@ -265,7 +248,6 @@ void OnlineWebsocketServer::Run(uint16_t port) {
     SHERPA_ONNX_LOGE("Invalid Warm up Value!. Expected 0 < warm_up < 100");
     exit(0);
   }
-  decoder_.Run();
 }
 
 void OnlineWebsocketServer::SetupLog() {
@@ -302,6 +284,8 @@ void OnlineWebsocketServer::OnOpen(connection_hdl hdl) {
 }
 
 void OnlineWebsocketServer::OnClose(connection_hdl hdl) {
+  decoder_.RemoveConnection(hdl);
+
   std::lock_guard<std::mutex> lock(mutex_);
   connections_.erase(hdl);
 
@@ -317,6 +301,10 @@ bool OnlineWebsocketServer::Contains(connection_hdl hdl) const {
 void OnlineWebsocketServer::OnMessage(connection_hdl hdl,
                                       server::message_ptr msg) {
   auto c = decoder_.GetOrCreateConnection(hdl);
+  if (!c) {
+    // The connection has been closed
+    return;
+  }
 
   const std::string &payload = msg->get_payload();
 
@@ -5,6 +5,8 @@
 #ifndef SHERPA_ONNX_CSRC_ONLINE_WEBSOCKET_SERVER_IMPL_H_
 #define SHERPA_ONNX_CSRC_ONLINE_WEBSOCKET_SERVER_IMPL_H_
 
+#include <array>
+#include <atomic>
 #include <deque>
 #include <fstream>
 #include <map>
@@ -17,6 +19,7 @@
 #include <vector>
 
 #include "asio.hpp"
+#include "sherpa-onnx/csrc/online-decode-scheduler.h"
 #include "sherpa-onnx/csrc/online-recognizer.h"
 #include "sherpa-onnx/csrc/online-stream.h"
 #include "sherpa-onnx/csrc/parse-options.h"
@@ -36,12 +39,15 @@ struct Connection {
   // set it to true when InputFinished() is called
   bool eof = false;
 
+  // set it to true when the client is disconnected
+  std::atomic<bool> closed{false};
+
   // The last time we received a message from the client
   // TODO(fangjun): Use it to disconnect from a client if it is inactive
   // for a specified time.
   std::chrono::steady_clock::time_point last_active;
 
-  std::mutex mutex;  // protect samples
+  std::mutex mutex;  // protect samples and eof
 
   // Audio samples received from the client.
   //
@@ -57,11 +63,21 @@ struct Connection {
 struct OnlineWebsocketDecoderConfig {
   OnlineRecognizerConfig recognizer_config;
 
-  // It determines how often the decoder loop runs.
+  // Deprecated and unused. See target_latency_ms.
   int32_t loop_interval_ms = 10;
 
   int32_t max_batch_size = 5;
 
+  // Number of threads that run the neural network
+  int32_t num_decode_threads = 2;
+
+  // A connection with enough frames waits at most this long for other
+  // connections to join its batch
+  float target_latency_ms = 10;
+
+  // If not empty, pin the decode threads to these CPUs, e.g., "4-7"
+  std::string decode_thread_cpus;
+
   float end_tail_padding = 0.8;
 
   void Register(ParseOptions *po);
@@ -77,6 +93,7 @@ class OnlineWebsocketDecoder {
    */
   explicit OnlineWebsocketDecoder(OnlineWebsocketServer *server);
 
+  // Return nullptr if the connection has been destroyed
   std::shared_ptr<Connection> GetOrCreateConnection(connection_hdl hdl);
 
   // Compute features for a stream given audio samples
@@ -85,37 +102,41 @@ class OnlineWebsocketDecoder {
   // signal that there will be no more audio samples for a stream
   void InputFinished(std::shared_ptr<Connection> c);
 
-  void Warmup() const;
+  // It is called when the client is disconnected
+  void RemoveConnection(connection_hdl hdl);
 
-  void Run();
+  void Warmup() const;
 
  private:
-  void ProcessConnections(const asio::error_code &ec);
+  // It is called by a worker thread of the scheduler after each decoding
+  // of a connection
+  void OnResult(connection_hdl hdl, const OnlineRecognizerResult &r,
+                bool is_last);
 
-  /** It is called by one of the worker thread.
-   */
-  void Decode();
+  struct Shard {
+    std::mutex mutex;
+
+    std::map<connection_hdl, std::shared_ptr<Connection>,
+             std::owner_less<connection_hdl>>
+        connections;
+  };
+
+  // Return nullptr if the connection has been destroyed
+  Shard *GetShard(connection_hdl hdl);
 
  private:
   OnlineWebsocketServer *server_;  // not owned
-  std::unique_ptr<OnlineRecognizer> recognizer_;
   OnlineWebsocketDecoderConfig config_;
-  asio::steady_timer timer_;
-
-  // It protects `connections_`, `ready_connections_`, and `active_`
-  std::mutex mutex_;
-
-  std::map<connection_hdl, std::shared_ptr<Connection>,
-           std::owner_less<connection_hdl>>
-      connections_;
+  std::unique_ptr<OnlineRecognizer> recognizer_;
 
-  // Whenever a connection has enough feature frames for decoding, we put
-  // it in this queue
-  std::deque<std::shared_ptr<Connection>> ready_connections_;
+  // Connections are spread over shards so that threads handling
+  // different connections seldom wait for the same lock
+  static constexpr int32_t kNumShards = 16;
+  std::array<Shard, kNumShards> shards_;
 
-  // If we are decoding a stream, we put it in the active_ set so that
-  // only one thread can decode a stream at a time.
-  std::set<connection_hdl, std::owner_less<connection_hdl>> active_;
+  // Batches connections that are ready for decoding. It is destroyed
+  // before recognizer_, which it uses.
+  OnlineDecodeScheduler scheduler_;
 };
 
 struct OnlineWebsocketServerConfig {
@@ -2,9 +2,14 @@
 //
 // Copyright (c)  2022-2023  Xiaomi Corporation
 
+#include <string>
+#include <vector>
+
 #include "asio.hpp"
+#include "sherpa-onnx/csrc/cpu-affinity.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/online-websocket-server-impl.h"
+#include "sherpa-onnx/csrc/ort-env.h"
 #include "sherpa-onnx/csrc/parse-options.h"
 
 static constexpr const char *kUsageMessage = R"(
@@ -16,14 +21,29 @@ Usage:
 
 ./bin/sherpa-onnx-online-websocket-server \
   --port=6006 \
-  --num-work-threads=5 \
+  --num-work-threads=2 \
+  --num-decode-threads=3 \
   --tokens=/path/to/tokens.txt \
   --encoder=/path/to/encoder.onnx \
   --decoder=/path/to/decoder.onnx \
   --joiner=/path/to/joiner.onnx \
   --log-file=./log.txt \
   --max-batch-size=5 \
-  --loop-interval-ms=10
+  --target-latency-ms=10
+
+The work threads compute features. The decode threads run the neural
+network on batches of connections that are ready for decoding.
+
+To keep the work threads, the decode threads and the onnxruntime threads
+from competing for the same cores, you can pin them to different ones,
+e.g., on a machine with 8 cores:
+
+  --num-work-threads=2 \
+  --work-thread-cpus=0-1 \
+  --num-decode-threads=2 \
+  --decode-thread-cpus=2-3 \
+  --num-threads=4 \
+  --ort-intra-op-thread-affinities="5;6;7"
 
 Please refer to
 https://k2-fsa.github.io/sherpa/onnx/pretrained_models/index.html
@@ -41,20 +61,37 @@ int32_t main(int32_t argc, char *argv[]) {
   // size of the thread pool for handling network connections
   int32_t num_io_threads = 1;
 
-  // size of the thread pool for neural network computation and decoding
+  // size of the thread pool for feature computation
   int32_t num_work_threads = 3;
 
   po.Register("num-io-threads", &num_io_threads,
               "Thread pool size for network connections.");
 
   po.Register("num-work-threads", &num_work_threads,
-              "Thread pool size for for neural network "
-              "computation and decoding.");
+              "Thread pool size for feature computation. Please use "
+              "--num-decode-threads for neural network computation.");
+
+  // If not empty, pin the threads to these CPUs, e.g., "0-3,8"
+  std::string io_thread_cpus;
+  std::string work_thread_cpus;
+
+  po.Register("io-thread-cpus", &io_thread_cpus,
+              "If not empty, pin the network threads to these CPUs, "
+              "e.g., 0-3,8. Thread i is pinned to the i-th CPU, wrapping "
+              "around if there are more threads than CPUs.");
+
+  po.Register("work-thread-cpus", &work_thread_cpus,
+              "If not empty, pin the work threads to these CPUs, "
+              "e.g., 4-7. Thread i is pinned to the i-th CPU, wrapping "
+              "around if there are more threads than CPUs.");
 
   po.Register("port", &port, "The port on which the server will listen.");
 
   config.Register(&po);
 
+  sherpa_onnx::OrtEnvConfig env_config;
+  env_config.Register(&po);
+
   if (argc == 1) {
     po.PrintUsage();
     exit(EXIT_FAILURE);
@@ -70,8 +107,25 @@ int32_t main(int32_t argc, char *argv[]) {
 
   config.Validate();
 
+  std::vector<int32_t> io_cpus;
+  if (!sherpa_onnx::ParseCpuList(io_thread_cpus, &io_cpus)) {
+    SHERPA_ONNX_LOGE("Invalid --io-thread-cpus: '%s'", io_thread_cpus.c_str());
+    exit(EXIT_FAILURE);
+  }
+
+  std::vector<int32_t> work_cpus;
+  if (!sherpa_onnx::ParseCpuList(work_thread_cpus, &work_cpus)) {
+    SHERPA_ONNX_LOGE("Invalid --work-thread-cpus: '%s'",
+                     work_thread_cpus.c_str());
+    exit(EXIT_FAILURE);
+  }
+
+  if (!sherpa_onnx::InitOrtEnv(env_config)) {
+    exit(EXIT_FAILURE);
+  }
+
   asio::io_context io_conn;  // for network connections
-  asio::io_context io_work;  // for neural network and decoding
+  asio::io_context io_work;  // for feature computation
 
   sherpa_onnx::OnlineWebsocketServer server(io_conn, io_work, config);
   server.Run(port);
@@ -85,16 +139,32 @@ int32_t main(int32_t argc, char *argv[]) {
 
   std::vector<std::thread> io_threads;
 
+  // Return the CPU for the i-th thread, or an empty list to not pin it
+  auto cpu_of = [](const std::vector<int32_t> &cpus,
+                   int32_t i) -> std::vector<int32_t> {
+    if (cpus.empty()) {
+      return {};
+    }
+    return {cpus[i % cpus.size()]};
+  };
+
   // decrement since the main thread is also used for network communications
   for (int32_t i = 0; i < num_io_threads - 1; ++i) {
-    io_threads.emplace_back([&io_conn]() { io_conn.run(); });
+    io_threads.emplace_back([&io_conn, cpus = cpu_of(io_cpus, i + 1)]() {
+      sherpa_onnx::SetCurrentThreadAffinity(cpus);
+      io_conn.run();
+    });
   }
 
   std::vector<std::thread> work_threads;
   for (int32_t i = 0; i < num_work_threads; ++i) {
-    work_threads.emplace_back([&io_work]() { io_work.run(); });
+    work_threads.emplace_back([&io_work, cpus = cpu_of(work_cpus, i)]() {
+      sherpa_onnx::SetCurrentThreadAffinity(cpus);
+      io_work.run();
+    });
   }
 
+  sherpa_onnx::SetCurrentThreadAffinity(cpu_of(io_cpus, 0));
   io_conn.run();
 
   for (auto &t : io_threads) {
@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "onnxruntime_cxx_api.h"  // NOLINT
+#include "sherpa-onnx/csrc/io-binding-cache.h"
 #include "sherpa-onnx/csrc/online-model-config.h"
 #include "sherpa-onnx/csrc/online-transducer-model.h"
 
@@ -34,6 +35,8 @@ class OnlineZipformerTransducerModel : public OnlineTransducerModel {
       Ort::Value features, std::vector<Ort::Value> states,
       Ort::Value processed_frames) override;
 
+  void RecycleEncoderTensors(std::vector<Ort::Value> tensors) override;
+
   Ort::Value RunDecoder(Ort::Value decoder_input) override;
 
   Ort::Value RunJoiner(Ort::Value encoder_out, Ort::Value decoder_out) override;
@@ -48,12 +51,12 @@ class OnlineZipformerTransducerModel : public OnlineTransducerModel {
   OrtAllocator *Allocator() override { return allocator_; }
 
  private:
-  void InitEncoder(void *model_data, size_t model_data_length);
-  void InitDecoder(void *model_data, size_t model_data_length);
-  void InitJoiner(void *model_data, size_t model_data_length);
+  void InitEncoder(const void *model_data, size_t model_data_length);
+  void InitDecoder(const void *model_data, size_t model_data_length);
+  void InitJoiner(const void *model_data, size_t model_data_length);
 
  private:
-  Ort::Env env_;
+  Ort::Env &env_;
   Ort::SessionOptions sess_opts_;
   Ort::AllocatorWithDefaultOptions allocator_;
 
@@ -67,6 +70,9 @@ class OnlineZipformerTransducerModel : public OnlineTransducerModel {
   std::vector<std::string> encoder_output_names_;
   std::vector<const char *> encoder_output_names_ptr_;
 
+  // Writes encoder outputs into recycled tensors
+  std::unique_ptr<IoBindingCache> encoder_cache_;
+
   std::vector<std::string> decoder_input_names_;
   std::vector<const char *> decoder_input_names_ptr_;
 
@@ -7,8 +7,11 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <memory>
 #include <numeric>
 #include <string>
+#include <utility>
+#include <vector>
 
 #if __ANDROID_API__ >= 9
 #include "android/asset_manager.h"
@@ -21,8 +24,10 @@
 
 #include "sherpa-onnx/csrc/cat.h"
 #include "sherpa-onnx/csrc/file-utils.h"
+#include "sherpa-onnx/csrc/io-binding-cache.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
+#include "sherpa-onnx/csrc/ort-env.h"
 #include "sherpa-onnx/csrc/session.h"
 #include "sherpa-onnx/csrc/text-utils.h"
 #include "sherpa-onnx/csrc/unbind.h"
@@ -33,11 +38,11 @@ class OnlineZipformer2CtcModel::Impl {
  public:
   explicit Impl(const OnlineModelConfig &config)
       : config_(config),
-        env_(ORT_LOGGING_LEVEL_ERROR),
+        env_(GetOrtEnv()),
         sess_opts_(GetSessionOptions(config)),
         allocator_{} {
     {
-      auto buf = ReadFile(config.zipformer2_ctc.model);
+      auto buf = MapFile(config.zipformer2_ctc.model);
       Init(buf.data(), buf.size());
     }
   }
@@ -45,7 +50,7 @@ class OnlineZipformer2CtcModel::Impl {
   template <typename Manager>
   Impl(Manager *mgr, const OnlineModelConfig &config)
       : config_(config),
-        env_(ORT_LOGGING_LEVEL_ERROR),
+        env_(GetOrtEnv()),
         sess_opts_(GetSessionOptions(config)),
         allocator_{} {
     {
@@ -64,8 +69,11 @@ class OnlineZipformer2CtcModel::Impl {
       inputs.push_back(std::move(v));
     }
 
-    return sess_->Run({}, input_names_ptr_.data(), inputs.data(), inputs.size(),
-                      output_names_ptr_.data(), output_names_ptr_.size());
+    return cache_->Run(inputs.data());
+  }
+
+  void RecycleTensors(std::vector<Ort::Value> tensors) {
+    cache_->Recycle(&tensors);
   }
 
   int32_t VocabSize() const { return vocab_size_; }
@@ -245,14 +253,16 @@ class OnlineZipformer2CtcModel::Impl {
   }
 
  private:
-  void Init(void *model_data, size_t model_data_length) {
-    sess_ = std::make_unique<Ort::Session>(env_, model_data, model_data_length,
-                                           sess_opts_);
+  void Init(const void *model_data, size_t model_data_length) {
+    sess_ = CreateSession(env_, model_data, model_data_length, sess_opts_);
 
     GetInputNames(sess_.get(), &input_names_, &input_names_ptr_);
 
     GetOutputNames(sess_.get(), &output_names_, &output_names_ptr_);
 
+    cache_ = std::make_unique<IoBindingCache>(sess_.get(), input_names_ptr_,
+                                              output_names_ptr_, allocator_);
+
     // get meta data
     Ort::ModelMetadata meta_data = sess_->GetModelMetadata();
     if (config_.debug) {
@@ -392,7 +402,7 @@ class OnlineZipformer2CtcModel::Impl {
 
  private:
   OnlineModelConfig config_;
-  Ort::Env env_;
+  Ort::Env &env_;
   Ort::SessionOptions sess_opts_;
   Ort::AllocatorWithDefaultOptions allocator_;
 
@@ -404,6 +414,9 @@ class OnlineZipformer2CtcModel::Impl {
   std::vector<std::string> output_names_;
   std::vector<const char *> output_names_ptr_;
 
+  // Writes outputs into recycled tensors
+  std::unique_ptr<IoBindingCache> cache_;
+
   std::vector<Ort::Value> initial_states_;
 
   std::vector<int32_t> encoder_dims_;
@@ -435,6 +448,11 @@ std::vector<Ort::Value> OnlineZipformer2CtcModel::Forward(
   return impl_->Forward(std::move(x), std::move(states));
 }
 
+void OnlineZipformer2CtcModel::RecycleTensors(
+    std::vector<Ort::Value> tensors) const {
+  impl_->RecycleTensors(std::move(tensors));
+}
+
 int32_t OnlineZipformer2CtcModel::VocabSize() const {
   return impl_->VocabSize();
 }
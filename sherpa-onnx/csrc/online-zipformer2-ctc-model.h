@@ -48,6 +48,8 @@ class OnlineZipformer2CtcModel : public OnlineCtcModel {
   std::vector<Ort::Value> Forward(
       Ort::Value x, std::vector<Ort::Value> states) const override;
 
+  void RecycleTensors(std::vector<Ort::Value> tensors) const override;
+
   /** Return the vocabulary size of the model
    */
   int32_t VocabSize() const override;
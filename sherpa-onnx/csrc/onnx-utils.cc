@@ -77,6 +77,21 @@ Ort::Value GetEncoderOutFrame(OrtAllocator *allocator, Ort::Value *encoder_out,
   std::vector<int64_t> encoder_out_shape =
       encoder_out->GetTensorTypeAndShapeInfo().GetShape();
 
+  std::array<int64_t, 2> shape{encoder_out_shape[0], encoder_out_shape[2]};
+
+  Ort::Value ans =
+      Ort::Value::CreateTensor<float>(allocator, shape.data(), shape.size());
+
+  GetEncoderOutFrame(encoder_out, t, &ans);
+
+  return ans;
+}
+
+void GetEncoderOutFrame(const Ort::Value *encoder_out, int32_t t,
+                        Ort::Value *frame) {
+  std::vector<int64_t> encoder_out_shape =
+      encoder_out->GetTensorTypeAndShapeInfo().GetShape();
+
   auto batch_size = encoder_out_shape[0];
   auto num_frames = encoder_out_shape[1];
   assert(t < num_frames);
@@ -85,12 +100,7 @@ Ort::Value GetEncoderOutFrame(OrtAllocator *allocator, Ort::Value *encoder_out,
 
   auto offset = num_frames * encoder_out_dim;
 
-  std::array<int64_t, 2> shape{batch_size, encoder_out_dim};
-
-  Ort::Value ans =
-      Ort::Value::CreateTensor<float>(allocator, shape.data(), shape.size());
-
-  float *dst = ans.GetTensorMutableData<float>();
+  float *dst = frame->GetTensorMutableData<float>();
   const float *src = encoder_out->GetTensorData<float>();
 
   for (int32_t i = 0; i != batch_size; ++i) {
@@ -98,7 +108,6 @@ Ort::Value GetEncoderOutFrame(OrtAllocator *allocator, Ort::Value *encoder_out,
     src += offset;
     dst += encoder_out_dim;
   }
-  return ans;
 }
 
 void PrintModelMetadata(std::ostream &os, const Ort::ModelMetadata &meta_data) {
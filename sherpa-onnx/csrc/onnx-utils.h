@@ -54,6 +54,17 @@ void GetOutputNames(Ort::Session *sess, std::vector<std::string> *output_names,
 Ort::Value GetEncoderOutFrame(OrtAllocator *allocator, Ort::Value *encoder_out,
                               int32_t t);
 
+/**
+ * Same as above, but write the output frame into a preallocated tensor
+ * so that it can be reused across frames.
+ *
+ * @param encoder_out encoder out tensor of shape (N, T, C)
+ * @param t frame_index
+ * @param frame A tensor of shape (N, C). It is changed in-place.
+ */
+void GetEncoderOutFrame(const Ort::Value *encoder_out, int32_t t,
+                        Ort::Value *frame);
+
 std::string LookupCustomModelMetaData(const Ort::ModelMetadata &meta_data,
                                       const char *key, OrtAllocator *allocator);
 
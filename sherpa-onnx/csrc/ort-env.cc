@@ -0,0 +1,216 @@
+// sherpa-onnx/csrc/ort-env.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/ort-env.h"
+
+#include <mutex>  // NOLINT
+#include <sstream>
+#include <string>
+
+#include "sherpa-onnx/csrc/macros.h"
+
+namespace sherpa_onnx {
+
+void OrtEnvConfig::Register(ParseOptions *po) {
+  po->Register("ort-global-thread-pool", &use_global_thread_pool,
+               "If true, all models share one onnxruntime thread pool. "
+               "--num-threads of each model is then ignored");
+
+  po->Register("ort-intra-op-num-threads", &intra_op_num_threads,
+               "Number of threads of the global intra-op thread pool. "
+               "0 means to use the number of physical cores. Used only when "
+               "--ort-global-thread-pool is true");
+
+  po->Register("ort-inter-op-num-threads", &inter_op_num_threads,
+               "Number of threads of the global inter-op thread pool. "
+               "Used only when --ort-global-thread-pool is true");
+
+  po->Register("ort-allow-spinning", &allow_spinning,
+               "If false, idle threads of the global thread pools don't spin "
+               "waiting for work. Used only when --ort-global-thread-pool "
+               "is true");
+
+  po->Register("ort-share-prepacked-weights", &share_prepacked_weights,
+               "If true, sessions share prepacked weights, so that loading "
+               "the same model again in this process does not duplicate "
+               "them");
+
+  po->Register("ort-optimized-model-cache-dir", &optimized_model_cache_dir,
+               "If not empty, models running on the CPU are saved to this "
+               "directory after graph optimization, so that later runs can "
+               "skip most of it. Optimizations that depend on the CPU are "
+               "not saved, so it can be shared between machines");
+
+  po->Register("ort-intra-op-thread-affinities", &intra_op_thread_affinities,
+               "If not empty, pin the intra-op threads to these logical "
+               "processors, e.g., \"1,2;3-4;5\" for 4 threads. Threads are "
+               "separated by ';'. The calling thread is not counted. With "
+               "--ort-global-thread-pool, it applies to the global pool; "
+               "otherwise, it applies to each session whose number of "
+               "threads is the number of entries plus 1 and is ignored "
+               "with a warning for other sessions");
+
+  po->Register("ort-profiling-prefix", &profiling_prefix,
+               "If not empty, each onnxruntime session writes a profile with "
+               "the time of each node to <prefix>-<n>_<timestamp>.json on "
+               "exit, where n is the index of the session in creation order. "
+               "It slows down inference, so use it only for debugging");
+}
+
+bool OrtEnvConfig::Validate() const {
+  if (intra_op_num_threads < 0) {
+    SHERPA_ONNX_LOGE("intra_op_num_threads should be >= 0. Given %d",
+                     intra_op_num_threads);
+    return false;
+  }
+
+  if (inter_op_num_threads < 0) {
+    SHERPA_ONNX_LOGE("inter_op_num_threads should be >= 0. Given %d",
+                     inter_op_num_threads);
+    return false;
+  }
+
+  return true;
+}
+
+std::string OrtEnvConfig::ToString() const {
+  std::ostringstream os;
+
+  os << "OrtEnvConfig(";
+  os << "use_global_thread_pool="
+     << (use_global_thread_pool ? "True" : "False") << ", ";
+  os << "intra_op_num_threads=" << intra_op_num_threads << ", ";
+  os << "inter_op_num_threads=" << inter_op_num_threads << ", ";
+  os << "allow_spinning=" << (allow_spinning ? "True" : "False") << ", ";
+  os << "share_prepacked_weights="
+     << (share_prepacked_weights ? "True" : "False") << ", ";
+  os << "optimized_model_cache_dir=\"" << optimized_model_cache_dir << "\", ";
+  os << "intra_op_thread_affinities=\"" << intra_op_thread_affinities
+     << "\", ";
+  os << "profiling_prefix=\"" << profiling_prefix << "\")";
+
+  return os.str();
+}
+
+namespace {
+
+std::mutex &EnvMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+// Protected by EnvMutex()
+OrtEnvConfig env_config;
+Ort::Env *env = nullptr;
+bool use_global_thread_pool = false;
+
+// The caller must hold EnvMutex()
+Ort::Env *CreateEnv(const OrtEnvConfig &config) {
+  if (!config.use_global_thread_pool) {
+    return new Ort::Env(ORT_LOGGING_LEVEL_ERROR);
+  }
+
+#if ORT_API_VERSION >= 12
+  Ort::ThreadingOptions tp;
+  tp.SetGlobalIntraOpNumThreads(config.intra_op_num_threads);
+  tp.SetGlobalInterOpNumThreads(config.inter_op_num_threads);
+  tp.SetGlobalSpinControl(config.allow_spinning ? 1 : 0);
+
+  if (!config.intra_op_thread_affinities.empty()) {
+#if ORT_API_VERSION >= 15
+    tp.SetGlobalIntraOpThreadAffinity(
+        config.intra_op_thread_affinities.c_str());
+#else
+    SHERPA_ONNX_LOGE(
+        "Thread affinities are not supported for onnxruntime API version "
+        "%d. Ignore them",
+        static_cast<int32_t>(ORT_API_VERSION));
+#endif
+  }
+
+  use_global_thread_pool = true;
+
+  return new Ort::Env(tp, ORT_LOGGING_LEVEL_ERROR, "sherpa-onnx");
+#else
+  SHERPA_ONNX_LOGE(
+      "Global thread pools are not supported for onnxruntime API version %d. "
+      "Each session uses its own thread pools",
+      static_cast<int32_t>(ORT_API_VERSION));
+  return new Ort::Env(ORT_LOGGING_LEVEL_ERROR);
+#endif
+}
+
+}  // namespace
+
+bool InitOrtEnv(const OrtEnvConfig &config) {
+  if (!config.Validate()) {
+    SHERPA_ONNX_LOGE("Errors in config: %s", config.ToString().c_str());
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(EnvMutex());
+  if (env) {
+    SHERPA_ONNX_LOGE(
+        "The onnxruntime environment has already been created with %s. "
+        "Please call InitOrtEnv() before creating any models",
+        env_config.ToString().c_str());
+    return false;
+  }
+
+  env_config = config;
+
+  // Never freed, so that it outlives all models, including those in
+  // static objects that are destroyed at exit
+  env = CreateEnv(env_config);
+
+  return true;
+}
+
+Ort::Env &GetOrtEnv() {
+  std::lock_guard<std::mutex> lock(EnvMutex());
+  if (!env) {
+    env = CreateEnv(env_config);
+  }
+
+  return *env;
+}
+
+bool UseGlobalThreadPool() {
+  std::lock_guard<std::mutex> lock(EnvMutex());
+  return use_global_thread_pool;
+}
+
+OrtPrepackedWeightsContainer *GetPrepackedWeightsContainer() {
+#if ORT_API_VERSION >= 12
+  std::lock_guard<std::mutex> lock(EnvMutex());
+  if (!env_config.share_prepacked_weights) {
+    return nullptr;
+  }
+
+  // Never freed, like the environment
+  static Ort::PrepackedWeightsContainer *container =
+      new Ort::PrepackedWeightsContainer;
+
+  return *container;
+#else
+  return nullptr;
+#endif
+}
+
+std::string GetOptimizedModelCacheDir() {
+  std::lock_guard<std::mutex> lock(EnvMutex());
+  return env_config.optimized_model_cache_dir;
+}
+
+std::string GetIntraOpThreadAffinities() {
+  std::lock_guard<std::mutex> lock(EnvMutex());
+  return env_config.intra_op_thread_affinities;
+}
+
+std::string GetProfilingPrefix() {
+  std::lock_guard<std::mutex> lock(EnvMutex());
+  return env_config.profiling_prefix;
+}
+
+}  // namespace sherpa_onnx
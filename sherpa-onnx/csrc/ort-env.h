@@ -0,0 +1,118 @@
+// sherpa-onnx/csrc/ort-env.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_ORT_ENV_H_
+#define SHERPA_ONNX_CSRC_ORT_ENV_H_
+
+#include <string>
+
+#include "onnxruntime_cxx_api.h"  // NOLINT
+#include "sherpa-onnx/csrc/parse-options.h"
+
+namespace sherpa_onnx {
+
+// Settings of the onnxruntime environment that is shared by all models
+// in the process.
+struct OrtEnvConfig {
+  // If true, all sessions share one intra-op and one inter-op thread pool
+  // instead of creating their own. The num_threads option of each model
+  // is then ignored.
+  bool use_global_thread_pool = false;
+
+  // Size of the global intra-op thread pool. 0 means to let onnxruntime
+  // decide, i.e., the number of physical cores.
+  int32_t intra_op_num_threads = 0;
+
+  // Size of the global inter-op thread pool. 0 means to let onnxruntime
+  // decide.
+  int32_t inter_op_num_threads = 1;
+
+  // If false, idle threads of the global thread pools don't spin
+  // waiting for work, which saves CPU at the cost of latency.
+  bool allow_spinning = true;
+
+  // If true, sessions on the CPU share prepacked weights, e.g., of MatMul
+  // and Conv, so that loading a model again in the same process does not
+  // duplicate them.
+  bool share_prepacked_weights = true;
+
+  // If not empty, models running on the CPU are saved to this directory
+  // after graph optimization. Later loads of the same model use the saved
+  // one and skip most of graph optimization. Only optimizations that don't
+  // depend on the CPU are saved, so the directory can be shared between
+  // machines with the same version of onnxruntime.
+  std::string optimized_model_cache_dir;
+
+  // If not empty, pin the threads of the intra-op thread pools to the
+  // given logical processors. The format is the one of the onnxruntime
+  // session option session.intra_op_thread_affinities, e.g., "1,2;3-4;5"
+  // for a pool of 4 threads, since the calling thread is not pinned. It
+  // applies to the global pool if use_global_thread_pool is true;
+  // otherwise, to the pool of each session, so num_threads of the models
+  // has to match it.
+  std::string intra_op_thread_affinities;
+
+  // If not empty, each session writes an onnxruntime profile with the time
+  // of each node to <profiling_prefix>-<n>_<timestamp>.json when it is
+  // destroyed, where n is the index of the session in creation order.
+  std::string profiling_prefix;
+
+  OrtEnvConfig() = default;
+
+  OrtEnvConfig(bool use_global_thread_pool, int32_t intra_op_num_threads,
+               int32_t inter_op_num_threads, bool allow_spinning,
+               bool share_prepacked_weights,
+               const std::string &optimized_model_cache_dir,
+               const std::string &intra_op_thread_affinities,
+               const std::string &profiling_prefix)
+      : use_global_thread_pool(use_global_thread_pool),
+        intra_op_num_threads(intra_op_num_threads),
+        inter_op_num_threads(inter_op_num_threads),
+        allow_spinning(allow_spinning),
+        share_prepacked_weights(share_prepacked_weights),
+        optimized_model_cache_dir(optimized_model_cache_dir),
+        intra_op_thread_affinities(intra_op_thread_affinities),
+        profiling_prefix(profiling_prefix) {}
+
+  void Register(ParseOptions *po);
+  bool Validate() const;
+
+  std::string ToString() const;
+};
+
+/** Set up the environment shared by all models in this process.
+ *
+ * It has to be called before any model is created. Otherwise, it has no
+ * effect and returns false.
+ */
+bool InitOrtEnv(const OrtEnvConfig &config);
+
+/** Return the environment shared by all models in this process.
+ *
+ * If InitOrtEnv() has not been called, an environment with the default
+ * OrtEnvConfig is created, in which each session has its own thread pools.
+ */
+Ort::Env &GetOrtEnv();
+
+// Return true if sessions should use the global thread pools of the
+// environment. See SessionOptions::DisablePerSessionThreads().
+bool UseGlobalThreadPool();
+
+// Return the container of prepacked weights shared by all sessions, or
+// nullptr if OrtEnvConfig::share_prepacked_weights is false.
+OrtPrepackedWeightsContainer *GetPrepackedWeightsContainer();
+
+// Return OrtEnvConfig::optimized_model_cache_dir. An empty string means
+// optimized models are not cached.
+std::string GetOptimizedModelCacheDir();
+
+// Return OrtEnvConfig::intra_op_thread_affinities
+std::string GetIntraOpThreadAffinities();
+
+// Return OrtEnvConfig::profiling_prefix. An empty string means sessions
+// are not profiled.
+std::string GetProfilingPrefix();
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_ORT_ENV_H_
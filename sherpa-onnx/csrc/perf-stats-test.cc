@@ -0,0 +1,63 @@
+// sherpa-onnx/csrc/perf-stats-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/perf-stats.h"
+
+#include <chrono>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(PerfStats, Add) {
+  PerfStats stats;
+  EXPECT_TRUE(stats.Get().empty());
+
+  stats.Add(PerfStage::kEncoder, std::chrono::milliseconds(5));
+  stats.Add(PerfStage::kEncoder, std::chrono::milliseconds(3));
+  stats.Add(PerfStage::kJoiner, std::chrono::microseconds(20));
+
+  auto s = stats.Get();
+  ASSERT_EQ(s.size(), 2);
+  EXPECT_EQ(s["encoder"].num_calls, 2);
+  EXPECT_NEAR(s["encoder"].total_seconds, 0.008, 1e-9);
+  EXPECT_EQ(s["joiner"].num_calls, 1);
+  EXPECT_NEAR(s["joiner"].total_seconds, 20e-6, 1e-9);
+
+  stats.Reset();
+  EXPECT_TRUE(stats.Get().empty());
+}
+
+TEST(PerfStats, StageNames) {
+  EXPECT_STREQ(PerfStageName(PerfStage::kFeatureExtraction),
+               "feature_extraction");
+  EXPECT_STREQ(PerfStageName(PerfStage::kDecodeStreams), "decode_streams");
+  EXPECT_STREQ(PerfStageName(PerfStage::kGenerate), "generate");
+}
+
+TEST(PerfStats, ManyThreads) {
+  PerfStats stats;
+
+  std::vector<std::thread> threads;
+  for (int32_t i = 0; i != 4; ++i) {
+    threads.emplace_back([&stats]() {
+      for (int32_t k = 0; k != 10000; ++k) {
+        ScopedPerfTimer timer(&stats, PerfStage::kDecoder);
+      }
+    });
+  }
+
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  EXPECT_EQ(stats.Get()["decoder"].num_calls, 40000);
+
+  // It does nothing without stats
+  ScopedPerfTimer timer(nullptr, PerfStage::kDecoder);
+}
+
+}  // namespace sherpa_onnx
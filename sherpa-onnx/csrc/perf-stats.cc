@@ -0,0 +1,107 @@
+// sherpa-onnx/csrc/perf-stats.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/perf-stats.h"
+
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <string>
+
+namespace sherpa_onnx {
+
+std::string StageStats::ToString() const {
+  std::ostringstream os;
+  os << "StageStats(";
+  os << "num_calls=" << num_calls << ", ";
+  os << "total_seconds=" << total_seconds << ")";
+
+  return os.str();
+}
+
+const char *PerfStageName(PerfStage stage) {
+  switch (stage) {
+    case PerfStage::kFeatureExtraction:
+      return "feature_extraction";
+    case PerfStage::kEncoder:
+      return "encoder";
+    case PerfStage::kDecoder:
+      return "decoder";
+    case PerfStage::kJoiner:
+      return "joiner";
+    case PerfStage::kSearch:
+      return "search";
+    case PerfStage::kLm:
+      return "lm";
+    case PerfStage::kPostprocessing:
+      return "postprocessing";
+    case PerfStage::kDecodeStreams:
+      return "decode_streams";
+    case PerfStage::kFrontend:
+      return "frontend";
+    case PerfStage::kAcousticModel:
+      return "acoustic_model";
+    case PerfStage::kVocoder:
+      return "vocoder";
+    case PerfStage::kGenerate:
+      return "generate";
+    case PerfStage::kNumStages:
+      break;
+  }
+
+  return "unknown";
+}
+
+void PerfStats::Add(PerfStage stage, std::chrono::steady_clock::duration d) {
+  auto &c = stages_[static_cast<int32_t>(stage)];
+  c.num_calls.fetch_add(1, std::memory_order_relaxed);
+  c.total_nanoseconds.fetch_add(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(d).count(),
+      std::memory_order_relaxed);
+}
+
+std::map<std::string, StageStats> PerfStats::Get() const {
+  std::map<std::string, StageStats> ans;
+  for (int32_t i = 0; i != static_cast<int32_t>(stages_.size()); ++i) {
+    const auto &c = stages_[i];
+    int64_t num_calls = c.num_calls.load(std::memory_order_relaxed);
+    if (num_calls == 0) {
+      continue;
+    }
+
+    StageStats &s = ans[PerfStageName(static_cast<PerfStage>(i))];
+    s.num_calls = num_calls;
+    s.total_seconds =
+        c.total_nanoseconds.load(std::memory_order_relaxed) * 1e-9;
+  }
+
+  return ans;
+}
+
+void PerfStats::Reset() {
+  for (auto &c : stages_) {
+    c.num_calls.store(0, std::memory_order_relaxed);
+    c.total_nanoseconds.store(0, std::memory_order_relaxed);
+  }
+}
+
+std::string PerfStatsToJson(const std::map<std::string, StageStats> &stats) {
+  std::ostringstream os;
+  os << std::setprecision(6) << std::fixed;
+
+  os << "{";
+  std::string sep;
+  for (const auto &p : stats) {
+    // Stage names are identifiers, so they don't need escaping
+    os << sep << "\"" << p.first << "\": {";
+    os << "\"num_calls\": " << p.second.num_calls << ", ";
+    os << "\"total_seconds\": " << p.second.total_seconds << "}";
+    sep = ", ";
+  }
+  os << "}";
+
+  return os.str();
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,116 @@
+// sherpa-onnx/csrc/perf-stats.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_PERF_STATS_H_
+#define SHERPA_ONNX_CSRC_PERF_STATS_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace sherpa_onnx {
+
+struct StageStats {
+  // Number of times the stage has run
+  int64_t num_calls = 0;
+
+  // Total wall time of all the runs
+  double total_seconds = 0;
+
+  std::string ToString() const;
+};
+
+// Stages whose time is tracked by PerfStats
+enum class PerfStage : int32_t {
+  kFeatureExtraction = 0,
+  kEncoder,
+  kDecoder,
+  kJoiner,
+  kSearch,
+  kLm,
+  kPostprocessing,
+  kDecodeStreams,
+  kFrontend,
+  kAcousticModel,
+  kVocoder,
+  kGenerate,
+  kNumStages,  // It must be the last one
+};
+
+// Return the name of a stage, e.g., "feature_extraction" for
+// PerfStage::kFeatureExtraction
+const char *PerfStageName(PerfStage stage);
+
+/** Cumulative time spent in each stage of a recognizer or a TTS engine,
+ * e.g., feature_extraction, encoder, decoder, joiner, lm, and
+ * postprocessing.
+ *
+ * Stages may nest. For instance, the time of search includes that of
+ * decoder and joiner, which are the runs of the neural networks during
+ * the search.
+ *
+ * It is thread-safe. Add() only increments two atomic counters, so it
+ * can be used on every run of a model from many threads.
+ */
+class PerfStats {
+ public:
+  void Add(PerfStage stage, std::chrono::steady_clock::duration d);
+
+  // Return the stats of each stage that has run, indexed by the stage name
+  std::map<std::string, StageStats> Get() const;
+
+  void Reset();
+
+ private:
+  struct Counters {
+    std::atomic<int64_t> num_calls{0};
+    std::atomic<int64_t> total_nanoseconds{0};
+  };
+
+  std::array<Counters, static_cast<int32_t>(PerfStage::kNumStages)> stages_;
+};
+
+/** Add the time from its construction to its destruction to a stage.
+ *
+ * It does nothing if stats is nullptr. Don't use it for work that takes
+ * less time than reading the clock, e.g., for each token of a search.
+ *
+ *  {
+ *    ScopedPerfTimer timer(stats, PerfStage::kEncoder);
+ *    // run the encoder
+ *  }
+ */
+class ScopedPerfTimer {
+ public:
+  ScopedPerfTimer(PerfStats *stats, PerfStage stage)
+      : stats_(stats), stage_(stage) {
+    if (stats_) {
+      begin_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~ScopedPerfTimer() {
+    if (stats_) {
+      stats_->Add(stage_, std::chrono::steady_clock::now() - begin_);
+    }
+  }
+
+  ScopedPerfTimer(const ScopedPerfTimer &) = delete;
+  ScopedPerfTimer &operator=(const ScopedPerfTimer &) = delete;
+
+ private:
+  PerfStats *stats_;
+  PerfStage stage_;
+  std::chrono::steady_clock::time_point begin_;
+};
+
+// Return the stats as a JSON object, e.g.,
+// {"encoder": {"num_calls": 10, "total_seconds": 0.5}}
+std::string PerfStatsToJson(const std::map<std::string, StageStats> &stats);
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_PERF_STATS_H_
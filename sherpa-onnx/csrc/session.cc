@@ -5,12 +5,26 @@
 #include "sherpa-onnx/csrc/session.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <random>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/macros.h"
+#include "sherpa-onnx/csrc/ort-env.h"
 #include "sherpa-onnx/csrc/provider.h"
+#if defined(_WIN32)
+#include "sherpa-onnx/csrc/text-utils.h"
+#endif
+
 #if defined(__APPLE__)
 #include "coreml_provider_factory.h"  // NOLINT
 #endif
@@ -25,6 +39,11 @@
 
 namespace sherpa_onnx {
 
+// Set by GetSessionOptionsImpl() for sessions whose optimized model
+// can be cached. Its value is part of the cache key.
+static constexpr const char *kOptimizedModelCacheEntry =
+    "sherpa_onnx.optimized_model_cache";
+
 static void OrtStatusFailure(OrtStatus *status, const char *s) {
   const auto &api = Ort::GetApi();
   const char *msg = api.GetErrorMessage(status);
@@ -41,9 +60,32 @@ Ort::SessionOptions GetSessionOptionsImpl(
   Provider p = StringToProvider(provider_str);
 
   Ort::SessionOptions sess_opts;
-  sess_opts.SetIntraOpNumThreads(num_threads);
+  if (UseGlobalThreadPool()) {
+    // Use the thread pools of the environment shared by all sessions.
+    // See InitOrtEnv()
+    sess_opts.DisablePerSessionThreads();
+  } else {
+    sess_opts.SetIntraOpNumThreads(num_threads);
 
-  sess_opts.SetInterOpNumThreads(num_threads);
+    sess_opts.SetInterOpNumThreads(num_threads);
+
+    std::string affinities = GetIntraOpThreadAffinities();
+    if (!affinities.empty()) {
+      // onnxruntime fails to create the session if the number of entries
+      // is not num_threads - 1
+      int32_t num_entries =
+          std::count(affinities.begin(), affinities.end(), ';') + 1;
+      if (num_entries == num_threads - 1) {
+        sess_opts.AddConfigEntry("session.intra_op_thread_affinities",
+                                 affinities.c_str());
+      } else {
+        SHERPA_ONNX_LOGE(
+            "Ignore intra-op thread affinities '%s': it has %d entries, but "
+            "num_threads is %d. Expected %d entries.",
+            affinities.c_str(), num_entries, num_threads, num_threads - 1);
+      }
+    }
+  }
 
   std::vector<std::string> available_providers = Ort::GetAvailableProviders();
   std::ostringstream os;
@@ -51,14 +93,33 @@ Ort::SessionOptions GetSessionOptionsImpl(
     os << ep << ", ";
   }
 
+  std::string profiling_prefix = GetProfilingPrefix();
+  if (!profiling_prefix.empty()) {
+    static std::atomic<int32_t> num_profiled_sessions{0};
+    std::string prefix =
+        profiling_prefix + "-" + std::to_string(num_profiled_sessions++);
+    SHERPA_ONNX_LOGE("Profile of the session is saved to %s_<timestamp>.json",
+                     prefix.c_str());
+#if defined(_WIN32)
+    sess_opts.EnableProfiling(ToWideString(prefix).c_str());
+#else
+    sess_opts.EnableProfiling(prefix.c_str());
+#endif
+  }
+
   // Other possible options
   // sess_opts.SetGraphOptimizationLevel(ORT_ENABLE_EXTENDED);
   // sess_opts.SetLogSeverityLevel(ORT_LOGGING_LEVEL_VERBOSE);
-  // sess_opts.EnableProfiling("profile");
 
   switch (p) {
     case Provider::kCPU:
-      break;  // nothing to do for the CPU provider
+      if (!GetOptimizedModelCacheDir().empty()) {
+        // Models optimized for other providers may contain nodes that
+        // only those providers can run, so only CPU sessions are cached.
+        // See CreateSession()
+        sess_opts.AddConfigEntry(kOptimizedModelCacheEntry, "cpu");
+      }
+      break;
     case Provider::kXnnpack: {
 #if ORT_API_VERSION >= 12
       if (std::find(available_providers.begin(), available_providers.end(),
@@ -278,4 +339,148 @@ Ort::SessionOptions GetSessionOptions(int32_t num_threads,
   return GetSessionOptionsImpl(num_threads, provider_str);
 }
 
+static std::unique_ptr<Ort::Session> CreateSessionImpl(
+    Ort::Env &env,  // NOLINT
+    const void *model_data, size_t model_data_length,
+    const Ort::SessionOptions &opts) {
+  OrtPrepackedWeightsContainer *container = GetPrepackedWeightsContainer();
+  if (container) {
+    return std::make_unique<Ort::Session>(env, model_data, model_data_length,
+                                          opts, container);
+  }
+
+  return std::make_unique<Ort::Session>(env, model_data, model_data_length,
+                                        opts);
+}
+
+// FNV-1a over 8-byte words, which is fast enough for models of several GB
+static uint64_t HashModel(const void *model_data, size_t model_data_length,
+                          const std::string &extra) {
+  constexpr uint64_t kPrime = 0x100000001b3ULL;
+  uint64_t h = 0xcbf29ce484222325ULL;
+
+  auto update = [&h](uint64_t v) {
+    h ^= v;
+    h *= kPrime;
+  };
+
+  const char *p = reinterpret_cast<const char *>(model_data);
+  size_t n = model_data_length / sizeof(uint64_t);
+  for (size_t i = 0; i != n; ++i, p += sizeof(uint64_t)) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    update(v);
+  }
+
+  for (size_t i = n * sizeof(uint64_t); i != model_data_length; ++i, ++p) {
+    update(static_cast<uint8_t>(*p));
+  }
+
+  update(model_data_length);
+
+  for (char c : extra) {
+    update(static_cast<uint8_t>(c));
+  }
+
+  return h;
+}
+
+// Only optimizations up to ORT_ENABLE_EXTENDED are saved. Unlike the
+// layout transformations of ORT_ENABLE_ALL, e.g., NCHWc for AVX-512, they
+// don't depend on the CPU, so a saved model can be loaded on any machine.
+// The layout transformations are applied when the saved model is loaded,
+// which is cheap compared to the fusions that are saved.
+static constexpr GraphOptimizationLevel kSavedOptimizationLevel =
+    ORT_ENABLE_EXTENDED;
+
+// Return true if the optimized model has been saved to filename
+static bool SaveOptimizedModel(Ort::Env &env,  // NOLINT
+                               const void *model_data,
+                               size_t model_data_length,
+                               const Ort::SessionOptions &opts,
+                               const std::string &filename) {
+  // Write to a temporary file first so that other processes never
+  // see a partially written model
+  std::string tmp =
+      filename + ".tmp" + std::to_string(std::random_device{}());
+
+  Ort::SessionOptions save_opts = opts.Clone();
+  save_opts.SetGraphOptimizationLevel(kSavedOptimizationLevel);
+#if defined(_WIN32)
+  save_opts.SetOptimizedModelFilePath(ToWideString(tmp).c_str());
+#else
+  save_opts.SetOptimizedModelFilePath(tmp.c_str());
+#endif
+
+  try {
+    CreateSessionImpl(env, model_data, model_data_length, save_opts);
+  } catch (const Ort::Exception &ex) {
+    // e.g., the directory is not writable or the model is larger than 2GB
+    SHERPA_ONNX_LOGE("Failed to save optimized model to %s: %s", tmp.c_str(),
+                     ex.what());
+    std::remove(tmp.c_str());
+    return false;
+  }
+
+  if (std::rename(tmp.c_str(), filename.c_str()) != 0) {
+    // Another process might have saved it first
+    std::remove(tmp.c_str());
+    return FileExists(filename);
+  }
+
+  return true;
+}
+
+static std::unique_ptr<Ort::Session> CreateCachedSession(
+    Ort::Env &env,  // NOLINT
+    const void *model_data, size_t model_data_length,
+    const Ort::SessionOptions &opts, const std::string &cache_dir,
+    const std::string &cache_key) {
+  std::string extra = cache_key + "-level-" +
+                      std::to_string(kSavedOptimizationLevel) + "-ort-api-" +
+                      std::to_string(ORT_API_VERSION);
+
+  std::ostringstream os;
+  os << std::hex << std::setw(16) << std::setfill('0')
+     << HashModel(model_data, model_data_length, extra);
+
+  std::string filename = cache_dir + "/" + os.str() + ".onnx";
+
+  if (FileExists(filename) ||
+      SaveOptimizedModel(env, model_data, model_data_length, opts,
+                         filename)) {
+    MappedFile buf = MapFile(filename);
+
+    try {
+      return CreateSessionImpl(env, buf.data(), buf.size(), opts);
+    } catch (const Ort::Exception &ex) {
+      // Don't remove it. Other processes may be using it.
+      SHERPA_ONNX_LOGE(
+          "Failed to load cached optimized model %s: %s. Use the original "
+          "model instead",
+          filename.c_str(), ex.what());
+    }
+  }
+
+  return CreateSessionImpl(env, model_data, model_data_length, opts);
+}
+
+std::unique_ptr<Ort::Session> CreateSession(Ort::Env &env,  // NOLINT
+                                            const void *model_data,
+                                            size_t model_data_length,
+                                            const Ort::SessionOptions &opts) {
+#if ORT_API_VERSION >= 14
+  if (opts.HasConfigEntry(kOptimizedModelCacheEntry)) {
+    std::string cache_dir = GetOptimizedModelCacheDir();
+    if (!cache_dir.empty()) {
+      std::string cache_key = opts.GetConfigEntry(kOptimizedModelCacheEntry);
+      return CreateCachedSession(env, model_data, model_data_length, opts,
+                                 cache_dir, cache_key);
+    }
+  }
+#endif
+
+  return CreateSessionImpl(env, model_data, model_data_length, opts);
+}
+
 }  // namespace sherpa_onnx
@@ -5,6 +5,7 @@
 #ifndef SHERPA_ONNX_CSRC_SESSION_H_
 #define SHERPA_ONNX_CSRC_SESSION_H_
 
+#include <memory>
 #include <string>
 
 #include "onnxruntime_cxx_api.h"  // NOLINT
@@ -34,6 +35,20 @@ Ort::SessionOptions GetSessionOptions(const T &config) {
   return GetSessionOptionsImpl(config.num_threads, config.provider);
 }
 
+/** Create a session from a model in memory, e.g., from MapFile().
+ *
+ * Sessions created by it share prepacked weights with each other.
+ * See OrtEnvConfig::share_prepacked_weights.
+ *
+ * If OrtEnvConfig::optimized_model_cache_dir is set, CPU sessions are
+ * created from the cached optimized model when there is one. Otherwise,
+ * the optimized model is saved there for the next time.
+ */
+std::unique_ptr<Ort::Session> CreateSession(Ort::Env &env,  // NOLINT
+                                            const void *model_data,
+                                            size_t model_data_length,
+                                            const Ort::SessionOptions &opts);
+
 }  // namespace sherpa_onnx
 
 #endif  // SHERPA_ONNX_CSRC_SESSION_H_
@@ -7,12 +7,17 @@
 #include <atomic>
 #include <chrono>  // NOLINT
 #include <fstream>
+#include <memory>
 #include <mutex>  // NOLINT
 #include <string>
 #include <thread>  // NOLINT
+#include <utility>
 #include <vector>
 
+#include "sherpa-onnx/csrc/bucket-by-length.h"
+#include "sherpa-onnx/csrc/cpu-affinity.h"
 #include "sherpa-onnx/csrc/offline-recognizer.h"
+#include "sherpa-onnx/csrc/ort-env.h"
 #include "sherpa-onnx/csrc/parse-options.h"
 #include "sherpa-onnx/csrc/wave-reader.h"
 
@@ -37,6 +42,37 @@ std::vector<std::vector<std::string>> SplitToBatches(
   return outputs;
 }
 
+// Group files of similar durations so that shorter files are not padded
+// to a much longer one in the same batch
+std::vector<std::vector<std::string>> SplitToBuckets(
+    const std::vector<std::string> &input, int32_t batch_size,
+    int32_t max_padded_frames) {
+  std::vector<int32_t> lengths;
+  lengths.reserve(input.size());
+  for (const auto &wav_filename : input) {
+    int32_t sampling_rate = -1;
+    bool is_ok = false;
+    const std::vector<float> samples =
+        sherpa_onnx::ReadWave(wav_filename, &sampling_rate, &is_ok);
+
+    // 10 ms per frame. Files that cannot be read are reported later
+    lengths.push_back(is_ok ? samples.size() * 100 / sampling_rate : 0);
+  }
+
+  std::vector<std::vector<std::string>> outputs;
+  for (const auto &bucket :
+       sherpa_onnx::BucketByLength(lengths, max_padded_frames, batch_size)) {
+    std::vector<std::string> batch;
+    batch.reserve(bucket.size());
+    for (auto i : bucket) {
+      batch.push_back(input[i]);
+    }
+    outputs.push_back(std::move(batch));
+  }
+
+  return outputs;
+}
+
 std::vector<std::string> LoadScpFile(const std::string &wav_scp_path) {
   std::vector<std::string> wav_paths;
   std::ifstream in(wav_scp_path);
@@ -214,6 +250,17 @@ See https://k2-fsa.github.io/sherpa/onnx/pretrained_models/offline-ctc/yesno/ind
 
 Note: It supports decoding multiple files in batches
 
+Files are batched in the input order by default, so a long file padded
+with a batch of short ones wastes most of the computation. Use, e.g.,
+--batch-size=16 --max-padded-frames=20000 to group files of similar
+durations instead.
+
+On machines with several NUMA nodes, --replica-per-numa-node=true loads one
+copy of the model on each node and pins the decoding threads of a copy to
+the CPUs of its node, so that they don't read weights from the memory of
+another node. Otherwise, --worker-cpus=0-7 pins the decoding threads to the
+given CPUs.
+
 foo.wav should be of single channel, 16-bit PCM encoded wave file; its
 sampling rate can be arbitrary and does not need to be 16kHz.
 
@@ -237,6 +284,29 @@ for a list of pre-trained models to download.
               "number of wav files processed at once during the decoding"
               "process. default=1");
 
+  int32_t max_padded_frames = 0;
+  po.Register("max-padded-frames", &max_padded_frames,
+              "If positive, group files of similar durations into batches "
+              "of at most --batch-size files, so that batch size times the "
+              "longest file in the batch, in frames of 10 ms, does not "
+              "exceed this value. Otherwise, files are batched in the input "
+              "order.");
+
+  std::string worker_cpus;
+  po.Register("worker-cpus", &worker_cpus,
+              "If not empty, pin the decoding threads to these CPUs, e.g., "
+              "0-3,8. Thread i is pinned to the i-th CPU, wrapping around "
+              "if there are more threads than CPUs.");
+
+  bool replica_per_numa_node = false;
+  po.Register("replica-per-numa-node", &replica_per_numa_node,
+              "If true, create one recognizer on each NUMA node and "
+              "distribute the decoding threads over them. The threads of a "
+              "recognizer are pinned to the CPUs of its node.");
+
+  sherpa_onnx::OrtEnvConfig env_config;
+  env_config.Register(&po);
+
   po.Read(argc, argv);
   if (po.NumArgs() < 1 && wav_scp.empty()) {
     fprintf(stderr, "Error: Please provide at least 1 wave file.\n\n");
@@ -250,10 +320,79 @@ for a list of pre-trained models to download.
     fprintf(stderr, "Errors in config!\n");
     return -1;
   }
+
+  std::vector<int32_t> cpus;
+  if (!sherpa_onnx::ParseCpuList(worker_cpus, &cpus)) {
+    fprintf(stderr, "Invalid --worker-cpus: '%s'\n", worker_cpus.c_str());
+    return -1;
+  }
+
+  // Decoding thread i is pinned to replica_cpus[i % replica_cpus.size()].
+  // With --replica-per-numa-node, entry i is also the node of recognizer i.
+  std::vector<std::vector<int32_t>> replica_cpus;
+  if (replica_per_numa_node) {
+    replica_cpus = sherpa_onnx::GetNumaNodeCpus();
+    fprintf(stderr, "Number of NUMA nodes: %d\n",
+            static_cast<int32_t>(replica_cpus.size()));
+
+    if (env_config.use_global_thread_pool) {
+      fprintf(stderr,
+              "--replica-per-numa-node cannot be used with "
+              "--ort-global-thread-pool since the threads of the global pool "
+              "are not bound to a node\n");
+      return -1;
+    }
+
+    if (!cpus.empty()) {
+      fprintf(stderr,
+              "Ignore --worker-cpus since --replica-per-numa-node is true\n");
+    }
+
+    // Otherwise, all replicas use the prepacked weights of the first one
+    // and the weights are no longer local to each node
+    env_config.share_prepacked_weights = false;
+  } else if (!cpus.empty()) {
+    for (auto c : cpus) {
+      replica_cpus.push_back({c});
+    }
+  }
+
+  if (!sherpa_onnx::InitOrtEnv(env_config)) {
+    return -1;
+  }
+
   std::this_thread::sleep_for(std::chrono::seconds(10));  // sleep 10s
   fprintf(stderr, "Creating recognizer ...\n");
   const auto begin = std::chrono::steady_clock::now();
-  sherpa_onnx::OfflineRecognizer recognizer(config);
+  std::vector<std::unique_ptr<sherpa_onnx::OfflineRecognizer>> recognizers;
+  if (replica_per_numa_node && replica_cpus.size() > 1) {
+    // Create each replica in a thread pinned to its node. Memory is
+    // allocated on the node of the thread that first touches it, so the
+    // weights are local to the node. The threads of the onnxruntime pools
+    // of a replica inherit the CPUs of the creating thread.
+    recognizers.resize(replica_cpus.size());
+    std::vector<std::thread> creators;
+    for (int32_t i = 0; i != static_cast<int32_t>(replica_cpus.size()); ++i) {
+      creators.emplace_back([&config, &recognizers, &replica_cpus, i]() {
+        sherpa_onnx::SetCurrentThreadAffinity(replica_cpus[i]);
+        recognizers[i] =
+            std::make_unique<sherpa_onnx::OfflineRecognizer>(config);
+      });
+    }
+
+    for (auto &t : creators) {
+      t.join();
+    }
+  } else {
+    if (replica_per_numa_node) {
+      fprintf(stderr, "Use a single recognizer since there are %d NUMA nodes\n",
+              static_cast<int32_t>(replica_cpus.size()));
+      replica_cpus.clear();
+    }
+
+    recognizers.push_back(
+        std::make_unique<sherpa_onnx::OfflineRecognizer>(config));
+  }
   const auto end = std::chrono::steady_clock::now();
   float elapsed_seconds =
       std::chrono::duration_cast<std::chrono::milliseconds>(end - begin)
@@ -278,12 +417,27 @@ for a list of pre-trained models to download.
   }
   std::vector<std::thread> threads;
   std::vector<std::vector<std::string>> batch_wav_paths =
-      SplitToBatches(wav_paths, batch_size);
+      max_padded_frames > 0
+          ? SplitToBuckets(wav_paths, batch_size, max_padded_frames)
+          : SplitToBatches(wav_paths, batch_size);
   float total_length = 0.0f;
   float total_time = 0.0f;
   for (int i = 0; i < nj; i++) {
-    threads.emplace_back(std::thread(AsrInference, batch_wav_paths, &recognizer,
-                                     &total_length, &total_time));
+    // Replicas share the batches through wav_index, so a replica that
+    // finishes its batches earlier takes more of them
+    sherpa_onnx::OfflineRecognizer *recognizer =
+        recognizers[i % recognizers.size()].get();
+
+    std::vector<int32_t> thread_cpus;
+    if (!replica_cpus.empty()) {
+      thread_cpus = replica_cpus[i % replica_cpus.size()];
+    }
+
+    threads.emplace_back([&batch_wav_paths, recognizer, thread_cpus,
+                          &total_length, &total_time]() {
+      sherpa_onnx::SetCurrentThreadAffinity(thread_cpus);
+      AsrInference(batch_wav_paths, recognizer, &total_length, &total_time);
+    });
   }
 
   for (auto &thread : threads) {
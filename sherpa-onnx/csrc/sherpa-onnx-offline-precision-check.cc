@@ -0,0 +1,248 @@
+// sherpa-onnx/csrc/sherpa-onnx-offline-precision-check.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sherpa-onnx/csrc/model-precision.h"
+#include "sherpa-onnx/csrc/offline-recognizer.h"
+#include "sherpa-onnx/csrc/ort-env.h"
+#include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/wave-reader.h"
+
+namespace {
+
+struct Wave {
+  std::string filename;
+  int32_t sampling_rate = -1;
+  std::vector<float> samples;
+};
+
+struct RunResult {
+  float load_seconds = 0;
+  float decode_seconds = 0;
+  std::vector<sherpa_onnx::OfflineRecognitionResult> results;
+};
+
+float SecondsSince(std::chrono::steady_clock::time_point begin) {
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::milliseconds>(end - begin)
+             .count() /
+         1000.;
+}
+
+RunResult Run(const sherpa_onnx::OfflineRecognizerConfig &config,
+              const std::vector<Wave> &waves) {
+  RunResult ans;
+
+  auto begin = std::chrono::steady_clock::now();
+  sherpa_onnx::OfflineRecognizer recognizer(config);
+  ans.load_seconds = SecondsSince(begin);
+
+  std::vector<std::unique_ptr<sherpa_onnx::OfflineStream>> ss;
+  std::vector<sherpa_onnx::OfflineStream *> ss_pointers;
+  for (const auto &w : waves) {
+    auto s = recognizer.CreateStream();
+    s->AcceptWaveform(w.sampling_rate, w.samples.data(), w.samples.size());
+
+    ss.push_back(std::move(s));
+    ss_pointers.push_back(ss.back().get());
+  }
+
+  begin = std::chrono::steady_clock::now();
+  recognizer.DecodeStreams(ss_pointers.data(), ss_pointers.size());
+  ans.decode_seconds = SecondsSince(begin);
+
+  for (const auto &s : ss) {
+    ans.results.push_back(s->GetResult());
+  }
+
+  return ans;
+}
+
+// Levenshtein distance between two token sequences
+int32_t EditDistance(const std::vector<std::string> &a,
+                     const std::vector<std::string> &b) {
+  std::vector<int32_t> prev(b.size() + 1);
+  std::vector<int32_t> cur(b.size() + 1);
+  for (int32_t j = 0; j <= static_cast<int32_t>(b.size()); ++j) {
+    prev[j] = j;
+  }
+
+  for (int32_t i = 1; i <= static_cast<int32_t>(a.size()); ++i) {
+    cur[0] = i;
+    for (int32_t j = 1; j <= static_cast<int32_t>(b.size()); ++j) {
+      int32_t cost = a[i - 1] == b[j - 1] ? 0 : 1;
+      cur[j] = std::min({prev[j] + 1, cur[j - 1] + 1, prev[j - 1] + cost});
+    }
+    std::swap(prev, cur);
+  }
+
+  return prev[b.size()];
+}
+
+}  // namespace
+
+int main(int32_t argc, char *argv[]) {
+  const char *kUsageMessage = R"usage(
+Compare the accuracy and speed of a non-streaming model in two precisions,
+e.g., to check whether the int8 model is good enough before switching to it.
+
+The model files in the other precision have to be next to the given ones,
+e.g., encoder.int8.onnx next to encoder.onnx. You can generate them with
+./scripts/quantize-models.py
+
+Usage:
+
+  ./bin/sherpa-onnx-offline-precision-check \
+    --tokens=/path/to/tokens.txt \
+    --encoder=/path/to/encoder.onnx \
+    --decoder=/path/to/decoder.onnx \
+    --joiner=/path/to/joiner.onnx \
+    --precision=fp32 \
+    --compare-precision=int8 \
+    --wav-list=/path/to/wav.list \
+    [foo.wav bar.wav ...]
+
+Model options are the same as the ones of ./bin/sherpa-onnx-offline.
+--precision selects the reference model. An empty value means the given
+files.
+
+wav.list contains one wave file per line. Results of the reference model
+are used as ground truth, so the reported error rate is the token-level
+difference between the two models.
+)usage";
+
+  sherpa_onnx::ParseOptions po(kUsageMessage);
+  sherpa_onnx::OfflineRecognizerConfig config;
+  sherpa_onnx::OrtEnvConfig env_config;
+  std::string compare_precision = "int8";
+  std::string wav_list;
+
+  config.Register(&po);
+  env_config.Register(&po);
+
+  po.Register("compare-precision", &compare_precision,
+              "Precision to compare with --precision: fp32, fp16, or int8");
+
+  po.Register("wav-list", &wav_list,
+              "A text file containing one wave file per line");
+
+  po.Read(argc, argv);
+
+  std::vector<std::string> filenames;
+  for (int32_t i = 1; i <= po.NumArgs(); ++i) {
+    filenames.push_back(po.GetArg(i));
+  }
+
+  if (!wav_list.empty()) {
+    std::ifstream is(wav_list);
+    if (!is) {
+      fprintf(stderr, "Failed to open '%s'\n", wav_list.c_str());
+      return -1;
+    }
+
+    std::string line;
+    while (std::getline(is, line)) {
+      if (!line.empty()) {
+        filenames.push_back(line);
+      }
+    }
+  }
+
+  if (filenames.empty()) {
+    fprintf(stderr, "Error: Please provide at least 1 wave file.\n\n");
+    po.PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+
+  if (compare_precision.empty() ||
+      !sherpa_onnx::IsValidModelPrecision(compare_precision)) {
+    fprintf(stderr, "Invalid --compare-precision '%s'\n",
+            compare_precision.c_str());
+    return -1;
+  }
+
+  fprintf(stderr, "%s\n", config.ToString().c_str());
+
+  if (!config.Validate()) {
+    fprintf(stderr, "Errors in config!\n");
+    return -1;
+  }
+
+  if (!sherpa_onnx::InitOrtEnv(env_config)) {
+    return -1;
+  }
+
+  std::vector<Wave> waves;
+  float duration = 0;
+  for (const auto &f : filenames) {
+    Wave w;
+    w.filename = f;
+
+    bool is_ok = false;
+    w.samples = sherpa_onnx::ReadWave(f, &w.sampling_rate, &is_ok);
+    if (!is_ok) {
+      fprintf(stderr, "Failed to read '%s'\n", f.c_str());
+      return -1;
+    }
+
+    duration += w.samples.size() / static_cast<float>(w.sampling_rate);
+    waves.push_back(std::move(w));
+  }
+
+  sherpa_onnx::OfflineRecognizerConfig compare_config = config;
+  compare_config.model_config.precision = compare_precision;
+
+  fprintf(stderr, "Decoding with precision '%s'\n",
+          config.model_config.precision.c_str());
+  RunResult ref = Run(config, waves);
+
+  fprintf(stderr, "Decoding with precision '%s'\n", compare_precision.c_str());
+  RunResult hyp = Run(compare_config, waves);
+
+  int32_t num_errors = 0;
+  int32_t num_tokens = 0;
+  int32_t num_different_files = 0;
+  for (int32_t i = 0; i != static_cast<int32_t>(waves.size()); ++i) {
+    const auto &r = ref.results[i];
+    const auto &h = hyp.results[i];
+
+    num_errors += EditDistance(r.tokens, h.tokens);
+    num_tokens += r.tokens.size();
+
+    if (r.text != h.text) {
+      ++num_different_files;
+      fprintf(stderr, "%s\n  %s: %s\n  %s: %s\n----\n",
+              waves[i].filename.c_str(),
+              config.model_config.precision.c_str(), r.text.c_str(),
+              compare_precision.c_str(), h.text.c_str());
+    }
+  }
+
+  fprintf(stderr, "Number of files: %d, total duration: %.3f s\n",
+          static_cast<int32_t>(waves.size()), duration);
+
+  fprintf(stderr, "%-8s load: %.3f s, decode: %.3f s, RTF: %.3f\n",
+          config.model_config.precision.c_str(), ref.load_seconds,
+          ref.decode_seconds, ref.decode_seconds / duration);
+
+  fprintf(stderr, "%-8s load: %.3f s, decode: %.3f s, RTF: %.3f\n",
+          compare_precision.c_str(), hyp.load_seconds, hyp.decode_seconds,
+          hyp.decode_seconds / duration);
+
+  fprintf(stderr, "Files with different results: %d\n", num_different_files);
+  fprintf(stderr, "Token error rate w.r.t. '%s': %.2f%% (%d/%d)\n",
+          config.model_config.precision.c_str(),
+          num_tokens ? 100. * num_errors / num_tokens : 0., num_errors,
+          num_tokens);
+
+  return 0;
+}
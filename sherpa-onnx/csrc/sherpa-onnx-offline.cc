@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "sherpa-onnx/csrc/offline-recognizer.h"
+#include "sherpa-onnx/csrc/ort-env.h"
 #include "sherpa-onnx/csrc/parse-options.h"
 #include "sherpa-onnx/csrc/wave-reader.h"
 
@@ -105,7 +106,9 @@ for a list of pre-trained models to download.
 
   sherpa_onnx::ParseOptions po(kUsageMessage);
   sherpa_onnx::OfflineRecognizerConfig config;
+  sherpa_onnx::OrtEnvConfig env_config;
   config.Register(&po);
+  env_config.Register(&po);
 
   po.Read(argc, argv);
   if (po.NumArgs() < 1) {
@@ -121,6 +124,10 @@ for a list of pre-trained models to download.
     return -1;
   }
 
+  if (!sherpa_onnx::InitOrtEnv(env_config)) {
+    return -1;
+  }
+
   fprintf(stderr, "Creating recognizer ...\n");
   sherpa_onnx::OfflineRecognizer recognizer(config);
 
@@ -12,6 +12,7 @@
 
 #include "sherpa-onnx/csrc/online-recognizer.h"
 #include "sherpa-onnx/csrc/online-stream.h"
+#include "sherpa-onnx/csrc/ort-env.h"
 #include "sherpa-onnx/csrc/parse-options.h"
 #include "sherpa-onnx/csrc/symbol-table.h"
 #include "sherpa-onnx/csrc/wave-reader.h"
@@ -77,8 +78,10 @@ for a list of pre-trained models to download.
 
   sherpa_onnx::ParseOptions po(kUsageMessage);
   sherpa_onnx::OnlineRecognizerConfig config;
+  sherpa_onnx::OrtEnvConfig env_config;
 
   config.Register(&po);
+  env_config.Register(&po);
 
   po.Read(argc, argv);
   if (po.NumArgs() < 1) {
@@ -94,6 +97,10 @@ for a list of pre-trained models to download.
     return -1;
   }
 
+  if (!sherpa_onnx::InitOrtEnv(env_config)) {
+    return -1;
+  }
+
   sherpa_onnx::OnlineRecognizer recognizer(config);
 
   std::vector<Stream> ss;
@@ -85,6 +85,27 @@ std::vector<float> SpeakerEmbeddingExtractor::Compute(OnlineStream *s) const {
   return impl_->Compute(s);
 }
 
+std::future<void> SpeakerEmbeddingExtractor::Warmup(
+    const std::vector<WarmupShape> &shapes) const {
+  return std::async(std::launch::async, [this, shapes]() {
+    // Streams resample the input if the model uses another sample rate
+    constexpr int32_t kSampleRate = 16000;
+
+    for (const auto &shape : shapes) {
+      auto samples = GenerateWarmupSamples(kSampleRate, shape.num_seconds);
+
+      for (int32_t i = 0; i != shape.batch_size; ++i) {
+        auto s = CreateStream();
+        s->AcceptWaveform(kSampleRate, samples.data(), samples.size());
+        s->InputFinished();
+        if (IsReady(s.get())) {
+          Compute(s.get());
+        }
+      }
+    }
+  });
+}
+
 #if __ANDROID_API__ >= 9
 template SpeakerEmbeddingExtractor::SpeakerEmbeddingExtractor(
     AAssetManager *mgr, const SpeakerEmbeddingExtractorConfig &config);
@@ -5,12 +5,14 @@
 #ifndef SHERPA_ONNX_CSRC_SPEAKER_EMBEDDING_EXTRACTOR_H_
 #define SHERPA_ONNX_CSRC_SPEAKER_EMBEDDING_EXTRACTOR_H_
 
+#include <future>  // NOLINT
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "sherpa-onnx/csrc/online-stream.h"
 #include "sherpa-onnx/csrc/parse-options.h"
+#include "sherpa-onnx/csrc/warmup.h"
 
 namespace sherpa_onnx {
 
@@ -62,6 +64,18 @@ class SpeakerEmbeddingExtractor {
   // You have to ensure IsReady(s) returns true before you call this method.
   std::vector<float> Compute(OnlineStream *s) const;
 
+  /** Compute embeddings of synthetic audio of the given durations so that
+   * later requests do not pay for kernel selection and memory allocation
+   * in onnxruntime. Streams are computed one by one since Compute() does
+   * not support batches, so batch_size only repeats a shape.
+   *
+   * It returns immediately; the warmup runs in a background thread and
+   * the returned future becomes ready when it is done. Note that the
+   * destructor of the future waits for the warmup. Requests can be served
+   * while it runs. This object must outlive the warmup.
+   */
+  std::future<void> Warmup(const std::vector<WarmupShape> &shapes) const;
+
  private:
   std::unique_ptr<SpeakerEmbeddingExtractorImpl> impl_;
 };
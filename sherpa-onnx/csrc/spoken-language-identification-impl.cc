@@ -13,6 +13,8 @@
 #include "sherpa-onnx/csrc/file-utils.h"
 #include "sherpa-onnx/csrc/macros.h"
 #include "sherpa-onnx/csrc/onnx-utils.h"
+#include "sherpa-onnx/csrc/ort-env.h"
+#include "sherpa-onnx/csrc/session.h"
 #include "sherpa-onnx/csrc/spoken-language-identification-whisper-impl.h"
 
 namespace sherpa_onnx {
@@ -26,13 +28,12 @@ enum class ModelType : std::uint8_t {
 
 }
 
-static ModelType GetModelType(char *model_data, size_t model_data_length,
+static ModelType GetModelType(const char *model_data, size_t model_data_length,
                               bool debug) {
-  Ort::Env env(ORT_LOGGING_LEVEL_ERROR);
+  Ort::Env &env = GetOrtEnv();
   Ort::SessionOptions sess_opts;
 
-  auto sess = std::make_unique<Ort::Session>(env, model_data, model_data_length,
-                                             sess_opts);
+  auto sess = CreateSession(env, model_data, model_data_length, sess_opts);
 
   Ort::ModelMetadata meta_data = sess->GetModelMetadata();
   if (debug) {
@@ -72,7 +73,7 @@ SpokenLanguageIdentificationImpl::Create(
       SHERPA_ONNX_LOGE("Only whisper models are supported at present");
       exit(-1);
     }
-    auto buffer = ReadFile(config.whisper.encoder);
+    auto buffer = MapFile(config.whisper.encoder);
 
     model_type = GetModelType(buffer.data(), buffer.size(), config.debug);
   }
@@ -120,9 +120,9 @@ void TransducerKeywordDecoder::Decode(
         // blank is hardcoded to 0
         // also, it treats unk as blank
         if (new_token != 0 && new_token != unk_id_) {
-          new_hyp.ys.push_back(new_token);
-          new_hyp.timestamps.push_back(t + frame_offset);
-          new_hyp.ys_probs.push_back(
+          HypothesisNode *new_node =
+              new_hyp.AddToken(new_token, t + frame_offset);
+          new_node->SetYsProb(
               exp(logprobs[hyp_index * vocab_size + new_token]));
 
           new_hyp.num_trailing_blanks = 0;
@@ -132,9 +132,7 @@ void TransducerKeywordDecoder::Decode(
           new_hyp.context_state = std::get<1>(context_res);
           // Start matching from the start state, forget the decoder history.
           if (new_hyp.context_state->token == -1) {
-            new_hyp.ys = blanks;
-            new_hyp.timestamps.clear();
-            new_hyp.ys_probs.clear();
+            new_hyp.SetTokens(blanks);
           }
         } else {
           ++new_hyp.num_trailing_blanks;
@@ -151,17 +149,21 @@ void TransducerKeywordDecoder::Decode(
 
       if (matched) {
         float ys_prob = 0.0;
+        auto ys_probs = best_hyp.YsProbs();
         for (int32_t i = 0; i < matched_state->level; ++i) {
-          ys_prob += best_hyp.ys_probs[i];
+          ys_prob += ys_probs[i];
         }
         ys_prob /= matched_state->level;
         if (best_hyp.num_trailing_blanks > num_trailing_blanks_ &&
             ys_prob >= matched_state->ac_threshold) {
           auto &r = (*result)[b];
-          r.tokens = {best_hyp.ys.end() - matched_state->level,
-                      best_hyp.ys.end()};
-          r.timestamps = {best_hyp.timestamps.end() - matched_state->level,
-                          best_hyp.timestamps.end()};
+          int32_t num_tokens = best_hyp.NumTokens();
+          r.tokens.resize(matched_state->level);
+          best_hyp.GetTokens(num_tokens - matched_state->level, num_tokens,
+                             r.tokens.data());
+          auto timestamps = best_hyp.Timestamps();
+          r.timestamps = {timestamps.end() - matched_state->level,
+                          timestamps.end()};
           r.keyword = matched_state->phrase;
 
           hyps = Hypotheses({{blanks, 0, ss[b]->GetContextGraph()->Root()}});
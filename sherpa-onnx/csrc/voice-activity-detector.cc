@@ -220,6 +220,24 @@ const VadModelConfig &VoiceActivityDetector::GetConfig() const {
   return impl_->GetConfig();
 }
 
+std::future<void> VoiceActivityDetector::Warmup(
+    const std::vector<WarmupShape> &shapes) {
+  return std::async(std::launch::async, [this, shapes]() {
+    int32_t sample_rate = GetConfig().sample_rate;
+
+    for (const auto &shape : shapes) {
+      auto samples = GenerateWarmupSamples(sample_rate, shape.num_seconds);
+      for (int32_t i = 0; i != shape.batch_size; ++i) {
+        AcceptWaveform(samples.data(), samples.size());
+        Flush();
+      }
+    }
+
+    Reset();
+    Clear();
+  });
+}
+
 #if __ANDROID_API__ >= 9
 template VoiceActivityDetector::VoiceActivityDetector(
     AAssetManager *mgr, const VadModelConfig &config,
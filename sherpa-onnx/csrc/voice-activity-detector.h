@@ -4,10 +4,12 @@
 #ifndef SHERPA_ONNX_CSRC_VOICE_ACTIVITY_DETECTOR_H_
 #define SHERPA_ONNX_CSRC_VOICE_ACTIVITY_DETECTOR_H_
 
+#include <future>  // NOLINT
 #include <memory>
 #include <vector>
 
 #include "sherpa-onnx/csrc/vad-model-config.h"
+#include "sherpa-onnx/csrc/warmup.h"
 
 namespace sherpa_onnx {
 
@@ -43,6 +45,17 @@ class VoiceActivityDetector {
 
   const VadModelConfig &GetConfig() const;
 
+  /** Run the model over synthetic audio of the given durations and then
+   * Reset() and Clear() this detector. The model processes one window
+   * at a time, so batch_size only repeats a shape.
+   *
+   * It returns immediately; the warmup runs in a background thread and
+   * the returned future becomes ready when it is done. Note that the
+   * destructor of the future waits for the warmup. Since this class is
+   * not thread-safe, do not use it before the future is ready.
+   */
+  std::future<void> Warmup(const std::vector<WarmupShape> &shapes);
+
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
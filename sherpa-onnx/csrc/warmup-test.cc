@@ -0,0 +1,37 @@
+// sherpa-onnx/csrc/warmup-test.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/warmup.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace sherpa_onnx {
+
+TEST(ParseWarmupShapes, Basic) {
+  std::vector<WarmupShape> shapes;
+
+  EXPECT_TRUE(ParseWarmupShapes("", &shapes));
+  EXPECT_TRUE(shapes.empty());
+
+  EXPECT_TRUE(ParseWarmupShapes("1x2,8x0.5", &shapes));
+  ASSERT_EQ(shapes.size(), 2);
+  EXPECT_EQ(shapes[0].batch_size, 1);
+  EXPECT_EQ(shapes[0].num_seconds, 2);
+  EXPECT_EQ(shapes[1].batch_size, 8);
+  EXPECT_EQ(shapes[1].num_seconds, 0.5);
+
+  EXPECT_FALSE(ParseWarmupShapes("4", &shapes));
+  EXPECT_FALSE(ParseWarmupShapes("0x2", &shapes));
+  EXPECT_FALSE(ParseWarmupShapes("2xa", &shapes));
+}
+
+TEST(GenerateWarmupSamples, Basic) {
+  auto samples = GenerateWarmupSamples(16000, 0.5);
+  EXPECT_EQ(samples.size(), 8000);
+  EXPECT_EQ(samples, GenerateWarmupSamples(16000, 0.5));
+}
+
+}  // namespace sherpa_onnx
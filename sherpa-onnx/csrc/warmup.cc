@@ -0,0 +1,58 @@
+// sherpa-onnx/csrc/warmup.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/csrc/warmup.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "sherpa-onnx/csrc/text-utils.h"
+
+namespace sherpa_onnx {
+
+bool ParseWarmupShapes(const std::string &s,
+                       std::vector<WarmupShape> *shapes) {
+  shapes->clear();
+
+  std::vector<std::string> parts;
+  SplitStringToVector(s, ",", true, &parts);
+
+  for (const auto &p : parts) {
+    auto pos = p.find('x');
+    if (pos == std::string::npos) {
+      return false;
+    }
+
+    WarmupShape shape;
+    if (!ConvertStringToInteger(p.substr(0, pos), &shape.batch_size) ||
+        !ConvertStringToReal(p.substr(pos + 1), &shape.num_seconds)) {
+      return false;
+    }
+
+    if (shape.batch_size <= 0 || shape.num_seconds <= 0) {
+      return false;
+    }
+
+    shapes->push_back(shape);
+  }
+
+  return true;
+}
+
+std::vector<float> GenerateWarmupSamples(int32_t sample_rate,
+                                         float num_seconds) {
+  std::vector<float> samples(static_cast<int32_t>(sample_rate * num_seconds));
+
+  // A fixed seed so that warmups are reproducible
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<float> dist(-0.01f, 0.01f);
+  for (auto &s : samples) {
+    s = dist(gen);
+  }
+
+  return samples;
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,86 @@
+// sherpa-onnx/csrc/warmup.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+#ifndef SHERPA_ONNX_CSRC_WARMUP_H_
+#define SHERPA_ONNX_CSRC_WARMUP_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sherpa_onnx {
+
+// The first runs of a session with a new input shape are slow since
+// onnxruntime selects kernels and grows its memory arena. Warmup() of
+// the top-level classes, e.g., OfflineRecognizer, runs synthetic inputs
+// of the given shapes in a background thread so that real requests
+// do not pay for it.
+struct WarmupShape {
+  // Number of streams decoded together
+  int32_t batch_size = 1;
+
+  // Duration of the audio of each stream
+  float num_seconds = 1;
+
+  WarmupShape() = default;
+  WarmupShape(int32_t batch_size, float num_seconds)
+      : batch_size(batch_size), num_seconds(num_seconds) {}
+};
+
+/** Parse a comma separated list of batch_size x num_seconds, e.g.,
+ * "1x2,8x2,8x10".
+ *
+ * @return Return false if s is malformed.
+ */
+bool ParseWarmupShapes(const std::string &s, std::vector<WarmupShape> *shapes);
+
+/** Return low-level noise of the given duration. Noise instead of silence
+ * so that the models take the same code paths as with real audio.
+ */
+std::vector<float> GenerateWarmupSamples(int32_t sample_rate,
+                                         float num_seconds);
+
+/** Decode batch_size streams together for each shape with a streaming
+ * recognizer, e.g., OnlineRecognizer or KeywordSpotter, until all input
+ * is consumed. Since the last chunks of streams become ready together,
+ * smaller batches are run as well.
+ */
+template <typename Recognizer>
+void RunStreamingWarmup(const Recognizer &recognizer,
+                        const std::vector<WarmupShape> &shapes) {
+  // Streams resample the input if the model uses another sample rate
+  constexpr int32_t kSampleRate = 16000;
+
+  for (const auto &shape : shapes) {
+    auto samples = GenerateWarmupSamples(kSampleRate, shape.num_seconds);
+
+    std::vector<decltype(recognizer.CreateStream())> ss;
+    for (int32_t i = 0; i != shape.batch_size; ++i) {
+      auto s = recognizer.CreateStream();
+      s->AcceptWaveform(kSampleRate, samples.data(), samples.size());
+      s->InputFinished();
+      ss.push_back(std::move(s));
+    }
+
+    std::vector<decltype(ss[0].get())> ready;
+    while (true) {
+      ready.clear();
+      for (const auto &s : ss) {
+        if (recognizer.IsReady(s.get())) {
+          ready.push_back(s.get());
+        }
+      }
+
+      if (ready.empty()) {
+        break;
+      }
+
+      recognizer.DecodeStreams(ready.data(), ready.size());
+    }
+  }
+}
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_CSRC_WARMUP_H_
@@ -0,0 +1,58 @@
+// sherpa-onnx/python/csrc/model-registry.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/python/csrc/model-registry.h"
+
+#include <string>
+
+#include "sherpa-onnx/csrc/model-registry.h"
+#include "sherpa-onnx/csrc/offline-recognizer.h"
+
+#if SHERPA_ONNX_ENABLE_TTS == 1
+#include "sherpa-onnx/csrc/offline-tts.h"
+#endif
+
+namespace sherpa_onnx {
+
+template <typename Model, typename Config>
+static void PybindModelRegistryImpl(py::module *m, const char *name) {
+  using PyClass = ModelRegistry<Model, Config>;
+  py::class_<PyClass>(*m, name)
+      .def(py::init([](int32_t max_memory_mb, float max_idle_seconds) {
+             ModelRegistryConfig config(max_memory_mb, max_idle_seconds);
+             if (!config.Validate()) {
+               throw py::value_error("Errors in config: " + config.ToString());
+             }
+             return std::make_unique<PyClass>(config);
+           }),
+           py::arg("max_memory_mb") = 0, py::arg("max_idle_seconds") = 0)
+      .def(
+          "add",
+          [](PyClass &self, const std::string &name, const Config &config) {
+            return self.Add(name, config);
+          },
+          py::arg("name"), py::arg("config"))
+      .def("get", &PyClass::Get, py::arg("name"),
+           py::call_guard<py::gil_scoped_release>())
+      .def("unload", &PyClass::Unload, py::arg("name"),
+           py::call_guard<py::gil_scoped_release>())
+      .def("evict_idle", &PyClass::EvictIdle,
+           py::call_guard<py::gil_scoped_release>())
+      .def("contains", &PyClass::Contains, py::arg("name"))
+      .def("is_loaded", &PyClass::IsLoaded, py::arg("name"))
+      .def_property_readonly("num_loaded", &PyClass::NumLoaded)
+      .def_property_readonly("loaded_bytes", &PyClass::LoadedBytes);
+}
+
+void PybindModelRegistry(py::module *m) {
+  PybindModelRegistryImpl<OfflineRecognizer, OfflineRecognizerConfig>(
+      m, "OfflineRecognizerRegistry");
+
+#if SHERPA_ONNX_ENABLE_TTS == 1
+  PybindModelRegistryImpl<OfflineTts, OfflineTtsConfig>(m,
+                                                        "OfflineTtsRegistry");
+#endif
+}
+
+}  // namespace sherpa_onnx
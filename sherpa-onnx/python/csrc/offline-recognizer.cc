@@ -4,6 +4,7 @@
 
 #include "sherpa-onnx/python/csrc/offline-recognizer.h"
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -43,7 +44,9 @@ void PybindOfflineRecognizer(py::module *m) {
   PybindOfflineRecognizerConfig(m);
 
   using PyClass = OfflineRecognizer;
-  py::class_<PyClass>(*m, "OfflineRecognizer")
+  // Hold it by std::shared_ptr since OfflineRecognizerRegistry returns it
+  // as std::shared_ptr
+  py::class_<PyClass, std::shared_ptr<PyClass>>(*m, "OfflineRecognizer")
       .def(py::init<const OfflineRecognizerConfig &>(), py::arg("config"),
            py::call_guard<py::gil_scoped_release>())
       .def(
@@ -56,6 +59,13 @@ void PybindOfflineRecognizer(py::module *m) {
             return self.CreateStream(hotwords);
           },
           py::arg("hotwords"), py::call_guard<py::gil_scoped_release>())
+      .def(
+          "clone",
+          [](const PyClass &self, const OfflineRecognizerConfig &config)
+              -> std::shared_ptr<PyClass> { return self.Clone(config); },
+          py::arg("config"), py::call_guard<py::gil_scoped_release>())
+      .def("get_stats", &PyClass::GetStats)
+      .def("reset_stats", &PyClass::ResetStats)
       .def("decode_stream", &PyClass::DecodeStream,
            py::call_guard<py::gil_scoped_release>())
       .def(
@@ -63,6 +73,16 @@ void PybindOfflineRecognizer(py::module *m) {
           [](const PyClass &self, std::vector<OfflineStream *> ss) {
             self.DecodeStreams(ss.data(), ss.size());
           },
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "decode_streams_bucketed",
+          [](const PyClass &self, std::vector<OfflineStream *> ss,
+             int32_t max_padded_frames, int32_t max_batch_size) {
+            self.DecodeStreamsBucketed(ss.data(), ss.size(),
+                                       max_padded_frames, max_batch_size);
+          },
+          py::arg("ss"), py::arg("max_padded_frames"),
+          py::arg("max_batch_size") = 0,
           py::call_guard<py::gil_scoped_release>());
 }
 
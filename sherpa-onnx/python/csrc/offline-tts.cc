@@ -4,6 +4,7 @@
 #include "sherpa-onnx/python/csrc/offline-tts.h"
 
 #include <algorithm>
+#include <memory>
 #include <string>
 
 #include "sherpa-onnx/csrc/offline-tts.h"
@@ -50,9 +51,18 @@ void PybindOfflineTts(py::module *m) {
   PybindGeneratedAudio(m);
 
   using PyClass = OfflineTts;
-  py::class_<PyClass>(*m, "OfflineTts")
+  // Hold it by std::shared_ptr since OfflineTtsRegistry returns it as
+  // std::shared_ptr
+  py::class_<PyClass, std::shared_ptr<PyClass>>(*m, "OfflineTts")
       .def(py::init<const OfflineTtsConfig &>(), py::arg("config"),
            py::call_guard<py::gil_scoped_release>())
+      .def(
+          "clone",
+          [](const PyClass &self, const OfflineTtsConfig &config)
+              -> std::shared_ptr<PyClass> { return self.Clone(config); },
+          py::arg("config"), py::call_guard<py::gil_scoped_release>())
+      .def("get_stats", &PyClass::GetStats)
+      .def("reset_stats", &PyClass::ResetStats)
       .def_property_readonly("sample_rate", &PyClass::SampleRate)
       .def_property_readonly("num_speakers", &PyClass::NumSpeakers)
       .def(
@@ -60,6 +60,7 @@ void PybindOnlineModelConfig(py::module *m) {
       .def_readwrite("model_type", &PyClass::model_type)
       .def_readwrite("modeling_unit", &PyClass::modeling_unit)
       .def_readwrite("bpe_vocab", &PyClass::bpe_vocab)
+      .def_readwrite("precision", &PyClass::precision)
       .def("validate", &PyClass::Validate)
       .def("__str__", &PyClass::ToString);
 }
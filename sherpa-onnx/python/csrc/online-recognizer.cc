@@ -103,6 +103,10 @@ void PybindOnlineRecognizer(py::module *m) {
             return self.CreateStream(hotwords);
           },
           py::arg("hotwords"), py::call_guard<py::gil_scoped_release>())
+      .def("clone", &PyClass::Clone, py::arg("config"),
+           py::call_guard<py::gil_scoped_release>())
+      .def("get_stats", &PyClass::GetStats)
+      .def("reset_stats", &PyClass::ResetStats)
       .def("is_ready", &PyClass::IsReady,
            py::call_guard<py::gil_scoped_release>())
       .def("decode_stream", &PyClass::DecodeStream,
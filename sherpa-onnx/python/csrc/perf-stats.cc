@@ -0,0 +1,20 @@
+// sherpa-onnx/python/csrc/perf-stats.cc
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#include "sherpa-onnx/python/csrc/perf-stats.h"
+
+#include "sherpa-onnx/csrc/perf-stats.h"
+
+namespace sherpa_onnx {
+
+void PybindPerfStats(py::module *m) {
+  using PyClass = StageStats;
+  py::class_<PyClass>(*m, "StageStats")
+      .def(py::init<>())
+      .def_readwrite("num_calls", &PyClass::num_calls)
+      .def_readwrite("total_seconds", &PyClass::total_seconds)
+      .def("__str__", &PyClass::ToString);
+}
+
+}  // namespace sherpa_onnx
@@ -0,0 +1,16 @@
+// sherpa-onnx/python/csrc/perf-stats.h
+//
+// Copyright (c)  2025  Xiaomi Corporation
+
+#ifndef SHERPA_ONNX_PYTHON_CSRC_PERF_STATS_H_
+#define SHERPA_ONNX_PYTHON_CSRC_PERF_STATS_H_
+
+#include "sherpa-onnx/python/csrc/sherpa-onnx.h"
+
+namespace sherpa_onnx {
+
+void PybindPerfStats(py::module *m);
+
+}  // namespace sherpa_onnx
+
+#endif  // SHERPA_ONNX_PYTHON_CSRC_PERF_STATS_H_
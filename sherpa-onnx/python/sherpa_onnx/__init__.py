@@ -12,6 +12,7 @@ from _sherpa_onnx import (
     OfflinePunctuation,
     OfflinePunctuationConfig,
     OfflinePunctuationModelConfig,
+    OfflineRecognizerRegistry,
     OfflineSpeakerDiarization,
     OfflineSpeakerDiarizationConfig,
     OfflineSpeakerDiarizationResult,
@@ -28,6 +29,7 @@ from _sherpa_onnx import (
     OfflineTtsKokoroModelConfig,
     OfflineTtsMatchaModelConfig,
     OfflineTtsModelConfig,
+    OfflineTtsRegistry,
     OfflineTtsVitsModelConfig,
     OfflineZipformerAudioTaggingModelConfig,
     OnlinePunctuation,
@@ -42,6 +44,7 @@ from _sherpa_onnx import (
     SpokenLanguageIdentification,
     SpokenLanguageIdentificationConfig,
     SpokenLanguageIdentificationWhisperConfig,
+    StageStats,
     VadModel,
     VadModelConfig,
     VoiceActivityDetector,
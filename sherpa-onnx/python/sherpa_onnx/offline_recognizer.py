@@ -956,3 +956,33 @@ class OfflineRecognizer(object):
 
     def decode_streams(self, ss: List[OfflineStream]):
         self.recognizer.decode_streams(ss)
+
+    def decode_streams_bucketed(
+        self,
+        ss: List[OfflineStream],
+        max_padded_frames: int,
+        max_batch_size: int = 0,
+    ):
+        """Like decode_streams(), but decode streams of similar lengths
+        together so that little computation is wasted on padding.
+
+        Args:
+          ss:
+            The streams to decode. The order does not matter.
+          max_padded_frames:
+            Upper bound of batch size times the number of frames of the
+            longest stream in the batch.
+          max_batch_size:
+            If positive, upper bound of the batch size.
+        """
+        self.recognizer.decode_streams_bucketed(
+            ss, max_padded_frames, max_batch_size
+        )
+
+    def get_stats(self):
+        """Return a dict mapping a stage name, e.g., encoder, to its
+        StageStats accumulated since the last call to reset_stats()."""
+        return self.recognizer.get_stats()
+
+    def reset_stats(self):
+        self.recognizer.reset_stats()
@@ -853,3 +853,11 @@ class OnlineRecognizer(object):
 
     def reset(self, s: OnlineStream) -> bool:
         return self.recognizer.reset(s)
+
+    def get_stats(self):
+        """Return a dict mapping a stage name, e.g., encoder, to its
+        StageStats accumulated since the last call to reset_stats()."""
+        return self.recognizer.get_stats()
+
+    def reset_stats(self):
+        self.recognizer.reset_stats()